@@ -0,0 +1,59 @@
+# Sources shared by the Android library and the host benchmark, paths are relative to this directory
+
+set(AIRE_JNI_SOURCES
+        aire.cpp jni/AcquireBitmapPixels.cpp jni/BlurPipes.cpp jni/ShiftPipelines.cpp jni/Base.cpp
+        jni/Pipelines.cpp jni/EffectsPipelines.cpp jni/ToneMappingPipelines.cpp jni/YuvPipelines.cpp
+        jni/Geometry.cpp jni/Compress.cpp jni/Instrumentation.cpp jni/BatchPipelines.cpp jni/SimdTargets.cpp
+        jni/ResultCache.cpp jni/Cancellation.cpp
+)
+
+set(AIRE_KERNEL_SOURCES
+        blur/BoxBlur.cpp blur/GaussBlur.cpp blur/MedianBlur.cpp blur/ShgStackBlur.cpp
+        blur/AnisotropicDiffusion.cpp blur/PoissonBlur.cpp blur/PyramidBlur.cpp blur/RecursiveGaussian.cpp
+        blur/VariableBoxBlur.cpp blur/ZoomBlur.cpp
+        shift/TiltShift.cpp shift/Glitch.cpp shift/WindStagger.cpp
+        conversion/CopyUnaligned.cpp conversion/F32ToRGB1010102.cpp conversion/Rgb565.cpp
+        conversion/Rgb1010102.cpp conversion/Rgb1010102toF16.cpp conversion/Rgba2Rgb.cpp
+        conversion/Rgba8ToF16.cpp conversion/Rgba1010102toF32.cpp conversion/RgbaF16bitNBitU8.cpp
+        conversion/RGBAlpha.cpp conversion/HalfFloats.cpp conversion/yuv/YuvConverter.cpp
+        halftone/Halftone.cpp
+        color/ConvolveToneMapper.cpp color/Gamut.cpp color/Adjustments.cpp
+        algo/median/QuickSelect.cpp algo/median/Wirth.cpp algo/sleef-hwy.cpp algo/MedianCut.cpp
+        algo/WuQuantizer.cpp algo/SimdNearestSearch.cpp
+        base/Arithmetics.cpp base/Erosion.cpp base/Grayscale.cpp base/Dilation.cpp base/Channels.cpp
+        base/Threshold.cpp base/Convolve1D.cpp base/Convolve2D.cpp base/FftConvolve.cpp base/Vibrance.cpp
+        base/Grain.cpp base/Sharpness.cpp base/LUT8.cpp base/ScratchArena.cpp base/Convolve1Db16.cpp
+        base/PNGEncoder.cpp base/RemapPalette.cpp base/AffineTransform.cpp base/WarpPerspective.cpp
+        base/Warp.cpp base/ExactTransform.cpp base/ArbitraryUtil.cpp base/Instrumentation.cpp
+        base/ImageCompression.cpp base/SimdTargets.cpp base/SummedAreaTable.cpp base/AdaptiveThreshold.cpp
+        base/MappedImage.cpp base/ImagePyramid.cpp base/ResultCache.cpp base/Cancellation.cpp
+        base/PaddedImage.cpp base/PlanarImage.cpp
+        effect/MarbleEffect.cpp effect/OilEffect.cpp effect/CrystallizeEffect.cpp
+        effect/FractalGlassEffect.cpp effect/WaterEffect.cpp effect/PerlinDistortion.cpp
+        pipelines/RemoveShadows.cpp pipelines/DehazeDarkChannel.cpp pipelines/FusedPipeline.cpp
+        pipelines/BatchPipeline.cpp pipelines/TiledPipeline.cpp
+        hwy/aligned_allocator.cc hwy/nanobenchmark.cc hwy/per_target.cc hwy/print.cc hwy/targets.cc
+        hwy/timer.cc
+        vendor/spng/spng.c
+)
+
+set(AIRE_JPEG_SOURCES
+        base/JPEGEncoder.cpp
+)
+
+# Highway targets compiled into every kernel, the best one supported by the CPU is picked at runtime.
+# SSSE3 and AVX-512 flavours above AVX3 cost code size for little gain. SVE kernels are opt-in until
+# they are checked against sizeless vector rules on device toolchains.
+option(AIRE_SIMD_STATIC "Compile only the baseline SIMD target" OFF)
+option(AIRE_SIMD_SVE "Compile SVE and SVE2 targets for arm64" OFF)
+
+set(AIRE_HWY_DISABLED_TARGETS "HWY_SSSE3|HWY_AVX3_DL|HWY_AVX3_ZEN4|HWY_AVX3_SPR|HWY_SVE_256|HWY_SVE2_128")
+if (NOT AIRE_SIMD_SVE)
+    string(APPEND AIRE_HWY_DISABLED_TARGETS "|HWY_SVE|HWY_SVE2")
+endif ()
+
+if (AIRE_SIMD_STATIC)
+    set(AIRE_HWY_DEFINITIONS HWY_COMPILE_ONLY_STATIC)
+else ()
+    set(AIRE_HWY_DEFINITIONS "HWY_DISABLED_TARGETS=(${AIRE_HWY_DISABLED_TARGETS})")
+endif ()
@@ -61,6 +61,19 @@ static vector<float> compute1DGaussianKernel(int width, float sigma) {
     return std::move(kernel);
 }
 
+/**
+ * Standard deviation of normalized symmetric kernel, accounts for kernel truncation
+ */
+static float computeKernelSigma(const vector<float> &kernel) {
+    const float mean = static_cast<float>(kernel.size() / 2);
+    float variance = 0;
+    for (int x = 0; x < kernel.size(); x++) {
+        const float d = static_cast<float>(x) - mean;
+        variance += kernel[x] * d * d;
+    }
+    return std::sqrtf(variance);
+}
+
 static bool isSquareRootInteger(float N) {
     if (N < 0)
         return false;
@@ -31,6 +31,10 @@
 #include "MedianCut.h"
 #include "median/Wirth.h"
 #include <vector>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include "concurrency.hpp"
 
 namespace aire {
 
@@ -131,20 +135,28 @@ namespace aire {
         uint8_t lg = _gmax - _gmin;
         uint8_t lb = _bmax - _bmin;
 
+        int shift = 0;
         if (lr >= lg && lr >= lb) {
-            std::sort(_histPtr + _lower, _histPtr + _upper, [&](uint16_t color1, uint16_t color2) {
-                return redFromRgb555(color1) < redFromRgb555(color2);
-            });
+            shift = 10;
         } else if (lg >= lr && lg >= lb) {
-            std::sort(_histPtr + _lower, _histPtr + _upper, [&](uint16_t color1, uint16_t color2) {
-                return greenFromRgb555(color1) < greenFromRgb555(color2);
-            });
-        } else if (lb >= lr && lb >= lg) {
-            std::sort(_histPtr + _lower, _histPtr + _upper, [&](uint16_t color1, uint16_t color2) {
-                return blueFromRgb555(color1) < blueFromRgb555(color2);
-            });
+            shift = 5;
         }
 
+        // Axis value has only 5 bits, so a stable counting sort orders the range in linear time
+        const uint8_t mask = (1 << 5) - 1;
+        uint32_t offsets[(1 << 5) + 1] = {0};
+        for (uint16_t i = _lower; i < _upper; i++) {
+            offsets[((_histPtr[i] >> shift) & mask) + 1]++;
+        }
+        for (int i = 1; i <= (1 << 5); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+        for (uint16_t i = _lower; i < _upper; i++) {
+            uint16_t color = _histPtr[i];
+            _sortBuffer[offsets[(color >> shift) & mask]++] = color;
+        }
+        std::copy(_sortBuffer, _sortBuffer + (_upper - _lower), _histPtr + _lower);
+
         int count = 0;
         int median = 0;
         for (uint16_t i = _lower; i < _upper; i++) {
@@ -189,10 +201,11 @@ namespace aire {
 
     //////////////////////////////////////////
     Palette::Palette(const RGBA *colors, size_t colorSize) : _colors(colors), _colorSize(colorSize) {
-        const size_t totalBytes = sizeof(int) * kHistSize + sizeof(uint16_t) * kHistSize;
+        const size_t totalBytes = sizeof(int) * kHistSize + 2 * sizeof(uint16_t) * kHistSize;
         uint8_t *bytes = (uint8_t *) malloc(totalBytes);
         _hist = (int *) bytes;
         _histPtr = (uint16_t *) (bytes + sizeof(int) * kHistSize);
+        _sortBuffer = _histPtr + kHistSize;
     }
 
     Palette::~Palette() {
@@ -210,21 +223,43 @@ namespace aire {
             }
 
             Cube cube = cubes[splitpos];
-            Cube cubeA(cube._hist, cube._histPtr);
-            Cube cubeB(cube._hist, cube._histPtr);
+            Cube cubeA(cube._hist, cube._histPtr, cube._sortBuffer);
+            Cube cubeB(cube._hist, cube._histPtr, cube._sortBuffer);
             cube.spliteCubes(cubeA, cubeB);
             cubes[splitpos] = cubeA;
             cubes[numCubes++] = cubeB;
         }
     }
 
-    void Palette::medianCut(size_t maxcubes, const std::function<void(const Cube &)> &callback) {
+    void Palette::buildHistogram() {
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    static_cast<int>(_colorSize / (256 * 256))), 1, 12);
+        const size_t segmentSize = (_colorSize + threadCount - 1) / threadCount;
+
+        // Every segment counts into its own histogram, the first one being the final, and they are merged afterwards
+        std::vector<int> partials(static_cast<size_t>(threadCount - 1) * kHistSize);
         memset(_hist, 0, sizeof(int) * kHistSize);
-        std::for_each(_colors, _colors + _colorSize, [&](RGBA color) {
-            uint16_t quantizedColor = rgb555FromRgba(color);
-            _hist[quantizedColor]++;
+
+        concurrency::parallel_for(threadCount, threadCount, [&](int segment) {
+            int *hist = segment == 0 ? _hist : partials.data() + (segment - 1) * kHistSize;
+            const size_t start = std::min(segment * segmentSize, _colorSize);
+            const size_t end = std::min(start + segmentSize, _colorSize);
+            for (size_t i = start; i < end; i++) {
+                hist[rgb555FromRgba(_colors[i])]++;
+            }
         });
 
+        for (int segment = 1; segment < threadCount; segment++) {
+            const int *hist = partials.data() + (segment - 1) * kHistSize;
+            for (size_t i = 0; i < kHistSize; i++) {
+                _hist[i] += hist[i];
+            }
+        }
+    }
+
+    void Palette::medianCut(size_t maxcubes, const std::function<void(const Cube &)> &callback) {
+        buildHistogram();
+
         uint16_t lower = 0;
         uint16_t upper = 0;
         for (size_t i = 0; i < kHistSize; i++) {
@@ -235,13 +270,13 @@ namespace aire {
         }
 
         if (upper - lower <= maxcubes) {
-            Cube cube(_hist, _histPtr);
+            Cube cube(_hist, _histPtr, _sortBuffer);
             for (size_t idx = lower; idx < upper; idx++) {
                 cube.shrink(idx, idx + 1);
                 callback(cube);
             }
         } else {
-            Cube cube(_hist, _histPtr);
+            Cube cube(_hist, _histPtr, _sortBuffer);
             cube.shrink(lower, upper);
 
             Cube *cubes = (Cube *) malloc(sizeof(Cube) * maxcubes);
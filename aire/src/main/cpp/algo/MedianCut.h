@@ -42,7 +42,8 @@ namespace aire {
         RGBA getAverageRGBA() const;
 
     private:
-        Cube(const int *hist, uint16_t *histPtr) : _hist(hist), _histPtr(histPtr) {
+        Cube(const int *hist, uint16_t *histPtr, uint16_t *sortBuffer) : _hist(hist), _histPtr(histPtr),
+                                                                         _sortBuffer(sortBuffer) {
         }
 
         void shrink(uint16_t lower, uint16_t upper);
@@ -56,6 +57,7 @@ namespace aire {
     private:
         const int *_hist;
         uint16_t *_histPtr;
+        uint16_t *_sortBuffer;
 
         uint16_t _lower;
         uint16_t _upper;
@@ -82,6 +84,8 @@ namespace aire {
     private:
         static void spliteCubes(Cube *cubes, size_t &numCubes, size_t maxCubes);
 
+        void buildHistogram();
+
     private:
         const RGBA *_colors;
         const size_t _colorSize;
@@ -90,5 +94,6 @@ namespace aire {
         };
         int *_hist;
         uint16_t *_histPtr;
+        uint16_t *_sortBuffer;
     };
 }
\ No newline at end of file
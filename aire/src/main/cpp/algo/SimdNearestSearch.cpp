@@ -0,0 +1,185 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "algo/SimdNearestSearch.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "SimdNearestSearch.h"
+#include <algorithm>
+#include <climits>
+#include "hwy/aligned_allocator.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    static const ScalableTag<int32_t> dSearch;
+    // Pixels matched per pass over the palette
+    static constexpr int kSearchPixels = 4;
+
+    static inline int channelPair(const int low, const int high) {
+        return (low & 0xFFFF) | (high << 16);
+    }
+
+    template<class D16, class V16 = Vec<D16>>
+    HWY_INLINE void pixelPairs(D16 d16, const uint8_t *pixel, V16 &rg, V16 &ba, V16 &weightBA) {
+        rg = BitCast(d16, Set(dSearch, channelPair(pixel[0], pixel[1])));
+        ba = BitCast(d16, Set(dSearch, channelPair(pixel[2], pixel[3])));
+        weightBA = BitCast(d16, Set(dSearch, channelPair(pixel[0] < 128 ? 3 : 2, 1)));
+    }
+
+    template<class V16, class V32>
+    HWY_INLINE void closerEntries(const V16 entryRG, const V16 entryBA, const V16 weightRG,
+                                  const V16 pixelRG, const V16 pixelBA, const V16 weightBA,
+                                  const V32 index, V32 &best, V32 &bestIndex) {
+        const V16 diffRG = Sub(pixelRG, entryRG);
+        const V16 diffBA = Sub(pixelBA, entryBA);
+        const V32 distance = Add(WidenMulPairwiseAdd(dSearch, diffRG, Mul(diffRG, weightRG)),
+                                 WidenMulPairwiseAdd(dSearch, diffBA, Mul(diffBA, weightBA)));
+        const auto closer = Lt(distance, best);
+        best = IfThenElse(closer, distance, best);
+        bestIndex = IfThenElse(closer, index, bestIndex);
+    }
+
+    template<class V32>
+    HWY_INLINE uint16_t closestIndex(const V32 best, const V32 bestIndex) {
+        const V32 minimum = MinOfLanes(dSearch, best);
+        const V32 candidates = IfThenElse(Eq(best, minimum), bestIndex, Set(dSearch, INT_MAX));
+        return static_cast<uint16_t>(GetLane(MinOfLanes(dSearch, candidates)));
+    }
+
+    /**
+     * Matches kSearchPixels pixels per pass, distance is 2dr^2 + 4dg^2 + (r < 128 ? 3 : 2)db^2 + da^2
+     */
+    static void searchBlock(const int16_t *redGreen, const int16_t *blueAlpha, const int entriesCount,
+                            const uint8_t *rgba, const int count, uint16_t *indices) {
+        const Repartition<int16_t, decltype(dSearch)> d16;
+        using V32 = Vec<decltype(dSearch)>;
+        using V16 = Vec<decltype(d16)>;
+        const int lanes = static_cast<int>(Lanes(dSearch));
+
+        const V16 weightRG = BitCast(d16, Set(dSearch, channelPair(2, 4)));
+        V16 rg0, ba0, w0, rg1, ba1, w1, rg2, ba2, w2, rg3, ba3, w3;
+        pixelPairs(d16, rgba, rg0, ba0, w0);
+        pixelPairs(d16, rgba + std::min(1, count - 1) * 4, rg1, ba1, w1);
+        pixelPairs(d16, rgba + std::min(2, count - 1) * 4, rg2, ba2, w2);
+        pixelPairs(d16, rgba + std::min(3, count - 1) * 4, rg3, ba3, w3);
+
+        V32 best0 = Set(dSearch, INT_MAX), best1 = best0, best2 = best0, best3 = best0;
+        V32 index0 = Zero(dSearch), index1 = index0, index2 = index0, index3 = index0;
+
+        V32 index = Iota(dSearch, 0);
+        const V32 step = Set(dSearch, lanes);
+
+        for (int i = 0; i < entriesCount; i += lanes) {
+            const V16 entryRG = LoadU(d16, redGreen + 2 * i);
+            const V16 entryBA = LoadU(d16, blueAlpha + 2 * i);
+            closerEntries(entryRG, entryBA, weightRG, rg0, ba0, w0, index, best0, index0);
+            closerEntries(entryRG, entryBA, weightRG, rg1, ba1, w1, index, best1, index1);
+            closerEntries(entryRG, entryBA, weightRG, rg2, ba2, w2, index, best2, index2);
+            closerEntries(entryRG, entryBA, weightRG, rg3, ba3, w3, index, best3, index3);
+            index = Add(index, step);
+        }
+
+        indices[0] = closestIndex(best0, index0);
+        if (count > 1) {
+            indices[1] = closestIndex(best1, index1);
+        }
+        if (count > 2) {
+            indices[2] = closestIndex(best2, index2);
+        }
+        if (count > 3) {
+            indices[3] = closestIndex(best3, index3);
+        }
+    }
+
+    void searchBlocksHWY(const int16_t *redGreen, const int16_t *blueAlpha, const int entriesCount,
+                         const uint8_t *rgba, const int count, uint16_t *indices) {
+        for (int x = 0; x < count; x += kSearchPixels) {
+            searchBlock(redGreen, blueAlpha, entriesCount, rgba + x * 4, std::min(kSearchPixels, count - x), indices + x);
+        }
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(searchBlocksHWY);
+
+    // Maximum number of int32 lanes of any target
+    static constexpr int kSearchSlack = 64;
+
+    SimdNearestSearch::SimdNearestSearch(const std::vector<Eigen::Vector4i> &initialPalette) : NearestColorSearch(),
+                                                                                              palette(initialPalette) {
+        if (palette.empty()) {
+            palette.emplace_back(0, 0, 0, 0);
+        }
+        entriesCount = static_cast<int>(palette.size());
+        // Loads of the widest target may run past the palette, so tail is padded for any vector length
+        const int stored = entriesCount + kSearchSlack;
+        redGreen.resize(stored * 2);
+        blueAlpha.resize(stored * 2);
+        for (int i = 0; i < stored; ++i) {
+            const Eigen::Vector4i &entry = palette[i < palette.size() ? i : 0];
+            redGreen[2 * i] = static_cast<int16_t>(entry.x());
+            redGreen[2 * i + 1] = static_cast<int16_t>(entry.y());
+            blueAlpha[2 * i] = static_cast<int16_t>(entry.z());
+            blueAlpha[2 * i + 1] = static_cast<int16_t>(entry.w());
+        }
+    }
+
+    void SimdNearestSearch::findClosestIndices(const uint8_t *rgba, int count, uint16_t *indices) const {
+        HWY_DYNAMIC_DISPATCH(searchBlocksHWY)(redGreen.data(), blueAlpha.data(), entriesCount, rgba, count, indices);
+    }
+
+    int SimdNearestSearch::findClosestIndex(const Eigen::Vector4i &color) const {
+        const uint8_t pixel[4] = {
+                static_cast<uint8_t>(std::clamp(color.x(), 0, 255)),
+                static_cast<uint8_t>(std::clamp(color.y(), 0, 255)),
+                static_cast<uint8_t>(std::clamp(color.z(), 0, 255)),
+                static_cast<uint8_t>(std::clamp(color.w(), 0, 255))
+        };
+        uint16_t index = 0;
+        findClosestIndices(pixel, 1, &index);
+        return index;
+    }
+
+    Eigen::Vector4i SimdNearestSearch::getNearest(Eigen::Vector4i &color) {
+        return palette[findClosestIndex(color)];
+    }
+
+}
+#endif
@@ -0,0 +1,76 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Eigen/Eigen"
+#include "MathUtils.hpp"
+#include "NearestColorSearch.hpp"
+
+namespace aire {
+
+    /**
+     * Brute force nearest palette search with the metric of LinearNearestSearch.
+     * Palette is kept as int16 red-green and blue-alpha planes, distances to a whole vector of entries
+     * are computed at once and several pixels are matched per pass over the palette
+     */
+    class SimdNearestSearch : public NearestColorSearch {
+    public:
+        explicit SimdNearestSearch(const std::vector<Eigen::Vector4i> &initialPalette);
+
+        ~SimdNearestSearch() override = default;
+
+        Eigen::Vector4i getNearest(Eigen::Vector4i &color) override;
+
+        /**
+         * Index of the nearest entry in the palette order given at construction, first one wins on ties
+         */
+        int findClosestIndex(const Eigen::Vector4i &color) const;
+
+        /**
+         * @param rgba - row of RGBA8888 pixels
+         * @param indices - receives palette index of every pixel
+         */
+        void findClosestIndices(const uint8_t *rgba, int count, uint16_t *indices) const;
+
+        const Eigen::Vector4i &color(int index) const {
+            return palette[index];
+        }
+
+    private:
+        std::vector<Eigen::Vector4i> palette;
+        // Interleaved pairs of red, green and blue, alpha of every entry, tail is padded by repeating the first entry
+        std::vector<int16_t> redGreen;
+        std::vector<int16_t> blueAlpha;
+        int entriesCount;
+    };
+}
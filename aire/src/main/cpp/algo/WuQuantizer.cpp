@@ -28,13 +28,47 @@
  *
  */
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "algo/WuQuantizer.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
 #include "WuQuantizer.h"
 #include <unordered_map>
 #include "MathUtils.hpp"
 #include "EigenUtils.h"
 #include <cstdint>
+#include <cmath>
+#include <thread>
+#include "concurrency.hpp"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    namespace hn = hwy::HWY_NAMESPACE;
+
+    void addDoublesHWY(double *d, const double *s, const size_t n) {
+        size_t i = 0;
+#if HWY_HAVE_FLOAT64
+        const hn::ScalableTag<double> df;
+        const size_t lanes = hn::Lanes(df);
+        for (; i + lanes <= n; i += lanes) {
+            hn::StoreU(hn::Add(hn::LoadU(df, d + i), hn::LoadU(df, s + i)), df, d + i);
+        }
+#endif
+        for (; i < n; ++i) {
+            d[i] += s[i];
+        }
+    }
+}
+HWY_AFTER_NAMESPACE();
 
+#if HWY_ONCE
 namespace aire {
+
+    HWY_EXPORT(addDoublesHWY);
+
     /// <summary><para>Shift color values right this many bits.</para><para>This reduces the granularity of the color maps produced, making it much faster.</para></summary>
     /// 3 = value error of 8 (0 and 7 will look the same to it, 0 and 8 different); Takes ~4MB for color tables; ~.25 -> .50 seconds
     /// 2 = value error of 4; Takes ~64MB for color tables; ~3 seconds
@@ -45,8 +79,6 @@ namespace aire {
     const uint8_t SIDESIZE = MAXSIDEINDEX + 1;
     const uint32_t TOTAL_SIDESIZE = SIDESIZE * SIDESIZE * SIDESIZE * SIDESIZE;
 
-    bool hasSemiTransparency = false;
-    int m_transparentPixelIndex = -1;
 //    uint32_t m_transparentColor = 0;
     double PR = .299, PG = .587, PB = .114;
 
@@ -82,85 +114,66 @@ namespace aire {
         return alpha + red * SIDESIZE + green * SIDESIZE * SIDESIZE + blue * SIDESIZE * SIDESIZE * SIDESIZE;
     }
 
-    inline float Volume(const Box &cube, long *moment) {
-        return (moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)] -
-                moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)] -
-                moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)] +
-                moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)] -
-                moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)] +
-                moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)] +
-                moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)] -
-                moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)]) -
-               (moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)] -
-                moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)] -
-                moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] +
-                moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] -
-                moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] +
-                moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] +
-                moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)] -
-                moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)]);
-    }
-
-    inline float Volume(const Box &cube, float *moment) {
-        return (moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)] -
-                moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)] -
-                moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)] +
-                moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)] -
-                moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)] +
-                moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)] +
-                moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)] -
-                moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)]) -
-               (moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)] -
-                moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)] -
-                moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] +
-                moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] -
-                moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] +
-                moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] +
-                moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)] -
-                moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)]);
+    inline float Volume(const Box &cube, const ColorMoment *moments, double ColorMoment::*field) {
+        return (moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)].*field -
+                moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)].*field -
+                moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)].*field +
+                moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)].*field -
+                moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)].*field +
+                moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)].*field +
+                moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)].*field -
+                moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)].*field) -
+               (moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)].*field -
+                moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)].*field -
+                moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)].*field +
+                moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)].*field -
+                moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)].*field +
+                moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)].*field +
+                moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field -
+                moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field);
     }
 
-    inline float Top(const Box &cube, Pixel direction, uint8_t position, long *moment) {
+    inline float Top(const Box &cube, Pixel direction, uint8_t position, const ColorMoment *moments, double ColorMoment::*field) {
         switch (direction) {
             case Alpha:
-                return (moment[Index(position, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)] -
-                        moment[Index(position, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)] -
-                        moment[Index(position, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)] +
-                        moment[Index(position, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)]) -
-                       (moment[Index(position, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)] -
-                        moment[Index(position, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] -
-                        moment[Index(position, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] +
-                        moment[Index(position, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)]);
+                return (moments[Index(position, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)].*field -
+                        moments[Index(position, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)].*field -
+                        moments[Index(position, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)].*field +
+                        moments[Index(position, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)].*field) -
+                       (moments[Index(position, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)].*field -
+                        moments[Index(position, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)].*field -
+                        moments[Index(position, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)].*field +
+                        moments[Index(position, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field);
 
             case Red:
-                return (moment[Index(cube.AlphaMaximum, position, cube.GreenMaximum, cube.BlueMaximum)] -
-                        moment[Index(cube.AlphaMaximum, position, cube.GreenMinimum, cube.BlueMaximum)] -
-                        moment[Index(cube.AlphaMinimum, position, cube.GreenMaximum, cube.BlueMaximum)] +
-                        moment[Index(cube.AlphaMinimum, position, cube.GreenMinimum, cube.BlueMaximum)]) -
-                       (moment[Index(cube.AlphaMaximum, position, cube.GreenMaximum, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMaximum, position, cube.GreenMinimum, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMinimum, position, cube.GreenMaximum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMinimum, position, cube.GreenMinimum, cube.BlueMinimum)]);
+                return (moments[Index(cube.AlphaMaximum, position, cube.GreenMaximum, cube.BlueMaximum)].*field -
+                        moments[Index(cube.AlphaMaximum, position, cube.GreenMinimum, cube.BlueMaximum)].*field -
+                        moments[Index(cube.AlphaMinimum, position, cube.GreenMaximum, cube.BlueMaximum)].*field +
+                        moments[Index(cube.AlphaMinimum, position, cube.GreenMinimum, cube.BlueMaximum)].*field) -
+                       (moments[Index(cube.AlphaMaximum, position, cube.GreenMaximum, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMaximum, position, cube.GreenMinimum, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMinimum, position, cube.GreenMaximum, cube.BlueMinimum)].*field +
+                        moments[Index(cube.AlphaMinimum, position, cube.GreenMinimum, cube.BlueMinimum)].*field);
 
             case Green:
-                return (moment[Index(cube.AlphaMaximum, cube.RedMaximum, position, cube.BlueMaximum)] -
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, position, cube.BlueMaximum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMaximum, position, cube.BlueMaximum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, position, cube.BlueMaximum)]) -
-                       (moment[Index(cube.AlphaMaximum, cube.RedMaximum, position, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, position, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMaximum, position, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, position, cube.BlueMinimum)]);
+                return (moments[Index(cube.AlphaMaximum, cube.RedMaximum, position, cube.BlueMaximum)].*field -
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, position, cube.BlueMaximum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMaximum, position, cube.BlueMaximum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, position, cube.BlueMaximum)].*field) -
+                       (moments[Index(cube.AlphaMaximum, cube.RedMaximum, position, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, position, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMaximum, position, cube.BlueMinimum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, position, cube.BlueMinimum)].*field);
 
             case Blue:
-                return (moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, position)] -
-                        moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, position)] -
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, position)] +
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, position)]) -
-                       (moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, position)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, position)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, position)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, position)]);
+                return (moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, position)].*field -
+                        moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, position)].*field -
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, position)].*field +
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, position)].*field) -
+                       (moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, position)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, position)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, position)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, position)].*field);
 
             default:
                 return 0;
@@ -171,89 +184,90 @@ namespace aire {
         return x * x;
     }
 
-    inline float Bottom(const Box &cube, Pixel direction, long *moment) {
+    inline float Bottom(const Box &cube, Pixel direction, const ColorMoment *moments, double ColorMoment::*field) {
         switch (direction) {
             case Alpha:
-                return (-moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)]) -
-                       (-moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)]);
+                return (-(moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMaximum)].*field) +
+                        moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)].*field) -
+                       (-(moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)].*field) +
+                        moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field);
 
             case Red:
-                return (-moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)] +
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)]) -
-                       (-moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)]);
+                return (-(moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)].*field) +
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMaximum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)].*field) -
+                       (-(moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)].*field) +
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field);
 
             case Green:
-                return (-moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)] +
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)]) -
-                       (-moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)]);
+                return (-(moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)].*field) +
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMaximum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMaximum)].*field) -
+                       (-(moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)].*field) +
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field);
 
             case Blue:
-                return (-moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)]) -
-                       (-moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)] +
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)] -
-                        moment[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)]);
+                return (-(moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)].*field) +
+                        moments[Index(cube.AlphaMaximum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)].*field +
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMaximum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field) -
+                       (-(moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMaximum, cube.BlueMinimum)].*field) +
+                        moments[Index(cube.AlphaMinimum, cube.RedMaximum, cube.GreenMinimum, cube.BlueMinimum)].*field +
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMaximum, cube.BlueMinimum)].*field -
+                        moments[Index(cube.AlphaMinimum, cube.RedMinimum, cube.GreenMinimum, cube.BlueMinimum)].*field);
 
             default:
                 return 0;
         }
     }
 
-    void WuQuantizer::Histogram3d(ColorData &colorData, const Eigen::Vector4i &color, const uint8_t alphaThreshold, const uint8_t alphaFader) {
-        uint8_t pixelBlue = color.z();
-        uint8_t pixelGreen = color.y();
-        uint8_t pixelRed = color.x();
-        uint8_t pixelAlpha = color.w();
+    struct HistogramEntry {
+        uint32_t index;
+        uint32_t color;
+    };
 
-        uint8_t indexAlpha = static_cast<uint8_t>((pixelAlpha >> SIDEPIXSHIFT) + 1);
-        uint8_t indexRed = static_cast<uint8_t>((pixelRed >> SIDEPIXSHIFT) + 1);
-        uint8_t indexGreen = static_cast<uint8_t>((pixelGreen >> SIDEPIXSHIFT) + 1);
-        uint8_t indexBlue = static_cast<uint8_t>((pixelBlue >> SIDEPIXSHIFT) + 1);
-
-        if (pixelAlpha > alphaThreshold) {
-            if (pixelAlpha < UINT8_MAX) {
-                short alpha = pixelAlpha + (pixelAlpha % alphaFader);
-                pixelAlpha = static_cast<uint8_t>(alpha > UINT8_MAX ? UINT8_MAX : alpha);
-                indexAlpha = static_cast<uint8_t>((pixelAlpha >> 3) + 1);
-            }
+    /**
+     * Histogram cell of the pixel and its color after alpha fading, false when pixel is below alpha threshold
+     */
+    static inline bool histogramCell(const uint8_t *pixel, const uint8_t alphaThreshold, const uint8_t alphaFader,
+                                     HistogramEntry &entry) {
+        const uint8_t pixelRed = pixel[0];
+        const uint8_t pixelGreen = pixel[1];
+        const uint8_t pixelBlue = pixel[2];
+        uint8_t pixelAlpha = pixel[3];
+
+        if (pixelAlpha <= alphaThreshold) {
+            return false;
+        }
 
-            const int index = Index(indexAlpha, indexRed, indexGreen, indexBlue);
-            if (index < TOTAL_SIDESIZE) {
-                colorData.weights[index]++;
-                colorData.momentsRed[index] += pixelRed;
-                colorData.momentsGreen[index] += pixelGreen;
-                colorData.momentsBlue[index] += pixelBlue;
-                colorData.momentsAlpha[index] += pixelAlpha;
-                colorData.moments[index] += sqr(pixelAlpha) + sqr(pixelRed) + sqr(pixelGreen) + sqr(pixelBlue);
-            }
+        uint8_t indexAlpha = static_cast<uint8_t>((pixelAlpha >> SIDEPIXSHIFT) + 1);
+        if (pixelAlpha < UINT8_MAX) {
+            short alpha = pixelAlpha + (pixelAlpha % alphaFader);
+            pixelAlpha = static_cast<uint8_t>(alpha > UINT8_MAX ? UINT8_MAX : alpha);
+            indexAlpha = static_cast<uint8_t>((pixelAlpha >> 3) + 1);
         }
 
-        colorData.AddPixel(packRGBA(pixelRed, pixelGreen, pixelBlue, pixelAlpha));
+        entry.index = Index(indexAlpha, static_cast<uint8_t>((pixelRed >> SIDEPIXSHIFT) + 1),
+                            static_cast<uint8_t>((pixelGreen >> SIDEPIXSHIFT) + 1),
+                            static_cast<uint8_t>((pixelBlue >> SIDEPIXSHIFT) + 1));
+        entry.color = packRGBA(pixelRed, pixelGreen, pixelBlue, pixelAlpha);
+        return true;
     }
 
     void AdjustMoments(const ColorData &colorData, const uint32_t &nMaxColors) {
         vector<int> indices;
         for (int i = 0; i < TOTAL_SIDESIZE; ++i) {
-            double d = colorData.weights[i];
+            double d = colorData.moments[i].weight;
             if (d > 0)
                 indices.emplace_back(i);
         }
@@ -262,124 +276,186 @@ namespace aire {
             return;
 
         for (const auto &i: indices) {
-            double d = colorData.weights[i];
-            d = (colorData.weights[i] = std::sqrt(d)) / d;
-            colorData.momentsRed[i] *= d;
-            colorData.momentsGreen[i] *= d;
-            colorData.momentsBlue[i] *= d;
-            colorData.momentsAlpha[i] *= d;
-            colorData.moments[i] *= d;
+            ColorMoment &cell = colorData.moments[i];
+            double d = cell.weight;
+            d = (cell.weight = std::trunc(std::sqrt(d))) / d;
+            cell.red = std::trunc(cell.red * d);
+            cell.green = std::trunc(cell.green * d);
+            cell.blue = std::trunc(cell.blue * d);
+            cell.alpha = std::trunc(cell.alpha * d);
+            cell.moment *= d;
         }
     }
 
     void WuQuantizer::BuildHistogram(ColorData &colorData, const uint32_t &nMaxColors, uint8_t alphaThreshold, uint8_t alphaFader) {
-        const uint32_t bitDepth = 8;
-        const uint32_t bitmapWidth = width;
-        const uint32_t bitmapHeight = height;
-
-        int pixelIndex = 0;
-
-        for (uint32_t y = 0; y < bitmapHeight; ++y) {
-            auto src = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
-            for (uint32_t x = 0; x < bitmapWidth; ++x, ++pixelIndex) {
-                Eigen::Vector4i color = packERGBA(src[x * 4], src[x * 4 + 1], src[x * 4 + 2], src[x * 4 + 3]);
-                if (color.w() < 0xE0) {
-                    if (color.w() == 0) {
-                        m_transparentPixelIndex = pixelIndex;
-//                        m_transparentColor = packRGBA(color);
-                    } else if (color.w() > alphaThreshold)
-                        hasSemiTransparency = true;
+        const uint32_t planeSize = SIDESIZE * SIDESIZE * SIDESIZE;
+        const int segments = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                 width * height / (256 * 256)), 1, 12);
+        const int segmentHeight = (height + segments - 1) / segments;
+
+        // Pixels are counted per blue plane of every row segment first, then bucketed so each plane is contiguous
+        // and planes are accumulated by workers owning disjoint ranges of cells
+        std::vector<uint32_t> counts(segments * SIDESIZE, 0);
+        std::vector<uint8_t> transparent(segments, 0);
+
+        concurrency::parallel_for(segments, segments, [&](int segment) {
+            const int rowEnd = std::min((segment + 1) * segmentHeight, height);
+            uint32_t *segmentCounts = counts.data() + segment * SIDESIZE;
+            bool hasTransparent = false;
+            HistogramEntry entry = {};
+            for (int y = segment * segmentHeight; y < rowEnd; ++y) {
+                const uint8_t *src = data + y * stride;
+                for (int x = 0; x < width; ++x, src += 4) {
+                    hasTransparent |= src[3] == 0;
+                    if (histogramCell(src, alphaThreshold, alphaFader, entry)) {
+                        segmentCounts[entry.index / planeSize]++;
+                    }
+                }
+            }
+            transparent[segment] = hasTransparent;
+        });
+
+        hasTransparentPixels = std::any_of(transparent.begin(), transparent.end(), [](uint8_t v) { return v != 0; });
+
+        std::vector<size_t> offsets(segments * SIDESIZE);
+        std::vector<size_t> planeStart(SIDESIZE + 1);
+        size_t total = 0;
+        for (int plane = 0; plane < SIDESIZE; ++plane) {
+            planeStart[plane] = total;
+            for (int segment = 0; segment < segments; ++segment) {
+                offsets[segment * SIDESIZE + plane] = total;
+                total += counts[segment * SIDESIZE + plane];
+            }
+        }
+        planeStart[SIDESIZE] = total;
+
+        ScratchLease entriesLease = acquireScratch(std::max(total, size_t(1)) * sizeof(HistogramEntry));
+        HistogramEntry *entries = entriesLease.data<HistogramEntry>();
+
+        concurrency::parallel_for(segments, segments, [&](int segment) {
+            const int rowEnd = std::min((segment + 1) * segmentHeight, height);
+            size_t *segmentOffsets = offsets.data() + segment * SIDESIZE;
+            HistogramEntry entry = {};
+            for (int y = segment * segmentHeight; y < rowEnd; ++y) {
+                const uint8_t *src = data + y * stride;
+                for (int x = 0; x < width; ++x, src += 4) {
+                    if (histogramCell(src, alphaThreshold, alphaFader, entry)) {
+                        entries[segmentOffsets[entry.index / planeSize]++] = entry;
+                    }
                 }
-                Histogram3d(colorData, color, alphaThreshold, alphaFader);
+            }
+        });
+
+        std::vector<int> groups = {0};
+        const size_t perGroup = (total + segments - 1) / segments;
+        for (int plane = 1; plane < SIDESIZE; ++plane) {
+            if (groups.size() < segments && planeStart[plane] >= perGroup * groups.size()) {
+                groups.push_back(plane);
             }
         }
+        groups.push_back(SIDESIZE);
+
+        ColorMoment *moments = colorData.moments;
+        concurrency::parallel_for(segments, static_cast<int>(groups.size()) - 1, [&](int group) {
+            for (size_t i = planeStart[groups[group]]; i < planeStart[groups[group + 1]]; ++i) {
+                const HistogramEntry &entry = entries[i];
+                const int red = static_cast<int>(entry.color & 0xFF);
+                const int green = static_cast<int>((entry.color >> 8) & 0xFF);
+                const int blue = static_cast<int>((entry.color >> 16) & 0xFF);
+                const int alpha = static_cast<int>(entry.color >> 24);
+                ColorMoment &cell = moments[entry.index];
+                cell.weight += 1;
+                cell.alpha += alpha;
+                cell.red += red;
+                cell.green += green;
+                cell.blue += blue;
+                cell.moment += sqr(alpha) + sqr(red) + sqr(green) + sqr(blue);
+            }
+        });
 
         AdjustMoments(colorData, nMaxColors);
     }
 
+    /**
+     * dst += src over rows of moments viewed as doubles
+     */
+    static void accumulateMoments(ColorMoment *dst, const ColorMoment *src, const size_t count) {
+        auto d = reinterpret_cast<double *>(dst);
+        auto s = reinterpret_cast<const double *>(src);
+        HWY_DYNAMIC_DISPATCH(addDoublesHWY)(d, s, count * (sizeof(ColorMoment) / sizeof(double)));
+    }
+
+    /**
+     * Turns the histogram into 4D cumulative sums, as separable prefix sums over alpha, red, green and blue axes
+     */
     void CalculateMoments(ColorData &data) {
+        const uint32_t SIDESIZE_2 = SIDESIZE * SIDESIZE;
         const uint32_t SIDESIZE_3 = SIDESIZE * SIDESIZE * SIDESIZE;
-        for (uint8_t alphaIndex = 1; alphaIndex <= MAXSIDEINDEX; ++alphaIndex) {
-            auto xarea = make_unique<uint32_t[]>(SIDESIZE_3);
-            auto xareaAlpha = make_unique<uint32_t[]>(SIDESIZE_3);
-            auto xareaRed = make_unique<uint32_t[]>(SIDESIZE_3);
-            auto xareaGreen = make_unique<uint32_t[]>(SIDESIZE_3);
-            auto xareaBlue = make_unique<uint32_t[]>(SIDESIZE_3);
-            auto xarea2 = make_unique<float[]>(SIDESIZE_3);
-
-            for (uint8_t redIndex = 1; redIndex <= MAXSIDEINDEX; ++redIndex) {
-                uint32_t area[SIDESIZE] = {0};
-                uint32_t areaAlpha[SIDESIZE] = {0};
-                uint32_t areaRed[SIDESIZE] = {0};
-                uint32_t areaGreen[SIDESIZE] = {0};
-                uint32_t areaBlue[SIDESIZE] = {0};
-                float area2[SIDESIZE] = {0};
-
-                for (uint8_t greenIndex = 1; greenIndex <= MAXSIDEINDEX; ++greenIndex) {
-                    uint32_t line = 0;
-                    uint32_t lineAlpha = 0;
-                    uint32_t lineRed = 0;
-                    uint32_t lineGreen = 0;
-                    uint32_t lineBlue = 0;
-                    float line2 = 0.0f;
-
-                    for (uint8_t blueIndex = 1; blueIndex <= MAXSIDEINDEX; ++blueIndex) {
-                        const uint32_t index = Index(alphaIndex, redIndex, greenIndex, blueIndex);
-                        line += data.weights[index];
-                        lineAlpha += data.momentsAlpha[index];
-                        lineRed += data.momentsRed[index];
-                        lineGreen += data.momentsGreen[index];
-                        lineBlue += data.momentsBlue[index];
-                        line2 += data.moments[index];
-
-                        area[blueIndex] += line;
-                        areaAlpha[blueIndex] += lineAlpha;
-                        areaRed[blueIndex] += lineRed;
-                        areaGreen[blueIndex] += lineGreen;
-                        areaBlue[blueIndex] += lineBlue;
-                        area2[blueIndex] += line2;
-
-                        const uint32_t rgbIndex = Index(redIndex, greenIndex, blueIndex);
-                        const uint32_t prevRgbIndex = Index(redIndex - 1, greenIndex, blueIndex);
-                        xarea[rgbIndex] = xarea[prevRgbIndex] + area[blueIndex];
-                        xareaAlpha[rgbIndex] = xareaAlpha[prevRgbIndex] + areaAlpha[blueIndex];
-                        xareaRed[rgbIndex] = xareaRed[prevRgbIndex] + areaRed[blueIndex];
-                        xareaGreen[rgbIndex] = xareaGreen[prevRgbIndex] + areaGreen[blueIndex];
-                        xareaBlue[rgbIndex] = xareaBlue[prevRgbIndex] + areaBlue[blueIndex];
-                        xarea2[rgbIndex] = xarea2[prevRgbIndex] + area2[blueIndex];
-
-                        const uint32_t prevIndex = Index(alphaIndex - 1, redIndex, greenIndex, blueIndex);
-                        data.weights[index] = data.weights[prevIndex] + xarea[rgbIndex];
-                        data.momentsAlpha[index] = data.momentsAlpha[prevIndex] + xareaAlpha[rgbIndex];
-                        data.momentsRed[index] = data.momentsRed[prevIndex] + xareaRed[rgbIndex];
-                        data.momentsGreen[index] = data.momentsGreen[prevIndex] + xareaGreen[rgbIndex];
-                        data.momentsBlue[index] = data.momentsBlue[prevIndex] + xareaBlue[rgbIndex];
-                        data.moments[index] = data.moments[prevIndex] + xarea2[rgbIndex];
+        ColorMoment *moments = data.moments;
+        const int threadCount = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 12);
+
+        concurrency::parallel_for(threadCount, MAXSIDEINDEX, [&](int plane) {
+            ColorMoment *blue = moments + (plane + 1) * SIDESIZE_3;
+            for (uint32_t green = 1; green <= MAXSIDEINDEX; ++green) {
+                for (uint32_t red = 1; red <= MAXSIDEINDEX; ++red) {
+                    ColorMoment *row = blue + green * SIDESIZE_2 + red * SIDESIZE;
+                    // Running sum along alpha is serial, single cell per dispatch would cost more than the add
+                    for (uint32_t alpha = 1; alpha <= MAXSIDEINDEX; ++alpha) {
+                        ColorMoment &cell = row[alpha];
+                        const ColorMoment &previous = row[alpha - 1];
+                        cell.weight += previous.weight;
+                        cell.alpha += previous.alpha;
+                        cell.red += previous.red;
+                        cell.green += previous.green;
+                        cell.blue += previous.blue;
+                        cell.moment += previous.moment;
                     }
                 }
+                for (uint32_t red = 1; red <= MAXSIDEINDEX; ++red) {
+                    ColorMoment *row = blue + green * SIDESIZE_2 + red * SIDESIZE;
+                    accumulateMoments(row, row - SIDESIZE, SIDESIZE);
+                }
             }
-        }
+            for (uint32_t green = 1; green <= MAXSIDEINDEX; ++green) {
+                ColorMoment *slice = blue + green * SIDESIZE_2;
+                accumulateMoments(slice, slice - SIDESIZE_2, SIDESIZE_2);
+            }
+        });
+
+        const int chunks = threadCount * 4;
+        const uint32_t chunkSize = (SIDESIZE_3 + chunks - 1) / chunks;
+        concurrency::parallel_for(threadCount, chunks, [&](int chunk) {
+            const uint32_t start = chunk * chunkSize;
+            const uint32_t end = std::min(start + chunkSize, SIDESIZE_3);
+            if (start >= end) {
+                return;
+            }
+            for (uint32_t plane = 1; plane <= MAXSIDEINDEX; ++plane) {
+                ColorMoment *volume = moments + plane * SIDESIZE_3;
+                accumulateMoments(volume + start, volume + start - SIDESIZE_3, end - start);
+            }
+        });
     }
 
     CubeCut
     Maximize(const ColorData &data, const Box &cube, Pixel direction, uint8_t first, uint8_t last, uint32_t wholeAlpha, uint32_t wholeRed, uint32_t wholeGreen,
              uint32_t wholeBlue, uint32_t wholeWeight) {
-        auto bottomAlpha = Bottom(cube, direction, data.momentsAlpha.get());
-        auto bottomRed = Bottom(cube, direction, data.momentsRed.get());
-        auto bottomGreen = Bottom(cube, direction, data.momentsGreen.get());
-        auto bottomBlue = Bottom(cube, direction, data.momentsBlue.get());
-        auto bottomWeight = Bottom(cube, direction, data.weights.get());
+        auto bottomAlpha = Bottom(cube, direction, data.moments, &ColorMoment::alpha);
+        auto bottomRed = Bottom(cube, direction, data.moments, &ColorMoment::red);
+        auto bottomGreen = Bottom(cube, direction, data.moments, &ColorMoment::green);
+        auto bottomBlue = Bottom(cube, direction, data.moments, &ColorMoment::blue);
+        auto bottomWeight = Bottom(cube, direction, data.moments, &ColorMoment::weight);
 
         bool valid = false;
         auto result = 0.0f;
         uint8_t cutPoint = 0;
 
         for (int position = first; position < last; ++position) {
-            auto halfAlpha = bottomAlpha + Top(cube, direction, position, data.momentsAlpha.get());
-            auto halfRed = bottomRed + Top(cube, direction, position, data.momentsRed.get());
-            auto halfGreen = bottomGreen + Top(cube, direction, position, data.momentsGreen.get());
-            auto halfBlue = bottomBlue + Top(cube, direction, position, data.momentsBlue.get());
-            auto halfWeight = bottomWeight + Top(cube, direction, position, data.weights.get());
+            auto halfAlpha = bottomAlpha + Top(cube, direction, position, data.moments, &ColorMoment::alpha);
+            auto halfRed = bottomRed + Top(cube, direction, position, data.moments, &ColorMoment::red);
+            auto halfGreen = bottomGreen + Top(cube, direction, position, data.moments, &ColorMoment::green);
+            auto halfBlue = bottomBlue + Top(cube, direction, position, data.moments, &ColorMoment::blue);
+            auto halfWeight = bottomWeight + Top(cube, direction, position, data.moments, &ColorMoment::weight);
 
             if (halfWeight == 0)
                 continue;
@@ -409,11 +485,11 @@ namespace aire {
     }
 
     bool Cut(const ColorData &data, Box &first, Box &second) {
-        auto wholeAlpha = Volume(first, data.momentsAlpha.get());
-        auto wholeRed = Volume(first, data.momentsRed.get());
-        auto wholeGreen = Volume(first, data.momentsGreen.get());
-        auto wholeBlue = Volume(first, data.momentsBlue.get());
-        auto wholeWeight = Volume(first, data.weights.get());
+        auto wholeAlpha = Volume(first, data.moments, &ColorMoment::alpha);
+        auto wholeRed = Volume(first, data.moments, &ColorMoment::red);
+        auto wholeGreen = Volume(first, data.moments, &ColorMoment::green);
+        auto wholeBlue = Volume(first, data.moments, &ColorMoment::blue);
+        auto wholeWeight = Volume(first, data.moments, &ColorMoment::weight);
 
         auto maxAlpha = Maximize(data, first, Alpha, static_cast<uint8_t>(first.AlphaMinimum + 1), first.AlphaMaximum, wholeAlpha, wholeRed, wholeGreen,
                                  wholeBlue, wholeWeight);
@@ -478,12 +554,12 @@ namespace aire {
     }
 
     float CalculateVariance(const ColorData &data, const Box &cube) {
-        auto volumeAlpha = Volume(cube, data.momentsAlpha.get());
-        auto volumeRed = Volume(cube, data.momentsRed.get());
-        auto volumeGreen = Volume(cube, data.momentsGreen.get());
-        auto volumeBlue = Volume(cube, data.momentsBlue.get());
-        auto volumeMoment = Volume(cube, data.moments.get());
-        auto volumeWeight = Volume(cube, data.weights.get());
+        auto volumeAlpha = Volume(cube, data.moments, &ColorMoment::alpha);
+        auto volumeRed = Volume(cube, data.moments, &ColorMoment::red);
+        auto volumeGreen = Volume(cube, data.moments, &ColorMoment::green);
+        auto volumeBlue = Volume(cube, data.moments, &ColorMoment::blue);
+        auto volumeMoment = Volume(cube, data.moments, &ColorMoment::moment);
+        auto volumeWeight = Volume(cube, data.moments, &ColorMoment::weight);
 
         float distance = sqr(volumeAlpha) + sqr(volumeRed) + sqr(volumeGreen) + sqr(volumeBlue);
 
@@ -500,6 +576,7 @@ namespace aire {
         boxList[0].BlueMaximum = MAXSIDEINDEX;
 
         for (int cubeIndex = 1; cubeIndex < colorCount; ++cubeIndex) {
+            cancellationPoint();
             if (Cut(data, boxList[next], boxList[cubeIndex])) {
                 volumeVariance[next] = boxList[next].Size > 1 ? CalculateVariance(data, boxList[next]) : 0.0f;
                 volumeVariance[cubeIndex] = boxList[cubeIndex].Size > 1 ? CalculateVariance(data, boxList[cubeIndex]) : 0.0f;
@@ -527,21 +604,21 @@ namespace aire {
         boxList.resize(colorCount);
     }
 
-    void BuildLookups(ColorPalette *pPalette, vector<Box> &cubes, const ColorData &data) {
+    void BuildLookups(ColorPalette *pPalette, vector<Box> &cubes, const ColorData &data, const bool hasTransparentPixels) {
         uint32_t lookupsCount = 0;
-        if (m_transparentPixelIndex >= 0)
+        if (hasTransparentPixels)
             pPalette->Entries[lookupsCount++] = 0;
 
         for (auto const &cube: cubes) {
-            auto weight = Volume(cube, data.weights.get());
+            auto weight = Volume(cube, data.moments, &ColorMoment::weight);
 
             if (weight <= 0)
                 continue;
 
-            uint8_t alpha = static_cast<uint8_t>(Volume(cube, data.momentsAlpha.get()) / weight);
-            uint8_t red = static_cast<uint8_t>(Volume(cube, data.momentsRed.get()) / weight);
-            uint8_t green = static_cast<uint8_t>(Volume(cube, data.momentsGreen.get()) / weight);
-            uint8_t blue = static_cast<uint8_t>(Volume(cube, data.momentsBlue.get()) / weight);
+            uint8_t alpha = static_cast<uint8_t>(Volume(cube, data.moments, &ColorMoment::alpha) / weight);
+            uint8_t red = static_cast<uint8_t>(Volume(cube, data.moments, &ColorMoment::red) / weight);
+            uint8_t green = static_cast<uint8_t>(Volume(cube, data.moments, &ColorMoment::green) / weight);
+            uint8_t blue = static_cast<uint8_t>(Volume(cube, data.moments, &ColorMoment::blue) / weight);
             pPalette->Entries[lookupsCount++] = packRGBA(red, green, blue, alpha);
         }
 
@@ -626,10 +703,14 @@ namespace aire {
 //        }
 //    }
 
+    size_t WuQuantizer::workingMemory(const int width, const int height) {
+        return static_cast<size_t>(TOTAL_SIDESIZE) * sizeof(ColorMoment)
+               + static_cast<size_t>(width) * height * sizeof(HistogramEntry);
+    }
+
     std::vector<Eigen::Vector4i> WuQuantizer::quantizeImage(uint32_t &nMaxColors, uint8_t alphaThreshold, uint8_t alphaFader) {
         const uint32_t bitmapWidth = width;
         const uint32_t bitmapHeight = height;
-        const auto area = (size_t) (bitmapWidth * bitmapHeight);
 
         ColorPalette palette = {};
         palette.Count = nMaxColors;
@@ -640,15 +721,13 @@ namespace aire {
         if (nMaxColors <= 32)
             PR = PG = PB = 1;
 
-        auto qPixels = make_unique<unsigned short[]>(area);
-
         ColorData colorData(SIDESIZE, bitmapWidth, bitmapHeight);
         BuildHistogram(colorData, nMaxColors, alphaThreshold, alphaFader);
         CalculateMoments(colorData);
         vector<Box> cubes;
         SplitData(cubes, nMaxColors, colorData);
 
-        BuildLookups(pPalette, cubes, colorData);
+        BuildLookups(pPalette, cubes, colorData, hasTransparentPixels);
         cubes.clear();
 
         nMaxColors = pPalette->Count;
@@ -678,3 +757,4 @@ namespace aire {
     }
 
 }
+#endif
@@ -38,6 +38,8 @@ using namespace std;
 
 #include "Eigen/Eigen"
 #include <unordered_map>
+#include <algorithm>
+#include "base/ScratchArena.h"
 
 namespace aire {
 /**
@@ -47,38 +49,29 @@ namespace aire {
         Blue, Green, Red, Alpha
     };
 
-    struct ColorData {
-        unique_ptr<long[]> weights;
-        unique_ptr<long[]> momentsAlpha;
-        unique_ptr<long[]> momentsRed;
-        unique_ptr<long[]> momentsGreen;
-        unique_ptr<long[]> momentsBlue;
-        unique_ptr<float[]> moments;
-
-//        unique_ptr<uint32_t[]> pixels;
+    struct ColorMoment {
+        double weight;
+        double alpha;
+        double red;
+        double green;
+        double blue;
+        double moment;
+    };
 
+    /**
+     * Cumulative moments of 4D color histogram, storage is leased from the scratch arena and reused between calls
+     */
+    struct ColorData {
+        ScratchLease storage;
+        ColorMoment *moments;
         uint32_t pixelsCount = 0;
-        uint32_t pixelFillingCounter = 0;
 
         ColorData(uint32_t sideSize, uint32_t bitmapWidth, uint32_t bitmapHeight) {
-            const int TOTAL_SIDESIZE = sideSize * sideSize * sideSize * sideSize;
-            weights = make_unique<long[]>(TOTAL_SIDESIZE);
-            momentsAlpha = make_unique<long[]>(TOTAL_SIDESIZE);
-            momentsRed = make_unique<long[]>(TOTAL_SIDESIZE);
-            momentsGreen = make_unique<long[]>(TOTAL_SIDESIZE);
-            momentsBlue = make_unique<long[]>(TOTAL_SIDESIZE);
-            moments = make_unique<float[]>(TOTAL_SIDESIZE);
+            const size_t totalSideSize = static_cast<size_t>(sideSize) * sideSize * sideSize * sideSize;
+            storage = acquireScratch(totalSideSize * sizeof(ColorMoment));
+            moments = storage.data<ColorMoment>();
+            std::fill(moments, moments + totalSideSize, ColorMoment{});
             pixelsCount = bitmapWidth * bitmapHeight;
-//            pixels = make_unique<uint32_t[]>(pixelsCount);
-        }
-
-//        inline uint32_t *GetPixels() {
-//            return pixels.get();
-//        }
-
-        inline void AddPixel(uint32_t pixel) {
-//            pixels[pixelFillingCounter] = pixel;
-            ++pixelFillingCounter;
         }
     };
 
@@ -95,17 +88,22 @@ namespace aire {
                                                                         width(width), height(height) {
         }
 
+        /**
+         * Upper bound of scratch quantizeImage leases for an image of the given size
+         */
+        static size_t workingMemory(int width, int height);
+
 
     private:
         void BuildHistogram(ColorData &colorData, const uint32_t &nMaxColors, uint8_t alphaThreshold, uint8_t alphaFader);
 
-        void Histogram3d(ColorData &colorData, const Eigen::Vector4i &color, const uint8_t alphaThreshold, const uint8_t alphaFader);
         unsigned short nearestColorIndex(const ColorPalette *pPalette, uint32_t value, const uint8_t alphaThreshold);
         void GetQuantizedPalette(const ColorData &data, ColorPalette *pPalette, const uint32_t colorCount, const uint8_t alphaThreshold);
         uint8_t *data;
         const int width;
         const int height;
         const int stride;
+        bool hasTransparentPixels = false;
 
         unordered_map<uint32_t, vector<unsigned short> > closestMap;
         unordered_map<uint32_t, unsigned short> nearestMap;
@@ -36,6 +36,10 @@
 #include <thread>
 #include <vector>
 #include <type_traits>
+#include <atomic>
+#include <algorithm>
+#include "base/Instrumentation.h"
+#include "base/Cancellation.h"
 
 namespace concurrency {
 
@@ -47,20 +51,137 @@ namespace concurrency {
         using result_type = R;
     };
 
+    /**
+     * Upper bound for workers of every parallel loop, 0 keeps the count requested by the caller
+     */
+    inline std::atomic<int> &threadsLimit() {
+        static std::atomic<int> limit{0};
+        return limit;
+    }
+
+    /**
+     * Limit for loops started from the current thread, takes precedence over threadsLimit when set
+     */
+    inline int &localThreadsLimit() {
+        thread_local int limit = 0;
+        return limit;
+    }
+
+    /**
+     * Overrides localThreadsLimit of the current thread for its lifetime
+     */
+    class ScopedThreadsLimit {
+    public:
+        explicit ScopedThreadsLimit(const int limit) : previous(localThreadsLimit()) {
+            localThreadsLimit() = limit;
+        }
+
+        ScopedThreadsLimit(const ScopedThreadsLimit &) = delete;
+
+        ScopedThreadsLimit &operator=(const ScopedThreadsLimit &) = delete;
+
+        ~ScopedThreadsLimit() {
+            localThreadsLimit() = previous;
+        }
+
+    private:
+        const int previous;
+    };
+
+    /**
+     * Threads divided evenly between workers active at the moment, the share is taken anew by every loop
+     * so workers that started early give threads back as soon as others join
+     */
+    class ThreadsShare {
+    public:
+        explicit ThreadsShare(const int threads) : threads(threads) {}
+
+        void enter() {
+            active.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void leave() {
+            active.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        int share() const {
+            return std::max(threads / std::max(active.load(std::memory_order_relaxed), 1), 1);
+        }
+
+    private:
+        const int threads;
+        std::atomic<int> active{0};
+    };
+
+    /**
+     * Share consulted by loops started from the current thread, used when localThreadsLimit is not set
+     */
+    inline ThreadsShare *&localThreadsShare() {
+        thread_local ThreadsShare *share = nullptr;
+        return share;
+    }
+
+    inline int limitThreads(const int requested) {
+        const int local = localThreadsLimit();
+        const ThreadsShare *share = localThreadsShare();
+        const int limit = local > 0 ? local
+                                    : share != nullptr ? share->share() : threadsLimit().load(std::memory_order_relaxed);
+        return limit > 0 ? std::max(std::min(requested, limit), 1) : requested;
+    }
+
+    /**
+     * Measures busy time of workers against wall time of a parallel loop, inert when instrumentation is disabled
+     */
+    class LoopProbe {
+    public:
+        explicit LoopProbe(const int workers) : workers(workers),
+                                                start(aire::Instrumentation::enabled() ? aire::Instrumentation::nowNanos() : 0) {
+        }
+
+        template<typename Worker>
+        void run(Worker &&worker) {
+            if (start == 0) {
+                worker();
+                return;
+            }
+            const uint64_t begin = aire::Instrumentation::nowNanos();
+            worker();
+            busy.fetch_add(aire::Instrumentation::nowNanos() - begin, std::memory_order_relaxed);
+        }
+
+        ~LoopProbe() {
+            if (start != 0) {
+                aire::Instrumentation::parallelLoop(workers, aire::Instrumentation::nowNanos() - start,
+                                                    busy.load(std::memory_order_relaxed));
+            }
+        }
+
+    private:
+        const int workers;
+        const uint64_t start;
+        std::atomic<uint64_t> busy{0};
+    };
+
     template<typename Function, typename... Args>
-    void parallel_for(const int numThreads, const int numIterations, Function &&func, Args &&... args) {
+    void parallel_for(const int requestedThreads, const int numIterations, Function &&func, Args &&... args) {
         static_assert(std::is_invocable_v<Function, int, Args...>, "func must take an int parameter for iteration id");
 
+        const int numThreads = limitThreads(requestedThreads);
         std::vector<std::thread> threads;
 
         int segmentHeight = numIterations / numThreads;
 
+        LoopProbe probe(numThreads);
+        aire::CancellablePass pass(numIterations);
+
         auto parallelWorker = [&](int start, int end) {
-            for (int y = start; y < end; ++y) {
-                {
-                    std::invoke(func, y, std::forward<Args>(args)...);
-                }
-            }
+            probe.run([&] {
+                pass.run([&] {
+                    for (int y = start; y < end && pass.proceed(); ++y) {
+                        std::invoke(func, y, std::forward<Args>(args)...);
+                    }
+                });
+            });
         };
 
         if (numThreads > 1) {
@@ -88,18 +209,30 @@ namespace concurrency {
                 thread.join();
             }
         }
+
+        pass.complete();
     }
 
     template<typename Function, typename... Args>
-    void parallel_for_segment(const int numThreads, const int numIterations, Function &&func, Args &&... args) {
+    void parallel_for_segment(const int requestedThreads, const int numIterations, Function &&func, Args &&... args) {
         static_assert(std::is_invocable_v<Function, int, int, Args...>, "func must take an int parameter for iteration id");
 
+        const int numThreads = limitThreads(requestedThreads);
         std::vector<std::thread> threads;
 
         int segmentHeight = numIterations / numThreads;
 
+        LoopProbe probe(numThreads);
+        aire::CancellablePass pass(numThreads);
+
         auto parallelWorker = [&](int start, int end) {
-            std::invoke(func, start, end, std::forward<Args>(args)...);
+            probe.run([&] {
+                pass.run([&] {
+                    if (pass.proceed()) {
+                        std::invoke(func, start, end, std::forward<Args>(args)...);
+                    }
+                });
+            });
         };
 
         if (numThreads > 1) {
@@ -127,22 +260,30 @@ namespace concurrency {
                 thread.join();
             }
         }
+
+        pass.complete();
     }
 
     template<typename Function, typename... Args>
-    void parallel_for_with_thread_id(const int numThreads, const int numIterations, Function &&func, Args &&... args) {
+    void parallel_for_with_thread_id(const int requestedThreads, const int numIterations, Function &&func, Args &&... args) {
         static_assert(std::is_invocable_v<Function, int, int, Args...>, "func must take an int parameter for threadId, and iteration Id");
 
+        const int numThreads = limitThreads(requestedThreads);
         std::vector<std::thread> threads;
 
         int segmentHeight = numIterations / numThreads;
 
+        LoopProbe probe(numThreads);
+        aire::CancellablePass pass(numIterations);
+
         auto parallel_worker = [&](int threadId, int start, int end) {
-            for (int y = start; y < end; ++y) {
-                {
-                    std::invoke(func, threadId, y, std::forward<Args>(args)...);
-                }
-            }
+            probe.run([&] {
+                pass.run([&] {
+                    for (int y = start; y < end && pass.proceed(); ++y) {
+                        std::invoke(func, threadId, y, std::forward<Args>(args)...);
+                    }
+                });
+            });
         };
 
         if (numThreads > 1) {
@@ -170,5 +311,7 @@ namespace concurrency {
                 thread.join();
             }
         }
+
+        pass.complete();
     }
 }
@@ -30,6 +30,7 @@
 
 #include "QuickSelect.h"
 #include <algorithm>
+#include <cstdint>
 
 template<class V>
 V QuickSelect(V arr[], int n) {
@@ -22,6 +22,11 @@
 
 #include "hwy/highway.h"
 
+// Only generic SLEEF paths are translated, AVX-512 intrinsic branches are kept for reference
+#ifndef AIRE_SLEEF_AVX512
+#define AIRE_SLEEF_AVX512 0
+#endif
+
 extern const float PayneHanekReductionTable_float[]; // Precomputed table of exponent values for Payne Hanek reduction
 
 HWY_BEFORE_NAMESPACE();
@@ -629,7 +634,7 @@ HWY_INLINE Vec3<D> PayneHanekReduction(const D df, Vec<D> a) {
   
   Vec2<D> x, y;
   Vec<RebindToSigned<D>> ex = ILogB2(df, a);
-#if HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3
+#if AIRE_SLEEF_AVX512
   ex = AndNot(ShiftRight<31>(ex), ex);
   ex = And(ex, Set(di, 127));
 #endif
@@ -762,7 +767,7 @@ HWY_INLINE Vec2<D> LogFastDF(const D df, Vec2<D> d) {
   Vec<D> t;
   Vec<RebindToSigned<D>> e;
 
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   e = ILogB(df, Mul(Get2<0>(d), Set(df, 1.0f/0.75f)));
 #else
   e = NearestInt(_mm512_getexp_ps(f.raw));
@@ -909,7 +914,7 @@ HWY_INLINE Vec<D> Log(const D df, Vec<D> d) {
   Vec2<D> x;
   Vec<D> t, m, x2;
 
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   Mask<D> o = Lt(d, Set(df, FloatMin));
   d = IfThenElse(RebindMask(df, o), Mul(d, Set(df, (float)(INT64_C(1) << 32) * (float)(INT64_C(1) << 32))), d);
   Vec<RebindToSigned<D>> e = ILogB2(df, Mul(d, Set(df, 1.0f/0.75f)));
@@ -935,7 +940,7 @@ HWY_INLINE Vec<D> Log(const D df, Vec<D> d) {
 
   Vec<D> r = Add(Get2<0>(s), Get2<1>(s));
 
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   r = IfThenElse(RebindMask(df, Eq(d, Inf(df))), Set(df, InfFloat), r);
   r = IfThenElse(RebindMask(df, Or(Lt(d, Set(df, 0)), IsNaN(d))), Set(df, NanFloat), r);
   r = IfThenElse(RebindMask(df, Eq(d, Set(df, 0))), Set(df, -InfFloat), r);
@@ -954,7 +959,7 @@ HWY_INLINE Vec<D> LogFast(const D df, Vec<D> d) {
   
   Vec<D> x, x2, t, m;
 
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   Mask<D> o = Lt(d, Set(df, FloatMin));
   d = IfThenElse(RebindMask(df, o), Mul(d, Set(df, (float)(INT64_C(1) << 32) * (float)(INT64_C(1) << 32))), d);
   Vec<RebindToSigned<D>> e = ILogB2(df, Mul(d, Set(df, 1.0f/0.75f)));
@@ -975,7 +980,7 @@ HWY_INLINE Vec<D> LogFast(const D df, Vec<D> d) {
   t = MulAdd(t, x2, Set(df, 0.666666686534881591796875f));
   t = MulAdd(t, x2, Set(df, 2.0f));
 
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   x = MulAdd(x, t, Mul(Set(df, 0.693147180559945286226764f), ConvertTo(df, e)));
   x = IfThenElse(RebindMask(df, Eq(d, Inf(df))), Set(df, InfFloat), x);
   x = IfThenElse(RebindMask(df, Or(Lt(d, Set(df, 0)), IsNaN(d))), Set(df, NanFloat), x);
@@ -1000,7 +1005,7 @@ HWY_INLINE Vec<D> Log1p(const D df, Vec<D> d) {
 
   Vec<D> dp1 = Add(d, Set(df, 1));
 
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   Mask<D> o = Lt(dp1, Set(df, FloatMin));
   dp1 = IfThenElse(RebindMask(df, o), Mul(dp1, Set(df, (float)(INT64_C(1) << 32) * (float)(INT64_C(1) << 32))), dp1);
   Vec<RebindToSigned<D>> e = ILogB2(df, Mul(dp1, Set(df, 1.0f/0.75f)));
@@ -1045,7 +1050,7 @@ HWY_INLINE Vec<D> Log2(const D df, Vec<D> d) {
   Vec2<D> x;
   Vec<D> t, m, x2;
 
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   Mask<D> o = Lt(d, Set(df, FloatMin));
   d = IfThenElse(RebindMask(df, o), Mul(d, Set(df, (float)(INT64_C(1) << 32) * (float)(INT64_C(1) << 32))), d);
   Vec<RebindToSigned<D>> e = ILogB2(df, Mul(d, Set(df, 1.0/0.75)));
@@ -1064,7 +1069,7 @@ HWY_INLINE Vec<D> Log2(const D df, Vec<D> d) {
   t = MulAdd(t, x2, Set(df, +0.5764790177e+0f));
   t = MulAdd(t, x2, Set(df, +0.9618012905120f));
   
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   Vec2<D> s = AddDF(df, ConvertTo(df, e),
 				MulDF(df, x, Create2(df, Set(df, 2.8853900432586669922), Set(df, 3.2734474483568488616e-08))));
 #else
@@ -1076,7 +1081,7 @@ HWY_INLINE Vec<D> Log2(const D df, Vec<D> d) {
 
   Vec<D> r = Add(Get2<0>(s), Get2<1>(s));
 
-#if !(HWY_ARCH_X86 && HWY_TARGET <= HWY_AVX3)
+#if !AIRE_SLEEF_AVX512
   r = IfThenElse(RebindMask(df, Eq(d, Inf(df))), Set(df, InfDouble), r);
   r = IfThenElse(RebindMask(df, Or(Lt(d, Set(df, 0)), IsNaN(d))), Set(df, NanDouble), r);
   r = IfThenElse(RebindMask(df, Eq(d, Set(df, 0))), Set(df, -InfDouble), r);
@@ -11,6 +11,7 @@
 
 #include <hwy/highway.h>
 
+HWY_BEFORE_NAMESPACE();
 namespace hwy::HWY_NAMESPACE {
 
     template<class D, HWY_IF_F32_D(D), HWY_IF_LANES_D(D, 8), class VF>
@@ -41,5 +42,6 @@ namespace hwy::HWY_NAMESPACE {
         v1 = ConvertTo(df, lowlow);
     }
 }
+HWY_AFTER_NAMESPACE();
 
 #endif
\ No newline at end of file
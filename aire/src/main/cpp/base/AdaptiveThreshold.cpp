@@ -0,0 +1,109 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "AdaptiveThreshold.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "SummedAreaTable.h"
+#include "AireError.h"
+#include "concurrency.hpp"
+
+namespace aire {
+
+    using namespace std;
+
+    // Dynamic range of standard deviation for 8 bit samples used by Sauvola
+    static constexpr float kSauvolaRange = 128.f;
+
+    void adaptiveThreshold(uint8_t *data, const int stride, const int width, const int height, const int radius,
+                           const float k, const AdaptiveThresholdMethod method) {
+        if (radius < 1) {
+            std::string err = "Adaptive threshold radius must be positive but received " + std::to_string(radius);
+            throw AireError(err);
+        }
+        if (method != ADAPTIVE_THRESHOLD_BRADLEY && method != ADAPTIVE_THRESHOLD_SAUVOLA) {
+            std::string err = "Unknown adaptive threshold method " + std::to_string(method);
+            throw AireError(err);
+        }
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+
+        std::vector<uint8_t> luma(width * height);
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const uint8_t *src = data + y * stride;
+            uint8_t *dst = luma.data() + y * width;
+            for (int x = 0; x < width; ++x) {
+                const uint8_t *px = src + x * 4;
+                dst[x] = static_cast<uint8_t>((px[0] * 77 + px[1] * 150 + px[2] * 29 + 128) >> 8);
+            }
+        });
+
+        // Bradley reads means from 32 bit table which is exact only for boxes up to 2^24 pixels
+        const int boxRadius = method == ADAPTIVE_THRESHOLD_BRADLEY ? min(radius, kSummedAreaMaxRadiusU8) : radius;
+
+        auto binarize = [&](auto &&isForeground) {
+            concurrency::parallel_for(threadCount, height, [&](int y) {
+                uint8_t *dst = data + y * stride;
+                const uint8_t *src = luma.data() + y * width;
+                const int y0 = max(y - boxRadius, 0);
+                const int y1 = min(y + boxRadius + 1, height);
+                for (int x = 0; x < width; ++x) {
+                    const int x0 = max(x - boxRadius, 0);
+                    const int x1 = min(x + boxRadius + 1, width);
+                    const uint8_t value = isForeground(src[x], x0, y0, x1, y1) ? 255 : 0;
+                    dst[x * 4] = value;
+                    dst[x * 4 + 1] = value;
+                    dst[x * 4 + 2] = value;
+                }
+            });
+        };
+
+        if (method == ADAPTIVE_THRESHOLD_BRADLEY) {
+            const SummedAreaTable<uint32_t> table = summedAreaTableU8(luma.data(), width, width, height, 1);
+            const float level = 1.f - k;
+            binarize([&](const uint8_t value, int x0, int y0, int x1, int y1) {
+                const auto area = static_cast<float>((x1 - x0) * (y1 - y0));
+                return static_cast<float>(value) * area > static_cast<float>(table.sum(x0, y0, x1, y1, 0)) * level;
+            });
+        } else {
+            const SummedAreaTable<uint64_t> table = squaredSummedAreaTableU8(luma.data(), width, width, height);
+            binarize([&](const uint8_t value, int x0, int y0, int x1, int y1) {
+                const double area = static_cast<double>((x1 - x0) * (y1 - y0));
+                const double mean = static_cast<double>(table.sum(x0, y0, x1, y1, 0)) / area;
+                const double variance = static_cast<double>(table.sum(x0, y0, x1, y1, 1)) / area - mean * mean;
+                const double deviation = std::sqrt(std::max(variance, 0.0));
+                return value > mean * (1.0 + k * (deviation / kSauvolaRange - 1.0));
+            });
+        }
+    }
+}
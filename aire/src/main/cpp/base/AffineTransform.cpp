@@ -29,55 +29,22 @@
  */
 
 #include "AffineTransform.h"
-#include "scale/sampler.h"
-#include <algorithm>
-#include "concurrency.hpp"
 
 namespace aire {
 
-    using namespace std;
+    Eigen::Matrix3f AffineTransform::planarTransform(const Eigen::Affine3f &transform) {
+        // Points are mapped as (x, y, 0), so only the planar part and translation take effect
+        Eigen::Matrix3f planar = Eigen::Matrix3f::Identity();
+        planar(0, 0) = transform(0, 0);
+        planar(0, 1) = transform(0, 1);
+        planar(0, 2) = transform(0, 3);
+        planar(1, 0) = transform(1, 0);
+        planar(1, 1) = transform(1, 1);
+        planar(1, 2) = transform(1, 3);
+        return planar;
+    }
 
     void AffineTransform::apply(uint8_t *destination, int dstStride, int newWidth, int newHeight) {
-        concurrency::parallel_for(4, newHeight, [&](int newY) {
-            auto dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(destination) + newY * dstStride);
-            for (int newX = 0; newX < newWidth; ++newX) {
-
-                int srcY = newY;
-                int srcX = newX;
-
-                Eigen::Vector3f point = {srcX, srcY, 0.f};
-                point = transform * point;
-
-                srcX = std::floor(point.x());
-                srcY = std::floor(point.y());
-
-                if (srcX < 0 || srcX >= width || srcY < 0 || srcY >= height) {
-                    continue;
-                }
-
-                int x2 = std::clamp(srcX + 1, 0, width - 1);
-                int y2 = std::clamp(srcY + 1, 0, height - 1);
-
-                float dx = (float) point.x() - static_cast<float>(srcX);
-                float dy = (float) point.y() - static_cast<float>(srcY);
-
-                auto src = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + srcY * stride);
-                auto src2 = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y2 * stride);
-
-                const int components = 4;
-                const int dstX = newX * components;
-
-                for (int c = 0; c < 4; ++c) {
-                    float c1 = static_cast<float>(src[srcX * components + c]);
-                    float c2 = static_cast<float>(src[x2 * components + c]);
-                    float c3 = static_cast<float>(src2[srcX * components + c]);
-                    float c4 = static_cast<float>(src2[x2 * components + c]);
-
-                    float result = blerp(c1, c2, c3, c4, dx, dy);
-                    float f = std::clamp(std::ceil(result), 0.0f, 255.f);
-                    dst[dstX + c] = static_cast<uint8_t>(f);
-                }
-            }
-        });
+        warp(data, stride, width, height, destination, dstStride, newWidth, newHeight, planarTransform(transform), sampler);
     }
-}
\ No newline at end of file
+}
@@ -31,6 +31,7 @@
 #pragma once
 
 #include "Eigen/Eigen"
+#include "Warp.h"
 
 namespace aire {
     class AffineTransform {
@@ -44,10 +45,20 @@ namespace aire {
             this->transform = mTransform;
         }
 
+        void setSampler(WarpSampler mSampler) {
+            this->sampler = mSampler;
+        }
+
         void apply(uint8_t* destination, int dstStride, int newWidth, int newHeight);
 
+        /**
+         * Destination to source 3x3 transform of the image plane
+         */
+        static Eigen::Matrix3f planarTransform(const Eigen::Affine3f &transform);
+
     private:
         Eigen::Affine3f transform = Eigen::Affine3f::Identity();
+        WarpSampler sampler = WARP_BILINEAR;
         uint8_t *data;
         const int stride;
         const int width;
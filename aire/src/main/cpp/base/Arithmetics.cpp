@@ -28,29 +28,35 @@
  *
  */
 
-#include "Arithmetics.h"
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Arithmetics.cpp"
+
+#include "hwy/foreach_target.h"
 #include "hwy/highway.h"
+
+#include "Arithmetics.h"
 #include "algo/support-inl.h"
 #include <iostream>
 #include <iomanip>
 #include <cstdint>
 #include <sstream>
 #include <omp.h>
-#include "jni/JNIUtils.h"
+#include "AireError.h"
 #include "concurrency.hpp"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace std;
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
 
-    void absDiff(uint8_t *destination, uint8_t *s1, uint8_t *s2, int width, int height) {
+    void absDiffHWY(uint8_t *destination, uint8_t *s1, uint8_t *s2, int width, int height) {
         const ScalableTag<uint8_t> du;
         using VU = Vec<decltype(du)>;
         const RebindToSigned<decltype(du)> di;
         using VI = Vec<decltype(du)>;
-        const int lanes = du.MaxLanes();
+        const int lanes = Lanes(du);
 
         concurrency::parallel_for(3, height, [&](int y) {
             auto ms = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(s1) + y * width);
@@ -77,13 +83,13 @@ namespace aire {
     }
 
     template<class V>
-    void pickMaxMin(V *source, int width, int height, V *min, V *max) {
+    void pickMaxMinHWY(V *source, int width, int height, V *min, V *max) {
         V mMin = 0;
         V mMax = 0;
 
         const ScalableTag<V> du;
         using VU = Vec<decltype(du)>;
-        const int lanes = du.MaxLanes();
+        const int lanes = Lanes(du);
 
         for (int y = 0; y < height; ++y) {
             auto src = reinterpret_cast<V *>(reinterpret_cast<V *>(source) + y * width);
@@ -114,7 +120,7 @@ namespace aire {
         *max = mMax;
     }
 
-    void fillSurface(uint8_t *destination, uint32_t value, int stride, int width, int height) {
+    void fillSurfaceHWY(uint8_t *destination, uint32_t value, int stride, int width, int height) {
         const FixedTag<uint32_t, 1> du32x1;
         const FixedTag<uint32_t, 4> du32x4;
 
@@ -137,7 +143,7 @@ namespace aire {
     }
 
     template<class V>
-    void normalize(V *source, int width, int height, V min, V max) {
+    void normalizeHWY(V *source, int width, int height, V min, V max) {
         V globalMax = 0;
         V globalMin = 0;
 
@@ -146,8 +152,8 @@ namespace aire {
         using VF = Vec<decltype(dfx4)>;
         using VU = Vec<decltype(du8)>;
 
-        pickMaxMin<V>(reinterpret_cast<V *>(source), width, height,
-                      reinterpret_cast<V *>(&globalMin), reinterpret_cast<V *>(&globalMax));
+        pickMaxMinHWY<V>(reinterpret_cast<V *>(source), width, height,
+                         reinterpret_cast<V *>(&globalMin), reinterpret_cast<V *>(&globalMax));
         const V oldMin = 0;
         const int lanes = 4;
         const auto vGlobalMin = Set(dfx4, globalMin);
@@ -176,13 +182,13 @@ namespace aire {
         });
     }
 
-    void diff(uint8_t *destination, uint8_t value, uint8_t *s1, int width, int height) {
+    void diffHWY(uint8_t *destination, uint8_t value, uint8_t *s1, int width, int height) {
 
         const ScalableTag<uint8_t> du16;
         using VU = Vec<decltype(du16)>;
 
         const auto leading = Set(du16, value);
-        const int lanes = du16.MaxLanes();
+        const int lanes = Lanes(du16);
 
         concurrency::parallel_for(2, height, [&](int y) {
             auto ms = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(s1) + y * width);
@@ -205,9 +211,51 @@ namespace aire {
         });
     }
 
+    void pickMaxMinU8HWY(uint8_t *source, int width, int height, uint8_t *min, uint8_t *max) {
+        pickMaxMinHWY(source, width, height, min, max);
+    }
+
+    void normalizeU8HWY(uint8_t *source, int width, int height, uint8_t min, uint8_t max) {
+        normalizeHWY(source, width, height, min, max);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(absDiffHWY);
+    HWY_EXPORT(pickMaxMinU8HWY);
+    HWY_EXPORT(fillSurfaceHWY);
+    HWY_EXPORT(normalizeU8HWY);
+    HWY_EXPORT(diffHWY);
+
+    void absDiff(uint8_t *destination, uint8_t *s1, uint8_t *s2, int width, int height) {
+        HWY_DYNAMIC_DISPATCH(absDiffHWY)(destination, s1, s2, width, height);
+    }
+
+    template<class V>
+    void pickMaxMin(V *source, int width, int height, V *min, V *max) {
+        HWY_DYNAMIC_DISPATCH(pickMaxMinU8HWY)(source, width, height, min, max);
+    }
+
+    void fillSurface(uint8_t *destination, uint32_t value, int stride, int width, int height) {
+        HWY_DYNAMIC_DISPATCH(fillSurfaceHWY)(destination, value, stride, width, height);
+    }
+
+    template<class V>
+    void normalize(V *source, int width, int height, V min, V max) {
+        HWY_DYNAMIC_DISPATCH(normalizeU8HWY)(source, width, height, min, max);
+    }
+
+    void diff(uint8_t *destination, uint8_t value, uint8_t *s1, int width, int height) {
+        HWY_DYNAMIC_DISPATCH(diffHWY)(destination, value, s1, width, height);
+    }
+
     template
     void pickMaxMin(uint8_t *source, int width, int height, uint8_t *min, uint8_t *max);
 
     template void normalize(uint8_t *source, int width, int height, uint8_t min, uint8_t max);
 
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,105 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "Cancellation.h"
+
+namespace aire {
+
+    struct CancellationContext {
+        CancellationToken *token = nullptr;
+        bool forwarded = false;
+    };
+
+    static CancellationContext &cancellationContext() {
+        thread_local CancellationContext context;
+        return context;
+    }
+
+    CancellationToken *CancellationToken::current() noexcept {
+        return cancellationContext().token;
+    }
+
+    void CancellationToken::beginPass(const int iterations) {
+        pass += 1;
+        reported = -1;
+        done.store(0, std::memory_order_relaxed);
+        total.store(iterations, std::memory_order_relaxed);
+        report(0);
+    }
+
+    void CancellationToken::report(const int finished) {
+        if (!listener) {
+            return;
+        }
+        const int iterations = total.load(std::memory_order_relaxed);
+        // Whole percents keep the listener off the hot path of short rows
+        const int percent = iterations > 0 ? static_cast<int>(static_cast<int64_t>(finished) * 100 / iterations) : 100;
+        if (percent == reported) {
+            return;
+        }
+        reported = percent;
+        listener(pass, static_cast<float>(percent) / 100.f);
+    }
+
+    CancellationScope::CancellationScope(CancellationToken *token, const bool forwarded) {
+        auto &context = cancellationContext();
+        previousToken = context.token;
+        previousForwarded = context.forwarded;
+        context.token = token;
+        context.forwarded = forwarded;
+    }
+
+    CancellationScope::~CancellationScope() {
+        auto &context = cancellationContext();
+        context.token = previousToken;
+        context.forwarded = previousForwarded;
+    }
+
+    CancellablePass::CancellablePass(const int iterations) : token(CancellationToken::current()),
+                                                             tracked(token != nullptr && !cancellationContext().forwarded),
+                                                             iterations(iterations),
+                                                             reporter(std::this_thread::get_id()) {
+        if (tracked) {
+            token->beginPass(iterations);
+        }
+    }
+
+    void CancellablePass::complete() {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        if (token != nullptr) {
+            token->throwIfCancelled();
+            if (tracked) {
+                token->report(iterations);
+            }
+        }
+    }
+}
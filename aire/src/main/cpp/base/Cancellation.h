@@ -0,0 +1,206 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "AireError.h"
+
+namespace aire {
+
+    class OperationCancelled : public AireError {
+    public:
+        OperationCancelled() : AireError("Operation was cancelled") {
+        }
+    };
+
+    /**
+     * Shared flag of a cancellable job and its progress.
+     * Filters see the token bound to their thread, parallel loops check it on every iteration and forward it
+     * to their workers. Progress is reported per pass - each top level loop of a job goes from 0 to 1,
+     * the listener is invoked only on the thread that bound the token
+     */
+    class CancellationToken {
+    public:
+        using ProgressListener = std::function<void(int pass, float fraction)>;
+
+        CancellationToken() = default;
+
+        explicit CancellationToken(ProgressListener listener) : listener(std::move(listener)) {
+        }
+
+        CancellationToken(const CancellationToken &) = delete;
+
+        CancellationToken &operator=(const CancellationToken &) = delete;
+
+        void cancel() noexcept {
+            flag.store(true, std::memory_order_release);
+        }
+
+        bool cancelled() const noexcept {
+            return flag.load(std::memory_order_relaxed);
+        }
+
+        void throwIfCancelled() const {
+            if (cancelled()) {
+                throw OperationCancelled();
+            }
+        }
+
+        /**
+         * Token bound to the calling thread, nullptr when the work is not cancellable
+         */
+        static CancellationToken *current() noexcept;
+
+    private:
+        friend class CancellablePass;
+
+        void beginPass(int iterations);
+
+        void report(int done);
+
+        std::atomic<bool> flag{false};
+        ProgressListener listener;
+        int pass = -1;
+        std::atomic<int> total{0};
+        std::atomic<int> done{0};
+        int reported = -1;
+    };
+
+    /**
+     * Binds a token to the current thread for the lifetime of the scope
+     */
+    class CancellationScope {
+    public:
+        /**
+         * @param forwarded - token is inherited by a worker thread, loops started there do not report progress
+         */
+        explicit CancellationScope(CancellationToken *token, bool forwarded = false);
+
+        CancellationScope(const CancellationScope &) = delete;
+
+        CancellationScope &operator=(const CancellationScope &) = delete;
+
+        ~CancellationScope();
+
+    private:
+        CancellationToken *previousToken;
+        bool previousForwarded;
+    };
+
+    /**
+     * One pass over rows or tiles.
+     * Counts finished iterations towards progress, stops workers once the token is cancelled or any of
+     * the workers has failed, and rethrows the failure on the thread that started the pass
+     */
+    class CancellablePass {
+    public:
+        explicit CancellablePass(int iterations);
+
+        CancellablePass(const CancellablePass &) = delete;
+
+        CancellablePass &operator=(const CancellablePass &) = delete;
+
+        /**
+         * Returns false when the remaining iterations must be skipped
+         */
+        bool proceed() noexcept {
+            if (failed.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            if (token == nullptr) {
+                return true;
+            }
+            if (token->cancelled()) {
+                return false;
+            }
+            if (tracked) {
+                const int finished = token->done.fetch_add(1, std::memory_order_relaxed);
+                if (std::this_thread::get_id() == reporter) {
+                    token->report(finished);
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Serial form of proceed, throws OperationCancelled
+         */
+        void checkpoint() {
+            if (!proceed() && token != nullptr) {
+                token->throwIfCancelled();
+            }
+        }
+
+        /**
+         * Runs a worker with the token forwarded to its thread, exceptions are kept until complete
+         */
+        template<typename Worker>
+        void run(Worker &&worker) noexcept {
+            try {
+                CancellationScope scope(token, true);
+                worker();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * Must be called after all workers have finished
+         */
+        void complete();
+
+    private:
+        CancellationToken *token;
+        bool tracked;
+        const int iterations;
+        std::thread::id reporter;
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::exception_ptr failure;
+    };
+
+    /**
+     * Throws OperationCancelled when the job running on this thread was cancelled
+     */
+    static inline void cancellationPoint() {
+        if (auto token = CancellationToken::current()) {
+            token->throwIfCancelled();
+        }
+    }
+}
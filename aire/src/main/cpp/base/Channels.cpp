@@ -59,7 +59,7 @@ namespace aire::HWY_NAMESPACE {
 
             int x = 0;
 
-            const int pixels = tag.MaxLanes();
+            const int pixels = Lanes(tag);
 
             for (; x + pixels < width; x += pixels) {
                 V r = LoadU(tag, rSrc);
@@ -102,19 +102,19 @@ namespace aire::HWY_NAMESPACE {
                 rDst = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(r) + y * width);
             }
             T *gDst = nullptr;
-            if (r != nullptr) {
+            if (g != nullptr) {
                 gDst = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(g) + y * width);
             }
             T *bDst = nullptr;
-            if (r != nullptr) {
+            if (b != nullptr) {
                 bDst = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(b) + y * width);
             }
             T *aDst = nullptr;
-            if (r != nullptr) {
+            if (a != nullptr) {
                 aDst = reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(a) + y * width);
             }
 
-            const int pixels = tag.MaxLanes();
+            const int pixels = Lanes(tag);
 
             int x = 0;
 
@@ -163,6 +163,15 @@ namespace aire::HWY_NAMESPACE {
         });
     }
 
+    void splitU8HWY(uint8_t *pixels, uint8_t *r, uint8_t *g, uint8_t *b, uint8_t *a,
+                    const int stride, const int width, const int height) {
+        splitHWY(pixels, r, g, b, a, stride, width, height);
+    }
+
+    void mergeU8HWY(uint8_t *destination, uint8_t *r, uint8_t *g, uint8_t *b, uint8_t *a,
+                    const int stride, const int width, const int height) {
+        mergeHWY(destination, r, g, b, a, stride, width, height);
+    }
 
 }
 HWY_AFTER_NAMESPACE();
@@ -170,14 +179,17 @@ HWY_AFTER_NAMESPACE();
 #if HWY_ONCE
 namespace aire {
 
+    HWY_EXPORT(splitU8HWY);
+    HWY_EXPORT(mergeU8HWY);
+
     template<class T>
     void split(T *pixels, T *r, T *g, T *b, T *a, int stride, int width, int height) {
-        aire::HWY_NAMESPACE::splitHWY(pixels, r, g, b, a, stride, width, height);
+        HWY_DYNAMIC_DISPATCH(splitU8HWY)(pixels, r, g, b, a, stride, width, height);
     }
 
     template<class T>
     void merge(T *destination, T *r, T *g, T *b, T *a, int stride, int width, int height) {
-        aire::HWY_NAMESPACE::mergeHWY(destination, r, g, b, a, stride, width, height);
+        HWY_DYNAMIC_DISPATCH(mergeU8HWY)(destination, r, g, b, a, stride, width, height);
     }
 
     template void
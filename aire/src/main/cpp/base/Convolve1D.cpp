@@ -36,10 +36,12 @@
 
 #include "Convolve1D.h"
 #include "hwy/highway.h"
-#include "jni/JNIUtils.h"
+#include "AireError.h"
 #include <thread>
 #include "algo/support-inl.h"
 #include "concurrency.hpp"
+#include "base/ScratchArena.h"
+#include "base/PaddedImage.h"
 #include "Eigen/Eigen"
 
 HWY_BEFORE_NAMESPACE();
@@ -50,14 +52,15 @@ using namespace std;
 using namespace hwy::HWY_NAMESPACE;
 
 void
-convolve1DHorizontalPass(std::vector<uint8_t> &transient,
+convolve1DHorizontalPass(uint8_t *transient,
                          uint8_t *data, int stride,
                          int y, int width,
                          int height,
+                         uint8_t *padded,
                          const Eigen::VectorXf &kernel) {
 
   auto src = reinterpret_cast<uint8_t *>(data + y * stride);
-  auto dst = reinterpret_cast<uint8_t *>(transient.data() + y * stride);
+  auto dst = reinterpret_cast<uint8_t *>(transient + y * stride);
 
   const FixedTag<uint8_t, 4> du8;
   const FixedTag<uint32_t, 4> du32x4;
@@ -76,172 +79,46 @@ convolve1DHorizontalPass(std::vector<uint8_t> &transient,
 
   const int kernelSize = kernel.size();
   const int halfOfKernel = kernelSize / 2;
-  const bool isEven = kernelSize % 2 == 0;
-  const int maxKernel = isEven ? halfOfKernel - 1 : halfOfKernel;
+
+  // Row with replicated edges, every tap of every pixel is an unconditional load
+  uint8_t *row = padded + halfOfKernel * 4;
+  std::copy(src, src + width * 4, row);
+  padRow(row, width, 4, halfOfKernel, EDGE_CLAMP);
+
+  const uint8_t *window = padded;
 
   for (int x = 0; x < width; ++x) {
     VF store = zeros;
 
-    int r = -halfOfKernel;
-
-    if (kernelSize == 3) {
-      int pos = clamp(x - 1, 0, width - 1) * 4;
-      VF dWeight = kernelCache[0];
-      VU pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x, 0, width - 1) * 4;
-      dWeight = kernelCache[1];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 1, 0, width - 1) * 4;
-      dWeight = kernelCache[2];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-    } else if (kernelSize == 5) {
-      int pos = clamp(x - 2, 0, width - 1) * 4;
-      VF dWeight = kernelCache[0];
-      VU pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x - 1, 0, width - 1) * 4;
-      dWeight = kernelCache[1];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x, 0, width - 1) * 4;
-      dWeight = kernelCache[2];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 1, 0, width - 1) * 4;
-      dWeight = kernelCache[3];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 2, 0, width - 1) * 4;
-      dWeight = kernelCache[4];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-    } else if (kernelSize == 7) {
-      int pos = clamp(x - 3, 0, width - 1) * 4;
-      VF dWeight = kernelCache[0];
-      VU pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x - 2, 0, width - 1) * 4;
-      dWeight = kernelCache[1];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x - 1, 0, width - 1) * 4;
-      dWeight = kernelCache[2];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x, 0, width - 1) * 4;
-      dWeight = kernelCache[3];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 1, 0, width - 1) * 4;
-      dWeight = kernelCache[4];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 2, 0, width - 1) * 4;
-      dWeight = kernelCache[5];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 3, 0, width - 1) * 4;
-      dWeight = kernelCache[6];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-    } else if (kernelSize == 9) {
-      int pos = clamp(x - 4, 0, width - 1) * 4;
-      VF dWeight = kernelCache[0];
-      VU pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x - 3, 0, width - 1) * 4;
-      dWeight = kernelCache[1];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x - 2, 0, width - 1) * 4;
-      dWeight = kernelCache[2];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x - 1, 0, width - 1) * 4;
-      dWeight = kernelCache[3];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x, 0, width - 1) * 4;
-      dWeight = kernelCache[4];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 1, 0, width - 1) * 4;
-      dWeight = kernelCache[5];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 2, 0, width - 1) * 4;
-      dWeight = kernelCache[6];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 3, 0, width - 1) * 4;
-      dWeight = kernelCache[7];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-
-      pos = clamp(x + 4, 0, width - 1) * 4;
-      dWeight = kernelCache[8];
-      pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-    } else {
-      for (; r + 4 <= maxKernel && x + r + 4 < width; r += 4) {
-        int pos = clamp((x + r), 0, width - 1) * 4;
-
-        VF v1, v2, v3, v4;
-        auto pu = LoadU(du8x16, &src[pos]);
-        ConvertToFloatVec16(du8x16, pu, v1, v2, v3, v4);
-
-        int pf = r + halfOfKernel;
-
-        VF dWeight = kernelCache[pf];
-        store = Add(store, Mul(v1, dWeight));
-        dWeight = kernelCache[pf + 1];
-        store = Add(store, Mul(v2, dWeight));
-        dWeight = kernelCache[pf + 2];
-        store = Add(store, Mul(v3, dWeight));
-        dWeight = kernelCache[pf + 3];
-        store = Add(store, Mul(v4, dWeight));
-      }
-
-      for (; r <= maxKernel; ++r) {
-        int pos = clamp((x + r), 0, width - 1) * 4;
-        VF dWeight = kernelCache[r + halfOfKernel];
-        VU pixels = LoadU(du8, &src[pos]);
-        store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
-      }
+    int r = 0;
+
+    for (; r + 4 <= kernelSize; r += 4) {
+      VF v1, v2, v3, v4;
+      auto pu = LoadU(du8x16, &window[r * 4]);
+      ConvertToFloatVec16(du8x16, pu, v1, v2, v3, v4);
+
+      store = Add(store, Mul(v1, kernelCache[r]));
+      store = Add(store, Mul(v2, kernelCache[r + 1]));
+      store = Add(store, Mul(v3, kernelCache[r + 2]));
+      store = Add(store, Mul(v4, kernelCache[r + 3]));
+    }
+
+    for (; r < kernelSize; ++r) {
+      VU pixels = LoadU(du8, &window[r * 4]);
+      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), kernelCache[r]));
     }
 
     store = Max(Min(Round(store), max255), zeros);
     VU pixelU = DemoteTo(du8, ConvertTo(du32x4, store));
     StoreU(pixelU, du8, dst);
 
+    window += 4;
     dst += 4;
   }
 }
 
 void
-convolve1DVerticalPass(std::vector<uint8_t> &transient, uint8_t *data, int stride,
+convolve1DVerticalPass(uint8_t *transient, uint8_t *data, int stride,
                        int y, int width, int height,
                        const Eigen::VectorXf &kernel) {
   const FixedTag<uint8_t, 4> du8;
@@ -251,6 +128,7 @@ convolve1DVerticalPass(std::vector<uint8_t> &transient, uint8_t *data, int strid
   using VU = Vec<decltype(du8)>;
   const auto max255 = Set(dfx4, 255.0f);
   const VF zeros = Zero(dfx4);
+  const FixedTag<uint8_t, 16> du8x16;
 
   // Preheat kernel memory to stack
   VF kernelCache[kernel.size()];
@@ -258,23 +136,46 @@ convolve1DVerticalPass(std::vector<uint8_t> &transient, uint8_t *data, int strid
     kernelCache[j] = Set(dfx4, kernel[j]);
   }
 
-  const int halfOfKernel = kernel.size() / 2;
-  const bool isEven = kernel.size() % 2 == 0;
-  const int maxKernel = isEven ? halfOfKernel - 1 : halfOfKernel;
+  const int kernelSize = kernel.size();
+  const int halfOfKernel = kernelSize / 2;
+
+  // Edge rows are resolved once per row instead of per tap of every pixel
+  const uint8_t *rows[kernelSize];
+  for (int r = 0; r < kernelSize; ++r) {
+    rows[r] = transient + clamp(y + r - halfOfKernel, 0, height - 1) * stride;
+  }
 
   auto dst = reinterpret_cast<uint8_t *>(data + y * stride);
-  for (int x = 0; x < width; ++x) {
-    VF store = zeros;
+  int x = 0;
+
+  for (; x + 4 <= width; x += 4) {
+    VF store1 = zeros, store2 = zeros, store3 = zeros, store4 = zeros;
+
+    for (int r = 0; r < kernelSize; ++r) {
+      VF v1, v2, v3, v4;
+      auto pu = LoadU(du8x16, &rows[r][x * 4]);
+      ConvertToFloatVec16(du8x16, pu, v1, v2, v3, v4);
+      const VF dWeight = kernelCache[r];
+      store1 = Add(store1, Mul(v1, dWeight));
+      store2 = Add(store2, Mul(v2, dWeight));
+      store3 = Add(store3, Mul(v3, dWeight));
+      store4 = Add(store4, Mul(v4, dWeight));
+    }
+
+    StoreU(DemoteTo(du8, ConvertTo(du32x4, Max(Min(Round(store1), max255), zeros))), du8, dst);
+    StoreU(DemoteTo(du8, ConvertTo(du32x4, Max(Min(Round(store2), max255), zeros))), du8, dst + 4);
+    StoreU(DemoteTo(du8, ConvertTo(du32x4, Max(Min(Round(store3), max255), zeros))), du8, dst + 8);
+    StoreU(DemoteTo(du8, ConvertTo(du32x4, Max(Min(Round(store4), max255), zeros))), du8, dst + 12);
 
-    int r = -halfOfKernel;
+    dst += 16;
+  }
+
+  for (; x < width; ++x) {
+    VF store = zeros;
 
-    for (; r <= maxKernel; ++r) {
-      auto src = reinterpret_cast<uint8_t *>(transient.data() +
-          clamp((r + y), 0, height - 1) * stride);
-      int pos = clamp(x, 0, width - 1) * 4;
-      VF dWeight = kernelCache[r + halfOfKernel];
-      VU pixels = LoadU(du8, &src[pos]);
-      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), dWeight));
+    for (int r = 0; r < kernelSize; ++r) {
+      VU pixels = LoadU(du8, &rows[r][x * 4]);
+      store = Add(store, Mul(ConvertTo(dfx4, PromoteTo(du32x4, pixels)), kernelCache[r]));
     }
 
     store = Max(Min(Round(store), max255), zeros);
@@ -294,8 +195,17 @@ namespace aire {
 HWY_EXPORT(convolve1DHorizontalPass);
 HWY_EXPORT(convolve1DVerticalPass);
 
+// Padded row per worker, 16 bytes of slack for the widest load
+static size_t convolve1DPaddedRow(const int width, const int horizontalSize) {
+  return static_cast<size_t>(width + horizontalSize) * 4 + 16;
+}
+
+size_t convolve1DWorkingMemory(int width, int height, int horizontalSize, int threads) {
+  return static_cast<size_t>(width) * 4 * height + convolve1DPaddedRow(width, horizontalSize) * threads;
+}
+
 void convolve1D(uint8_t *data, int stride, int width, int height, const std::vector<float> &horizontal, const std::vector<float> &vertical) {
-  std::vector<uint8_t> transient(stride * height);
+  ScratchLease transient = acquireScratch(stride * height);
 
   Eigen::VectorXf horizontalKernel(horizontal.size());
   for (int i = 0; i < horizontal.size(); ++i) {
@@ -309,12 +219,15 @@ void convolve1D(uint8_t *data, int stride, int width, int height, const std::vec
 
   const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
                                               height * width / (256 * 256)), 1, 12);
-  concurrency::parallel_for(threadCount, height, [&](int y) {
-    HWY_DYNAMIC_DISPATCH(convolve1DHorizontalPass)(transient, data, stride, y, width, height, horizontalKernel);
+  const size_t paddedRowSize = convolve1DPaddedRow(width, static_cast<int>(horizontalKernel.size()));
+  ScratchLease paddedRows = acquireScratch(paddedRowSize * threadCount);
+  concurrency::parallel_for_with_thread_id(threadCount, height, [&](int threadId, int y) {
+    HWY_DYNAMIC_DISPATCH(convolve1DHorizontalPass)(transient.data(), data, stride, y, width, height,
+                                                   paddedRows.data() + paddedRowSize * threadId, horizontalKernel);
   });
 
   concurrency::parallel_for(threadCount, height, [&](int y) {
-    HWY_DYNAMIC_DISPATCH(convolve1DVerticalPass)(transient, data, stride, y, width, height, verticalKernel);
+    HWY_DYNAMIC_DISPATCH(convolve1DVerticalPass)(transient.data(), data, stride, y, width, height, verticalKernel);
   });
 }
 }
@@ -31,8 +31,14 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <vector>
 
 namespace aire {
     void convolve1D(uint8_t *data, int stride, int width, int height, const std::vector<float>& horizontal, const std::vector<float> &vertical);
+
+    /**
+     * Upper bound of temporary memory convolve1D takes over RGBA8888 image with `threads` workers
+     */
+    size_t convolve1DWorkingMemory(int width, int height, int horizontalSize, int threads);
 }
\ No newline at end of file
@@ -35,25 +35,23 @@
 #include "hwy/highway.h"
 
 #include "Convolve1Db16.h"
-#include "hwy/highway.h"
-#include "jni/JNIUtils.h"
+#include "AireError.h"
 #include <thread>
 #include "algo/support-inl.h"
 #include "concurrency.hpp"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace hwy;
     using namespace std;
     using namespace hwy::HWY_NAMESPACE;
 
-    void Convolve1Db16::horizontalPass(std::vector<uint16_t> &transient,
-                                       uint16_t *data, int stride,
-                                       int y, int width,
-                                       int height) {
+    void convolve1Db16HorizontalPass(uint16_t *transient, uint16_t *data, int stride,
+                                     int y, int width, int height, const std::vector<float> &horizontal) {
 
         auto src = reinterpret_cast<hwy::float16_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
-        auto dst = reinterpret_cast<hwy::float16_t *>(reinterpret_cast<uint8_t *>(transient.data()) + y * stride);
+        auto dst = reinterpret_cast<hwy::float16_t *>(reinterpret_cast<uint8_t *>(transient) + y * stride);
 
         const FixedTag<float32_t, 4> dfx4;
         using VF = Vec<decltype(dfx4)>;
@@ -65,13 +63,13 @@ namespace aire {
         using VFb16x4 = Vec<decltype(df16x4)>;
 
         // Preheat kernel memory to stack
-        VF kernelCache[this->horizontal.size()];
-        for (int j = 0; j < this->horizontal.size(); ++j) {
-            kernelCache[j] = Set(dfx4, this->horizontal[j]);
+        VF kernelCache[horizontal.size()];
+        for (int j = 0; j < horizontal.size(); ++j) {
+            kernelCache[j] = Set(dfx4, horizontal[j]);
         }
 
-        const int halfOfKernel = this->horizontal.size() / 2;
-        const bool isEven = this->horizontal.size() % 2 == 0;
+        const int halfOfKernel = horizontal.size() / 2;
+        const bool isEven = horizontal.size() % 2 == 0;
         const int maxKernel = isEven ? halfOfKernel - 1 : halfOfKernel;
 
         for (int x = 0; x < width; ++x) {
@@ -113,11 +111,8 @@ namespace aire {
         }
     }
 
-    void
-    Convolve1Db16::verticalPass(std::vector<uint16_t> &transient,
-                                uint16_t *data, int stride,
-                                int y, int width,
-                                int height) {
+    void convolve1Db16VerticalPass(uint16_t *transient, uint16_t *data, int stride,
+                                   int y, int width, int height, const std::vector<float> &vertical) {
 
         const FixedTag<float32_t, 4> dfx4;
         using VF = Vec<decltype(dfx4)>;
@@ -131,8 +126,8 @@ namespace aire {
             kernelCache[j] = Set(dfx4, vertical[j]);
         }
 
-        const int halfOfKernel = this->vertical.size() / 2;
-        const bool isEven = this->vertical.size() % 2 == 0;
+        const int halfOfKernel = vertical.size() / 2;
+        const bool isEven = vertical.size() % 2 == 0;
         const int maxKernel = isEven ? halfOfKernel - 1 : halfOfKernel;
 
         auto dst = reinterpret_cast<hwy::float16_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
@@ -142,7 +137,7 @@ namespace aire {
             int r = -halfOfKernel;
 
             for (; r <= maxKernel; ++r) {
-                auto src = reinterpret_cast<hwy::float16_t * > (reinterpret_cast<uint8_t *>(transient.data()) +
+                auto src = reinterpret_cast<hwy::float16_t * > (reinterpret_cast<uint8_t *>(transient) +
                                                                 clamp((r + y), 0, height - 1) * stride);
                 int pos = clamp(x, 0, width - 1) * 4;
                 VF dWeight = kernelCache[r + halfOfKernel];
@@ -157,6 +152,31 @@ namespace aire {
         }
     }
 
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    using namespace std;
+
+    HWY_EXPORT(convolve1Db16HorizontalPass);
+    HWY_EXPORT(convolve1Db16VerticalPass);
+
+    void Convolve1Db16::horizontalPass(std::vector<uint16_t> &transient,
+                                       uint16_t *data, int stride,
+                                       int y, int width,
+                                       int height) {
+        HWY_DYNAMIC_DISPATCH(convolve1Db16HorizontalPass)(transient.data(), data, stride, y, width, height, horizontal);
+    }
+
+    void Convolve1Db16::verticalPass(std::vector<uint16_t> &transient,
+                                     uint16_t *data, int stride,
+                                     int y, int width,
+                                     int height) {
+        HWY_DYNAMIC_DISPATCH(convolve1Db16VerticalPass)(transient.data(), data, stride, y, width, height, vertical);
+    }
+
     void Convolve1Db16::convolve(uint16_t *data, const int stride, const int width, const int height) {
         std::vector<uint16_t> transient(stride * height);
 
@@ -172,4 +192,5 @@ namespace aire {
         });
     }
 
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,182 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Convolve2D.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "Convolve2D.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include "MathUtils.hpp"
+#include "concurrency.hpp"
+#include "Convolve1D.h"
+#include "FftConvolve.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace std;
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    void directConvolve2DHWY(uint8_t *data, const int stride, const int width, const int height,
+                             const Eigen::MatrixXf &kernel) {
+        const int kernelWidth = static_cast<int>(kernel.cols());
+        const int kernelHeight = static_cast<int>(kernel.rows());
+        const int anchorX = kernelWidth / 2;
+        const int anchorY = kernelHeight / 2;
+
+        const FixedTag<uint8_t, 4> du8;
+        const FixedTag<uint32_t, 4> du32x4;
+        const FixedTag<float32_t, 4> dfx4;
+        using VF = Vec<decltype(dfx4)>;
+
+        std::vector<VF> weights(kernelWidth * kernelHeight);
+        for (int j = 0; j < kernelHeight; ++j) {
+            for (int i = 0; i < kernelWidth; ++i) {
+                weights[j * kernelWidth + i] = Set(dfx4, kernel(j, i));
+            }
+        }
+
+        std::vector<uint8_t> output(stride * height);
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const VF max255 = Set(dfx4, 255.0f);
+            const VF zeros = Zero(dfx4);
+            uint8_t *dst = output.data() + y * stride;
+            for (int x = 0; x < width; ++x) {
+                VF store = zeros;
+                for (int j = 0; j < kernelHeight; ++j) {
+                    const uint8_t *src = data + clamp(y - anchorY + j, 0, height - 1) * stride;
+                    const VF *rowWeights = weights.data() + j * kernelWidth;
+                    for (int i = 0; i < kernelWidth; ++i) {
+                        const int pos = clamp(x - anchorX + i, 0, width - 1) * 4;
+                        const VF pixel = ConvertTo(dfx4, PromoteTo(du32x4, LoadU(du8, src + pos)));
+                        store = MulAdd(pixel, rowWeights[i], store);
+                    }
+                }
+                store = Max(Min(Round(store), max255), zeros);
+                StoreU(DemoteTo(du8, ConvertTo(du32x4, store)), du8, dst);
+                dst += 4;
+            }
+        });
+
+        for (int y = 0; y < height; ++y) {
+            std::copy(output.begin() + y * stride, output.begin() + y * stride + width * 4, data + y * stride);
+        }
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    using namespace std;
+
+    // Above this kernel area overlap-save FFT is cheaper than direct convolution
+    static constexpr int directConvolutionMaxArea = 17 * 17;
+    static constexpr float separableRankTolerance = 1e-5f;
+
+    HWY_EXPORT(directConvolve2DHWY);
+
+    Convolve2DPlan planConvolve2D(const Eigen::MatrixXf &kernel) {
+        Convolve2DPlan plan;
+        plan.kernel = kernel;
+        if (kernel.size() == 0) {
+            return plan;
+        }
+
+        Eigen::JacobiSVD<Eigen::MatrixXf> svd(kernel, Eigen::ComputeThinU | Eigen::ComputeThinV);
+        const auto &singular = svd.singularValues();
+        if (singular.size() == 1 || singular(1) <= singular(0) * separableRankTolerance) {
+            const float scale = std::sqrt(singular(0));
+            Eigen::VectorXf vertical = svd.matrixU().col(0) * scale;
+            Eigen::VectorXf horizontal = svd.matrixV().col(0) * scale;
+            if (horizontal.sum() < 0) {
+                vertical = -vertical;
+                horizontal = -horizontal;
+            }
+            // Separable passes store intermediate result in 8 bits, so negative lobes would be clipped
+            const float verticalFloor = -vertical.maxCoeff() * separableRankTolerance;
+            const float horizontalFloor = -horizontal.maxCoeff() * separableRankTolerance;
+            if (vertical.minCoeff() >= verticalFloor && horizontal.minCoeff() >= horizontalFloor) {
+                vertical = vertical.cwiseMax(0.f);
+                horizontal = horizontal.cwiseMax(0.f);
+                plan.horizontal.assign(horizontal.data(), horizontal.data() + horizontal.size());
+                plan.vertical.assign(vertical.data(), vertical.data() + vertical.size());
+                plan.separable = true;
+                return plan;
+            }
+        }
+
+        plan.fft = kernel.size() > directConvolutionMaxArea;
+        return plan;
+    }
+
+    void convolve2D(uint8_t *data, const int stride, const int width, const int height, const Convolve2DPlan &plan) {
+        if (plan.kernel.size() == 0) {
+            return;
+        }
+        if (plan.separable) {
+            convolve1D(data, stride, width, height, plan.horizontal, plan.vertical);
+        } else if (plan.fft) {
+            fftConvolve2D(data, stride, width, height, plan.kernel);
+        } else {
+            HWY_DYNAMIC_DISPATCH(directConvolve2DHWY)(data, stride, width, height, plan.kernel);
+        }
+    }
+
+    void convolve2D(uint8_t *data, const int stride, const int width, const int height, const Eigen::MatrixXf &kernel) {
+        convolve2D(data, stride, width, height, planConvolve2D(kernel));
+    }
+
+    size_t convolve2DWorkingMemory(const Convolve2DPlan &plan, const int width, const int height, const int threads) {
+        if (plan.kernel.size() == 0) {
+            return 0;
+        }
+        const size_t image = static_cast<size_t>(width) * 4 * height;
+        if (plan.separable) {
+            return convolve1DWorkingMemory(width, height, static_cast<int>(plan.horizontal.size()), threads);
+        }
+        if (plan.fft) {
+            return fftConvolve2DWorkingMemory(static_cast<int>(plan.kernel.cols()), static_cast<int>(plan.kernel.rows()),
+                                              width, height, threads);
+        }
+        return image + plan.kernel.size() * 4 * sizeof(float);
+    }
+
+}
+#endif
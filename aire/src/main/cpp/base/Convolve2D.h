@@ -0,0 +1,68 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Eigen/Eigen"
+
+namespace aire {
+
+    /**
+     * Outcome of kernel analysis, reusable for any number of images
+     */
+    struct Convolve2DPlan {
+        Eigen::MatrixXf kernel;
+        // Rank one factors, set only when the kernel is applied separably
+        std::vector<float> horizontal;
+        std::vector<float> vertical;
+        bool separable = false;
+        bool fft = false;
+    };
+
+    /**
+     * Rank one kernels are applied separably, small kernels directly and large ones through FFT
+     */
+    Convolve2DPlan planConvolve2D(const Eigen::MatrixXf &kernel);
+
+    /**
+     * 2D correlation of RGBA8888 image with arbitrary kernel, edges are clamped
+     */
+    void convolve2D(uint8_t *data, int stride, int width, int height, const Eigen::MatrixXf &kernel);
+
+    void convolve2D(uint8_t *data, int stride, int width, int height, const Convolve2DPlan &plan);
+
+    /**
+     * Upper bound of temporary memory convolve2D takes over RGBA8888 image of the given size with `threads` workers
+     */
+    size_t convolve2DWorkingMemory(const Convolve2DPlan &plan, int width, int height, int threads);
+}
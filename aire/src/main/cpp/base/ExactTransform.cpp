@@ -0,0 +1,260 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/ExactTransform.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "ExactTransform.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include "MathUtils.hpp"
+#include "concurrency.hpp"
+#include "AireError.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace std;
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    static constexpr int exactTileSize = 64;
+
+    /**
+     * Destination range [start, end) for which `direction * t + offset` stays inside [0, size)
+     */
+    static void exactRange(const int direction, const int offset, const int size, const int dstSize,
+                           int &start, int &end) {
+        if (direction > 0) {
+            start = -offset;
+            end = size - offset;
+        } else {
+            start = offset - size + 1;
+            end = offset + 1;
+        }
+        start = std::max(start, 0);
+        end = std::min(end, dstSize);
+    }
+
+    template<typename T>
+    static void exactReverseCopy(const T *src, T *dst, const int count) {
+        // dst[i] = src[-i]
+        const ScalableTag<T> d;
+        const int lanes = static_cast<int>(Lanes(d));
+        int i = 0;
+        for (; i + lanes <= count; i += lanes) {
+            StoreU(Reverse(d, LoadU(d, src - i - lanes + 1)), d, dst + i);
+        }
+        for (; i < count; ++i) {
+            dst[i] = src[-i];
+        }
+    }
+
+    template<typename T>
+    static void exactCopyRows(const uint8_t *source, const int srcStride, uint8_t *destination, const int dstStride,
+                              const ExactTransform &m, const int x0, const int x1, const int y0, const int y1) {
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          (y1 - y0) * (x1 - x0) / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, y1 - y0, [&](int iteration) {
+            const int y = y0 + iteration;
+            const T *src = reinterpret_cast<const T *>(source + (m.yy * y + m.ty) * srcStride);
+            T *dst = reinterpret_cast<T *>(destination + y * dstStride) + x0;
+            if (m.xx > 0) {
+                std::memcpy(dst, src + x0 + m.tx, (x1 - x0) * sizeof(T));
+            } else {
+                exactReverseCopy(src + m.tx - x0, dst, x1 - x0);
+            }
+        });
+    }
+
+    static inline void exactTransposeBlock(const uint8_t *source, const int srcStride, uint8_t *destination, const int dstStride,
+                                           const ExactTransform &m, const int x0, const int y0) {
+        // Destination row y takes source column xy * y + tx, destination column x takes source row yx * x + ty
+        const FixedTag<uint32_t, 4> d;
+        const Repartition<uint64_t, decltype(d)> d64;
+        Vec<decltype(d)> rows[4];
+        for (int i = 0; i < 4; ++i) {
+            const auto src = reinterpret_cast<const uint32_t *>(source + (m.yx * (x0 + i) + m.ty) * srcStride);
+            if (m.xy > 0) {
+                rows[i] = LoadU(d, src + m.tx + y0);
+            } else {
+                rows[i] = Reverse(d, LoadU(d, src + m.tx - y0 - 3));
+            }
+        }
+        const auto t0 = BitCast(d64, InterleaveLower(d, rows[0], rows[1]));
+        const auto t1 = BitCast(d64, InterleaveUpper(d, rows[0], rows[1]));
+        const auto t2 = BitCast(d64, InterleaveLower(d, rows[2], rows[3]));
+        const auto t3 = BitCast(d64, InterleaveUpper(d, rows[2], rows[3]));
+        auto dst = reinterpret_cast<uint32_t *>(destination + y0 * dstStride) + x0;
+        StoreU(BitCast(d, InterleaveLower(d64, t0, t2)), d, dst);
+        dst = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(dst) + dstStride);
+        StoreU(BitCast(d, InterleaveUpper(d64, t0, t2)), d, dst);
+        dst = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(dst) + dstStride);
+        StoreU(BitCast(d, InterleaveLower(d64, t1, t3)), d, dst);
+        dst = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(dst) + dstStride);
+        StoreU(BitCast(d, InterleaveUpper(d64, t1, t3)), d, dst);
+    }
+
+    template<typename T>
+    static void exactTranspose(const uint8_t *source, const int srcStride, uint8_t *destination, const int dstStride,
+                               const ExactTransform &m, const int x0, const int x1, const int y0, const int y1) {
+        const int bandsCount = (y1 - y0 + exactTileSize - 1) / exactTileSize;
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          (y1 - y0) * (x1 - x0) / (256 * 256)), 1, std::min(12, bandsCount));
+        concurrency::parallel_for(threadCount, bandsCount, [&](int band) {
+            const int bandStart = y0 + band * exactTileSize;
+            const int bandEnd = std::min(bandStart + exactTileSize, y1);
+            for (int tileX = x0; tileX < x1; tileX += exactTileSize) {
+                const int tileEnd = std::min(tileX + exactTileSize, x1);
+                int y = bandStart;
+                if constexpr (std::is_same<T, uint32_t>::value) {
+                    for (; y + 4 <= bandEnd; y += 4) {
+                        int x = tileX;
+                        for (; x + 4 <= tileEnd; x += 4) {
+                            exactTransposeBlock(source, srcStride, destination, dstStride, m, x, y);
+                        }
+                        for (int row = y; row < y + 4; ++row) {
+                            T *dst = reinterpret_cast<T *>(destination + row * dstStride);
+                            const int sx = m.xy * row + m.tx;
+                            for (int column = x; column < tileEnd; ++column) {
+                                dst[column] = reinterpret_cast<const T *>(source + (m.yx * column + m.ty) * srcStride)[sx];
+                            }
+                        }
+                    }
+                }
+                for (; y < bandEnd; ++y) {
+                    T *dst = reinterpret_cast<T *>(destination + y * dstStride);
+                    const int sx = m.xy * y + m.tx;
+                    for (int x = tileX; x < tileEnd; ++x) {
+                        dst[x] = reinterpret_cast<const T *>(source + (m.yx * x + m.ty) * srcStride)[sx];
+                    }
+                }
+            }
+        });
+    }
+
+    template<typename T>
+    static void exactTransformImpl(const uint8_t *source, const int srcStride, const int width, const int height,
+                                   uint8_t *destination, const int dstStride, const int newWidth, const int newHeight,
+                                   const ExactTransform &m) {
+        int x0, x1, y0, y1;
+        if (m.xy == 0) {
+            exactRange(m.xx, m.tx, width, newWidth, x0, x1);
+            exactRange(m.yy, m.ty, height, newHeight, y0, y1);
+            if (x0 < x1 && y0 < y1) {
+                exactCopyRows<T>(source, srcStride, destination, dstStride, m, x0, x1, y0, y1);
+            }
+        } else {
+            exactRange(m.yx, m.ty, height, newWidth, x0, x1);
+            exactRange(m.xy, m.tx, width, newHeight, y0, y1);
+            if (x0 < x1 && y0 < y1) {
+                exactTranspose<T>(source, srcStride, destination, dstStride, m, x0, x1, y0, y1);
+            }
+        }
+    }
+
+    void exactTransformHWY(const uint8_t *source, const int srcStride, const int width, const int height,
+                           uint8_t *destination, const int dstStride, const int newWidth, const int newHeight,
+                           const int pixelSize, const ExactTransform &transform) {
+        switch (pixelSize) {
+            case 2:
+                exactTransformImpl<uint16_t>(source, srcStride, width, height, destination, dstStride,
+                                             newWidth, newHeight, transform);
+                break;
+            case 4:
+                exactTransformImpl<uint32_t>(source, srcStride, width, height, destination, dstStride,
+                                             newWidth, newHeight, transform);
+                break;
+            case 8:
+                exactTransformImpl<uint64_t>(source, srcStride, width, height, destination, dstStride,
+                                             newWidth, newHeight, transform);
+                break;
+            default: {
+                std::string msg("Exact transform supports only 2, 4 or 8 bytes pixels but received " + std::to_string(pixelSize));
+                throw AireError(msg);
+            }
+        }
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    using namespace std;
+
+    static constexpr float exactLinearTolerance = 1e-4f;
+    static constexpr float exactTranslationTolerance = 1e-3f;
+
+    static bool exactCoefficient(const float value, const float tolerance, int &rounded) {
+        const float nearest = std::round(value);
+        if (std::abs(value - nearest) > tolerance) {
+            return false;
+        }
+        rounded = static_cast<int>(nearest);
+        return true;
+    }
+
+    bool isExactTransform(const Eigen::Matrix3f &transform, ExactTransform &exact) {
+        if (std::abs(transform(2, 0)) > exactLinearTolerance || std::abs(transform(2, 1)) > exactLinearTolerance
+            || std::abs(transform(2, 2)) <= exactLinearTolerance) {
+            return false;
+        }
+        const Eigen::Matrix3f m = transform / transform(2, 2);
+        if (!exactCoefficient(m(0, 0), exactLinearTolerance, exact.xx)
+            || !exactCoefficient(m(0, 1), exactLinearTolerance, exact.xy)
+            || !exactCoefficient(m(1, 0), exactLinearTolerance, exact.yx)
+            || !exactCoefficient(m(1, 1), exactLinearTolerance, exact.yy)
+            || !exactCoefficient(m(0, 2), exactTranslationTolerance, exact.tx)
+            || !exactCoefficient(m(1, 2), exactTranslationTolerance, exact.ty)) {
+            return false;
+        }
+        // Signed permutation: either axis aligned or swapped, each with unit scale
+        const bool aligned = exact.xy == 0 && exact.yx == 0 && std::abs(exact.xx) == 1 && std::abs(exact.yy) == 1;
+        const bool swapped = exact.xx == 0 && exact.yy == 0 && std::abs(exact.xy) == 1 && std::abs(exact.yx) == 1;
+        return aligned || swapped;
+    }
+
+    HWY_EXPORT(exactTransformHWY);
+
+    void exactTransform(const uint8_t *source, const int srcStride, const int width, const int height,
+                        uint8_t *destination, const int dstStride, const int newWidth, const int newHeight,
+                        const int pixelSize, const ExactTransform &transform) {
+        HWY_DYNAMIC_DISPATCH(exactTransformHWY)(source, srcStride, width, height, destination, dstStride,
+                                                newWidth, newHeight, pixelSize, transform);
+    }
+
+}
+#endif
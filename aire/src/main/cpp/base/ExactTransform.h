@@ -0,0 +1,59 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "Eigen/Eigen"
+
+namespace aire {
+
+    /**
+     * Transform which maps destination pixels exactly onto source pixels:
+     * `sx = xx * x + xy * y + tx`, `sy = yx * x + yy * y + ty` with coefficients in {-1, 0, 1}
+     */
+    struct ExactTransform {
+        int xx, xy, tx;
+        int yx, yy, ty;
+    };
+
+    /**
+     * Detects integer translations, right angle rotations and flips in destination to source `transform`
+     */
+    bool isExactTransform(const Eigen::Matrix3f &transform, ExactTransform &exact);
+
+    /**
+     * Moves pixels of `pixelSize` bytes (2, 4 or 8) with row copies or blocked transposes,
+     * destination pixels mapped outside of the source are left untouched
+     */
+    void exactTransform(const uint8_t *source, int srcStride, int width, int height,
+                        uint8_t *destination, int dstStride, int newWidth, int newHeight,
+                        int pixelSize, const ExactTransform &transform);
+}
@@ -0,0 +1,524 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/FftConvolve.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "FftConvolve.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <cmath>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include "FftUtils.h"
+#include "MathUtils.hpp"
+#include "concurrency.hpp"
+#include "AireError.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace std;
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    struct FftRadix2 {
+        static constexpr int radix = 2;
+
+        template<class D, class V = Vec<D>>
+        static HWY_INLINE void butterfly(D d, V *re, V *im) {
+            const V r0 = Add(re[0], re[1]);
+            const V i0 = Add(im[0], im[1]);
+            re[1] = Sub(re[0], re[1]);
+            im[1] = Sub(im[0], im[1]);
+            re[0] = r0;
+            im[0] = i0;
+        }
+    };
+
+    struct FftRadix3 {
+        static constexpr int radix = 3;
+
+        template<class D, class V = Vec<D>>
+        static HWY_INLINE void butterfly(D d, V *re, V *im) {
+            const V sin60 = Set(d, 0.86602540378443864676f);
+            const V half = Set(d, 0.5f);
+            const V tr = Add(re[1], re[2]);
+            const V ti = Add(im[1], im[2]);
+            const V cr = NegMulAdd(half, tr, re[0]);
+            const V ci = NegMulAdd(half, ti, im[0]);
+            const V sr = Mul(sin60, Sub(im[1], im[2]));
+            const V si = Mul(sin60, Sub(re[1], re[2]));
+            re[0] = Add(re[0], tr);
+            im[0] = Add(im[0], ti);
+            re[1] = Add(cr, sr);
+            im[1] = Sub(ci, si);
+            re[2] = Sub(cr, sr);
+            im[2] = Add(ci, si);
+        }
+    };
+
+    struct FftRadix4 {
+        static constexpr int radix = 4;
+
+        template<class D, class V = Vec<D>>
+        static HWY_INLINE void butterfly(D d, V *re, V *im) {
+            const V t0r = Add(re[0], re[2]);
+            const V t0i = Add(im[0], im[2]);
+            const V t1r = Sub(re[0], re[2]);
+            const V t1i = Sub(im[0], im[2]);
+            const V t2r = Add(re[1], re[3]);
+            const V t2i = Add(im[1], im[3]);
+            // -i * (a1 - a3)
+            const V t3r = Sub(im[1], im[3]);
+            const V t3i = Sub(re[3], re[1]);
+            re[0] = Add(t0r, t2r);
+            im[0] = Add(t0i, t2i);
+            re[1] = Add(t1r, t3r);
+            im[1] = Add(t1i, t3i);
+            re[2] = Sub(t0r, t2r);
+            im[2] = Sub(t0i, t2i);
+            re[3] = Sub(t1r, t3r);
+            im[3] = Sub(t1i, t3i);
+        }
+    };
+
+    struct FftRadix5 {
+        static constexpr int radix = 5;
+
+        template<class D, class V = Vec<D>>
+        static HWY_INLINE void butterfly(D d, V *re, V *im) {
+            const V c1 = Set(d, 0.30901699437494742410f);
+            const V c2 = Set(d, -0.80901699437494742410f);
+            const V s1 = Set(d, 0.95105651629515357212f);
+            const V s2 = Set(d, 0.58778525229247312917f);
+            const V b1r = Add(re[1], re[4]);
+            const V b1i = Add(im[1], im[4]);
+            const V b2r = Add(re[2], re[3]);
+            const V b2i = Add(im[2], im[3]);
+            const V d1r = Sub(re[1], re[4]);
+            const V d1i = Sub(im[1], im[4]);
+            const V d2r = Sub(re[2], re[3]);
+            const V d2i = Sub(im[2], im[3]);
+            const V a1r = MulAdd(c2, b2r, MulAdd(c1, b1r, re[0]));
+            const V a1i = MulAdd(c2, b2i, MulAdd(c1, b1i, im[0]));
+            const V a2r = MulAdd(c1, b2r, MulAdd(c2, b1r, re[0]));
+            const V a2i = MulAdd(c1, b2i, MulAdd(c2, b1i, im[0]));
+            const V t1r = MulAdd(s2, d2r, Mul(s1, d1r));
+            const V t1i = MulAdd(s2, d2i, Mul(s1, d1i));
+            const V t2r = NegMulAdd(s1, d2r, Mul(s2, d1r));
+            const V t2i = NegMulAdd(s1, d2i, Mul(s2, d1i));
+            re[0] = Add(re[0], Add(b1r, b2r));
+            im[0] = Add(im[0], Add(b1i, b2i));
+            re[1] = Add(a1r, t1i);
+            im[1] = Sub(a1i, t1r);
+            re[4] = Sub(a1r, t1i);
+            im[4] = Add(a1i, t1r);
+            re[2] = Add(a2r, t2i);
+            im[2] = Sub(a2i, t2r);
+            re[3] = Sub(a2r, t2i);
+            im[3] = Add(a2i, t2r);
+        }
+    };
+
+    template<class Radix, class D>
+    static HWY_INLINE void fftButterflyStep(D d, const float *xr, const float *xi, float *yr, float *yi,
+                                            const size_t i, const size_t inStep, const size_t outStep,
+                                            const float *twiddleRe, const float *twiddleIm) {
+        using V = Vec<D>;
+        V re[Radix::radix], im[Radix::radix];
+        for (int j = 0; j < Radix::radix; ++j) {
+            re[j] = LoadU(d, xr + i + j * inStep);
+            im[j] = LoadU(d, xi + i + j * inStep);
+        }
+        Radix::butterfly(d, re, im);
+        StoreU(re[0], d, yr + i);
+        StoreU(im[0], d, yi + i);
+        for (int k = 1; k < Radix::radix; ++k) {
+            const V wr = Set(d, twiddleRe[k - 1]);
+            const V wi = Set(d, twiddleIm[k - 1]);
+            StoreU(MulSub(re[k], wr, Mul(im[k], wi)), d, yr + i + k * outStep);
+            StoreU(MulAdd(re[k], wi, Mul(im[k], wr)), d, yi + i + k * outStep);
+        }
+    }
+
+    template<class Radix>
+    static void fftButterflies(const float *xr, const float *xi, float *yr, float *yi,
+                               const size_t length, const size_t inStep, const size_t outStep,
+                               const float *twiddleRe, const float *twiddleIm) {
+        const ScalableTag<float> df;
+        const CappedTag<float, 1> df1;
+        const size_t lanes = Lanes(df);
+        size_t i = 0;
+        for (; i + lanes <= length; i += lanes) {
+            fftButterflyStep<Radix>(df, xr, xi, yr, yi, i, inStep, outStep, twiddleRe, twiddleIm);
+        }
+        for (; i < length; ++i) {
+            fftButterflyStep<Radix>(df1, xr, xi, yr, yi, i, inStep, outStep, twiddleRe, twiddleIm);
+        }
+    }
+
+    /**
+     * One self-sorting pass: input element q + s * (p + j * m) goes to q + s * (radix * p + k)
+     */
+    void fftStageHWY(const int radix, const int m, const float *xr, const float *xi, float *yr, float *yi,
+                     const size_t length, const float *twiddlesRe, const float *twiddlesIm) {
+        const size_t inStep = m * length;
+        for (int p = 0; p < m; ++p) {
+            const float *inRe = xr + p * length;
+            const float *inIm = xi + p * length;
+            float *outRe = yr + p * radix * length;
+            float *outIm = yi + p * radix * length;
+            const float *twiddleRe = twiddlesRe + p * (radix - 1);
+            const float *twiddleIm = twiddlesIm + p * (radix - 1);
+            switch (radix) {
+                case 2:
+                    fftButterflies<FftRadix2>(inRe, inIm, outRe, outIm, length, inStep, length, twiddleRe, twiddleIm);
+                    break;
+                case 3:
+                    fftButterflies<FftRadix3>(inRe, inIm, outRe, outIm, length, inStep, length, twiddleRe, twiddleIm);
+                    break;
+                case 4:
+                    fftButterflies<FftRadix4>(inRe, inIm, outRe, outIm, length, inStep, length, twiddleRe, twiddleIm);
+                    break;
+                default:
+                    fftButterflies<FftRadix5>(inRe, inIm, outRe, outIm, length, inStep, length, twiddleRe, twiddleIm);
+                    break;
+            }
+        }
+    }
+
+    void fftMultiplySpectrumHWY(float *re, float *im, const float *kRe, const float *kIm, const size_t length) {
+        const ScalableTag<float> df;
+        const size_t lanes = Lanes(df);
+        size_t i = 0;
+        for (; i + lanes <= length; i += lanes) {
+            const auto ar = LoadU(df, re + i);
+            const auto ai = LoadU(df, im + i);
+            const auto br = LoadU(df, kRe + i);
+            const auto bi = LoadU(df, kIm + i);
+            StoreU(MulSub(ar, br, Mul(ai, bi)), df, re + i);
+            StoreU(MulAdd(ar, bi, Mul(ai, br)), df, im + i);
+        }
+        for (; i < length; ++i) {
+            const float ar = re[i], ai = im[i];
+            re[i] = ar * kRe[i] - ai * kIm[i];
+            im[i] = ar * kIm[i] + ai * kRe[i];
+        }
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    using namespace std;
+
+    HWY_EXPORT(fftStageHWY);
+    HWY_EXPORT(fftMultiplySpectrumHWY);
+
+    FftPlan::FftPlan(int n) : n(n) {
+        if (n < 1) {
+            std::string msg("FFT size must be positive but received " + std::to_string(n));
+            throw AireError(msg);
+        }
+        if (n == 1) {
+            return;
+        }
+        int implementedFactors[] = {4, 2, 3, 5, 0};
+        int factors[64];
+        int factorsCount = 0;
+        factorize(n, &factorsCount, factors, implementedFactors);
+        int length = n;
+        int stride = 1;
+        for (int f = 0; f < factorsCount; ++f) {
+            const int radix = factors[f];
+            if (radix != 2 && radix != 3 && radix != 4 && radix != 5) {
+                std::string msg("FFT size must be 2, 3, 5 smooth but received " + std::to_string(n));
+                throw AireError(msg);
+            }
+            Stage stage;
+            stage.radix = radix;
+            stage.length = length;
+            stage.stride = stride;
+            const int m = length / radix;
+            stage.twiddleRe.resize(m * (radix - 1));
+            stage.twiddleIm.resize(m * (radix - 1));
+            for (int p = 0; p < m; ++p) {
+                for (int k = 1; k < radix; ++k) {
+                    const double angle = -2.0 * M_PI * static_cast<double>(p * k) / static_cast<double>(length);
+                    stage.twiddleRe[p * (radix - 1) + k - 1] = static_cast<float>(std::cos(angle));
+                    stage.twiddleIm[p * (radix - 1) + k - 1] = static_cast<float>(std::sin(angle));
+                }
+            }
+            stages.emplace_back(std::move(stage));
+            length = m;
+            stride *= radix;
+        }
+    }
+
+    void FftPlan::forward(float *re, float *im, float *scratchRe, float *scratchIm, const int batch) const {
+        float *xr = re, *xi = im, *yr = scratchRe, *yi = scratchIm;
+        for (const Stage &stage: stages) {
+            const int radix = stage.radix;
+            const int m = stage.length / radix;
+            const size_t length = static_cast<size_t>(stage.stride) * batch;
+            HWY_DYNAMIC_DISPATCH(fftStageHWY)(radix, m, xr, xi, yr, yi, length,
+                                              stage.twiddleRe.data(), stage.twiddleIm.data());
+            std::swap(xr, yr);
+            std::swap(xi, yi);
+        }
+        if (xr != re) {
+            std::copy(xr, xr + static_cast<size_t>(n) * batch, re);
+            std::copy(xi, xi + static_cast<size_t>(n) * batch, im);
+        }
+    }
+
+    static void fftTranspose(const float *src, float *dst, const int rows, const int cols) {
+        constexpr int block = 16;
+        for (int by = 0; by < rows; by += block) {
+            const int maxY = std::min(by + block, rows);
+            for (int bx = 0; bx < cols; bx += block) {
+                const int maxX = std::min(bx + block, cols);
+                for (int y = by; y < maxY; ++y) {
+                    for (int x = bx; x < maxX; ++x) {
+                        dst[x * rows + y] = src[y * cols + x];
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * 2D transform of `rows` x `cols` tile, forward result is stored transposed ( cols x rows ),
+     * inverse accepts transposed spectrum and restores `rows` x `cols` layout
+     */
+    static void fft2D(const FftPlan &rowsPlan, const FftPlan &colsPlan, float *re, float *im,
+                      float *scratchRe, float *scratchIm, const bool inverse) {
+        const int rows = rowsPlan.size();
+        const int cols = colsPlan.size();
+        if (!inverse) {
+            rowsPlan.forward(re, im, scratchRe, scratchIm, cols);
+            fftTranspose(re, scratchRe, rows, cols);
+            fftTranspose(im, scratchIm, rows, cols);
+            colsPlan.forward(scratchRe, scratchIm, re, im, rows);
+        } else {
+            colsPlan.inverse(re, im, scratchRe, scratchIm, rows);
+            fftTranspose(re, scratchRe, cols, rows);
+            fftTranspose(im, scratchIm, cols, rows);
+            rowsPlan.inverse(scratchRe, scratchIm, re, im, cols);
+        }
+        std::copy(scratchRe, scratchRe + rows * cols, re);
+        std::copy(scratchIm, scratchIm + rows * cols, im);
+    }
+
+    struct FftKernelSpectrum {
+        std::vector<float> kernel;
+        int kernelWidth;
+        int kernelHeight;
+        int tileWidth;
+        int tileHeight;
+        std::vector<float> re;
+        std::vector<float> im;
+    };
+
+    static constexpr size_t fftSpectraCacheCapacity = 8;
+    // Guarded by fftSharedRcLock
+    static std::unordered_map<uint64_t, std::shared_ptr<FftKernelSpectrum>> fftSpectraCache;
+
+    static uint64_t fftSpectrumKey(const std::vector<float> &kernel, const int kernelWidth, const int kernelHeight,
+                                   const int tileWidth, const int tileHeight) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        auto mix = [&hash](uint64_t value) {
+            hash ^= value;
+            hash *= 0x100000001b3ull;
+        };
+        mix(kernelWidth);
+        mix(kernelHeight);
+        mix(tileWidth);
+        mix(tileHeight);
+        for (float value: kernel) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            mix(bits);
+        }
+        return hash;
+    }
+
+    static std::shared_ptr<FftKernelSpectrum> fftKernelSpectrum(const Eigen::MatrixXf &kernel,
+                                                                const FftPlan &rowsPlan,
+                                                                const FftPlan &colsPlan) {
+        const int kernelWidth = static_cast<int>(kernel.cols());
+        const int kernelHeight = static_cast<int>(kernel.rows());
+        const int tileWidth = colsPlan.size();
+        const int tileHeight = rowsPlan.size();
+        std::vector<float> values(kernelWidth * kernelHeight);
+        for (int j = 0; j < kernelHeight; ++j) {
+            for (int i = 0; i < kernelWidth; ++i) {
+                values[j * kernelWidth + i] = kernel(j, i);
+            }
+        }
+        const uint64_t key = fftSpectrumKey(values, kernelWidth, kernelHeight, tileWidth, tileHeight);
+        {
+            std::lock_guard<std::mutex> lock(fftSharedRcLock);
+            auto it = fftSpectraCache.find(key);
+            if (it != fftSpectraCache.end() && it->second->kernel == values
+                && it->second->tileWidth == tileWidth && it->second->tileHeight == tileHeight) {
+                return it->second;
+            }
+        }
+
+        auto spectrum = std::make_shared<FftKernelSpectrum>();
+        spectrum->kernel = values;
+        spectrum->kernelWidth = kernelWidth;
+        spectrum->kernelHeight = kernelHeight;
+        spectrum->tileWidth = tileWidth;
+        spectrum->tileHeight = tileHeight;
+        const size_t tileSize = static_cast<size_t>(tileWidth) * tileHeight;
+        spectrum->re.resize(tileSize, 0.f);
+        spectrum->im.resize(tileSize, 0.f);
+        // Kernel is flipped so circular convolution computes correlation
+        for (int j = 0; j < kernelHeight; ++j) {
+            for (int i = 0; i < kernelWidth; ++i) {
+                spectrum->re[j * tileWidth + i] = kernel(kernelHeight - 1 - j, kernelWidth - 1 - i);
+            }
+        }
+        std::vector<float> scratchRe(tileSize), scratchIm(tileSize);
+        fft2D(rowsPlan, colsPlan, spectrum->re.data(), spectrum->im.data(), scratchRe.data(), scratchIm.data(), false);
+
+        std::lock_guard<std::mutex> lock(fftSharedRcLock);
+        if (fftSpectraCache.size() >= fftSpectraCacheCapacity) {
+            fftSpectraCache.clear();
+        }
+        fftSpectraCache[key] = spectrum;
+        return spectrum;
+    }
+
+    static int fftTileSize(const int kernelSize, const int imageSize) {
+        const int preferred = static_cast<int>(fft_next_good_size(std::max(kernelSize * 2, kernelSize + 256)));
+        const int required = static_cast<int>(fft_next_good_size(imageSize + kernelSize - 1));
+        return std::min(preferred, required);
+    }
+
+    size_t fftConvolve2DWorkingMemory(const int kernelWidth, const int kernelHeight, const int width, const int height,
+                                      const int threads) {
+        const size_t tileSize = static_cast<size_t>(fftTileSize(kernelWidth, width)) * fftTileSize(kernelHeight, height);
+        // Four float planes per worker, complex spectrum and the output image
+        return tileSize * sizeof(float) * (4 * static_cast<size_t>(threads) + 2)
+               + static_cast<size_t>(width) * 4 * height;
+    }
+
+    void fftConvolve2D(uint8_t *data, const int stride, const int width, const int height, const Eigen::MatrixXf &kernel) {
+        const int kernelWidth = static_cast<int>(kernel.cols());
+        const int kernelHeight = static_cast<int>(kernel.rows());
+        if (kernelWidth < 1 || kernelHeight < 1) {
+            std::string msg("Kernel must not be empty");
+            throw AireError(msg);
+        }
+        const int tileWidth = fftTileSize(kernelWidth, width);
+        const int tileHeight = fftTileSize(kernelHeight, height);
+        const int validWidth = tileWidth - kernelWidth + 1;
+        const int validHeight = tileHeight - kernelHeight + 1;
+        const int anchorX = kernelWidth / 2;
+        const int anchorY = kernelHeight / 2;
+
+        const FftPlan rowsPlan(tileHeight);
+        const FftPlan colsPlan(tileWidth);
+        const auto spectrum = fftKernelSpectrum(kernel, rowsPlan, colsPlan);
+
+        const int tilesX = (width + validWidth - 1) / validWidth;
+        const int tilesY = (height + validHeight - 1) / validHeight;
+        const int tilesCount = tilesX * tilesY;
+
+        const size_t tileSize = static_cast<size_t>(tileWidth) * tileHeight;
+        const float normalization = 1.f / static_cast<float>(tileSize);
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, std::min(12, tilesCount));
+
+        std::vector<std::vector<float>> buffers(threadCount, std::vector<float>(tileSize * 4));
+        std::vector<uint8_t> output(stride * height);
+
+        concurrency::parallel_for_with_thread_id(threadCount, tilesCount, [&](int threadId, int tile) {
+            const int originX = (tile % tilesX) * validWidth;
+            const int originY = (tile / tilesX) * validHeight;
+            float *re = buffers[threadId].data();
+            float *im = re + tileSize;
+            float *scratchRe = im + tileSize;
+            float *scratchIm = scratchRe + tileSize;
+
+            const int outWidth = std::min(validWidth, width - originX);
+            const int outHeight = std::min(validHeight, height - originY);
+
+            // Two real channels are packed as one complex signal, kernel is real so they don't mix
+            for (int pair = 0; pair < 2; ++pair) {
+                const int channel = pair * 2;
+                for (int t = 0; t < tileHeight; ++t) {
+                    const int sy = std::clamp(originY - anchorY + t, 0, height - 1);
+                    const uint8_t *src = data + sy * stride;
+                    float *rowRe = re + t * tileWidth;
+                    float *rowIm = im + t * tileWidth;
+                    for (int s = 0; s < tileWidth; ++s) {
+                        const int sx = std::clamp(originX - anchorX + s, 0, width - 1) * 4 + channel;
+                        rowRe[s] = src[sx];
+                        rowIm[s] = src[sx + 1];
+                    }
+                }
+
+                fft2D(rowsPlan, colsPlan, re, im, scratchRe, scratchIm, false);
+                HWY_DYNAMIC_DISPATCH(fftMultiplySpectrumHWY)(re, im, spectrum->re.data(), spectrum->im.data(), tileSize);
+                fft2D(rowsPlan, colsPlan, re, im, scratchRe, scratchIm, true);
+
+                for (int y = 0; y < outHeight; ++y) {
+                    const float *rowRe = re + (y + kernelHeight - 1) * tileWidth + kernelWidth - 1;
+                    const float *rowIm = im + (y + kernelHeight - 1) * tileWidth + kernelWidth - 1;
+                    uint8_t *dst = output.data() + (originY + y) * stride + originX * 4 + channel;
+                    for (int x = 0; x < outWidth; ++x) {
+                        dst[0] = static_cast<uint8_t>(std::clamp(std::roundf(rowRe[x] * normalization), 0.f, 255.f));
+                        dst[1] = static_cast<uint8_t>(std::clamp(std::roundf(rowIm[x] * normalization), 0.f, 255.f));
+                        dst += 4;
+                    }
+                }
+            }
+        });
+
+        for (int y = 0; y < height; ++y) {
+            std::copy(output.begin() + y * stride, output.begin() + y * stride + width * 4, data + y * stride);
+        }
+    }
+
+}
+#endif
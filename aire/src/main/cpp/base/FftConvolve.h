@@ -0,0 +1,84 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Eigen/Eigen"
+
+namespace aire {
+
+    /**
+     * Batched mixed radix (2, 3, 4, 5) Stockham FFT on split complex data.
+     * `batch` sequences are interleaved, element `e` of every sequence starts at `e * batch`
+     */
+    class FftPlan {
+    public:
+        explicit FftPlan(int n);
+
+        void forward(float *re, float *im, float *scratchRe, float *scratchIm, int batch) const;
+
+        /**
+         * Unnormalized inverse, result must be scaled by 1 / n
+         */
+        void inverse(float *re, float *im, float *scratchRe, float *scratchIm, int batch) const {
+            forward(im, re, scratchIm, scratchRe, batch);
+        }
+
+        int size() const {
+            return n;
+        }
+
+    private:
+        struct Stage {
+            int radix;
+            int length;
+            int stride;
+            std::vector<float> twiddleRe;
+            std::vector<float> twiddleIm;
+        };
+
+        int n;
+        std::vector<Stage> stages;
+    };
+
+    /**
+     * 2D correlation of RGBA8888 image with arbitrary kernel using overlap-save FFT tiles, edges are clamped
+     */
+    void fftConvolve2D(uint8_t *data, int stride, int width, int height, const Eigen::MatrixXf &kernel);
+
+    /**
+     * Upper bound of temporary memory fftConvolve2D takes over RGBA8888 image with `threads` workers,
+     * including the kernel spectrum
+     */
+    size_t fftConvolve2DWorkingMemory(int kernelWidth, int kernelHeight, int width, int height, int threads);
+}
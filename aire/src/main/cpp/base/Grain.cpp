@@ -28,31 +28,216 @@
  *
  */
 
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Grain.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
 #include "Grain.h"
-#include <random>
+#include <vector>
+#include <thread>
+#include <cmath>
+#include "MathUtils.hpp"
 #include "concurrency.hpp"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace std;
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    static constexpr int grainTextureSize = 64;
+    static constexpr uint32_t grainColumnMultiplier = 0x9E3779B1u;
+    static constexpr uint32_t grainRowMultiplier = 0x85EBCA77u;
+    // Sum of 4 uniform bytes has mean 510 and standard deviation ~147.8
+    static constexpr float grainIrwinHallMean = 510.f;
+    static constexpr float grainIrwinHallScale = 1.f / 147.8f;
+
+    static inline uint32_t lowBias32(uint32_t h) {
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return h;
+    }
+
+    template<class D, class V = Vec<D>>
+    HWY_INLINE V lowBias32(D d, V h) {
+        h = Xor(h, ShiftRight<16>(h));
+        h = Mul(h, Set(d, 0x7feb352du));
+        h = Xor(h, ShiftRight<15>(h));
+        h = Mul(h, Set(d, 0x846ca68bu));
+        h = Xor(h, ShiftRight<16>(h));
+        return h;
+    }
+
+    static inline uint32_t grainRowKey(const int y, const uint64_t seed) {
+        const uint32_t seed32 = static_cast<uint32_t>(seed) ^ lowBias32(static_cast<uint32_t>(seed >> 32));
+        return lowBias32(static_cast<uint32_t>(y) * grainRowMultiplier ^ seed32);
+    }
+
+    /**
+     * Stateless per pixel normal approximation: hash of (seed, x, y) split into 4 bytes summed as Irwin-Hall
+     */
+    static inline float gaussianGrain(const int x, const uint32_t rowKey) {
+        const uint32_t h = lowBias32(static_cast<uint32_t>(x) * grainColumnMultiplier ^ rowKey);
+        const uint32_t sum = (h & 0xff) + ((h >> 8) & 0xff) + ((h >> 16) & 0xff) + (h >> 24);
+        return (static_cast<float>(sum) - grainIrwinHallMean) * grainIrwinHallScale;
+    }
+
+    template<class D, class V = Vec<D>>
+    HWY_INLINE Vec<Rebind<float, D>> gaussianGrain(D d, V x, V rowKey) {
+        const Rebind<float, D> df;
+        const RebindToSigned<D> di;
+        const V h = lowBias32(d, Xor(Mul(x, Set(d, grainColumnMultiplier)), rowKey));
+        const V mask = Set(d, 0xff);
+        const V sum = Add(Add(And(h, mask), And(ShiftRight<8>(h), mask)),
+                          Add(And(ShiftRight<16>(h), mask), ShiftRight<24>(h)));
+        return Mul(Sub(ConvertTo(df, BitCast(di, sum)), Set(df, grainIrwinHallMean)), Set(df, grainIrwinHallScale));
+    }
+
+    /**
+     * Tileable blue noise: white noise with its toroidal low frequencies removed, normalized to unit variance.
+     * Rows are stored twice as wide to allow unaligned loads across the tile edge
+     */
+    static std::vector<float> generateGrainTexture(const uint64_t seed) {
+        const int size = grainTextureSize;
+        std::vector<float> noise(size * size);
+        for (int y = 0; y < size; ++y) {
+            const uint32_t rowKey = grainRowKey(y, seed);
+            for (int x = 0; x < size; ++x) {
+                noise[y * size + x] = gaussianGrain(x, rowKey);
+            }
+        }
+
+        const int radius = 2;
+        const float weight = 1.f / static_cast<float>((2 * radius + 1) * (2 * radius + 1));
+        std::vector<float> highPass(size * size);
+        double mean = 0;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                float sum = 0;
+                for (int j = -radius; j <= radius; ++j) {
+                    const int row = ((y + j + size) % size) * size;
+                    for (int i = -radius; i <= radius; ++i) {
+                        sum += noise[row + (x + i + size) % size];
+                    }
+                }
+                const float value = noise[y * size + x] - sum * weight;
+                highPass[y * size + x] = value;
+                mean += value;
+            }
+        }
+        mean /= static_cast<double>(size * size);
 
-    void grain(uint8_t *data, int stride, int width, int height, float intensity) {
-        default_random_engine generator;
-        generator.seed(std::chrono::system_clock::now().time_since_epoch().count());
-        normal_distribution<float> distribution(0, 127.f * intensity);
-
-        concurrency::parallel_for(2, height, [&](int y) {
-            auto dst = reinterpret_cast<uint8_t *>(
-                    reinterpret_cast<uint8_t *>(data) + y * stride);
-            for (int x = 0; x < width; ++x) {
-                int grain = distribution(generator);
-                const float mGrain = static_cast<float>(grain);
-
-                int px = x * 4;
-                dst[px] = clamp(dst[px] + mGrain, 0.f, 255.f);
-                dst[px + 1] = clamp(dst[px + 1] + mGrain, 0.f, 255.f);
-                dst[px + 2] = clamp(dst[px + 2] + mGrain, 0.f, 255.f);
+        double variance = 0;
+        for (float &value: highPass) {
+            value -= static_cast<float>(mean);
+            variance += static_cast<double>(value) * static_cast<double>(value);
+        }
+        const float norm = static_cast<float>(1.0 / std::sqrt(std::max(variance / static_cast<double>(size * size), 1e-12)));
+
+        std::vector<float> texture(size * size * 2);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size * 2; ++x) {
+                texture[y * size * 2 + x] = highPass[y * size + x % size] * norm;
+            }
+        }
+        return texture;
+    }
+
+    /**
+     * Film grain is the strongest in mid tones and fades towards shadows and highlights
+     */
+    static inline float grainLuminanceWeight(const float r, const float g, const float b) {
+        const float luma = (0.299f * r + 0.587f * g + 0.114f * b) * (1.f / 255.f);
+        return 0.25f + 3.f * luma * (1.f - luma);
+    }
+
+    void grainHWY(uint8_t *data, int stride, int width, int height, float intensity, uint64_t seed, GrainMode mode) {
+        const ScalableTag<uint32_t> du32;
+        const RebindToSigned<decltype(du32)> di32;
+        const Rebind<float, decltype(du32)> df32;
+        const Rebind<uint8_t, decltype(du32)> du8;
+        using VU8 = Vec<decltype(du8)>;
+        using VF = Vec<decltype(df32)>;
+        const int lanes = static_cast<int>(Lanes(du32));
+
+        const float scale = 127.f * intensity;
+        const std::vector<float> texture = mode == GRAIN_FILM ? generateGrainTexture(seed) : std::vector<float>();
+
+        const VF vScale = Set(df32, scale);
+        const VF vLumaR = Set(df32, 0.299f / 255.f);
+        const VF vLumaG = Set(df32, 0.587f / 255.f);
+        const VF vLumaB = Set(df32, 0.114f / 255.f);
+        const VF vQuarter = Set(df32, 0.25f);
+        const VF vThree = Set(df32, 3.f);
+        const VF vOne = Set(df32, 1.f);
+
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            auto dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
+            const uint32_t rowKey = grainRowKey(y, seed);
+            const auto vRowKey = Set(du32, rowKey);
+            const float *textureRow = mode == GRAIN_FILM
+                                      ? texture.data() + (y % grainTextureSize) * grainTextureSize * 2 : nullptr;
+            int x = 0;
+
+            if (lanes <= grainTextureSize) {
+                for (; x + lanes <= width; x += lanes) {
+                    VU8 r, g, b, a;
+                    LoadInterleaved4(du8, dst, r, g, b, a);
+                    VF fr = ConvertTo(df32, PromoteTo(di32, r));
+                    VF fg = ConvertTo(df32, PromoteTo(di32, g));
+                    VF fb = ConvertTo(df32, PromoteTo(di32, b));
+                    VF noise;
+                    if (mode == GRAIN_FILM) {
+                        const VF luma = MulAdd(fr, vLumaR, MulAdd(fg, vLumaG, Mul(fb, vLumaB)));
+                        const VF weight = MulAdd(Mul(vThree, luma), Sub(vOne, luma), vQuarter);
+                        noise = Mul(Mul(LoadU(df32, textureRow + x % grainTextureSize), weight), vScale);
+                    } else {
+                        noise = Mul(gaussianGrain(du32, Iota(du32, static_cast<uint32_t>(x)), vRowKey), vScale);
+                    }
+                    r = DemoteTo(du8, NearestInt(Add(fr, noise)));
+                    g = DemoteTo(du8, NearestInt(Add(fg, noise)));
+                    b = DemoteTo(du8, NearestInt(Add(fb, noise)));
+                    StoreInterleaved4(r, g, b, a, du8, dst);
+                    dst += lanes * 4;
+                }
+            }
+
+            for (; x < width; ++x) {
+                const float r = dst[0], g = dst[1], b = dst[2];
+                float noise;
+                if (mode == GRAIN_FILM) {
+                    noise = textureRow[x % grainTextureSize] * grainLuminanceWeight(r, g, b) * scale;
+                } else {
+                    noise = gaussianGrain(x, rowKey) * scale;
+                }
+                dst[0] = static_cast<uint8_t>(std::clamp(std::roundf(r + noise), 0.f, 255.f));
+                dst[1] = static_cast<uint8_t>(std::clamp(std::roundf(g + noise), 0.f, 255.f));
+                dst[2] = static_cast<uint8_t>(std::clamp(std::roundf(b + noise), 0.f, 255.f));
+                dst += 4;
             }
         });
     }
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(grainHWY);
+
+    void grain(uint8_t *data, int stride, int width, int height, float intensity, uint64_t seed, GrainMode mode) {
+        HWY_DYNAMIC_DISPATCH(grainHWY)(data, stride, width, height, intensity, seed, mode);
+    }
+
+}
+#endif
@@ -33,5 +33,14 @@
 #include <cstdint>
 
 namespace aire {
-    void grain(uint8_t *data, int stride, int width, int height, float intensity);
+    enum GrainMode {
+        GRAIN_GAUSSIAN = 0,
+        GRAIN_FILM = 1
+    };
+
+    /**
+     * Counter based grain, noise is a pure function of (seed, x, y) so output is reproducible for the same seed
+     * and independent of the threads count
+     */
+    void grain(uint8_t *data, int stride, int width, int height, float intensity, uint64_t seed, GrainMode mode);
 }
\ No newline at end of file
@@ -28,17 +28,22 @@
  *
  */
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Grayscale.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
 #include "Grayscale.h"
 #include "color/Gamut.h"
-#include "hwy/highway.h"
 #include "color/eotf-inl.h"
 #include "concurrency.hpp"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
-    using namespace aire::HWY_NAMESPACE;
 
     template<class D, HWY_IF_U8_D(D), typename T = TFromD<D>>
     void grayscaleHWY(D du, T *pixels, T *destination, int stride, int width, int height,
@@ -74,11 +79,27 @@ namespace aire {
     }
 
     void
-    grayscale(uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
-              const float rPrimary,
-              const float gPrimary, const float bPrimary) {
+    grayscaleU8HWY(uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
+                   const float rPrimary, const float gPrimary, const float bPrimary) {
         const FixedTag<uint8_t, 4> du8;
         grayscaleHWY(du8, pixels, destination, stride, width, height, rPrimary, gPrimary,
                      bPrimary);
     }
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(grayscaleU8HWY);
+
+    void
+    grayscale(uint8_t *pixels, uint8_t *destination, int stride, int width, int height,
+              const float rPrimary,
+              const float gPrimary, const float bPrimary) {
+        HWY_DYNAMIC_DISPATCH(grayscaleU8HWY)(pixels, destination, stride, width, height, rPrimary, gPrimary,
+                                             bPrimary);
+    }
+
+}
+#endif
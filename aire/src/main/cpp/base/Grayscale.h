@@ -31,6 +31,7 @@
 #pragma once
 
 #include <valarray>
+#include <cstdint>
 
 namespace aire {
     void
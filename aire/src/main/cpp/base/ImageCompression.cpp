@@ -0,0 +1,146 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "ImageCompression.h"
+#include <string>
+#include "AireError.h"
+#include "EigenUtils.h"
+#include "algo/WuQuantizer.h"
+#include "algo/MedianCut.h"
+#include "base/PNGEncoder.h"
+#if !AIRE_NO_JPEG
+#include "base/JPEGEncoder.h"
+#endif
+#include "base/Instrumentation.h"
+#include "conversion/RGBAlpha.h"
+
+namespace aire {
+
+    std::vector<uint8_t> compressPNG(const uint8_t *data, int stride, int width, int height,
+                                     int maxColors, AireQuantize quantize, RemapDithering dithering,
+                                     RemapMappingStrategy strategy, int compressionLevel) {
+        if (maxColors < 2) {
+            std::string msg("Max colors must be at least 2, but was received " + std::to_string(maxColors));
+            throw AireError(msg);
+        }
+
+        if (compressionLevel < 0 || compressionLevel > 9) {
+            std::string msg("Compression level is expected to in 0...9 but received: " + std::to_string(compressionLevel));
+            throw AireError(msg);
+        }
+
+        std::vector<Eigen::Vector4i> palette;
+        uint32_t colors = maxColors;
+        std::vector<uint8_t> original(stride * height);
+
+        {
+            ScopedStage stage("toPNG.unpremultiply");
+            UnpremultiplyRGBA(data, stride, original.data(), stride, width, height);
+        }
+
+        {
+            ScopedStage stage("toPNG.quantize");
+            switch (quantize) {
+                case AIRE_QUANTIZE_MEDIAN_CUT: {
+                    Palette cut(reinterpret_cast<uint32_t *>(original.data()), width * height);
+                    cut.medianCut(maxColors, [&palette](const Cube &cube) {
+                        auto clr = cube.getAverageRGBA();
+                        palette.push_back(unpackRGBA(clr));
+                    });
+                }
+                    break;
+                case AIRE_QUANTIZE_XIAOLING_WU: {
+                    WuQuantizer wuQuantizer(original.data(), stride, width, height);
+                    palette = wuQuantizer.quantizeImage(colors, 15, 15);
+                }
+                    break;
+            }
+        }
+
+        RemapPalette remapPalette(palette, original.data(), stride, width, height, dithering, strategy);
+        if (maxColors > 255 || dithering != Remap_Dither_Skip) {
+            std::vector<uint8_t> remapped;
+            {
+                ScopedStage stage("toPNG.remap");
+                remapped = remapPalette.remap();
+            }
+            ScopedStage stage("toPNG.encode");
+            PNGEncoder encoder(remapped.data(), stride, width, height);
+            encoder.setCompressionLevel(compressionLevel);
+            return encoder.getPNGData();
+        }
+
+        std::vector<uint8_t> remapped;
+        {
+            ScopedStage stage("toPNG.remap");
+            remapped = remapPalette.indexed();
+        }
+        ScopedStage stage("toPNG.encode");
+        PNGEncoder encoder(remapped.data(), stride, width, height);
+        encoder.setCompressionLevel(compressionLevel);
+        return encoder.encode(palette);
+    }
+
+    std::vector<uint8_t> compressJPEG(const uint8_t *data, int stride, int width, int height, int quality) {
+        if (quality < 0 || quality > 100) {
+            std::string msg("Quality must be between 0...100 but received: " + std::to_string(quality));
+            throw AireError(msg);
+        }
+
+        std::vector<uint8_t> original(stride * height);
+        {
+            ScopedStage stage("toJPEG.unpremultiply");
+            UnpremultiplyRGBA(data, stride, original.data(), stride, width, height);
+        }
+#if AIRE_NO_JPEG
+        throw AireError("JPEG encoder is not available in this build");
+#else
+        ScopedStage stage("toJPEG.encode");
+        JPEGEncoder encoder(original.data(), stride, width, height);
+        encoder.setQuality(quality);
+        return encoder.encode();
+#endif
+    }
+
+    size_t compressPNGWorkingMemory(const int width, const int height, const AireQuantize quantize) {
+        const size_t image = static_cast<size_t>(width) * 4 * height;
+        // Unpremultiplied copy, remapped image and encoded stream
+        const size_t buffers = image * 3;
+        if (quantize == AIRE_QUANTIZE_XIAOLING_WU) {
+            return buffers + WuQuantizer::workingMemory(width, height);
+        }
+        return buffers + image;
+    }
+
+    size_t compressJPEGWorkingMemory(const int width, const int height) {
+        // Unpremultiplied copy, RGB rows for the encoder and encoded stream
+        return static_cast<size_t>(width) * 4 * height * 3;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "base/RemapPalette.h"
+
+enum AireQuantize {
+    AIRE_QUANTIZE_MEDIAN_CUT = 1,
+    AIRE_QUANTIZE_XIAOLING_WU = 2
+};
+
+namespace aire {
+
+    /**
+     * Quantizes premultiplied RGBA8888 image to at most maxColors and encodes it as PNG
+     */
+    std::vector<uint8_t> compressPNG(const uint8_t *data, int stride, int width, int height,
+                                     int maxColors, AireQuantize quantize, RemapDithering dithering,
+                                     RemapMappingStrategy strategy, int compressionLevel);
+
+    /**
+     * Encodes premultiplied RGBA8888 image as JPEG
+     */
+    std::vector<uint8_t> compressJPEG(const uint8_t *data, int stride, int width, int height, int quality);
+
+    /**
+     * Upper bound of temporary memory compressPNG takes, quantizer scratch included
+     */
+    size_t compressPNGWorkingMemory(int width, int height, AireQuantize quantize);
+
+    size_t compressJPEGWorkingMemory(int width, int height);
+}
@@ -0,0 +1,78 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "ImagePyramid.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include "MathUtils.hpp"
+#include "concurrency.hpp"
+
+namespace aire {
+
+    using namespace std;
+
+    void pyramidDownsample(const uint8_t *src, const int srcStride, const int srcWidth, const int srcHeight,
+                           uint8_t *dst, const int dstStride) {
+        const int width = (srcWidth + 1) / 2;
+        const int height = (srcHeight + 1) / 2;
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          srcHeight * srcWidth / (256 * 256)), 1, 12);
+
+        const int hStride = width * 4;
+        std::vector<uint16_t> horizontal(hStride * srcHeight);
+
+        concurrency::parallel_for(threadCount, srcHeight, [&](int y) {
+            auto row = src + y * srcStride;
+            auto hRow = horizontal.data() + y * hStride;
+            for (int x = 0; x < width; ++x) {
+                const int x0 = std::max(2 * x - 1, 0) * 4;
+                const int x1 = 2 * x * 4;
+                const int x2 = std::min(2 * x + 1, srcWidth - 1) * 4;
+                const int x3 = std::min(2 * x + 2, srcWidth - 1) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    hRow[c] = row[x0 + c] + 3 * (row[x1 + c] + row[x2 + c]) + row[x3 + c];
+                }
+                hRow += 4;
+            }
+        });
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const uint16_t *r0 = horizontal.data() + std::max(2 * y - 1, 0) * hStride;
+            const uint16_t *r1 = horizontal.data() + 2 * y * hStride;
+            const uint16_t *r2 = horizontal.data() + std::min(2 * y + 1, srcHeight - 1) * hStride;
+            const uint16_t *r3 = horizontal.data() + std::min(2 * y + 2, srcHeight - 1) * hStride;
+            uint8_t *row = dst + y * dstStride;
+            for (int x = 0; x < hStride; ++x) {
+                row[x] = static_cast<uint8_t>((r0[x] + 3 * (r1[x] + r2[x]) + r3[x] + 32) >> 6);
+            }
+        });
+    }
+}
@@ -0,0 +1,189 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "Instrumentation.h"
+#include <mutex>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <algorithm>
+
+namespace aire {
+
+    struct StageEvent {
+        const char *name;
+        uint64_t start;
+        uint64_t end;
+        int thread;
+    };
+
+    struct StageTotals {
+        uint64_t calls = 0;
+        uint64_t totalNanos = 0;
+        uint64_t maxNanos = 0;
+    };
+
+    // Trace keeps the first events only, totals are aggregated for every stage
+    static constexpr size_t kMaxTraceEvents = 16384;
+
+    static std::mutex instrumentationMutex;
+    static std::vector<StageEvent> traceEvents;
+    static std::map<std::string, StageTotals> stageTotals;
+    static uint64_t droppedEvents = 0;
+    static uint64_t traceOrigin = 0;
+
+    static int currentThreadIndex() {
+        static std::atomic<int> nextIndex{1};
+        thread_local int index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    static const char *counterName(int counter) {
+        switch (counter) {
+            case COUNTER_BYTES_ALLOCATED:
+                return "bytes_allocated";
+            case COUNTER_BYTES_COPIED:
+                return "bytes_copied";
+            case COUNTER_SCRATCH_REQUESTED:
+                return "scratch_requested_bytes";
+            case COUNTER_SCRATCH_ALLOCATED:
+                return "scratch_allocated_bytes";
+            case COUNTER_SCRATCH_REUSED:
+                return "scratch_reused";
+            case COUNTER_PARALLEL_LOOPS:
+                return "parallel_loops";
+            case COUNTER_PARALLEL_TASKS:
+                return "parallel_tasks";
+            case COUNTER_PARALLEL_WALL_NS:
+                return "parallel_wall_ns";
+            case COUNTER_PARALLEL_BUSY_NS:
+                return "parallel_busy_ns";
+            default:
+                return "unknown";
+        }
+    }
+
+    void Instrumentation::setEnabled(bool enabled) {
+        if (enabled && !Instrumentation::enabled()) {
+            std::lock_guard<std::mutex> lock(instrumentationMutex);
+            if (traceOrigin == 0) {
+                traceOrigin = nowNanos();
+            }
+        }
+        enabledFlag().store(enabled, std::memory_order_relaxed);
+    }
+
+    void Instrumentation::record(const char *name, uint64_t startNanos, uint64_t endNanos) {
+        const int thread = currentThreadIndex();
+        const uint64_t duration = endNanos > startNanos ? endNanos - startNanos : 0;
+        std::lock_guard<std::mutex> lock(instrumentationMutex);
+        StageTotals &totals = stageTotals[name];
+        totals.calls += 1;
+        totals.totalNanos += duration;
+        totals.maxNanos = std::max(totals.maxNanos, duration);
+        if (traceEvents.size() < kMaxTraceEvents) {
+            traceEvents.push_back({name, startNanos, endNanos, thread});
+        } else {
+            droppedEvents += 1;
+        }
+    }
+
+    void Instrumentation::parallelLoop(int workers, uint64_t wallNanos, uint64_t busyNanos) {
+        count(COUNTER_PARALLEL_LOOPS, 1);
+        count(COUNTER_PARALLEL_TASKS, workers);
+        count(COUNTER_PARALLEL_WALL_NS, wallNanos * workers);
+        count(COUNTER_PARALLEL_BUSY_NS, busyNanos);
+    }
+
+    std::string Instrumentation::report() {
+        std::string json = "{\"enabled\":";
+        json += enabled() ? "true" : "false";
+        char buffer[256];
+
+        json += ",\"stages\":[";
+        {
+            std::lock_guard<std::mutex> lock(instrumentationMutex);
+            bool first = true;
+            for (const auto &[name, totals]: stageTotals) {
+                snprintf(buffer, sizeof(buffer),
+                         "%s{\"name\":\"%s\",\"calls\":%llu,\"total_ms\":%.3f,\"max_ms\":%.3f}",
+                         first ? "" : ",", name.c_str(), static_cast<unsigned long long>(totals.calls),
+                         static_cast<double>(totals.totalNanos) / 1e6, static_cast<double>(totals.maxNanos) / 1e6);
+                json += buffer;
+                first = false;
+            }
+            snprintf(buffer, sizeof(buffer), "],\"dropped_trace_events\":%llu",
+                     static_cast<unsigned long long>(droppedEvents));
+            json += buffer;
+        }
+
+        json += ",\"counters\":{";
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            snprintf(buffer, sizeof(buffer), "%s\"%s\":%llu", i == 0 ? "" : ",", counterName(i),
+                     static_cast<unsigned long long>(counters()[i].load(std::memory_order_relaxed)));
+            json += buffer;
+        }
+
+        const uint64_t wall = counters()[COUNTER_PARALLEL_WALL_NS].load(std::memory_order_relaxed);
+        const uint64_t busy = counters()[COUNTER_PARALLEL_BUSY_NS].load(std::memory_order_relaxed);
+        snprintf(buffer, sizeof(buffer), "},\"thread_utilization\":%.4f}",
+                 wall > 0 ? static_cast<double>(busy) / static_cast<double>(wall) : 0.0);
+        json += buffer;
+        return json;
+    }
+
+    std::string Instrumentation::chromeTrace() {
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        char buffer[256];
+        std::lock_guard<std::mutex> lock(instrumentationMutex);
+        for (size_t i = 0; i < traceEvents.size(); ++i) {
+            const StageEvent &event = traceEvents[i];
+            const uint64_t start = event.start > traceOrigin ? event.start - traceOrigin : 0;
+            snprintf(buffer, sizeof(buffer),
+                     "%s{\"name\":\"%s\",\"cat\":\"aire\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                     i == 0 ? "" : ",", event.name, static_cast<double>(start) / 1e3,
+                     static_cast<double>(event.end - event.start) / 1e3, event.thread);
+            json += buffer;
+        }
+        json += "]}";
+        return json;
+    }
+
+    void Instrumentation::reset() {
+        std::lock_guard<std::mutex> lock(instrumentationMutex);
+        traceEvents.clear();
+        stageTotals.clear();
+        droppedEvents = 0;
+        traceOrigin = nowNanos();
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            counters()[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace aire {
+
+    enum InstrumentationCounter {
+        COUNTER_BYTES_ALLOCATED = 0,
+        COUNTER_BYTES_COPIED = 1,
+        COUNTER_SCRATCH_REQUESTED = 2,
+        COUNTER_SCRATCH_ALLOCATED = 3,
+        COUNTER_SCRATCH_REUSED = 4,
+        COUNTER_PARALLEL_LOOPS = 5,
+        COUNTER_PARALLEL_TASKS = 6,
+        COUNTER_PARALLEL_WALL_NS = 7,
+        COUNTER_PARALLEL_BUSY_NS = 8,
+        COUNTER_COUNT = 9
+    };
+
+    /**
+     * Process wide stage timings and counters. When disabled every probe costs a single relaxed load
+     */
+    class Instrumentation {
+    public:
+        static bool enabled() {
+            return enabledFlag().load(std::memory_order_relaxed);
+        }
+
+        static void setEnabled(bool enabled);
+
+        static void count(InstrumentationCounter counter, uint64_t value) {
+            if (enabled()) {
+                counters()[counter].fetch_add(value, std::memory_order_relaxed);
+            }
+        }
+
+        static uint64_t nowNanos() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /**
+         * @param name - must have static storage duration
+         */
+        static void record(const char *name, uint64_t startNanos, uint64_t endNanos);
+
+        static void parallelLoop(int workers, uint64_t wallNanos, uint64_t busyNanos);
+
+        /**
+         * Aggregated stages, counters and thread pool utilization as JSON
+         */
+        static std::string report();
+
+        /**
+         * Recorded stages in Chrome trace event format, loadable by chrome://tracing and Perfetto
+         */
+        static std::string chromeTrace();
+
+        static void reset();
+
+    private:
+        static std::atomic<bool> &enabledFlag() {
+            static std::atomic<bool> flag{false};
+            return flag;
+        }
+
+        static std::atomic<uint64_t> *counters() {
+            static std::atomic<uint64_t> values[COUNTER_COUNT];
+            return values;
+        }
+    };
+
+    /**
+     * Records duration of the enclosing scope as a named stage
+     */
+    class ScopedStage {
+    public:
+        explicit ScopedStage(const char *name) : name(name),
+                                                 start(Instrumentation::enabled() ? Instrumentation::nowNanos() : 0) {
+        }
+
+        ScopedStage(const ScopedStage &) = delete;
+
+        ScopedStage &operator=(const ScopedStage &) = delete;
+
+        ~ScopedStage() {
+            stop();
+        }
+
+        /**
+         * Ends the stage before the scope exits
+         */
+        void stop() {
+            if (start != 0) {
+                Instrumentation::record(name, start, Instrumentation::nowNanos());
+                start = 0;
+            }
+        }
+
+    private:
+        const char *name;
+        uint64_t start;
+    };
+}
@@ -32,7 +32,7 @@
 #include "turbojpeg/jpeglib.h"
 #include "Rgba2Rgb.h"
 #include <setjmp.h>
-#include "jni/JNIUtils.h"
+#include "AireError.h"
 #include <string>
 
 namespace aire {
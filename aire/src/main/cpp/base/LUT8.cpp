@@ -30,24 +30,132 @@
 
 #include "LUT8.h"
 #include <algorithm>
+#include <thread>
+#include <cmath>
+#include "MathUtils.hpp"
 #include "concurrency.hpp"
 
+#if __aarch64__
+#include <arm_neon.h>
+#endif
+
 namespace aire {
 
     using namespace std;
 
+    LUT8::LUT8() {
+        for (int c = 0; c < 4; ++c) {
+            for (int i = 0; i < 256; ++i) {
+                tables[c][i] = static_cast<uint8_t>(i);
+            }
+        }
+    }
+
+    LUT8::LUT8(const uint8_t table[256]) : LUT8() {
+        memcpy(tables[0], table, sizeof(uint8_t) * 256);
+        memcpy(tables[1], table, sizeof(uint8_t) * 256);
+        memcpy(tables[2], table, sizeof(uint8_t) * 256);
+    }
+
+    LUT8::LUT8(const uint8_t red[256], const uint8_t green[256], const uint8_t blue[256], const uint8_t alpha[256]) {
+        memcpy(tables[0], red, sizeof(uint8_t) * 256);
+        memcpy(tables[1], green, sizeof(uint8_t) * 256);
+        memcpy(tables[2], blue, sizeof(uint8_t) * 256);
+        memcpy(tables[3], alpha, sizeof(uint8_t) * 256);
+    }
+
+    LUT8 LUT8::then(const LUT8 &next) const {
+        LUT8 composed;
+        for (int c = 0; c < 4; ++c) {
+            for (int i = 0; i < 256; ++i) {
+                composed.tables[c][i] = next.tables[c][tables[c][i]];
+            }
+        }
+        return composed;
+    }
+
+    LUT8 LUT8::adjustment(const float gain, const float bias) {
+        uint8_t table[256];
+        for (int i = 0; i < 256; ++i) {
+            const float v = gain * (static_cast<float>(i) / 255.f - 0.5f) + 0.5f + bias;
+            table[i] = static_cast<uint8_t>(std::clamp(v * 255.f, 0.f, 255.f));
+        }
+        return LUT8(table);
+    }
+
+    LUT8 LUT8::gamma(const float gamma) {
+        uint8_t table[256];
+        for (int i = 0; i < 256; ++i) {
+            table[i] = static_cast<uint8_t>(std::clamp(std::powf(float(i), gamma), 0.f, 255.f));
+        }
+        return LUT8(table);
+    }
+
+    LUT8 LUT8::levels(const int inBlack, const int inWhite, const float gamma, const int outBlack, const int outWhite) {
+        uint8_t table[256];
+        const float range = static_cast<float>(std::max(inWhite - inBlack, 1));
+        const float invGamma = 1.f / std::max(gamma, 0.01f);
+        for (int i = 0; i < 256; ++i) {
+            const float v = std::clamp(static_cast<float>(i - inBlack) / range, 0.f, 1.f);
+            const float mapped = static_cast<float>(outBlack) + std::powf(v, invGamma) * static_cast<float>(outWhite - outBlack);
+            table[i] = static_cast<uint8_t>(std::clamp(mapped + 0.5f, 0.f, 255.f));
+        }
+        return LUT8(table);
+    }
+
+#if __aarch64__
+    /**
+     * Full 256 entries lookup with four 64 bytes TBL tables, out of range indices keep previous result
+     */
+    static inline uint8x16_t lookupTBL(const uint8x16_t v, const uint8_t *table) {
+        const uint8x16_t step = vdupq_n_u8(64);
+        uint8x16_t index = v;
+        uint8x16_t result = vqtbl4q_u8(vld1q_u8_x4(table), index);
+        index = vsubq_u8(index, step);
+        result = vqtbx4q_u8(result, vld1q_u8_x4(table + 64), index);
+        index = vsubq_u8(index, step);
+        result = vqtbx4q_u8(result, vld1q_u8_x4(table + 128), index);
+        index = vsubq_u8(index, step);
+        return vqtbx4q_u8(result, vld1q_u8_x4(table + 192), index);
+    }
+#endif
+
     void LUT8::apply(uint8_t *data, int stride, int width, int height) const {
-        concurrency::parallel_for(2, height, [&](int y) {
-            auto dst = reinterpret_cast<uint8_t *>(
-                    reinterpret_cast<uint8_t *>(data) + y * stride);
-            for (int x = 0; x < width; ++x) {
-                auto src = reinterpret_cast<uint8_t *>(
-                        reinterpret_cast<uint8_t *>(data) + y * stride);
-                int px = x * 4;
-                dst[px] = this->table[clamp(src[px], uint8_t(0), uint8_t(255))];
-                dst[px + 1] = this->table[clamp(src[px + 1], uint8_t(0), uint8_t(255))];
-                dst[px + 2] = this->table[clamp(src[px + 2], uint8_t(0), uint8_t(255))];
+        bool identity[4];
+        for (int c = 0; c < 4; ++c) {
+            identity[c] = true;
+            for (int i = 0; i < 256 && identity[c]; ++i) {
+                identity[c] = tables[c][i] == i;
+            }
+        }
+
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            uint8_t *dst = data + y * stride;
+            int x = 0;
+
+#if __aarch64__
+            for (; x + 16 <= width; x += 16) {
+                uint8x16x4_t pixels = vld4q_u8(dst);
+                for (int c = 0; c < 4; ++c) {
+                    if (!identity[c]) {
+                        pixels.val[c] = lookupTBL(pixels.val[c], tables[c]);
+                    }
+                }
+                vst4q_u8(dst, pixels);
+                dst += 64;
+            }
+#endif
+
+            for (; x < width; ++x) {
+                dst[0] = tables[0][dst[0]];
+                dst[1] = tables[1][dst[1]];
+                dst[2] = tables[2][dst[2]];
+                dst[3] = tables[3][dst[3]];
+                dst += 4;
             }
         });
     }
-}
\ No newline at end of file
+}
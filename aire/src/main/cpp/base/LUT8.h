@@ -31,17 +31,39 @@
 #pragma once
 
 #include <memory>
+#include <cstring>
 #include <cstdint>
 
 namespace aire {
+    /**
+     * Independent 8-bit lookup tables for R, G, B and A channels of RGBA8888 image.
+     * Chains of per channel point operations compose into a single table with [then]
+     */
     class LUT8 {
     public:
-        LUT8(uint8_t table[256]) {
-            memcpy(this->table, table, sizeof(uint8_t) * 256);
-        }
+        LUT8();
+
+        /**
+         * Same table for R, G, B, alpha is kept as is
+         */
+        LUT8(const uint8_t table[256]);
+
+        LUT8(const uint8_t red[256], const uint8_t green[256], const uint8_t blue[256], const uint8_t alpha[256]);
+
+        /**
+         * Table equivalent to applying this and then next
+         */
+        LUT8 then(const LUT8 &next) const;
+
+        static LUT8 adjustment(float gain, float bias);
+
+        static LUT8 gamma(float gamma);
+
+        static LUT8 levels(int inBlack, int inWhite, float gamma, int outBlack, int outWhite);
 
         void apply(uint8_t *data, int stride, int width, int height) const;
+
     private:
-        uint8_t table[256];
+        alignas(16) uint8_t tables[4][256];
     };
 }
\ No newline at end of file
@@ -0,0 +1,181 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "MappedImage.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include "AireError.h"
+
+namespace aire {
+
+    using namespace std;
+
+    static void checkGeometry(const int width, const int height, const int stride) {
+        if (width <= 0 || height <= 0) {
+            std::string msg("Mapped image must have positive size but received "
+                            + std::to_string(width) + "x" + std::to_string(height));
+            throw AireError(msg);
+        }
+        if (stride < width * 4) {
+            std::string msg("Mapped image stride " + std::to_string(stride) + " is less than row of "
+                            + std::to_string(width) + " pixels");
+            throw AireError(msg);
+        }
+    }
+
+    static void throwErrno(const std::string &what, const std::string &path) {
+        std::string msg(what + " " + path + ": " + strerror(errno));
+        throw AireError(msg);
+    }
+
+    MappedImage MappedImage::create(const std::string &path, int width, int height) {
+        checkGeometry(width, height, width * 4);
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throwErrno("Cannot create", path);
+        }
+        const size_t length = static_cast<size_t>(width) * 4 * height;
+        if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+            close(fd);
+            throwErrno("Cannot resize", path);
+        }
+        MappedImage image;
+        image.width = width;
+        image.height = height;
+        image.stride = width * 4;
+        image.map(fd, 0, length, true);
+        close(fd);
+        return image;
+    }
+
+    MappedImage MappedImage::open(const std::string &path, int width, int height, int stride,
+                                  size_t offset, bool writable) {
+        checkGeometry(width, height, stride);
+        const int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            throwErrno("Cannot open", path);
+        }
+        const size_t length = static_cast<size_t>(stride) * (height - 1) + width * 4;
+        struct stat st = {};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < offset + length) {
+            close(fd);
+            std::string msg("File " + path + " is too small for " + std::to_string(width) + "x"
+                            + std::to_string(height) + " raster");
+            throw AireError(msg);
+        }
+        MappedImage image;
+        image.width = width;
+        image.height = height;
+        image.stride = stride;
+        image.map(fd, offset, length, writable);
+        close(fd);
+        return image;
+    }
+
+    void MappedImage::map(int fd, size_t offset, size_t length, bool mapWritable) {
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t alignedOffset = offset / pageSize * pageSize;
+        const size_t lead = offset - alignedOffset;
+        void *pointer = mmap(nullptr, length + lead, mapWritable ? PROT_READ | PROT_WRITE : PROT_READ,
+                             MAP_SHARED, fd, static_cast<off_t>(alignedOffset));
+        if (pointer == MAP_FAILED) {
+            std::string msg("Cannot map " + std::to_string(length) + " bytes: " + strerror(errno));
+            throw AireError(msg);
+        }
+        madvise(pointer, length + lead, MADV_SEQUENTIAL);
+        mapping = reinterpret_cast<uint8_t *>(pointer);
+        mappingLength = length + lead;
+        base = mapping + lead;
+        writable = mapWritable;
+    }
+
+    void MappedImage::release(int y0, int y1) {
+        y0 = std::clamp(y0, 0, height);
+        y1 = std::clamp(y1, 0, height);
+        if (y1 <= y0) {
+            return;
+        }
+        const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        // Only pages fully covered by the rows, neighbours may still be in use
+        const uintptr_t start = (reinterpret_cast<uintptr_t>(row(y0)) + pageSize - 1) / pageSize * pageSize;
+        const uintptr_t end = y1 == height ? reinterpret_cast<uintptr_t>(mapping + mappingLength)
+                                           : reinterpret_cast<uintptr_t>(row(y1)) / pageSize * pageSize;
+        if (end <= start) {
+            return;
+        }
+        void *pointer = reinterpret_cast<void *>(start);
+        if (writable) {
+            msync(pointer, end - start, MS_ASYNC);
+        }
+        madvise(pointer, end - start, MADV_DONTNEED);
+    }
+
+    void MappedImage::unmap() {
+        if (mapping != nullptr) {
+            if (writable) {
+                msync(mapping, mappingLength, MS_SYNC);
+            }
+            munmap(mapping, mappingLength);
+        }
+        mapping = nullptr;
+        mappingLength = 0;
+        base = nullptr;
+    }
+
+    MappedImage::MappedImage(MappedImage &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedImage &MappedImage::operator=(MappedImage &&other) noexcept {
+        if (this != &other) {
+            unmap();
+            width = other.width;
+            height = other.height;
+            stride = other.stride;
+            mapping = other.mapping;
+            mappingLength = other.mappingLength;
+            base = other.base;
+            writable = other.writable;
+            other.mapping = nullptr;
+            other.mappingLength = 0;
+            other.base = nullptr;
+        }
+        return *this;
+    }
+
+    MappedImage::~MappedImage() {
+        unmap();
+    }
+}
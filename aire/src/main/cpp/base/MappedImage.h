@@ -0,0 +1,92 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace aire {
+
+    /**
+     * RGBA8888 raster backed by a shared file mapping, pages are loaded on first touch and
+     * may be handed back to the kernel once a band of rows is done, so resident memory stays bounded
+     * no matter how large the file is
+     */
+    class MappedImage {
+    public:
+        /**
+         * Creates or truncates file at `path` to hold width x height raster with tightly packed rows
+         */
+        static MappedImage create(const std::string &path, int width, int height);
+
+        /**
+         * Maps raw raster already stored in the file, rows start `offset` bytes into the file
+         */
+        static MappedImage open(const std::string &path, int width, int height, int stride,
+                                size_t offset, bool writable);
+
+        MappedImage(MappedImage &&other) noexcept;
+
+        MappedImage &operator=(MappedImage &&other) noexcept;
+
+        MappedImage(const MappedImage &) = delete;
+
+        MappedImage &operator=(const MappedImage &) = delete;
+
+        ~MappedImage();
+
+        uint8_t *row(const int y) const {
+            return base + static_cast<size_t>(y) * stride;
+        }
+
+        /**
+         * Drops rows [y0, y1) from resident memory, dirty rows are scheduled for write back first
+         */
+        void release(int y0, int y1);
+
+        int width = 0;
+        int height = 0;
+        int stride = 0;
+
+    private:
+        MappedImage() = default;
+
+        void map(int fd, size_t offset, size_t length, bool writable);
+
+        void unmap();
+
+        uint8_t *mapping = nullptr;
+        size_t mappingLength = 0;
+        uint8_t *base = nullptr;
+        bool writable = false;
+    };
+}
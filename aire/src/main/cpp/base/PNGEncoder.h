@@ -35,7 +35,7 @@
 #include "spng/spng.h"
 #include "Eigen/Eigen"
 #include <string>
-#include "jni/JNIUtils.h"
+#include "AireError.h"
 
 namespace aire {
     class PNGEncoder {
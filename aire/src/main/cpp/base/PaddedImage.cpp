@@ -0,0 +1,148 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "PaddedImage.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "AireError.h"
+#include "concurrency.hpp"
+
+namespace aire {
+
+    static size_t alignUp(const size_t value) {
+        return (value + 63) & ~static_cast<size_t>(63);
+    }
+
+    int edgeIndex(const int i, const int size, const EdgeMode mode) {
+        if (i >= 0 && i < size) {
+            return i;
+        }
+        switch (mode) {
+            case EDGE_CLAMP:
+                return std::clamp(i, 0, size - 1);
+            case EDGE_WRAP: {
+                const int m = i % size;
+                return m < 0 ? m + size : m;
+            }
+            case EDGE_REFLECT: {
+                const int period = 2 * size;
+                int m = i % period;
+                m = m < 0 ? m + period : m;
+                return m < size ? m : period - 1 - m;
+            }
+            case EDGE_REFLECT_101: {
+                if (size == 1) {
+                    return 0;
+                }
+                const int period = 2 * size - 2;
+                int m = i % period;
+                m = m < 0 ? m + period : m;
+                return m < size ? m : period - m;
+            }
+            case EDGE_CONSTANT:
+                return -1;
+        }
+        return std::clamp(i, 0, size - 1);
+    }
+
+    void padRow(uint8_t *row, const int width, const int channels, const int pad, const EdgeMode mode,
+                const uint8_t *constant) {
+        const uint8_t zeros[8] = {0};
+        const uint8_t *fill = constant != nullptr ? constant : zeros;
+        for (int x = -pad; x < 0; ++x) {
+            const int source = edgeIndex(x, width, mode);
+            std::memcpy(row + x * channels, source < 0 ? fill : row + source * channels, channels);
+        }
+        for (int x = width; x < width + pad; ++x) {
+            const int source = edgeIndex(x, width, mode);
+            std::memcpy(row + x * channels, source < 0 ? fill : row + source * channels, channels);
+        }
+    }
+
+    PaddedImage::PaddedImage(const int width, const int height, const int channels, const int padX, const int padY) :
+            width(width), height(height), channels(channels), padX(padX), padY(padY),
+            stride(alignUp(alignUp(static_cast<size_t>(padX) * channels) + static_cast<size_t>(width + padX) * channels + 64)),
+            leading(alignUp(static_cast<size_t>(padX) * channels)) {
+        if (width <= 0 || height <= 0 || channels <= 0 || channels > 8 || padX < 0 || padY < 0) {
+            std::string msg("Invalid padded image " + std::to_string(width) + "x" + std::to_string(height) +
+                            " with " + std::to_string(channels) + " channels");
+            throw AireError(msg);
+        }
+        storage = acquireScratch(stride * (height + 2 * padY));
+    }
+
+    void PaddedImage::load(const uint8_t *src, const int srcStride, const EdgeMode mode, const uint8_t *constant) {
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    height * width / (256 * 256)), 1, 12);
+        const size_t rowBytes = static_cast<size_t>(width) * channels;
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            uint8_t *dst = row(y);
+            std::memcpy(dst, src + static_cast<size_t>(y) * srcStride, rowBytes);
+            padRow(dst, width, channels, padX, mode, constant);
+        });
+        materializeRows(mode, constant);
+    }
+
+    void PaddedImage::materialize(const EdgeMode mode, const uint8_t *constant) {
+        if (padX > 0) {
+            const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                        height * width / (256 * 256)), 1, 12);
+            concurrency::parallel_for(threadCount, height, [&](int y) {
+                padRow(row(y), width, channels, padX, mode, constant);
+            });
+        }
+        materializeRows(mode, constant);
+    }
+
+    void PaddedImage::materializeRows(const EdgeMode mode, const uint8_t *constant) {
+        const size_t paddedBytes = static_cast<size_t>(width + 2 * padX) * channels;
+        const size_t padBytes = static_cast<size_t>(padX) * channels;
+        auto fillRow = [&](int y) {
+            const int source = edgeIndex(y, height, mode);
+            uint8_t *dst = row(y) - padBytes;
+            if (source >= 0) {
+                std::memcpy(dst, row(source) - padBytes, paddedBytes);
+            } else if (constant == nullptr) {
+                std::memset(dst, 0, paddedBytes);
+            } else {
+                for (size_t x = 0; x < paddedBytes; x += channels) {
+                    std::memcpy(dst + x, constant, channels);
+                }
+            }
+        };
+        for (int y = -padY; y < 0; ++y) {
+            fillRow(y);
+        }
+        for (int y = height; y < height + padY; ++y) {
+            fillRow(y);
+        }
+    }
+}
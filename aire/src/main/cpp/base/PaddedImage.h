@@ -0,0 +1,103 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "base/ScratchArena.h"
+
+namespace aire {
+
+    /**
+     * Values match com.awxkee.aire.EdgeMode
+     */
+    enum EdgeMode {
+        EDGE_CLAMP = 0,
+        EDGE_WRAP = 1,
+        EDGE_REFLECT = 2,
+        EDGE_REFLECT_101 = 3,
+        EDGE_CONSTANT = 4
+    };
+
+    /**
+     * Maps a coordinate onto 0..<size by the edge rule, -1 when the constant border must be used
+     */
+    int edgeIndex(int i, int size, EdgeMode mode);
+
+    /**
+     * Fills pad pixels on both sides of a row, row points to the first pixel of the image
+     * @param constant - channels bytes of the constant border, nullptr is zero
+     */
+    void padRow(uint8_t *row, int width, int channels, int pad, EdgeMode mode, const uint8_t *constant = nullptr);
+
+    /**
+     * Interleaved 8 bit image surrounded by materialized borders of padX columns and padY rows,
+     * so neighbourhood kernels read up to the pad outside of the image without clamping.
+     * The first pixel of every row is 64 byte aligned and rows keep 64 bytes of slack for vector overreads
+     */
+    class PaddedImage {
+    public:
+        PaddedImage(int width, int height, int channels, int padX, int padY);
+
+        /**
+         * @param y - in -padY..<height + padY
+         */
+        uint8_t *row(int y) {
+            return storage.data() + static_cast<size_t>(y + padY) * stride + leading;
+        }
+
+        const uint8_t *row(int y) const {
+            return storage.data() + static_cast<size_t>(y + padY) * stride + leading;
+        }
+
+        /**
+         * Copies the image into the interior and materializes the borders
+         */
+        void load(const uint8_t *src, int srcStride, EdgeMode mode, const uint8_t *constant = nullptr);
+
+        /**
+         * Fills the borders from the interior
+         */
+        void materialize(EdgeMode mode, const uint8_t *constant = nullptr);
+
+        const int width;
+        const int height;
+        const int channels;
+        const int padX;
+        const int padY;
+        const size_t stride;
+
+    private:
+        void materializeRows(EdgeMode mode, const uint8_t *constant);
+
+        const size_t leading;
+        ScratchLease storage;
+    };
+}
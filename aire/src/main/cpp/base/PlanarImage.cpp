@@ -0,0 +1,354 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/PlanarImage.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "PlanarImage.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <type_traits>
+#include "AireError.h"
+#include "concurrency.hpp"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    void deinterleaveRowU8HWY(const uint8_t *src, uint8_t *const *dst, const int channels, const int width,
+                              const float) {
+        const ScalableTag<uint8_t> du;
+        using VU = Vec<decltype(du)>;
+        const int lanes = Lanes(du);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            VU r, g, b, a;
+            LoadInterleaved4(du, src + x * 4, r, g, b, a);
+            StoreU(r, du, dst[0] + x);
+            StoreU(g, du, dst[1] + x);
+            StoreU(b, du, dst[2] + x);
+            if (channels == 4) {
+                StoreU(a, du, dst[3] + x);
+            }
+        }
+        for (; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                dst[c][x] = src[x * 4 + c];
+            }
+        }
+    }
+
+    void deinterleaveRowU16HWY(const uint8_t *src, uint16_t *const *dst, const int channels, const int width,
+                               const float) {
+        const ScalableTag<uint16_t> du16;
+        const Rebind<uint8_t, decltype(du16)> du8;
+        using VU = Vec<decltype(du8)>;
+        const int lanes = Lanes(du16);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            VU r, g, b, a;
+            LoadInterleaved4(du8, src + x * 4, r, g, b, a);
+            StoreU(PromoteTo(du16, r), du16, dst[0] + x);
+            StoreU(PromoteTo(du16, g), du16, dst[1] + x);
+            StoreU(PromoteTo(du16, b), du16, dst[2] + x);
+            if (channels == 4) {
+                StoreU(PromoteTo(du16, a), du16, dst[3] + x);
+            }
+        }
+        for (; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                dst[c][x] = src[x * 4 + c];
+            }
+        }
+    }
+
+    void deinterleaveRowF32HWY(const uint8_t *src, float *const *dst, const int channels, const int width,
+                               const float scale) {
+        const ScalableTag<float> df;
+        const Rebind<uint32_t, decltype(df)> du32;
+        const Rebind<uint8_t, decltype(df)> du8;
+        using VU = Vec<decltype(du8)>;
+        const auto vScale = Set(df, scale);
+        const int lanes = Lanes(df);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            VU r, g, b, a;
+            LoadInterleaved4(du8, src + x * 4, r, g, b, a);
+            StoreU(Mul(ConvertTo(df, PromoteTo(du32, r)), vScale), df, dst[0] + x);
+            StoreU(Mul(ConvertTo(df, PromoteTo(du32, g)), vScale), df, dst[1] + x);
+            StoreU(Mul(ConvertTo(df, PromoteTo(du32, b)), vScale), df, dst[2] + x);
+            if (channels == 4) {
+                StoreU(Mul(ConvertTo(df, PromoteTo(du32, a)), vScale), df, dst[3] + x);
+            }
+        }
+        for (; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                dst[c][x] = static_cast<float>(src[x * 4 + c]) * scale;
+            }
+        }
+    }
+
+    void deinterleaveRowF16HWY(const uint8_t *src, hwy::float16_t *const *dst, const int channels, const int width,
+                               const float scale) {
+        const ScalableTag<float> df;
+        const Rebind<uint32_t, decltype(df)> du32;
+        const Rebind<uint8_t, decltype(df)> du8;
+        const Rebind<hwy::float16_t, decltype(df)> dh;
+        using VU = Vec<decltype(du8)>;
+        const auto vScale = Set(df, scale);
+        const int lanes = Lanes(df);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            VU r, g, b, a;
+            LoadInterleaved4(du8, src + x * 4, r, g, b, a);
+            StoreU(DemoteTo(dh, Mul(ConvertTo(df, PromoteTo(du32, r)), vScale)), dh, dst[0] + x);
+            StoreU(DemoteTo(dh, Mul(ConvertTo(df, PromoteTo(du32, g)), vScale)), dh, dst[1] + x);
+            StoreU(DemoteTo(dh, Mul(ConvertTo(df, PromoteTo(du32, b)), vScale)), dh, dst[2] + x);
+            if (channels == 4) {
+                StoreU(DemoteTo(dh, Mul(ConvertTo(df, PromoteTo(du32, a)), vScale)), dh, dst[3] + x);
+            }
+        }
+        for (; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                dst[c][x] = hwy::F16FromF32(static_cast<float>(src[x * 4 + c]) * scale);
+            }
+        }
+    }
+
+    void interleaveRowU8HWY(const uint8_t *const *src, uint8_t *dst, const int channels, const int width,
+                            const float) {
+        const ScalableTag<uint8_t> du;
+        using VU = Vec<decltype(du)>;
+        const int lanes = Lanes(du);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            VU r, g, b, a;
+            if (channels == 4) {
+                a = LoadU(du, src[3] + x);
+            } else {
+                LoadInterleaved4(du, dst + x * 4, r, g, b, a);
+            }
+            StoreInterleaved4(LoadU(du, src[0] + x), LoadU(du, src[1] + x), LoadU(du, src[2] + x), a,
+                              du, dst + x * 4);
+        }
+        for (; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                dst[x * 4 + c] = src[c][x];
+            }
+        }
+    }
+
+    void interleaveRowU16HWY(const uint16_t *const *src, uint8_t *dst, const int channels, const int width,
+                             const float) {
+        const ScalableTag<uint16_t> du16;
+        const Rebind<uint8_t, decltype(du16)> du8;
+        using VU = Vec<decltype(du8)>;
+        const int lanes = Lanes(du16);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            VU r, g, b, a;
+            if (channels == 4) {
+                a = DemoteTo(du8, LoadU(du16, src[3] + x));
+            } else {
+                LoadInterleaved4(du8, dst + x * 4, r, g, b, a);
+            }
+            StoreInterleaved4(DemoteTo(du8, LoadU(du16, src[0] + x)), DemoteTo(du8, LoadU(du16, src[1] + x)),
+                              DemoteTo(du8, LoadU(du16, src[2] + x)), a, du8, dst + x * 4);
+        }
+        for (; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                dst[x * 4 + c] = static_cast<uint8_t>(std::min(src[c][x], static_cast<uint16_t>(255)));
+            }
+        }
+    }
+
+    // Native rounding conversion, emulated Round does not survive fast math, demotion saturates
+    template<class DF, class V = Vec<DF>>
+    HWY_INLINE Vec<Rebind<uint8_t, DF>> floatToU8(DF, V v, V scale) {
+        const Rebind<uint8_t, DF> du8;
+        return DemoteTo(du8, NearestInt(Mul(v, scale)));
+    }
+
+    void interleaveRowF32HWY(const float *const *src, uint8_t *dst, const int channels, const int width,
+                             const float scale) {
+        const ScalableTag<float> df;
+        const Rebind<uint8_t, decltype(df)> du8;
+        using VU = Vec<decltype(du8)>;
+        const float inverse = 1.f / scale;
+        const auto vInverse = Set(df, inverse);
+        const int lanes = Lanes(df);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            VU r, g, b, a;
+            if (channels == 4) {
+                a = floatToU8(df, LoadU(df, src[3] + x), vInverse);
+            } else {
+                LoadInterleaved4(du8, dst + x * 4, r, g, b, a);
+            }
+            StoreInterleaved4(floatToU8(df, LoadU(df, src[0] + x), vInverse),
+                              floatToU8(df, LoadU(df, src[1] + x), vInverse),
+                              floatToU8(df, LoadU(df, src[2] + x), vInverse), a, du8, dst + x * 4);
+        }
+        for (; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                dst[x * 4 + c] = static_cast<uint8_t>(std::clamp(std::nearbyint(src[c][x] * inverse), 0.f, 255.f));
+            }
+        }
+    }
+
+    void interleaveRowF16HWY(const hwy::float16_t *const *src, uint8_t *dst, const int channels, const int width,
+                             const float scale) {
+        const ScalableTag<float> df;
+        const Rebind<uint8_t, decltype(df)> du8;
+        const Rebind<hwy::float16_t, decltype(df)> dh;
+        using VU = Vec<decltype(du8)>;
+        const float inverse = 1.f / scale;
+        const auto vInverse = Set(df, inverse);
+        const int lanes = Lanes(df);
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            VU r, g, b, a;
+            if (channels == 4) {
+                a = floatToU8(df, PromoteTo(df, LoadU(dh, src[3] + x)), vInverse);
+            } else {
+                LoadInterleaved4(du8, dst + x * 4, r, g, b, a);
+            }
+            StoreInterleaved4(floatToU8(df, PromoteTo(df, LoadU(dh, src[0] + x)), vInverse),
+                              floatToU8(df, PromoteTo(df, LoadU(dh, src[1] + x)), vInverse),
+                              floatToU8(df, PromoteTo(df, LoadU(dh, src[2] + x)), vInverse), a, du8, dst + x * 4);
+        }
+        for (; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                const float value = hwy::F32FromF16(src[c][x]) * inverse;
+                dst[x * 4 + c] = static_cast<uint8_t>(std::clamp(std::nearbyint(value), 0.f, 255.f));
+            }
+        }
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(deinterleaveRowU8HWY);
+    HWY_EXPORT(deinterleaveRowU16HWY);
+    HWY_EXPORT(deinterleaveRowF16HWY);
+    HWY_EXPORT(deinterleaveRowF32HWY);
+    HWY_EXPORT(interleaveRowU8HWY);
+    HWY_EXPORT(interleaveRowU16HWY);
+    HWY_EXPORT(interleaveRowF16HWY);
+    HWY_EXPORT(interleaveRowF32HWY);
+
+    template<typename T>
+    PlanarImage<T>::PlanarImage(const int width, const int height, const int channels) :
+            width(width), height(height), channels(channels),
+            planeSize(((static_cast<size_t>(width) * height * sizeof(T) + 63) & ~static_cast<size_t>(63)) / sizeof(T)) {
+        if (width <= 0 || height <= 0 || (channels != 3 && channels != 4)) {
+            std::string msg("Invalid planar image " + std::to_string(width) + "x" + std::to_string(height) +
+                            " with " + std::to_string(channels) + " channels");
+            throw AireError(msg);
+        }
+        storage = acquireScratch(planeSize * channels * sizeof(T));
+    }
+
+    template<typename T>
+    static void deinterleaveRow(const uint8_t *src, T *const *dst, int channels, int width, float scale) {
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            HWY_DYNAMIC_DISPATCH(deinterleaveRowU8HWY)(src, dst, channels, width, scale);
+        } else if constexpr (std::is_same_v<T, uint16_t>) {
+            HWY_DYNAMIC_DISPATCH(deinterleaveRowU16HWY)(src, dst, channels, width, scale);
+        } else if constexpr (std::is_same_v<T, hwy::float16_t>) {
+            HWY_DYNAMIC_DISPATCH(deinterleaveRowF16HWY)(src, dst, channels, width, scale);
+        } else {
+            HWY_DYNAMIC_DISPATCH(deinterleaveRowF32HWY)(src, dst, channels, width, scale);
+        }
+    }
+
+    template<typename T>
+    static void interleaveRow(const T *const *src, uint8_t *dst, int channels, int width, float scale) {
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            HWY_DYNAMIC_DISPATCH(interleaveRowU8HWY)(src, dst, channels, width, scale);
+        } else if constexpr (std::is_same_v<T, uint16_t>) {
+            HWY_DYNAMIC_DISPATCH(interleaveRowU16HWY)(src, dst, channels, width, scale);
+        } else if constexpr (std::is_same_v<T, hwy::float16_t>) {
+            HWY_DYNAMIC_DISPATCH(interleaveRowF16HWY)(src, dst, channels, width, scale);
+        } else {
+            HWY_DYNAMIC_DISPATCH(interleaveRowF32HWY)(src, dst, channels, width, scale);
+        }
+    }
+
+    template<typename T>
+    void deinterleave(const uint8_t *src, const int stride, PlanarImage<T> &planes, const float scale) {
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    planes.height * planes.width / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, planes.height, [&](int y) {
+            T *rows[4] = {};
+            for (int c = 0; c < planes.channels; ++c) {
+                rows[c] = planes.row(c, y);
+            }
+            deinterleaveRow<T>(src + static_cast<size_t>(y) * stride, rows, planes.channels, planes.width, scale);
+        });
+    }
+
+    template<typename T>
+    void interleave(const PlanarImage<T> &planes, uint8_t *dst, const int stride, const float scale) {
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    planes.height * planes.width / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, planes.height, [&](int y) {
+            const T *rows[4] = {};
+            for (int c = 0; c < planes.channels; ++c) {
+                rows[c] = planes.row(c, y);
+            }
+            interleaveRow<T>(rows, dst + static_cast<size_t>(y) * stride, planes.channels, planes.width, scale);
+        });
+    }
+
+    template class PlanarImage<uint8_t>;
+    template class PlanarImage<uint16_t>;
+    template class PlanarImage<hwy::float16_t>;
+    template class PlanarImage<float>;
+
+    template void deinterleave(const uint8_t *, int, PlanarImage<uint8_t> &, float);
+    template void deinterleave(const uint8_t *, int, PlanarImage<uint16_t> &, float);
+    template void deinterleave(const uint8_t *, int, PlanarImage<hwy::float16_t> &, float);
+    template void deinterleave(const uint8_t *, int, PlanarImage<float> &, float);
+
+    template void interleave(const PlanarImage<uint8_t> &, uint8_t *, int, float);
+    template void interleave(const PlanarImage<uint16_t> &, uint8_t *, int, float);
+    template void interleave(const PlanarImage<hwy::float16_t> &, uint8_t *, int, float);
+    template void interleave(const PlanarImage<float> &, uint8_t *, int, float);
+}
+#endif
@@ -0,0 +1,90 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "hwy/base.h"
+#include "base/ScratchArena.h"
+
+namespace aire {
+
+    /**
+     * Working image of separate channel planes for multi stage kernels.
+     * Every plane is a dense width * height array starting 64 byte aligned, so plane kernels run on
+     * contiguous full width vectors. Supported element types are uint8_t, uint16_t, hwy::float16_t and float
+     */
+    template<typename T>
+    class PlanarImage {
+    public:
+        /**
+         * @param channels - 3 holds RGB and leaves alpha of the interleaved image untouched, 4 holds RGBA
+         */
+        PlanarImage(int width, int height, int channels);
+
+        T *plane(int channel) {
+            return storage.data<T>() + planeSize * channel;
+        }
+
+        const T *plane(int channel) const {
+            return storage.data<T>() + planeSize * channel;
+        }
+
+        T *row(int channel, int y) {
+            return plane(channel) + static_cast<size_t>(y) * width;
+        }
+
+        const T *row(int channel, int y) const {
+            return plane(channel) + static_cast<size_t>(y) * width;
+        }
+
+        const int width;
+        const int height;
+        const int channels;
+
+    private:
+        const size_t planeSize;
+        ScratchLease storage;
+    };
+
+    /**
+     * Splits RGBA8888 into planes converting on the fly, float planes receive value * scale
+     */
+    template<typename T>
+    void deinterleave(const uint8_t *src, int stride, PlanarImage<T> &planes, float scale = 1.f);
+
+    /**
+     * Merges planes back into RGBA8888, float planes are divided by scale, rounded and saturated.
+     * Alpha of the destination is kept when planes hold only RGB
+     */
+    template<typename T>
+    void interleave(const PlanarImage<T> &planes, uint8_t *dst, int stride, float scale = 1.f);
+}
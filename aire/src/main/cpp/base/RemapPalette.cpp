@@ -34,28 +34,37 @@
 #include "KDColorTree.hpp"
 #include <exception>
 #include "NearestColorSearch.hpp"
+#include "SimdNearestSearch.h"
+#include "ScratchArena.h"
+#include "concurrency.hpp"
+#include <memory>
+#include <thread>
 
 namespace aire {
 
+    static int remapThreads(int width, int height) {
+        return std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                   width * height / (256 * 256)), 1, 12);
+    }
+
     std::vector<uint8_t> RemapPalette::indexed() {
         std::vector<uint8_t> destination(width * height);
 
-        LinearNearestSearch linear(this->palette);
+        // Indices refer to the palette as given, so the search keeps its order
+        SimdNearestSearch search(this->palette);
 
-        for (int y = 0; y < height; ++y) {
+        concurrency::parallel_for(remapThreads(width, height), height, [&](int y) {
+            uint16_t indices[256];
             auto src = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
             auto dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(destination.data()) + y * width);
-            for (int x = 0; x < width; ++x) {
-                uint32_t clr = reinterpret_cast<uint32_t *>(src)[0];
-                Eigen::Vector4i original = unpackRGBA(clr);
-                auto color = linear.findClosestIndex(original);
-
-                dst[0] = color;
-
-                src += 4;
-                dst += 1;
+            for (int x = 0; x < width; x += 256) {
+                const int count = std::min(256, width - x);
+                search.findClosestIndices(src + x * 4, count, indices);
+                for (int i = 0; i < count; ++i) {
+                    dst[x + i] = static_cast<uint8_t>(indices[i]);
+                }
             }
-        }
+        });
 
         return std::move(destination);
     }
@@ -64,6 +73,9 @@ namespace aire {
         std::vector<uint8_t> destination(stride * height);
 
         std::unique_ptr<NearestColorSearch> search;
+        // Nearest entries for the SIMD strategy are found for the whole image upfront in parallel
+        ScratchLease nearestLease;
+        uint16_t *nearest = nullptr;
         switch (strategy) {
             case Remap_Search_KD:
                 search = std::make_unique<KDNearestSearch>(palette);
@@ -71,6 +83,16 @@ namespace aire {
             case Remap_Search_Cover:
                 search = std::make_unique<CoverNearestSearch>(palette);
                 break;
+            case Remap_Search_Simd: {
+                auto simd = std::make_unique<SimdNearestSearch>(palette);
+                nearestLease = acquireScratch(static_cast<size_t>(width) * height * sizeof(uint16_t));
+                nearest = nearestLease.data<uint16_t>();
+                concurrency::parallel_for(remapThreads(width, height), height, [&](int y) {
+                    simd->findClosestIndices(data + y * stride, width, nearest + static_cast<size_t>(y) * width);
+                });
+                search = std::move(simd);
+            }
+                break;
             default:
                 search = std::make_unique<LinearNearestSearch>(palette);
                 break;
@@ -82,7 +104,9 @@ namespace aire {
             for (int x = 0; x < width; ++x) {
                 uint32_t clr = reinterpret_cast<uint32_t *>(src)[0];
                 Eigen::Vector4i original = unpackRGBA(clr);
-                auto color = search->getNearest(original);
+                Eigen::Vector4i color = nearest != nullptr
+                                        ? static_cast<SimdNearestSearch *>(search.get())->color(nearest[y * width + x])
+                                        : search->getNearest(original);
 
                 dst[x * 4 + 0] = color.x();
                 dst[x * 4 + 1] = color.y();
@@ -45,7 +45,8 @@ namespace aire {
     enum RemapMappingStrategy {
         Remap_Search_Linear = 0,
         Remap_Search_KD = 1,
-        Remap_Search_Cover = 2
+        Remap_Search_Cover = 2,
+        Remap_Search_Simd = 3
     };
 
     class RemapPalette {
@@ -0,0 +1,197 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/ResultCache.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+#include "ResultCache.h"
+#include "SimdTargets.h"
+#include <cstring>
+#include <string>
+#include <algorithm>
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    /**
+     * Multiply accumulate hash over vector wide stripes, every stripe is keyed by it's offset
+     * so permuted blocks do not collide, lanes are scrambled after every row
+     */
+    void hashPixelsHWY(const uint8_t *data, const int stride, const int rowBytes, const int height,
+                       const uint64_t seed, uint64_t *out) {
+        const ScalableTag<uint64_t> d64;
+        const Repartition<uint32_t, decltype(d64)> d32;
+        const Repartition<uint8_t, decltype(d64)> du8;
+        using V64 = Vec<decltype(d64)>;
+        const int lanes8 = static_cast<int>(Lanes(du8));
+        const int lanes64 = static_cast<int>(Lanes(d64));
+
+        const V64 keyStep = Set(d64, ResultKey::kPrime2);
+        const auto scramble = Set(d32, 0x9E3779B1U);
+        V64 acc = Xor(Set(d64, seed), Mul(Iota(d64, 1), Set(d64, ResultKey::kPrime1)));
+
+        auto stripe = [&](const V64 v, const V64 key) {
+            const V64 keyed = Xor(v, key);
+            const V64 product = MulEven(BitCast(d32, keyed), BitCast(d32, ShiftRight<32>(keyed)));
+            acc = Add(acc, Add(product, v));
+        };
+
+        std::vector<uint8_t> tail(lanes8, 0);
+        for (int y = 0; y < height; ++y) {
+            const uint8_t *row = data + static_cast<size_t>(y) * stride;
+            V64 key = Add(Set(d64, static_cast<uint64_t>(y) * ResultKey::kPrime1), Iota(d64, 0));
+            int x = 0;
+            for (; x + lanes8 <= rowBytes; x += lanes8) {
+                stripe(BitCast(d64, LoadU(du8, row + x)), key);
+                key = Add(key, keyStep);
+            }
+            if (x < rowBytes) {
+                std::fill(tail.begin(), tail.end(), 0);
+                std::memcpy(tail.data(), row + x, rowBytes - x);
+                stripe(BitCast(d64, LoadU(du8, tail.data())), Xor(key, Set(d64, rowBytes - x)));
+            }
+            acc = Xor(acc, ShiftRight<47>(acc));
+            const V64 low = MulEven(BitCast(d32, acc), scramble);
+            const V64 high = MulEven(BitCast(d32, ShiftRight<32>(acc)), scramble);
+            acc = Add(low, ShiftLeft<32>(high));
+        }
+
+        std::vector<uint64_t> accumulators(lanes64);
+        StoreU(acc, d64, accumulators.data());
+        uint64_t first = seed;
+        uint64_t second = ~seed;
+        for (int i = 0; i < lanes64; ++i) {
+            first = ResultKey::mix(first ^ accumulators[i]);
+            second = ResultKey::mix(second + accumulators[i] * ResultKey::kPrime2);
+        }
+        out[0] = first;
+        out[1] = second;
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(hashPixelsHWY);
+
+    ResultKey::ResultKey(const char *operation) : low(kPrime1), high(kPrime2) {
+        bytes(operation, std::strlen(operation));
+    }
+
+    ResultKey &ResultKey::bytes(const void *data, size_t size) {
+        auto source = reinterpret_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; i += 8) {
+            uint64_t chunk = 0;
+            std::memcpy(&chunk, source + i, std::min<size_t>(8, size - i));
+            low = mix(low ^ chunk);
+            high = mix(high + chunk * kPrime1 + size);
+        }
+        return *this;
+    }
+
+    ResultKey &ResultKey::pixels(const uint8_t *data, int stride, int rowBytes, int height) {
+        const std::string target = activeSimdTarget();
+        bytes(target.data(), target.size());
+        uint64_t digest[2];
+        HWY_DYNAMIC_DISPATCH(hashPixelsHWY)(data, stride, rowBytes, height, low ^ high, digest);
+        low = mix(low ^ digest[0]);
+        high = mix(high ^ digest[1]);
+        return *this;
+    }
+
+    ResultCache &ResultCache::shared() {
+        static ResultCache cache;
+        return cache;
+    }
+
+    void ResultCache::setBudget(size_t bytesBudget) {
+        std::lock_guard<std::mutex> lock(mutex);
+        budget.store(bytesBudget, std::memory_order_relaxed);
+        evictLocked();
+    }
+
+    std::shared_ptr<const CachedImage> ResultCache::find(const ResultKey &key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            counters.misses += 1;
+            return nullptr;
+        }
+        counters.hits += 1;
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->image;
+    }
+
+    void ResultCache::insert(const ResultKey &key, std::shared_ptr<const CachedImage> image) {
+        const size_t size = image->data.size();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (size > budget.load(std::memory_order_relaxed) || index.find(key) != index.end()) {
+            return;
+        }
+        entries.push_front({key, std::move(image)});
+        index[key] = entries.begin();
+        bytes += size;
+        evictLocked();
+    }
+
+    void ResultCache::evictLocked() {
+        const size_t limit = budget.load(std::memory_order_relaxed);
+        while (bytes > limit && !entries.empty()) {
+            const Entry &last = entries.back();
+            bytes -= last.image->data.size();
+            index.erase(last.key);
+            entries.pop_back();
+            counters.evictions += 1;
+        }
+    }
+
+    void ResultCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+        bytes = 0;
+    }
+
+    ResultCacheStats ResultCache::stats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ResultCacheStats result = counters;
+        result.entries = entries.size();
+        result.bytes = bytes;
+        result.budget = budget.load(std::memory_order_relaxed);
+        return result;
+    }
+}
+#endif
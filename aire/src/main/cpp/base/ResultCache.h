@@ -0,0 +1,149 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace aire {
+
+    /**
+     * 128 bit digest of an operation, it's parameters and input pixels.
+     * Pixel digest includes the active SIMD target, so results of different targets never alias
+     */
+    class ResultKey {
+    public:
+        static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+        static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+        static uint64_t mix(uint64_t value) {
+            value ^= value >> 33;
+            value *= 0xFF51AFD7ED558CCDULL;
+            value ^= value >> 33;
+            value *= 0xC4CEB9FE1A85EC53ULL;
+            value ^= value >> 33;
+            return value;
+        }
+
+        explicit ResultKey(const char *operation);
+
+        ResultKey &bytes(const void *data, size_t size);
+
+        template<typename T>
+        ResultKey &with(const T &value) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be hashed");
+            return bytes(&value, sizeof(T));
+        }
+
+        template<typename T>
+        ResultKey &with(const std::vector<T> &values) {
+            with(values.size());
+            return bytes(values.data(), values.size() * sizeof(T));
+        }
+
+        ResultKey &pixels(const uint8_t *data, int stride, int rowBytes, int height);
+
+        bool operator==(const ResultKey &other) const {
+            return low == other.low && high == other.high;
+        }
+
+        uint64_t low;
+        uint64_t high;
+    };
+
+    struct ResultKeyHash {
+        size_t operator()(const ResultKey &key) const {
+            return static_cast<size_t>(key.low);
+        }
+    };
+
+    struct CachedImage {
+        std::vector<uint8_t> data;
+        int stride = 0;
+        int width = 0;
+        int height = 0;
+        int format = 0;
+    };
+
+    struct ResultCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t entries = 0;
+        uint64_t bytes = 0;
+        uint64_t budget = 0;
+    };
+
+    /**
+     * Process wide LRU cache of filter results, disabled until budget is set.
+     * Entries larger than the whole budget are never stored
+     */
+    class ResultCache {
+    public:
+        static ResultCache &shared();
+
+        bool enabled() const {
+            return budget.load(std::memory_order_relaxed) != 0;
+        }
+
+        void setBudget(size_t bytes);
+
+        std::shared_ptr<const CachedImage> find(const ResultKey &key);
+
+        void insert(const ResultKey &key, std::shared_ptr<const CachedImage> image);
+
+        void clear();
+
+        ResultCacheStats stats();
+
+    private:
+        struct Entry {
+            ResultKey key;
+            std::shared_ptr<const CachedImage> image;
+        };
+
+        void evictLocked();
+
+        std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<ResultKey, std::list<Entry>::iterator, ResultKeyHash> index;
+        size_t bytes = 0;
+        std::atomic<size_t> budget{0};
+        ResultCacheStats counters;
+    };
+}
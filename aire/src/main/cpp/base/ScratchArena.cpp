@@ -0,0 +1,183 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "ScratchArena.h"
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <sys/mman.h>
+#include "Instrumentation.h"
+
+namespace aire {
+
+    static constexpr size_t kScratchAlignment = 64;
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+    ScratchLease::ScratchLease(ScratchLease &&other) noexcept:
+            arena(other.arena), block(other.block), requested(other.requested) {
+        other.arena = nullptr;
+        other.block = ScratchBlock();
+        other.requested = 0;
+    }
+
+    ScratchLease &ScratchLease::operator=(ScratchLease &&other) noexcept {
+        if (this != &other) {
+            reset();
+            arena = other.arena;
+            block = other.block;
+            requested = other.requested;
+            other.arena = nullptr;
+            other.block = ScratchBlock();
+            other.requested = 0;
+        }
+        return *this;
+    }
+
+    ScratchLease::~ScratchLease() {
+        reset();
+    }
+
+    void ScratchLease::reset() {
+        if (arena != nullptr && block.pointer != nullptr) {
+            arena->release(block);
+        }
+        arena = nullptr;
+        block = ScratchBlock();
+        requested = 0;
+    }
+
+    ScratchArena &ScratchArena::shared() {
+        static ScratchArena arena;
+        return arena;
+    }
+
+    ScratchBlock ScratchArena::allocate(size_t size) {
+        ScratchBlock block;
+        if (size >= kHugePageSize) {
+            block.capacity = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+            void *pointer = mmap(nullptr, block.capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (pointer == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+#if defined(MADV_HUGEPAGE)
+            madvise(pointer, block.capacity, MADV_HUGEPAGE);
+#endif
+            block.pointer = reinterpret_cast<uint8_t *>(pointer);
+            block.mapped = true;
+        } else {
+            block.capacity = std::max((size + kScratchAlignment - 1) / kScratchAlignment * kScratchAlignment,
+                                      kScratchAlignment);
+            block.pointer = reinterpret_cast<uint8_t *>(aligned_alloc(kScratchAlignment, block.capacity));
+            if (block.pointer == nullptr) {
+                throw std::bad_alloc();
+            }
+        }
+        return block;
+    }
+
+    void ScratchArena::deallocate(const ScratchBlock &block) {
+        if (block.mapped) {
+            munmap(block.pointer, block.capacity);
+        } else {
+            free(block.pointer);
+        }
+    }
+
+    ScratchLease ScratchArena::acquire(size_t size) {
+        Instrumentation::count(COUNTER_SCRATCH_REQUESTED, size);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            int best = -1;
+            for (int i = 0; i < idle.size(); ++i) {
+                const size_t capacity = idle[i].capacity;
+                if (capacity >= size && capacity / 2 <= size &&
+                    (best == -1 || capacity < idle[best].capacity)) {
+                    best = i;
+                }
+            }
+            if (best != -1) {
+                const ScratchBlock block = idle[best];
+                idle.erase(idle.begin() + best);
+                idleBytes -= block.capacity;
+                leasedBytes += block.capacity;
+                highWaterMark = std::max(highWaterMark, leasedBytes);
+                Instrumentation::count(COUNTER_SCRATCH_REUSED, 1);
+                return ScratchLease(this, block, size);
+            }
+        }
+
+        const ScratchBlock block = allocate(size);
+        Instrumentation::count(COUNTER_SCRATCH_ALLOCATED, block.capacity);
+        std::lock_guard<std::mutex> lock(mutex);
+        leasedBytes += block.capacity;
+        highWaterMark = std::max(highWaterMark, leasedBytes);
+        return ScratchLease(this, block, size);
+    }
+
+    void ScratchArena::release(const ScratchBlock &block) {
+        std::lock_guard<std::mutex> lock(mutex);
+        leasedBytes -= block.capacity;
+        idle.push_back(block);
+        idleBytes += block.capacity;
+        evictLocked();
+    }
+
+    void ScratchArena::evictLocked() {
+        const size_t limit = std::min(highWaterMark, retainLimit);
+        while (idleBytes > limit && !idle.empty()) {
+            const ScratchBlock oldest = idle.front();
+            idle.erase(idle.begin());
+            idleBytes -= oldest.capacity;
+            deallocate(oldest);
+        }
+    }
+
+    void ScratchArena::trim() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &block: idle) {
+            deallocate(block);
+        }
+        idle.clear();
+        idleBytes = 0;
+        highWaterMark = leasedBytes;
+    }
+
+    void ScratchArena::setRetainLimit(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        retainLimit = bytes;
+        evictLocked();
+    }
+
+    ScratchArena::~ScratchArena() {
+        for (const auto &block: idle) {
+            deallocate(block);
+        }
+    }
+}
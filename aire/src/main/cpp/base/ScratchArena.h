@@ -0,0 +1,129 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace aire {
+
+    struct ScratchBlock {
+        uint8_t *pointer = nullptr;
+        size_t capacity = 0;
+        bool mapped = false;
+    };
+
+    class ScratchArena;
+
+    /**
+     * Exclusive ownership of uninitialized 64 byte aligned buffer, returned to the arena on destruction
+     */
+    class ScratchLease {
+    public:
+        ScratchLease() = default;
+
+        ScratchLease(ScratchLease &&other) noexcept;
+
+        ScratchLease &operator=(ScratchLease &&other) noexcept;
+
+        ScratchLease(const ScratchLease &) = delete;
+
+        ScratchLease &operator=(const ScratchLease &) = delete;
+
+        ~ScratchLease();
+
+        template<typename T = uint8_t>
+        T *data() const {
+            return reinterpret_cast<T *>(block.pointer);
+        }
+
+        size_t size() const {
+            return requested;
+        }
+
+    private:
+        friend class ScratchArena;
+
+        ScratchLease(ScratchArena *arena, const ScratchBlock &block, size_t requested) :
+                arena(arena), block(block), requested(requested) {}
+
+        void reset();
+
+        ScratchArena *arena = nullptr;
+        ScratchBlock block;
+        size_t requested = 0;
+    };
+
+    /**
+     * Process wide pool of frame sized buffers.
+     * Idle buffers are kept up to the peak amount of simultaneously leased memory and never more than retain limit,
+     * large buffers are mapped directly and advised to use huge pages
+     */
+    class ScratchArena {
+    public:
+        static ScratchArena &shared();
+
+        ScratchLease acquire(size_t size);
+
+        /**
+         * Releases all idle buffers and resets high water mark
+         */
+        void trim();
+
+        void setRetainLimit(size_t bytes);
+
+        ~ScratchArena();
+
+    private:
+        friend class ScratchLease;
+
+        void release(const ScratchBlock &block);
+
+        void evictLocked();
+
+        static ScratchBlock allocate(size_t size);
+
+        static void deallocate(const ScratchBlock &block);
+
+        std::mutex mutex;
+        std::vector<ScratchBlock> idle;
+        size_t idleBytes = 0;
+        size_t leasedBytes = 0;
+        size_t highWaterMark = 0;
+        size_t retainLimit = 256 * 1024 * 1024;
+    };
+
+    static inline ScratchLease acquireScratch(size_t size) {
+        return ScratchArena::shared().acquire(size);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "SimdTargets.h"
+#include <algorithm>
+#include <mutex>
+#include "hwy/highway.h"
+#include "hwy/targets.h"
+#include "AireError.h"
+
+namespace aire {
+
+    static std::mutex simdTargetsLock;
+
+    /**
+     * Captured on the first use, before anything is forced, since forcing hides other targets from Highway
+     */
+    static const std::vector<int64_t> &availableSimdTargets() {
+        static const std::vector<int64_t> targets = hwy::SupportedAndGeneratedTargets();
+        return targets;
+    }
+
+    static bool sameTargetName(const std::string &lhs, const std::string &rhs) {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+            return std::toupper(static_cast<unsigned char>(a)) == std::toupper(static_cast<unsigned char>(b));
+        });
+    }
+
+    std::vector<std::string> simdTargets() {
+        std::vector<std::string> names;
+        for (const int64_t target: availableSimdTargets()) {
+            names.emplace_back(hwy::TargetName(target));
+        }
+        return names;
+    }
+
+    std::string activeSimdTarget() {
+        availableSimdTargets();
+        const int64_t targets = hwy::SupportedTargets() & HWY_TARGETS;
+        // Lower bits are the better targets, dispatch takes the best one left
+        const int64_t active = targets != 0 ? targets & -targets : HWY_STATIC_TARGET;
+        return hwy::TargetName(active);
+    }
+
+    void forceSimdTarget(const std::string &target) {
+        std::lock_guard<std::mutex> lock(simdTargetsLock);
+        const auto &targets = availableSimdTargets();
+        if (target.empty()) {
+            hwy::DisableTargets(0);
+            return;
+        }
+        for (const int64_t candidate: targets) {
+            if (sameTargetName(hwy::TargetName(candidate), target)) {
+                hwy::DisableTargets(~candidate);
+                return;
+            }
+        }
+        std::string msg("SIMD target " + target + " is not available, supported targets are:");
+        for (const int64_t candidate: targets) {
+            msg += " ";
+            msg += hwy::TargetName(candidate);
+        }
+        throw AireError(msg);
+    }
+}
@@ -0,0 +1,217 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/SummedAreaTable.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+#include "SummedAreaTable.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "AireError.h"
+#include "concurrency.hpp"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    static int summedAreaThreads(const int width, const int height) {
+        return std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                   width * height / (256 * 256)), 1, 12);
+    }
+
+    /**
+     * Turns rows of running sums into the table by accumulating them top to bottom
+     */
+    template<typename T>
+    void summedAreaColumns(SummedAreaTable<T> &table, const int threadCount) {
+        constexpr int stripElements = SummedAreaTable<T>::kRowAlignment / sizeof(T);
+        const int strips = static_cast<int>(table.pitch / stripElements);
+        concurrency::parallel_for(threadCount, strips, [&](int strip) {
+            for (int y = 2; y <= table.height; ++y) {
+                const T *previous = table.row(y - 1) + strip * stripElements;
+                T *current = table.row(y) + strip * stripElements;
+#if !HWY_HAVE_FLOAT64
+                if constexpr (std::is_same_v<T, double>) {
+                    for (int i = 0; i < stripElements; ++i) {
+                        current[i] += previous[i];
+                    }
+                } else
+#endif
+                {
+                    const ScalableTag<T> d;
+                    const int lanes = Lanes(d);
+                    for (int i = 0; i < stripElements; i += lanes) {
+                        StoreU(Add(LoadU(d, current + i), LoadU(d, previous + i)), d, current + i);
+                    }
+                }
+            }
+        });
+    }
+
+    void summedAreaTableU8HWY(const uint8_t *data, const int stride, SummedAreaTable<uint32_t> &table) {
+        const int threadCount = summedAreaThreads(table.width, table.height);
+        concurrency::parallel_for(threadCount, table.height, [&](int y) {
+            const uint8_t *src = data + y * stride;
+            uint32_t *dst = table.row(y + 1) + table.channels;
+            if (table.channels == 4) {
+                const FixedTag<uint32_t, 4> du;
+                const FixedTag<uint8_t, 4> du8;
+                auto acc = Zero(du);
+                for (int x = 0; x < table.width; ++x) {
+                    acc = Add(acc, PromoteTo(du, LoadU(du8, src + x * 4)));
+                    StoreU(acc, du, dst + x * 4);
+                }
+            } else {
+                uint32_t acc = 0;
+                for (int x = 0; x < table.width; ++x) {
+                    acc += src[x];
+                    dst[x] = acc;
+                }
+            }
+        });
+        summedAreaColumns(table, threadCount);
+    }
+
+    void squaredSummedAreaTableU8HWY(const uint8_t *data, const int stride, SummedAreaTable<uint64_t> &table) {
+        const int threadCount = summedAreaThreads(table.width, table.height);
+        concurrency::parallel_for(threadCount, table.height, [&](int y) {
+            const uint8_t *src = data + y * stride;
+            uint64_t *dst = table.row(y + 1) + 2;
+            uint64_t sum = 0;
+            uint64_t squares = 0;
+            for (int x = 0; x < table.width; ++x) {
+                const uint32_t value = src[x];
+                sum += value;
+                squares += value * value;
+                dst[x * 2] = sum;
+                dst[x * 2 + 1] = squares;
+            }
+        });
+        summedAreaColumns(table, threadCount);
+    }
+
+    void summedAreaTableF16HWY(const uint16_t *data, const int stride, SummedAreaTable<double> &table) {
+        const int threadCount = summedAreaThreads(table.width, table.height);
+        concurrency::parallel_for(threadCount, table.height, [&](int y) {
+            const FixedTag<hwy::float16_t, 4> df16;
+            const FixedTag<float, 4> df;
+            auto src = reinterpret_cast<const hwy::float16_t *>(reinterpret_cast<const uint8_t *>(data) + y * stride);
+            double *dst = table.row(y + 1) + 4;
+#if HWY_HAVE_FLOAT64
+            const FixedTag<float, 2> dfh;
+            const FixedTag<double, 2> dd;
+            auto low = Zero(dd);
+            auto high = Zero(dd);
+            for (int x = 0; x < table.width; ++x) {
+                const auto pixel = PromoteTo(df, LoadU(df16, src + x * 4));
+                low = Add(low, PromoteTo(dd, LowerHalf(dfh, pixel)));
+                high = Add(high, PromoteTo(dd, UpperHalf(dfh, pixel)));
+                StoreU(low, dd, dst + x * 4);
+                StoreU(high, dd, dst + x * 4 + 2);
+            }
+#else
+            double acc[4] = {0, 0, 0, 0};
+            HWY_ALIGN float pixel[4];
+            for (int x = 0; x < table.width; ++x) {
+                Store(PromoteTo(df, LoadU(df16, src + x * 4)), df, pixel);
+                for (int c = 0; c < 4; ++c) {
+                    acc[c] += pixel[c];
+                    dst[x * 4 + c] = acc[c];
+                }
+            }
+#endif
+        });
+        summedAreaColumns(table, threadCount);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(summedAreaTableU8HWY);
+    HWY_EXPORT(squaredSummedAreaTableU8HWY);
+    HWY_EXPORT(summedAreaTableF16HWY);
+
+    template<typename T>
+    SummedAreaTable<T>::SummedAreaTable(const int width, const int height, const int channels) :
+            width(width), height(height), channels(channels),
+            pitch(((width + 1) * channels * sizeof(T) + kRowAlignment - 1) / kRowAlignment * kRowAlignment / sizeof(T)),
+            table(pitch * (height + 1), 0) {
+    }
+
+    static void checkTableSize(const int width, const int height) {
+        if (width <= 0 || height <= 0) {
+            std::string err = "Summed area table requires positive dimensions but received " +
+                              std::to_string(width) + "x" + std::to_string(height);
+            throw AireError(err);
+        }
+    }
+
+    template
+    class SummedAreaTable<uint32_t>;
+
+    template
+    class SummedAreaTable<uint64_t>;
+
+    template
+    class SummedAreaTable<double>;
+
+    SummedAreaTable<uint32_t> summedAreaTableU8(const uint8_t *data, int stride, int width, int height, int channels) {
+        if (channels != 1 && channels != 4) {
+            std::string err = "Summed area table supports 1 or 4 channels but received " + std::to_string(channels);
+            throw AireError(err);
+        }
+        checkTableSize(width, height);
+        SummedAreaTable<uint32_t> table(width, height, channels);
+        HWY_DYNAMIC_DISPATCH(summedAreaTableU8HWY)(data, stride, table);
+        return table;
+    }
+
+    SummedAreaTable<uint64_t> squaredSummedAreaTableU8(const uint8_t *data, int stride, int width, int height) {
+        checkTableSize(width, height);
+        SummedAreaTable<uint64_t> table(width, height, 2);
+        HWY_DYNAMIC_DISPATCH(squaredSummedAreaTableU8HWY)(data, stride, table);
+        return table;
+    }
+
+    SummedAreaTable<double> summedAreaTableF16(const uint16_t *data, int stride, int width, int height) {
+        checkTableSize(width, height);
+        SummedAreaTable<double> table(width, height, 4);
+        HWY_DYNAMIC_DISPATCH(summedAreaTableF16HWY)(data, stride, table);
+        return table;
+    }
+}
+#endif
@@ -0,0 +1,101 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace aire {
+
+    /**
+     * Integral image with leading zero row and column, entry (x, y) holds sums of all samples above and left of it,
+     * channels are interleaved. Unsigned tables wrap around, so rectangle sums stay exact while the true sum
+     * of the rectangle fits the type: for 8 bit input and 32 bit table that is any rectangle up to 2^24 pixels
+     * no matter how large the frame is
+     */
+    template<typename T>
+    class SummedAreaTable {
+    public:
+        // Rows are padded to multiple of this many bytes
+        static constexpr int kRowAlignment = 256;
+
+        SummedAreaTable(int width, int height, int channels);
+
+        /**
+         * Sum of `channel` over [x0, x1) x [y0, y1)
+         */
+        T sum(const int x0, const int y0, const int x1, const int y1, const int channel) const {
+            const T *top = row(y0);
+            const T *bottom = row(y1);
+            return bottom[x1 * channels + channel] - bottom[x0 * channels + channel]
+                   - top[x1 * channels + channel] + top[x0 * channels + channel];
+        }
+
+        const T *row(const int y) const {
+            return table.data() + static_cast<size_t>(y) * pitch;
+        }
+
+        T *row(const int y) {
+            return table.data() + static_cast<size_t>(y) * pitch;
+        }
+
+        const int width;
+        const int height;
+        const int channels;
+        // Row pitch in elements, rows hold (width + 1) * channels entries and zero padding
+        const size_t pitch;
+
+    private:
+        std::vector<T> table;
+    };
+
+    /**
+     * Largest box radius whose (2 * radius + 1)^2 box stays within 2^24 pixels, so sums over 8 bit table
+     * are exact on any frame size
+     */
+    static constexpr int kSummedAreaMaxRadiusU8 = 2047;
+
+    /**
+     * Table of 8 bit image with 1 or 4 channels
+     */
+    SummedAreaTable<uint32_t> summedAreaTableU8(const uint8_t *data, int stride, int width, int height, int channels);
+
+    /**
+     * Table of single 8 bit plane with 2 channels: sums of samples and sums of their squares
+     */
+    SummedAreaTable<uint64_t> squaredSummedAreaTableU8(const uint8_t *data, int stride, int width, int height);
+
+    /**
+     * Table of 4 channels F16 image, accumulated in double
+     */
+    SummedAreaTable<double> summedAreaTableF16(const uint16_t *data, int stride, int width, int height);
+}
@@ -28,22 +28,28 @@
  *
  */
 
-#include "Threshold.h"
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Threshold.cpp"
+
+#include "hwy/foreach_target.h"
 #include "hwy/highway.h"
+
+#include "Threshold.h"
 #include "algo/support-inl.h"
 #include "concurrency.hpp"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace std;
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
 
     template<class V>
-    void threshold(V *pixels, int width, int height, V thresholdLevel, V max, V min) {
+    void thresholdHWY(V *pixels, int width, int height, V thresholdLevel, V max, V min) {
         const ScalableTag<uint8_t> du;
         using VU = Vec<decltype(du)>;
-        const int lanes = du.MaxLanes();
+        const int lanes = Lanes(du);
 
         const auto vThresholdLevel = Set(du, thresholdLevel);
         const auto vMax = Set(du, max);
@@ -71,7 +77,25 @@ namespace aire {
         });
     }
 
+    void thresholdU8HWY(uint8_t *pixels, int width, int height, uint8_t thresholdLevel, uint8_t max, uint8_t min) {
+        thresholdHWY(pixels, width, height, thresholdLevel, max, min);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(thresholdU8HWY);
+
+    template<class V>
+    void threshold(V *pixels, int width, int height, V thresholdLevel, V max, V min) {
+        HWY_DYNAMIC_DISPATCH(thresholdU8HWY)(pixels, width, height, thresholdLevel, max, min);
+    }
+
     template
     void threshold(uint8_t *pixels, int width, int height, uint8_t thresholdLevel, uint8_t max,
                    uint8_t min);
-}
\ No newline at end of file
+
+}
+#endif
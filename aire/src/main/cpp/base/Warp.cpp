@@ -0,0 +1,416 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "base/Warp.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "Warp.h"
+#include "ExactTransform.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "scale/sampler.h"
+#include "MathUtils.hpp"
+#include "concurrency.hpp"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace std;
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    static constexpr int warpTileSize = 64;
+    static constexpr int warpMaxSupersampling = 4;
+    static constexpr float warpMaxFootprint = 8.f;
+    static constexpr int warpMaxTaps = 2 * 3 * 8 + 2;
+    static constexpr int warpKernelResolution = 256;
+
+    typedef float (*WarpKernel)(float);
+
+    /**
+     * Kernel tabulated over |x| in [0, support] to avoid transcendental evaluation per tap
+     */
+    class WarpKernelTable {
+    public:
+        WarpKernelTable(WarpKernel kernel, const float support) : support(support),
+                                                                  weights(static_cast<int>(support * warpKernelResolution) + 2) {
+            for (size_t i = 0; i < weights.size(); ++i) {
+                weights[i] = kernel(static_cast<float>(i) / static_cast<float>(warpKernelResolution));
+            }
+        }
+
+        inline float operator()(const float x) const {
+            const float position = std::abs(x) * static_cast<float>(warpKernelResolution);
+            const int index = static_cast<int>(position);
+            if (index >= static_cast<int>(weights.size()) - 1) {
+                return 0.f;
+            }
+            const float fraction = position - static_cast<float>(index);
+            return weights[index] + (weights[index + 1] - weights[index]) * fraction;
+        }
+
+        const float support;
+
+    private:
+        std::vector<float> weights;
+    };
+
+    static float warpBiCubic(float x) {
+        return BiCubicSpline<float>(x);
+    }
+
+    static float warpMitchell(float x) {
+        return MitchellNetravalli<float>(x);
+    }
+
+    static float warpLanczos(float x) {
+        return Lanczos3Sinc<float>(x);
+    }
+
+    class WarpRow {
+    public:
+        WarpRow(const uint8_t *source, int srcStride, int width, int height, const Eigen::Matrix3f &m) :
+                source(source), srcStride(srcStride), width(width), height(height), m(m),
+                isAffine(m(2, 0) == 0.f && m(2, 1) == 0.f && m(2, 2) == 1.f) {
+        }
+
+        /**
+         * Source footprint of one destination pixel along destination x and y axes
+         */
+        void footprint(const float x, const float y, float &scaleX, float &scaleY) const {
+            const float hx = m(0, 0) * x + m(0, 1) * y + m(0, 2);
+            const float hy = m(1, 0) * x + m(1, 1) * y + m(1, 2);
+            const float hw = m(2, 0) * x + m(2, 1) * y + m(2, 2);
+            const float invW = hw != 0.f ? 1.f / hw : 0.f;
+            const float u = hx * invW;
+            const float v = hy * invW;
+            const float dudx = (m(0, 0) - u * m(2, 0)) * invW;
+            const float dvdx = (m(1, 0) - v * m(2, 0)) * invW;
+            const float dudy = (m(0, 1) - u * m(2, 1)) * invW;
+            const float dvdy = (m(1, 1) - v * m(2, 1)) * invW;
+            scaleX = std::sqrt(dudx * dudx + dvdx * dvdx);
+            scaleY = std::sqrt(dudy * dudy + dvdy * dvdy);
+        }
+
+        /**
+         * Bilinear samples `count` destination pixels starting at (x, y), `samples` x `samples` per pixel.
+         * Source coordinates are stepped incrementally along the row and gathered 4 pixels at a time
+         */
+        void bilinear(uint32_t *dst, const int x, const int y, const int count, const int samples) const {
+            const FixedTag<float32_t, 4> df;
+            const FixedTag<int32_t, 4> di;
+            const FixedTag<uint32_t, 4> du;
+            using VF = Vec<decltype(df)>;
+            using VI = Vec<decltype(di)>;
+            using VU = Vec<decltype(du)>;
+            const int lanes = 4;
+
+            const auto srcPixels = reinterpret_cast<const uint32_t *>(source);
+            const VI vZeroI = Zero(di);
+            const VI vMaxX = Set(di, width - 1);
+            const VI vMaxY = Set(di, height - 1);
+            const VI vWidth = Set(di, width);
+            const VI vHeight = Set(di, height);
+            const VI vStride = Set(di, srcStride / 4);
+            const VI vOne = Set(di, 1);
+            const VU vMask = Set(du, 0xff);
+            const VF vOneF = Set(df, 1.f);
+            const VF vStepX = Set(df, m(0, 0) * lanes);
+            const VF vStepY = Set(df, m(1, 0) * lanes);
+            const VF vStepW = Set(df, m(2, 0) * lanes);
+            const VF iota = Iota(df, 0);
+
+            HWY_ALIGN float accumulator[4][warpTileSize];
+            HWY_ALIGN float coverage[warpTileSize];
+            std::fill(&accumulator[0][0], &accumulator[0][0] + 4 * warpTileSize, 0.f);
+            std::fill(coverage, coverage + warpTileSize, 0.f);
+
+            const int vectorCount = count - count % lanes;
+
+            for (int sy = 0; sy < samples; ++sy) {
+                const float py = static_cast<float>(y) + (static_cast<float>(sy) + 0.5f) / static_cast<float>(samples) - 0.5f;
+                for (int sx = 0; sx < samples; ++sx) {
+                    const float px = static_cast<float>(x) + (static_cast<float>(sx) + 0.5f) / static_cast<float>(samples) - 0.5f;
+                    const VF xs = Add(iota, Set(df, px));
+                    VF hx = MulAdd(xs, Set(df, m(0, 0)), Set(df, m(0, 1) * py + m(0, 2)));
+                    VF hy = MulAdd(xs, Set(df, m(1, 0)), Set(df, m(1, 1) * py + m(1, 2)));
+                    VF hw = MulAdd(xs, Set(df, m(2, 0)), Set(df, m(2, 1) * py + m(2, 2)));
+
+                    for (int i = 0; i < vectorCount; i += lanes) {
+                        VF u = hx;
+                        VF v = hy;
+                        if (!isAffine) {
+                            const VF invW = Div(vOneF, hw);
+                            u = Mul(u, invW);
+                            v = Mul(v, invW);
+                        }
+                        const VF fu = Floor(u);
+                        const VF fv = Floor(v);
+                        const VF dx = Sub(u, fu);
+                        const VF dy = Sub(v, fv);
+                        const VI x0 = ConvertTo(di, fu);
+                        const VI y0 = ConvertTo(di, fv);
+                        const auto inside = RebindMask(df, And(And(Ge(x0, vZeroI), Lt(x0, vWidth)),
+                                                               And(Ge(y0, vZeroI), Lt(y0, vHeight))));
+                        const VI cx0 = Min(Max(x0, vZeroI), vMaxX);
+                        const VI cy0 = Min(Max(y0, vZeroI), vMaxY);
+                        const VI cx1 = Min(Add(cx0, vOne), vMaxX);
+                        const VI row0 = Mul(cy0, vStride);
+                        const VI row1 = Mul(Min(Add(cy0, vOne), vMaxY), vStride);
+                        const VU p00 = GatherIndex(du, srcPixels, Add(row0, cx0));
+                        const VU p10 = GatherIndex(du, srcPixels, Add(row0, cx1));
+                        const VU p01 = GatherIndex(du, srcPixels, Add(row1, cx0));
+                        const VU p11 = GatherIndex(du, srcPixels, Add(row1, cx1));
+                        for (int c = 0; c < 4; ++c) {
+                            const int shift = c * 8;
+                            const VF c00 = ConvertTo(df, BitCast(di, And(ShiftRightSame(p00, shift), vMask)));
+                            const VF c10 = ConvertTo(df, BitCast(di, And(ShiftRightSame(p10, shift), vMask)));
+                            const VF c01 = ConvertTo(df, BitCast(di, And(ShiftRightSame(p01, shift), vMask)));
+                            const VF c11 = ConvertTo(df, BitCast(di, And(ShiftRightSame(p11, shift), vMask)));
+                            const VF top = MulAdd(Sub(c10, c00), dx, c00);
+                            const VF bottom = MulAdd(Sub(c11, c01), dx, c01);
+                            const VF value = MulAdd(Sub(bottom, top), dy, top);
+                            Store(Add(Load(df, accumulator[c] + i), IfThenElseZero(inside, value)), df, accumulator[c] + i);
+                        }
+                        Store(Add(Load(df, coverage + i), IfThenElseZero(inside, vOneF)), df, coverage + i);
+
+                        hx = Add(hx, vStepX);
+                        hy = Add(hy, vStepY);
+                        hw = Add(hw, vStepW);
+                    }
+
+                    for (int i = vectorCount; i < count; ++i) {
+                        float u, v;
+                        map(px + static_cast<float>(i), py, u, v);
+                        const float fu = std::floor(u);
+                        const float fv = std::floor(v);
+                        const int x0 = static_cast<int>(fu);
+                        const int y0 = static_cast<int>(fv);
+                        if (x0 < 0 || x0 >= width || y0 < 0 || y0 >= height) {
+                            continue;
+                        }
+                        const int x1 = std::min(x0 + 1, width - 1);
+                        const int y1 = std::min(y0 + 1, height - 1);
+                        const uint8_t *src = source + y0 * srcStride;
+                        const uint8_t *src2 = source + y1 * srcStride;
+                        for (int c = 0; c < 4; ++c) {
+                            accumulator[c][i] += blerp(static_cast<float>(src[x0 * 4 + c]), static_cast<float>(src[x1 * 4 + c]),
+                                                       static_cast<float>(src2[x0 * 4 + c]), static_cast<float>(src2[x1 * 4 + c]),
+                                                       u - fu, v - fv);
+                        }
+                        coverage[i] += 1.f;
+                    }
+                }
+            }
+
+            const float weight = 1.f / static_cast<float>(samples * samples);
+            const VF vWeight = Set(df, weight);
+            const VI vMax = Set(di, 255);
+            for (int i = 0; i < vectorCount; i += lanes) {
+                VU packed = Zero(du);
+                for (int c = 0; c < 4; ++c) {
+                    const VI value = Min(Max(NearestInt(Mul(Load(df, accumulator[c] + i), vWeight)), vZeroI), vMax);
+                    packed = Or(packed, ShiftLeftSame(BitCast(du, value), c * 8));
+                }
+                // Destination is untouched where the source is not mapped
+                const auto covered = RebindMask(du, Gt(Load(df, coverage + i), Zero(df)));
+                StoreU(IfThenElse(covered, packed, LoadU(du, dst + i)), du, dst + i);
+            }
+            for (int i = vectorCount; i < count; ++i) {
+                if (coverage[i] == 0.f) {
+                    continue;
+                }
+                auto pixel = reinterpret_cast<uint8_t *>(dst + i);
+                for (int c = 0; c < 4; ++c) {
+                    pixel[c] = static_cast<uint8_t>(std::clamp(std::roundf(accumulator[c][i] * weight), 0.f, 255.f));
+                }
+            }
+        }
+
+        /**
+         * Separable kernel sampling, kernel is stretched by the source footprint to prefilter minification
+         */
+        void kernel(uint32_t *dst, const int x, const int y, const int count, const WarpKernelTable &kernel,
+                    const float scaleX, const float scaleY) const {
+            const FixedTag<uint8_t, 4> du8;
+            const FixedTag<uint32_t, 4> du32;
+            const FixedTag<float32_t, 4> df;
+            using VF = Vec<decltype(df)>;
+
+            const float radiusX = kernel.support * scaleX;
+            const float radiusY = kernel.support * scaleY;
+            const float invScaleX = 1.f / scaleX;
+            const float invScaleY = 1.f / scaleY;
+            float weightsX[warpMaxTaps];
+            float weightsY[warpMaxTaps];
+
+            for (int i = 0; i < count; ++i) {
+                float u, v;
+                map(static_cast<float>(x + i), static_cast<float>(y), u, v);
+                if (u < 0.f || u >= static_cast<float>(width) || v < 0.f || v >= static_cast<float>(height)) {
+                    continue;
+                }
+                const int startX = static_cast<int>(std::ceil(u - radiusX));
+                const int startY = static_cast<int>(std::ceil(v - radiusY));
+                const int tapsX = std::min(static_cast<int>(std::floor(u + radiusX)) - startX + 1, warpMaxTaps);
+                const int tapsY = std::min(static_cast<int>(std::floor(v + radiusY)) - startY + 1, warpMaxTaps);
+
+                float sumX = 0.f;
+                for (int j = 0; j < tapsX; ++j) {
+                    weightsX[j] = kernel((static_cast<float>(startX + j) - u) * invScaleX);
+                    sumX += weightsX[j];
+                }
+                float sumY = 0.f;
+                for (int j = 0; j < tapsY; ++j) {
+                    weightsY[j] = kernel((static_cast<float>(startY + j) - v) * invScaleY);
+                    sumY += weightsY[j];
+                }
+                if (sumX == 0.f || sumY == 0.f) {
+                    continue;
+                }
+
+                VF accumulator = Zero(df);
+                for (int k = 0; k < tapsY; ++k) {
+                    const uint8_t *src = source + std::clamp(startY + k, 0, height - 1) * srcStride;
+                    VF row = Zero(df);
+                    for (int j = 0; j < tapsX; ++j) {
+                        const int px = std::clamp(startX + j, 0, width - 1) * 4;
+                        const VF pixel = ConvertTo(df, PromoteTo(du32, LoadU(du8, src + px)));
+                        row = MulAdd(pixel, Set(df, weightsX[j]), row);
+                    }
+                    accumulator = MulAdd(row, Set(df, weightsY[k]), accumulator);
+                }
+                accumulator = Mul(accumulator, Set(df, 1.f / (sumX * sumY)));
+                accumulator = Min(Max(Round(accumulator), Zero(df)), Set(df, 255.f));
+                StoreU(DemoteTo(du8, ConvertTo(du32, accumulator)), du8, reinterpret_cast<uint8_t *>(dst + i));
+            }
+        }
+
+    private:
+        void map(const float x, const float y, float &u, float &v) const {
+            u = m(0, 0) * x + m(0, 1) * y + m(0, 2);
+            v = m(1, 0) * x + m(1, 1) * y + m(1, 2);
+            if (!isAffine) {
+                const float w = m(2, 0) * x + m(2, 1) * y + m(2, 2);
+                u /= w;
+                v /= w;
+            }
+        }
+
+        const uint8_t *source;
+        const int srcStride;
+        const int width;
+        const int height;
+        const Eigen::Matrix3f m;
+        const bool isAffine;
+    };
+
+    void warpHWY(const uint8_t *source, int srcStride, int width, int height,
+                 uint8_t *destination, int dstStride, int newWidth, int newHeight,
+                 const Eigen::Matrix3f &transform, WarpSampler sampler) {
+        if (width <= 0 || height <= 0 || newWidth <= 0 || newHeight <= 0) {
+            return;
+        }
+        ExactTransform exact;
+        if (isExactTransform(transform, exact)) {
+            exactTransform(source, srcStride, width, height, destination, dstStride, newWidth, newHeight,
+                           sizeof(uint32_t), exact);
+            return;
+        }
+        const WarpRow row(source, srcStride, width, height, transform);
+
+        std::unique_ptr<WarpKernelTable> kernel;
+        switch (sampler) {
+            case WARP_BICUBIC:
+                kernel = std::make_unique<WarpKernelTable>(warpBiCubic, 2.f);
+                break;
+            case WARP_MITCHELL:
+                kernel = std::make_unique<WarpKernelTable>(warpMitchell, 2.f);
+                break;
+            case WARP_LANCZOS:
+                kernel = std::make_unique<WarpKernelTable>(warpLanczos, 3.f);
+                break;
+            default:
+                break;
+        }
+
+        const int tilesX = (newWidth + warpTileSize - 1) / warpTileSize;
+        const int tilesY = (newHeight + warpTileSize - 1) / warpTileSize;
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          newHeight * newWidth / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, tilesX * tilesY, [&](int tile) {
+            const int tileX = (tile % tilesX) * warpTileSize;
+            const int tileY = (tile / tilesX) * warpTileSize;
+            const int tileWidth = std::min(warpTileSize, newWidth - tileX);
+            const int tileHeight = std::min(warpTileSize, newHeight - tileY);
+
+            float scaleX, scaleY;
+            row.footprint(static_cast<float>(tileX) + static_cast<float>(tileWidth) * 0.5f,
+                          static_cast<float>(tileY) + static_cast<float>(tileHeight) * 0.5f, scaleX, scaleY);
+            scaleX = std::clamp(scaleX, 1.f, warpMaxFootprint);
+            scaleY = std::clamp(scaleY, 1.f, warpMaxFootprint);
+
+            for (int y = tileY; y < tileY + tileHeight; ++y) {
+                auto dst = reinterpret_cast<uint32_t *>(destination + y * dstStride);
+                if (kernel) {
+                    row.kernel(dst + tileX, tileX, y, tileWidth, *kernel, scaleX, scaleY);
+                } else {
+                    const int samples = std::min(static_cast<int>(std::ceil(std::max(scaleX, scaleY))),
+                                                 warpMaxSupersampling);
+                    row.bilinear(dst + tileX, tileX, y, tileWidth, samples);
+                }
+            }
+        });
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(warpHWY);
+
+    void warp(const uint8_t *source, int srcStride, int width, int height,
+              uint8_t *destination, int dstStride, int newWidth, int newHeight,
+              const Eigen::Matrix3f &transform, WarpSampler sampler) {
+        HWY_DYNAMIC_DISPATCH(warpHWY)(source, srcStride, width, height, destination, dstStride,
+                                      newWidth, newHeight, transform, sampler);
+    }
+
+}
+#endif
@@ -46,7 +46,15 @@ namespace aire {
         int newHeight = static_cast<int>(std::ceil(maxY - minY));
         int dstStride = computeStride(newWidth, sizeof(uint8_t), 4);
 
-        std::vector<uint8_t > dst(dstStride * newHeight);
+        std::vector<uint8_t> dst(dstStride * newHeight);
+
+        // Destination pixels are mapped back into the source through the inverse perspective
+        Eigen::Matrix3f offset = Eigen::Matrix3f::Identity();
+        offset(0, 2) = static_cast<float>(minX);
+        offset(1, 2) = static_cast<float>(minY);
+        const Eigen::Matrix3f inverse = perspective.inverse() * offset;
+
+        warp(data, stride, width, height, dst.data(), dstStride, newWidth, newHeight, inverse, sampler);
 
         return {
             .result = dst,
@@ -31,7 +31,9 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 #include "Eigen/Eigen"
+#include "Warp.h"
 
 namespace aire {
 
@@ -55,12 +57,17 @@ namespace aire {
             this->perspective = mTransform;
         }
 
+        void setSampler(WarpSampler mSampler) {
+            this->sampler = mSampler;
+        }
+
     private:
         uint8_t *data;
         const int stride;
         const int width;
         const int height;
         Eigen::Matrix3f perspective;
+        WarpSampler sampler = WARP_BILINEAR;
     };
 
 } // aire
@@ -0,0 +1,649 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "hwy/highway.h"
+#include "hwy/timer.h"
+#include "hwy/robust_statistics.h"
+#include "Eigen/Eigen"
+#include "AireError.h"
+#include "algo/concurrency.hpp"
+#include "algo/MedianCut.h"
+#include "algo/WuQuantizer.h"
+#include "blur/BoxBlur.h"
+#include "blur/GaussBlur.h"
+#include "blur/MedianBlur.h"
+#include "blur/ShgStackBlur.h"
+#include "blur/PoissonBlur.h"
+#include "blur/RecursiveGaussian.h"
+#include "blur/VariableBoxBlur.h"
+#include "blur/ZoomBlur.h"
+#include "blur/AnisotropicDiffusion.h"
+#include "base/AdaptiveThreshold.h"
+#include "base/Convolve1D.h"
+#include "base/Convolve2D.h"
+#include "base/Dilation.h"
+#include "base/Erosion.h"
+#include "base/Grayscale.h"
+#include "base/LUT8.h"
+#include "base/PNGEncoder.h"
+#include "base/RemapPalette.h"
+#include "base/SimdTargets.h"
+#include "base/Vibrance.h"
+#include "color/ConvolveToneMapper.h"
+#include "conversion/Rgba8ToF16.h"
+#include "conversion/Rgb1010102.h"
+#include "pipelines/FusedPipeline.h"
+#include "pipelines/BatchPipeline.h"
+#include "pipelines/TiledPipeline.h"
+#include "pipelines/DehazeDarkChannel.h"
+
+#if AIRE_HOST_JPEG
+#include "base/JPEGEncoder.h"
+#endif
+
+/**
+ * Host benchmark of aire kernels, every case is swept over image sizes, thread limits and,
+ * when it takes one, over kernel radii. Timings are median of repeated runs on a fresh copy of the frame.
+ */
+
+namespace {
+
+    struct Frame {
+        int width;
+        int height;
+        int stride;
+        std::vector<uint8_t> pixels;
+    };
+
+    Frame makeFrame(const int width, const int height) {
+        Frame frame{width, height, width * 4, std::vector<uint8_t>(width * 4 * height)};
+        uint32_t state = 0x9E3779B9u;
+        for (int y = 0; y < height; ++y) {
+            uint8_t *row = frame.pixels.data() + y * frame.stride;
+            for (int x = 0; x < width; ++x) {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                const int noise = static_cast<int>(state & 31) - 16;
+                row[4 * x] = static_cast<uint8_t>(std::clamp(x * 255 / width + noise, 0, 255));
+                row[4 * x + 1] = static_cast<uint8_t>(std::clamp(y * 255 / height + noise, 0, 255));
+                row[4 * x + 2] = static_cast<uint8_t>(std::clamp(((x ^ y) & 255) + noise, 0, 255));
+                row[4 * x + 3] = 255;
+            }
+        }
+        return frame;
+    }
+
+    /**
+     * Kernel runs in place on RGBA8888 frame and returns size of produced stream, 0 when there is none
+     */
+    typedef std::function<size_t(uint8_t *data, int stride, int width, int height, int radius)> BenchKernel;
+
+    struct BenchCase {
+        std::string group;
+        std::string name;
+        // Nominal memory traffic, bytes read and written per pixel
+        double bytesPerPixel;
+        // Radius sweep is applied only when maxRadius > 0, radii above are skipped
+        int maxRadius;
+        BenchKernel kernel;
+    };
+
+    struct BenchResult {
+        std::string group;
+        std::string name;
+        std::string target;
+        int width;
+        int height;
+        int threads;
+        int radius;
+        int samples;
+        double medianMs;
+        double madMs;
+        double mpixPerSecond;
+        double bytesPerPixel;
+        double outputBytesPerPixel;
+    };
+
+    Eigen::MatrixXi squareMask(const int radius) {
+        const int size = 2 * radius + 1;
+        Eigen::MatrixXi kernel(size, size);
+        kernel.setOnes();
+        return kernel;
+    }
+
+    Eigen::Vector4i unpackColor(const uint32_t color) {
+        return {static_cast<int>(color & 0xff), static_cast<int>((color >> 8) & 0xff),
+                static_cast<int>((color >> 16) & 0xff), static_cast<int>((color >> 24) & 0xff)};
+    }
+
+    std::vector<BenchCase> buildCases() {
+        std::vector<BenchCase> cases;
+
+        // Blurs
+        cases.push_back({"blur", "boxBlur", 8, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::boxBlurU8(d, s, w, h, r);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "tentBlur", 8, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::tentBlur(d, s, w, h, 2 * r + 1);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "gaussBlur", 8, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::gaussBlurU8(d, s, w, h, 2 * r + 1, static_cast<float>(r) / 2.f + 0.5f);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "recursiveGaussian", 72, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::recursiveGaussianU8(d, s, w, h, static_cast<float>(r) / 2.f + 0.5f);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "variableBoxBlur", 56, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            // Radius ramps from 0 at the left edge to r at the right one
+            aire::variableBoxBlurU8(d, s, w, h, [w, r](int, float *radii) {
+                for (int x = 0; x < w; ++x) {
+                    radii[x] = static_cast<float>(r) * static_cast<float>(x) / static_cast<float>(w);
+                }
+            });
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "zoomBlur", 8, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::zoomBlur(d, s, w, h, 2 * r + 1, static_cast<float>(r) / 2.f + 0.5f, 0.5f, 0.5f, 1.f, 0.785f);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "spinBlur", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::spinBlur(d, s, w, h, 0.5f, 0.5f, 0.3f);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "gaussianApproximation3D", 8, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::gaussianApproximation3D(d, s, w, h, r);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "stackBlur", 8, 254, [](uint8_t *d, int, int w, int h, int r) {
+            aire::shgStackBlur(d, w, h, r);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "poissonBlur", 8, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::poissonBlur(d, s, w, h, 2 * r + 1, 1);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "medianBlur", 8, 7, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::medianBlur(d, s, w, h, r);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "convolve2D", 8, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            const int size = 2 * r + 1;
+            Eigen::MatrixXf kernel(size, size);
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    kernel(y, x) = 1.f + static_cast<float>((x * 7 + y * 3) % 5);
+                }
+            }
+            kernel /= kernel.sum();
+            aire::convolve2D(d, s, w, h, kernel);
+            return size_t(0);
+        }});
+
+        cases.push_back({"blur", "convolve1D", 16, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            std::vector<float> kernel(2 * r + 1);
+            for (size_t i = 0; i < kernel.size(); ++i) {
+                kernel[i] = 1.f / static_cast<float>(kernel.size());
+            }
+            aire::convolve1D(d, s, w, h, kernel, kernel);
+            return size_t(0);
+        }});
+        cases.push_back({"blur", "anisotropicDiffusion", 16, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::anisotropicDiffusion(d, s, w, h, 0.1f, 20.f, 4);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "dehaze", 12, 15, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::dehaze(d, s, w, h, r, 0.45f);
+            return size_t(0);
+        }});
+
+        // Morphology
+        cases.push_back({"morphology", "erosion", 8, 7, [](uint8_t *d, int s, int w, int h, int r) {
+            Eigen::MatrixXi kernel = squareMask(r);
+            std::vector<uint8_t> output(s * h);
+            aire::erodeRGBA(d, output.data(), s, w, h, kernel);
+            return size_t(0);
+        }});
+        cases.push_back({"morphology", "dilation", 8, 7, [](uint8_t *d, int s, int w, int h, int r) {
+            Eigen::MatrixXi kernel = squareMask(r);
+            std::vector<uint8_t> output(s * h);
+            aire::dilateRGBA(d, output.data(), s, w, h, kernel);
+            return size_t(0);
+        }});
+
+        // Local thresholds
+        cases.push_back({"threshold", "bradley", 24, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::adaptiveThreshold(d, s, w, h, r, 0.15f, aire::ADAPTIVE_THRESHOLD_BRADLEY);
+            return size_t(0);
+        }});
+        cases.push_back({"threshold", "sauvola", 48, 255, [](uint8_t *d, int s, int w, int h, int r) {
+            aire::adaptiveThreshold(d, s, w, h, r, 0.2f, aire::ADAPTIVE_THRESHOLD_SAUVOLA);
+            return size_t(0);
+        }});
+
+        // Tone mapping and color
+        cases.push_back({"tone", "exposure", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::exposure(d, s, w, h, 1.2f);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "logarithmic", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::logarithmic(d, s, w, h, 1.f);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "acesFilm", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::acesFilm(d, s, w, h, 1.f);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "hableFilmic", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::hableFilmic(d, s, w, h, 1.f);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "uchimura", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::uchimura(d, s, w, h, 1.f);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "drago", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::drago(d, s, w, h, 1.f, 250.f);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "vibrance", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::vibrance(d, s, w, h, 0.5f);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "levelsLUT", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::LUT8::levels(16, 235, 1.1f, 0, 255).apply(d, s, w, h);
+            return size_t(0);
+        }});
+        cases.push_back({"tone", "fusedPointChain", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::FusedPipeline pipeline({aire::FUSED_EXPOSURE, aire::FUSED_CONTRAST, aire::FUSED_VIBRANCE,
+                                          aire::FUSED_ACES_FILMIC},
+                                         {1.2f, 1.1f, 0.4f, 1.f});
+            pipeline.apply(d, s, w, h);
+            return size_t(0);
+        }});
+
+        // Conversions
+        cases.push_back({"conversion", "grayscale", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            std::vector<uint8_t> output(s * h);
+            aire::grayscale(d, output.data(), s, w, h);
+            return size_t(0);
+        }});
+        cases.push_back({"conversion", "rgba8ToF16", 12, 0, [](uint8_t *d, int s, int w, int h, int) {
+            const int dstStride = w * 4 * static_cast<int>(sizeof(uint16_t));
+            std::vector<uint16_t> output(w * 4 * h);
+            aire::Rgba8ToF16(d, s, output.data(), dstStride, w, h, 8, false);
+            return size_t(0);
+        }});
+        cases.push_back({"conversion", "rgba8ToRGBA1010102", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            std::vector<uint8_t> output(s * h);
+            aire::Rgba8ToRGBA1010102(d, s, output.data(), s, w, h, false);
+            return size_t(0);
+        }});
+
+        // Quantizers
+        cases.push_back({"quantize", "medianCut", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            std::vector<Eigen::Vector4i> palette;
+            aire::Palette cut(reinterpret_cast<uint32_t *>(d), w * h);
+            cut.medianCut(256, [&palette](const aire::Cube &cube) {
+                palette.push_back(unpackColor(cube.getAverageRGBA()));
+            });
+            aire::RemapPalette remap(palette, d, s, w, h, aire::Remap_Dither_Skip, aire::Remap_Search_Cover);
+            remap.remap();
+            return size_t(0);
+        }});
+        cases.push_back({"quantize", "wuQuantizer", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::WuQuantizer quantizer(d, s, w, h);
+            uint32_t colors = 256;
+            std::vector<Eigen::Vector4i> palette = quantizer.quantizeImage(colors, 15, 15);
+            aire::RemapPalette remap(palette, d, s, w, h, aire::Remap_Dither_Skip, aire::Remap_Search_Cover);
+            remap.remap();
+            return size_t(0);
+        }});
+
+        // Encoders
+        cases.push_back({"encode", "png", 4, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::PNGEncoder encoder(d, s, w, h);
+            encoder.setCompressionLevel(5);
+            return encoder.getPNGData().size();
+        }});
+#if AIRE_HOST_JPEG
+        cases.push_back({"encode", "jpeg", 4, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::JPEGEncoder encoder(d, s, w, h);
+            encoder.setQuality(81);
+            return encoder.encode().size();
+        }});
+#endif
+
+        // Frame cut into 256x256 thumbnails filtered and encoded as one batch
+        cases.push_back({"batch", "thumbnailsPng", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            const int tile = 256;
+            const int columns = std::max(w / tile, 1);
+            const int count = columns * std::max(h / tile, 1);
+            aire::BatchRecipe recipe;
+            recipe.ops = {aire::FUSED_CONTRAST, aire::FUSED_GAUSSIAN_BLUR};
+            recipe.params = {1.1f, 5.f, 0.f};
+            recipe.encoding = aire::BATCH_ENCODE_PNG;
+            recipe.maxColors = 64;
+            recipe.quantize = AIRE_QUANTIZE_MEDIAN_CUT;
+            recipe.dithering = aire::Remap_Dither_Skip;
+            recipe.strategy = aire::Remap_Search_Simd;
+            aire::BatchPipeline pipeline(recipe, 0);
+            size_t total = 0;
+            pipeline.run(count, [&](int index, aire::BatchImage &image) {
+                image.width = std::min(tile, w);
+                image.height = std::min(tile, h);
+                image.stride = image.width * 4;
+                image.data.resize(image.stride * image.height);
+                const uint8_t *src = d + (index / columns) * tile * s + (index % columns) * tile * 4;
+                for (int y = 0; y < image.height; ++y) {
+                    std::copy(src + y * s, src + y * s + image.stride, image.data.data() + y * image.stride);
+                }
+            }, [&](int, std::vector<uint8_t> &encoded) {
+                total += encoded.size();
+            });
+            return total;
+        }});
+
+        // Blur and tone mapping streamed through full width bands within 16 MB of working memory
+        cases.push_back({"tiled", "blurTone", 8, 0, [](uint8_t *d, int s, int w, int h, int) {
+            aire::FusedPipeline pipeline({aire::FUSED_GAUSSIAN_BLUR, aire::FUSED_ACES_FILMIC},
+                                         {9.f, 0.f, 1.f});
+            aire::RowProviderSource source(w, h, [&](int y, uint8_t *row) {
+                std::copy(d + y * s, d + y * s + w * 4, row);
+            });
+            std::vector<uint8_t> output(w * 4 * h);
+            aire::RowConsumerSink sink([&](int y, const uint8_t *row) {
+                std::copy(row, row + w * 4, output.data() + y * w * 4);
+            });
+            aire::TiledPipeline(pipeline, 16 * 1024 * 1024).run(source, sink);
+            return size_t(0);
+        }});
+        return cases;
+    }
+
+    struct Options {
+        std::vector<std::pair<int, int>> sizes{{640, 480}, {1920, 1080}, {4000, 3000}};
+        std::vector<int> threads;
+        std::vector<int> radii{2, 8, 32};
+        std::string filter;
+        std::string json;
+        // SIMD targets to sweep, empty runs only the best supported one
+        std::vector<std::string> targets;
+        int minSamples = 3;
+        int maxSamples = 25;
+        double minSeconds = 0.5;
+    };
+
+    std::vector<std::string> splitList(const std::string &value) {
+        std::vector<std::string> items;
+        size_t start = 0;
+        while (start <= value.size()) {
+            size_t end = value.find(',', start);
+            if (end == std::string::npos) {
+                end = value.size();
+            }
+            if (end > start) {
+                items.push_back(value.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        return items;
+    }
+
+    std::vector<int> parseInts(const std::string &value) {
+        std::vector<int> items;
+        for (const std::string &item: splitList(value)) {
+            items.push_back(std::atoi(item.c_str()));
+        }
+        return items;
+    }
+
+    void printUsage(const char *binary) {
+        std::printf("Usage: %s [options]\n"
+                    "  --sizes WxH,...     image sizes, default 640x480,1920x1080,4000x3000\n"
+                    "  --threads N,...     thread limits, default 1 and hardware concurrency\n"
+                    "  --radii R,...       radii for kernels that take one, default 2,8,32\n"
+                    "  --filter TEXT       run only cases whose group/name contains TEXT\n"
+                    "  --samples MIN,MAX   samples per measurement, default 3,25\n"
+                    "  --min-time SECONDS  sampling time per measurement, default 0.5\n"
+                    "  --targets all|T,... SIMD targets to sweep, default best supported\n"
+                    "  --json PATH         write results as JSON\n"
+                    "  --list              print cases and exit\n", binary);
+    }
+
+    BenchResult measure(const BenchCase &benchCase, const Frame &frame, const int threads, const int radius,
+                        const Options &options) {
+        std::vector<uint8_t> work(frame.pixels.size());
+        std::vector<int64_t> samples;
+        size_t produced = 0;
+        double elapsed = 0;
+        // First run is a warmup, it touches pages and fills the scratch arena
+        for (int i = -1; i < options.maxSamples; ++i) {
+            std::copy(frame.pixels.begin(), frame.pixels.end(), work.begin());
+            const hwy::Timestamp start;
+            produced = benchCase.kernel(work.data(), frame.stride, frame.width, frame.height, radius);
+            const double seconds = hwy::SecondsSince(start);
+            if (i < 0) {
+                continue;
+            }
+            samples.push_back(static_cast<int64_t>(seconds * 1e9));
+            elapsed += seconds;
+            if (static_cast<int>(samples.size()) >= options.minSamples && elapsed >= options.minSeconds) {
+                break;
+            }
+        }
+        const int64_t median = hwy::robust_statistics::Median(samples.data(), samples.size());
+        const int64_t mad = hwy::robust_statistics::MedianAbsoluteDeviation(samples.data(), samples.size(), median);
+        const double pixels = static_cast<double>(frame.width) * frame.height;
+        BenchResult result{};
+        result.group = benchCase.group;
+        result.name = benchCase.name;
+        result.target = aire::activeSimdTarget();
+        result.width = frame.width;
+        result.height = frame.height;
+        result.threads = threads;
+        result.radius = benchCase.maxRadius > 0 ? radius : 0;
+        result.samples = static_cast<int>(samples.size());
+        result.medianMs = static_cast<double>(median) / 1e6;
+        result.madMs = static_cast<double>(mad) / 1e6;
+        result.mpixPerSecond = median > 0 ? pixels / (static_cast<double>(median) / 1e9) / 1e6 : 0;
+        result.bytesPerPixel = benchCase.bytesPerPixel;
+        result.outputBytesPerPixel = static_cast<double>(produced) / pixels;
+        return result;
+    }
+
+    bool writeJson(const std::string &path, const std::vector<BenchResult> &results) {
+        FILE *file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+        std::fprintf(file, "{\n  \"target\": \"%s\",\n  \"hardware_concurrency\": %u,\n  \"results\": [\n",
+                     aire::activeSimdTarget().c_str(), std::thread::hardware_concurrency());
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult &r = results[i];
+            std::fprintf(file, "    {\"group\": \"%s\", \"name\": \"%s\", \"target\": \"%s\", \"width\": %d, \"height\": %d, "
+                               "\"threads\": %d, \"radius\": %d, \"samples\": %d, \"median_ms\": %.4f, "
+                               "\"mad_ms\": %.4f, \"mpix_per_s\": %.3f, \"bytes_per_pixel\": %.2f, "
+                               "\"output_bytes_per_pixel\": %.4f}%s\n",
+                         r.group.c_str(), r.name.c_str(), r.target.c_str(), r.width, r.height, r.threads, r.radius, r.samples,
+                         r.medianMs, r.madMs, r.mpixPerSecond, r.bytesPerPixel, r.outputBytesPerPixel,
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+        std::fclose(file);
+        return true;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    bool listOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) {
+            options.sizes.clear();
+            for (const std::string &item: splitList(argv[++i])) {
+                int width = 0, height = 0;
+                if (std::sscanf(item.c_str(), "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+                    options.sizes.emplace_back(width, height);
+                }
+            }
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = parseInts(argv[++i]);
+        } else if (arg == "--radii" && hasValue) {
+            options.radii = parseInts(argv[++i]);
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--samples" && hasValue) {
+            const std::vector<int> bounds = parseInts(argv[++i]);
+            if (bounds.size() == 2) {
+                options.minSamples = std::max(bounds[0], 1);
+                options.maxSamples = std::max(bounds[1], options.minSamples);
+            }
+        } else if (arg == "--min-time" && hasValue) {
+            options.minSeconds = std::atof(argv[++i]);
+        } else if (arg == "--targets" && hasValue) {
+            const std::string value = argv[++i];
+            options.targets = value == "all" ? aire::simdTargets() : splitList(value);
+        } else if (arg == "--json" && hasValue) {
+            options.json = argv[++i];
+        } else if (arg == "--list") {
+            listOnly = true;
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (options.threads.empty()) {
+        const int concurrency = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+        options.threads.push_back(1);
+        if (concurrency > 1) {
+            options.threads.push_back(concurrency);
+        }
+    }
+
+    std::vector<BenchCase> cases;
+    for (BenchCase &benchCase: buildCases()) {
+        const std::string fullName = benchCase.group + "/" + benchCase.name;
+        if (options.filter.empty() || fullName.find(options.filter) != std::string::npos) {
+            cases.push_back(std::move(benchCase));
+        }
+    }
+
+    if (listOnly) {
+        for (const BenchCase &benchCase: cases) {
+            std::printf("%s/%s\n", benchCase.group.c_str(), benchCase.name.c_str());
+        }
+        return 0;
+    }
+
+    if (options.targets.empty()) {
+        options.targets.push_back(aire::activeSimdTarget());
+    }
+    for (const std::string &target: options.targets) {
+        try {
+            aire::forceSimdTarget(target);
+        } catch (AireError &err) {
+            std::printf("%s\n", err.what());
+            return 1;
+        }
+    }
+    aire::forceSimdTarget("");
+
+    std::string available;
+    for (const std::string &target: aire::simdTargets()) {
+        available += (available.empty() ? "" : ",") + target;
+    }
+    std::printf("targets %s, best %s, %u hardware threads\n", available.c_str(), aire::activeSimdTarget().c_str(),
+                std::thread::hardware_concurrency());
+    std::printf("%-34s %-8s %11s %4s %4s %11s %9s %10s %6s %8s\n", "case", "target", "size", "thr", "rad",
+                "median ms", "mad ms", "Mpix/s", "B/px", "out B/px");
+
+    std::vector<BenchResult> results;
+    for (const std::string &target: options.targets) {
+        aire::forceSimdTarget(target);
+        for (const auto &[width, height]: options.sizes) {
+            const Frame frame = makeFrame(width, height);
+            for (const BenchCase &benchCase: cases) {
+                std::vector<int> radii;
+                for (int radius: options.radii) {
+                    if (benchCase.maxRadius > 0 && radius > 0 && radius <= benchCase.maxRadius) {
+                        radii.push_back(radius);
+                    }
+                }
+                if (benchCase.maxRadius == 0) {
+                    radii = {0};
+                }
+                for (const int threads: options.threads) {
+                    concurrency::threadsLimit().store(threads);
+                    for (const int radius: radii) {
+                        try {
+                            BenchResult result = measure(benchCase, frame, threads, radius, options);
+                            const std::string fullName = result.group + "/" + result.name;
+                            const std::string size = std::to_string(width) + "x" + std::to_string(height);
+                            std::printf("%-34s %-8s %11s %4d %4d %11.3f %9.3f %10.2f %6.1f %8.3f\n",
+                                        fullName.c_str(), result.target.c_str(), size.c_str(), result.threads,
+                                        result.radius, result.medianMs, result.madMs, result.mpixPerSecond,
+                                        result.bytesPerPixel, result.outputBytesPerPixel);
+                            std::fflush(stdout);
+                            results.push_back(std::move(result));
+                        } catch (AireError &err) {
+                            std::printf("%s/%s failed: %s\n", benchCase.group.c_str(), benchCase.name.c_str(),
+                                        err.what());
+                        }
+                    }
+                }
+            }
+        }
+    }
+    aire::forceSimdTarget("");
+    concurrency::threadsLimit().store(0);
+
+    if (!options.json.empty() && !writeJson(options.json, results)) {
+        std::printf("Cannot write %s\n", options.json.c_str());
+        return 1;
+    }
+    return 0;
+}
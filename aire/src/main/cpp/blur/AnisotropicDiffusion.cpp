@@ -33,6 +33,8 @@
 #include "hwy/highway.h"
 #include "algo/support-inl.h"
 #include "concurrency.hpp"
+#include "base/PaddedImage.h"
+#include <thread>
 
 using namespace std;
 using namespace hwy;
@@ -40,58 +42,54 @@ using namespace hwy::HWY_NAMESPACE;
 
 namespace aire {
 
-    inline float PerconaMalik(float I, float conduction) {
-        float K = I / conduction;
-        float diffusionTerm = 1.0 / (1.0 + K * K);
-        return diffusionTerm;
-    }
-
     void anisotropicDiffusion(uint8_t *data, int stride, int width, int height, float diffusion,
                               float conduction, int noOfTimeSteps) {
-        std::vector<uint8_t> transient(stride * height);
-        std::copy(data, data + stride * height, transient.begin());
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+        // Every step reads the previous one from a snapshot with replicated edges
+        PaddedImage previous(width, height, 4, 1, 1);
         for (int iteration = 0; iteration < noOfTimeSteps; ++iteration) {
-            concurrency::parallel_for(4, height, [&](int y) {
-                auto src = reinterpret_cast<uint8_t *>(
-                        reinterpret_cast<uint8_t *>(transient.data()) +
-                        y * stride);
-                for (int x = 0; x < width; ++x) {
-                    int nextX = clamp(x + 1, 0, width - 1);
-                    int nextY = clamp(y + 1, 0, height - 1);
-                    int previousX = clamp(x - 1, 0, width - 1);
-                    int previousY = clamp(y - 1, 0, height - 1);
-                    for (int channel = 0; channel < 3; ++channel) {
-                        float local = src[x * 4 + channel];
+            previous.load(data, stride, EDGE_CLAMP);
+            concurrency::parallel_for(threadCount, height, [&](int y) {
+                const FixedTag<uint8_t, 4> du8;
+                const FixedTag<uint32_t, 4> du32;
+                const FixedTag<float32_t, 4> dfx4;
+                using VF = Vec<decltype(dfx4)>;
+                const VF one = Set(dfx4, 1.f);
+                const VF vDiffusion = Set(dfx4, diffusion);
+                const VF vConduction = Set(dfx4, 1.f / conduction);
+                const VF zeros = Zero(dfx4);
+                const VF max255 = Set(dfx4, 255.f);
+                // Alpha is carried over untouched
+                const auto colorLanes = FirstN(dfx4, 3);
 
-                        float leftTopMagnitude = reinterpret_cast<uint8_t *>(
-                                                         reinterpret_cast<uint8_t *>(transient.data()) +
-                                                         previousY * stride)[previousX * 4 + channel] - local;
+                const uint8_t *top = previous.row(y - 1);
+                const uint8_t *center = previous.row(y);
+                const uint8_t *bottom = previous.row(y + 1);
+                uint8_t *dst = data + y * stride;
 
-                        float rightTopMagnitude = reinterpret_cast<uint8_t *>(
-                                                          reinterpret_cast<uint8_t *>(transient.data()) +
-                                                          previousY * stride)[nextX * 4 + channel] - local;
+                auto load = [&](const uint8_t *src) {
+                    return ConvertTo(dfx4, PromoteTo(du32, LoadU(du8, src)));
+                };
 
-                        float leftBottomMagnitude = reinterpret_cast<uint8_t *>(
-                                                            reinterpret_cast<uint8_t *>(transient.data()) +
-                                                            nextY * stride)[previousX * 4 + channel] - local;
+                // Perona-Malik conductance times the gradient
+                auto flux = [&](VF magnitude) {
+                    const VF k = Mul(magnitude, vConduction);
+                    return Mul(Div(one, MulAdd(k, k, one)), magnitude);
+                };
 
-                        float rightBottomMagnitude = reinterpret_cast<uint8_t *>(
-                                                             reinterpret_cast<uint8_t *>(transient.data()) +
-                                                             nextY * stride)[nextX * 4 + channel] - local;
-
-                        float currentPixel = src[x * 4 + channel];
-                        float param = diffusion * (PerconaMalik(leftTopMagnitude, conduction) * leftTopMagnitude +
-                                                   PerconaMalik(rightTopMagnitude, conduction) * rightTopMagnitude +
-                                                   PerconaMalik(leftBottomMagnitude, conduction) * leftBottomMagnitude +
-                                                   PerconaMalik(rightBottomMagnitude, conduction) * rightBottomMagnitude);
-                        float newValue = currentPixel * param;
-                        float updatedValue = currentPixel + newValue;
-                        src[x * 4 + channel] = clamp(ceil(updatedValue), 0.f, 255.f);
-                    }
+                for (int x = 0; x < width; ++x) {
+                    const int px = x * 4;
+                    const VF local = load(center + px);
+                    VF param = flux(Sub(load(top + px - 4), local));
+                    param = Add(param, flux(Sub(load(top + px + 4), local)));
+                    param = Add(param, flux(Sub(load(bottom + px - 4), local)));
+                    param = Add(param, flux(Sub(load(bottom + px + 4), local)));
+                    const VF updated = MulAdd(local, Mul(vDiffusion, param), local);
+                    const VF result = IfThenElse(colorLanes, Min(Max(Ceil(updated), zeros), max255), local);
+                    StoreU(DemoteTo(du8, ConvertTo(du32, result)), du8, dst + px);
                 }
             });
         }
-
-        std::copy(transient.begin(), transient.end(), data);
     }
-}
\ No newline at end of file
+}
@@ -28,6 +28,9 @@
  *
  */
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "blur/BoxBlur.cpp"
+
 #include "hwy/foreach_target.h"
 #include "hwy/highway.h"
 #include "algo/support-inl.h"
@@ -40,12 +43,14 @@
 #include <math.h>
 #include <thread>
 #include "base/Convolve1D.h"
-#include "jni/JNIUtils.h"
+#include "AireError.h"
 #include "concurrency.hpp"
+#include "base/ScratchArena.h"
 
 using namespace std;
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
@@ -59,7 +64,7 @@ namespace aire {
         }
 
         void convolve() {
-            std::vector<uint8_t> transient(stride *height);
+            ScratchLease transient = acquireScratch(stride * height);
             horizontalPass(reinterpret_cast<TFromD<D> *>(data), reinterpret_cast<TFromD<D> *>(transient.data()));
             verticalPass(reinterpret_cast<TFromD<D> *>(transient.data()), reinterpret_cast<TFromD<D> *>(data));
         }
@@ -189,7 +194,7 @@ namespace aire {
         }
 
         void convolve() {
-            std::vector<uint8_t> transient(stride *height);
+            ScratchLease transient = acquireScratch(stride * height);
             horizontalPass(reinterpret_cast<TFromD<D> *>(data), reinterpret_cast<TFromD<D> *>(transient.data()));
             verticalPass(reinterpret_cast<TFromD<D> *>(data), reinterpret_cast<TFromD<D> *>(transient.data()));
         }
@@ -381,18 +386,49 @@ namespace aire {
         }
     };
 
-    void boxBlurU8(uint8_t *data, int stride, int width, int height, int radius) {
+    void boxBlurU8HWY(uint8_t *data, int stride, int width, int height, int radius) {
         const FixedTag<uint8_t, 4> du8;
         BoxBlur boxBlur(du8, data, stride, width, height, radius);
         boxBlur.convolve();
     }
 
-    void boxBlurF16(uint16_t *data, int stride, int width, int height, int radius) {
+    void boxBlurF16HWY(uint16_t *data, int stride, int width, int height, int radius) {
         const FixedTag<hwy::float16_t, 4> df16x4;
         BoxBlur boxBlur(df16x4, reinterpret_cast<hwy::float16_t *>(data), stride, width, height, radius);
         boxBlur.convolve();
     }
 
+    void tentBlurHWY(uint8_t *data, int stride, int width, int height, const int size) {
+        const FixedTag<uint8_t, 4> du8;
+        TentBlur tentBlur(du8, data, stride, width, height, size);
+        tentBlur.convolve();
+    }
+
+    void tentBlurF16HWY(uint16_t *data, int stride, int width, int height, const int size) {
+        const FixedTag<hwy::float16_t, 4> df16x4;
+        TentBlur tentBlur(df16x4, reinterpret_cast<hwy::float16_t*>(data), stride, width, height, size);
+        tentBlur.convolve();
+    }
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(boxBlurU8HWY);
+    HWY_EXPORT(boxBlurF16HWY);
+    HWY_EXPORT(tentBlurHWY);
+    HWY_EXPORT(tentBlurF16HWY);
+
+    void boxBlurU8(uint8_t *data, int stride, int width, int height, int radius) {
+        HWY_DYNAMIC_DISPATCH(boxBlurU8HWY)(data, stride, width, height, radius);
+    }
+
+    void boxBlurF16(uint16_t *data, int stride, int width, int height, int radius) {
+        HWY_DYNAMIC_DISPATCH(boxBlurF16HWY)(data, stride, width, height, radius);
+    }
+
     std::vector<float> generateBoxKernel(int size) {
         if (size < 0) {
             std::string err = "Radius must be a non-negative integer but received " + std::to_string(size);
@@ -480,15 +516,12 @@ namespace aire {
     }
 
     void tentBlur(uint8_t *data, int stride, int width, int height, const int size) {
-        const FixedTag<uint8_t, 4> du8;
-        TentBlur tentBlur(du8, data, stride, width, height, size);
-        tentBlur.convolve();
+        HWY_DYNAMIC_DISPATCH(tentBlurHWY)(data, stride, width, height, size);
     }
 
     void tentBlurF16(uint16_t *data, int stride, int width, int height, const int size) {
-        const FixedTag<hwy::float16_t, 4> df16x4;
-        TentBlur tentBlur(df16x4, reinterpret_cast<hwy::float16_t*>(data), stride, width, height, size);
-        tentBlur.convolve();
+        HWY_DYNAMIC_DISPATCH(tentBlurF16HWY)(data, stride, width, height, size);
     }
 
-}
\ No newline at end of file
+}
+#endif
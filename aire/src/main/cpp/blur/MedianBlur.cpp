@@ -32,8 +32,10 @@
 #include <thread>
 #include "algo/median/QuickSelect.h"
 #include "algo/median/Wirth.h"
-#include "jni/JNIUtils.h"
+#include "AireError.h"
 #include "concurrency.hpp"
+#include "base/Cancellation.h"
+#include <cstring>
 
 using namespace std;
 
@@ -162,8 +164,10 @@ namespace aire {
         std::vector<uint8_t> transient(width * height);
 
         MedianHistogram histogram;
+        CancellablePass pass(height);
 
         for (int y = 0; y < height; ++y) {
+            pass.checkpoint();
             uint8_t *src = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * width);
             uint8_t *dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(transient.data()) + y * width);
             for (int x = 0; x < width; ++x) {
@@ -184,6 +188,7 @@ namespace aire {
                 dst += 1;
             }
         }
+        pass.complete();
 
         std::copy(transient.begin(), transient.end(), data);
     }
@@ -193,8 +198,10 @@ namespace aire {
         std::vector<uint8_t> transient(stride * height);
 
         MedianRGBHistogram histogram;
+        CancellablePass pass(height);
 
         for (int y = 0; y < height; ++y) {
+            pass.checkpoint();
             uint8_t *src = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
             uint8_t *dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(transient.data()) + y * stride);
             for (int x = 0; x < width; ++x) {
@@ -224,6 +231,7 @@ namespace aire {
                 dst += 4;
             }
         }
+        pass.complete();
 
         std::copy(transient.begin(), transient.end(), data);
     }
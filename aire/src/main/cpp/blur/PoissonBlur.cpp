@@ -34,23 +34,21 @@
 #include "Eigen/Eigen"
 #include <vector>
 #include <random>
-#include <chrono>
+#include <algorithm>
 
 namespace aire {
 
-    void poissonBlurF16(uint16_t *data, int stride, int width, int height, int radius) {
-        auto kernel = generatePoissonBlur(radius);
+    void poissonBlurF16(uint16_t *data, int stride, int width, int height, int radius, uint64_t seed) {
+        auto kernel = generatePoissonBlur(radius, seed);
         Convolve1Db16 convolution(kernel, kernel);
         convolution.convolve(data, stride, width, height);
     }
 
-    Eigen::MatrixXf generatePoissonBlur2D(int size) {
+    Eigen::MatrixXf generatePoissonBlur2D(int size, uint64_t seed) {
         std::poisson_distribution<> d(size);
         Eigen::MatrixXf kernel(size, size);
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        gen.seed(std::chrono::system_clock::now().time_since_epoch().count());
+        std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
 
         for (int j = 0; j < size; ++j) {
             for (int i = 0; i < size; ++i) {
@@ -78,40 +76,36 @@ namespace aire {
         return kernel;
     }
 
-    void poissonBlur(uint8_t *data, int stride, int width, int height, int kernelSize) {
-        auto kernel = generatePoissonBlur(kernelSize);
+    void poissonBlur(uint8_t *data, int stride, int width, int height, int kernelSize, uint64_t seed) {
+        auto kernel = generatePoissonBlur(kernelSize, seed);
         convolve1D(data, stride, width, height, kernel, kernel);
     }
 
-    std::vector<float> generatePoissonBlur(const int kernelSize) {
+    std::vector<float> generatePoissonBlur(const int kernelSize, uint64_t seed) {
         std::poisson_distribution<> d(kernelSize);
         std::vector<float> kernel(kernelSize, 1.0f / kernelSize);
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        gen.seed(std::chrono::system_clock::now().time_since_epoch().count());
-
-        for (int i = 0; i < kernelSize; ++i) {
-            kernel[i] = d(gen);
-        }
+        std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
 
         float sum = 0.f;
-        for (int i = 0; i < kernelSize; ++i) {
-            sum += kernel[i];
-        }
-
         int maxIter = 0;
-        while (sum == 0.f && maxIter < 50) {
-            kernel = generatePoissonBlur(kernelSize);
+        do {
+            sum = 0.f;
+            for (int i = 0; i < kernelSize; ++i) {
+                kernel[i] = d(gen);
+                sum += kernel[i];
+            }
             maxIter++;
-        }
+        } while (sum == 0.f && maxIter < 50);
 
         if (sum != 0.f) {
             for (int i = 0; i < kernelSize; ++i) {
                 kernel[i] /= sum;
             }
+        } else {
+            std::fill(kernel.begin(), kernel.end(), 1.0f / kernelSize);
         }
 
-        return std::move(kernel);
+        return kernel;
     }
 }
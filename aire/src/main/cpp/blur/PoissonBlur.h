@@ -34,9 +34,9 @@
 #include <vector>
 
 namespace aire {
-    void poissonBlur(uint8_t *data, int stride, int width, int height, const int kernelSize);
+    void poissonBlur(uint8_t *data, int stride, int width, int height, const int kernelSize, uint64_t seed);
 
-    void poissonBlurF16(uint16_t *data, int stride, int width, int height, const int kernelSize);
+    void poissonBlurF16(uint16_t *data, int stride, int width, int height, const int kernelSize, uint64_t seed);
 
-    std::vector<float> generatePoissonBlur(const int kernelSize);
+    std::vector<float> generatePoissonBlur(const int kernelSize, uint64_t seed);
 }
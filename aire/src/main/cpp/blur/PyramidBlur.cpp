@@ -0,0 +1,157 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "PyramidBlur.h"
+#include "base/ImagePyramid.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include "MathUtils.hpp"
+#include "concurrency.hpp"
+
+#if defined(__clang__)
+#pragma clang fp contract(fast) exceptions(ignore) reassociate(on)
+#endif
+
+namespace aire {
+
+    struct PyramidLevel {
+        std::vector<uint8_t> data;
+        int stride;
+        int width;
+        int height;
+        float scale;
+        float sigma;
+    };
+
+    struct LevelRow {
+        const uint8_t *row0;
+        const uint8_t *row1;
+        float weight;
+    };
+
+    static inline void sampleLevel(const PyramidLevel &level, const LevelRow &rows, const int x, float *out) {
+        float fx = std::max((static_cast<float>(x) + 0.5f) * level.scale - 0.5f, 0.f);
+        const int x0 = std::min(static_cast<int>(fx), level.width - 1);
+        const int x1 = std::min(x0 + 1, level.width - 1);
+        const float wx = fx - static_cast<float>(x0);
+        const uint8_t *p00 = rows.row0 + x0 * 4;
+        const uint8_t *p01 = rows.row0 + x1 * 4;
+        const uint8_t *p10 = rows.row1 + x0 * 4;
+        const uint8_t *p11 = rows.row1 + x1 * 4;
+        for (int c = 0; c < 4; ++c) {
+            const float top = p00[c] + (p01[c] - p00[c]) * wx;
+            const float bottom = p10[c] + (p11[c] - p10[c]) * wx;
+            out[c] = top + (bottom - top) * rows.weight;
+        }
+    }
+
+    void pyramidBlur(uint8_t *data, const int stride, const int width, const int height, const float maxSigma,
+                     const SigmaRowProvider &sigmaRow, const bool preserveAlpha) {
+        if (maxSigma <= 0.f) {
+            return;
+        }
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+
+        // Level 0 is the source itself, level k is reconstructed by bilinear upsampling, so it's effective
+        // sigma is accumulated binomial variance (4^k - 1) / 4 plus tent variance of 4^k / 6
+        std::vector<PyramidLevel> levels(1);
+        levels[0].stride = stride;
+        levels[0].width = width;
+        levels[0].height = height;
+        levels[0].scale = 1.f;
+        levels[0].sigma = 0.f;
+        while (levels.back().sigma < maxSigma && (levels.back().width > 1 || levels.back().height > 1)) {
+            const PyramidLevel &previous = levels.back();
+            PyramidLevel level;
+            level.width = (previous.width + 1) / 2;
+            level.height = (previous.height + 1) / 2;
+            level.stride = level.width * 4;
+            level.data.resize(level.stride * level.height);
+            const uint8_t *src = levels.size() == 1 ? data : previous.data.data();
+            pyramidDownsample(src, previous.stride, previous.width, previous.height, level.data.data(), level.stride);
+            const float power = std::powf(4.f, static_cast<float>(levels.size()));
+            level.scale = previous.scale * 0.5f;
+            level.sigma = std::sqrtf((power - 1.f) / 4.f + power / 6.f);
+            levels.emplace_back(std::move(level));
+        }
+
+        const int levelsCount = static_cast<int>(levels.size());
+        const int channels = preserveAlpha ? 3 : 4;
+
+        concurrency::parallel_for_segment(threadCount, height, [&](int start, int end) {
+            std::vector<float> sigmas(width);
+            std::vector<LevelRow> rows(levelsCount);
+            float lower[4], upper[4];
+            for (int y = start; y < end; ++y) {
+                sigmaRow(y, sigmas.data());
+                uint8_t *dst = data + y * stride;
+                rows[0] = {dst, dst, 0.f};
+                for (int k = 1; k < levelsCount; ++k) {
+                    const PyramidLevel &level = levels[k];
+                    float fy = std::max((static_cast<float>(y) + 0.5f) * level.scale - 0.5f, 0.f);
+                    const int y0 = std::min(static_cast<int>(fy), level.height - 1);
+                    const int y1 = std::min(y0 + 1, level.height - 1);
+                    rows[k] = {level.data.data() + y0 * level.stride,
+                               level.data.data() + y1 * level.stride,
+                               fy - static_cast<float>(y0)};
+                }
+
+                for (int x = 0; x < width; ++x) {
+                    const float sigma = sigmas[x];
+                    if (sigma <= 0.f) {
+                        continue;
+                    }
+                    int k = 0;
+                    while (k + 1 < levelsCount && levels[k + 1].sigma <= sigma) {
+                        ++k;
+                    }
+                    sampleLevel(levels[k], rows[k], x, lower);
+                    if (k + 1 < levelsCount) {
+                        sampleLevel(levels[k + 1], rows[k + 1], x, upper);
+                        // Interpolating in variance keeps blend variance exactly sigma^2
+                        const float lowerVariance = levels[k].sigma * levels[k].sigma;
+                        const float upperVariance = levels[k + 1].sigma * levels[k + 1].sigma;
+                        const float t = (sigma * sigma - lowerVariance) / (upperVariance - lowerVariance);
+                        for (int c = 0; c < channels; ++c) {
+                            lower[c] += (upper[c] - lower[c]) * t;
+                        }
+                    }
+                    uint8_t *px = dst + x * 4;
+                    for (int c = 0; c < channels; ++c) {
+                        px[c] = static_cast<uint8_t>(std::clamp(lower[c] + 0.5f, 0.f, 255.f));
+                    }
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,435 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "blur/RecursiveGaussian.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+#include "RecursiveGaussian.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "AireError.h"
+#include "concurrency.hpp"
+#include "base/ScratchArena.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    static constexpr int kRecursiveU8 = 0;
+    static constexpr int kRecursiveF16 = 1;
+    static constexpr int kRecursive1010102 = 2;
+
+    // Vertical pass filters strips of this many bytes of columns at once
+    static constexpr int kRecursiveStripBytes = 256;
+
+    /**
+     * Causal and anticausal passes over `count` samples, each sample is `sampleWidth` contiguous elements
+     * placed `sampleStride` elements apart, so rows are filtered pixel by pixel and strips of columns row by row.
+     * Input is extended by its edge values, with such extension causal output of the first sample equals input
+     */
+    template<class D>
+    void recursiveLine(D d, TFromD<D> *data, const int count, const size_t sampleStride, const int sampleWidth,
+                       const RecursiveGaussianCoefficients &c) {
+        using T = TFromD<D>;
+        using V = Vec<D>;
+        const V vb = Set(d, static_cast<T>(c.b));
+        const V va1 = Set(d, static_cast<T>(c.a1));
+        const V va2 = Set(d, static_cast<T>(c.a2));
+        const V va3 = Set(d, static_cast<T>(c.a3));
+        const int lanes = Lanes(d);
+
+        HWY_ALIGN T edge[kRecursiveStripBytes / sizeof(T)];
+        HWY_ALIGN T next1[kRecursiveStripBytes / sizeof(T)];
+        HWY_ALIGN T next2[kRecursiveStripBytes / sizeof(T)];
+
+        auto sample = [&](const int n) {
+            return data + static_cast<size_t>(std::max(n, 0)) * sampleStride;
+        };
+
+        std::copy(sample(count - 1), sample(count - 1) + sampleWidth, edge);
+
+        for (int n = 1; n < count; ++n) {
+            T *row = sample(n);
+            const T *p1 = sample(n - 1);
+            const T *p2 = sample(n - 2);
+            const T *p3 = sample(n - 3);
+            for (int i = 0; i < sampleWidth; i += lanes) {
+                V acc = Mul(va3, LoadU(d, p3 + i));
+                acc = MulAdd(va2, LoadU(d, p2 + i), acc);
+                acc = MulAdd(va1, LoadU(d, p1 + i), acc);
+                StoreU(MulAdd(vb, LoadU(d, row + i), acc), d, row + i);
+            }
+        }
+
+        T *tail = sample(count - 1);
+        const T *w1 = sample(count - 2);
+        const T *w2 = sample(count - 3);
+        for (int i = 0; i < sampleWidth; i += lanes) {
+            const V u = Load(d, edge + i);
+            const V d0 = Sub(LoadU(d, tail + i), u);
+            const V d1 = Sub(LoadU(d, w1 + i), u);
+            const V d2 = Sub(LoadU(d, w2 + i), u);
+            auto triggs = [&](const int k) {
+                V acc = Mul(Set(d, static_cast<T>(c.b * c.m[k * 3 + 2])), d2);
+                acc = MulAdd(Set(d, static_cast<T>(c.b * c.m[k * 3 + 1])), d1, acc);
+                acc = MulAdd(Set(d, static_cast<T>(c.b * c.m[k * 3])), d0, acc);
+                return Add(acc, u);
+            };
+            StoreU(triggs(0), d, tail + i);
+            Store(triggs(1), d, next1 + i);
+            Store(triggs(2), d, next2 + i);
+        }
+
+        auto after = [&](const int n) -> const T * {
+            if (n < count) {
+                return sample(n);
+            }
+            return n == count ? next1 : next2;
+        };
+
+        for (int n = count - 2; n >= 0; --n) {
+            T *row = sample(n);
+            const T *q1 = after(n + 1);
+            const T *q2 = after(n + 2);
+            const T *q3 = after(n + 3);
+            for (int i = 0; i < sampleWidth; i += lanes) {
+                V acc = Mul(va3, LoadU(d, q3 + i));
+                acc = MulAdd(va2, LoadU(d, q2 + i), acc);
+                acc = MulAdd(va1, LoadU(d, q1 + i), acc);
+                StoreU(MulAdd(vb, LoadU(d, row + i), acc), d, row + i);
+            }
+        }
+    }
+
+    /**
+     * Same passes as `recursiveLine` sample by sample, used for double precision on targets without f64 lanes
+     */
+    template<typename T>
+    void recursiveLineScalar(T *data, const int count, const size_t sampleStride, const int sampleWidth,
+                             const RecursiveGaussianCoefficients &c) {
+        const T b = static_cast<T>(c.b);
+        const T a1 = static_cast<T>(c.a1);
+        const T a2 = static_cast<T>(c.a2);
+        const T a3 = static_cast<T>(c.a3);
+
+        T edge[kRecursiveStripBytes / sizeof(T)];
+        T next1[kRecursiveStripBytes / sizeof(T)];
+        T next2[kRecursiveStripBytes / sizeof(T)];
+
+        auto sample = [&](const int n) {
+            return data + static_cast<size_t>(std::max(n, 0)) * sampleStride;
+        };
+
+        std::copy(sample(count - 1), sample(count - 1) + sampleWidth, edge);
+
+        for (int n = 1; n < count; ++n) {
+            T *row = sample(n);
+            const T *p1 = sample(n - 1);
+            const T *p2 = sample(n - 2);
+            const T *p3 = sample(n - 3);
+            for (int i = 0; i < sampleWidth; ++i) {
+                row[i] = b * row[i] + a1 * p1[i] + a2 * p2[i] + a3 * p3[i];
+            }
+        }
+
+        T *tail = sample(count - 1);
+        const T *w1 = sample(count - 2);
+        const T *w2 = sample(count - 3);
+        for (int i = 0; i < sampleWidth; ++i) {
+            const T u = edge[i];
+            const T d0 = tail[i] - u;
+            const T d1 = w1[i] - u;
+            const T d2 = w2[i] - u;
+            auto triggs = [&](const int k) {
+                return static_cast<T>(c.b * c.m[k * 3]) * d0 + static_cast<T>(c.b * c.m[k * 3 + 1]) * d1
+                       + static_cast<T>(c.b * c.m[k * 3 + 2]) * d2 + u;
+            };
+            tail[i] = triggs(0);
+            next1[i] = triggs(1);
+            next2[i] = triggs(2);
+        }
+
+        auto after = [&](const int n) -> const T * {
+            if (n < count) {
+                return sample(n);
+            }
+            return n == count ? next1 : next2;
+        };
+
+        for (int n = count - 2; n >= 0; --n) {
+            T *row = sample(n);
+            const T *q1 = after(n + 1);
+            const T *q2 = after(n + 2);
+            const T *q3 = after(n + 3);
+            for (int i = 0; i < sampleWidth; ++i) {
+                row[i] = b * row[i] + a1 * q1[i] + a2 * q2[i] + a3 * q3[i];
+            }
+        }
+    }
+
+    /**
+     * Filters `count` samples of `sampleWidth` elements with `lanes` wide vectors, 0 means full vector width
+     */
+    template<typename T, size_t lanes>
+    void recursiveSamples(T *data, const int count, const size_t sampleStride, const int sampleWidth,
+                          const RecursiveGaussianCoefficients &c) {
+#if !HWY_HAVE_FLOAT64
+        if constexpr (std::is_same_v<T, double>) {
+            recursiveLineScalar(data, count, sampleStride, sampleWidth, c);
+        } else
+#endif
+        if constexpr (lanes == 0) {
+            recursiveLine(ScalableTag<T>(), data, count, sampleStride, sampleWidth, c);
+        } else {
+            recursiveLine(CappedTag<T, lanes>(), data, count, sampleStride, sampleWidth, c);
+        }
+    }
+
+    template<int format, typename T>
+    void loadRecursiveRow(const uint8_t *src, T *dst, const int width) {
+        const FixedTag<float, 4> df;
+        const FixedTag<int32_t, 4> di;
+        const FixedTag<uint32_t, 4> du;
+        const FixedTag<uint8_t, 4> du8;
+        const FixedTag<hwy::float16_t, 4> df16;
+        HWY_ALIGN static constexpr uint32_t kShifts[4] = {0, 10, 20, 30};
+        HWY_ALIGN static constexpr uint32_t kMasks[4] = {1023, 1023, 1023, 3};
+
+        for (int x = 0; x < width; ++x) {
+            Vec<decltype(df)> pixel;
+            if constexpr (format == kRecursiveU8) {
+                pixel = ConvertTo(df, PromoteTo(di, LoadU(du8, src + x * 4)));
+            } else if constexpr (format == kRecursiveF16) {
+                pixel = PromoteTo(df, LoadU(df16, reinterpret_cast<const hwy::float16_t *>(src) + x * 4));
+            } else {
+                const auto packed = Set(du, reinterpret_cast<const uint32_t *>(src)[x]);
+                const auto channels = And(Shr(packed, Load(du, kShifts)), Load(du, kMasks));
+                pixel = ConvertTo(df, BitCast(di, channels));
+            }
+            if constexpr (std::is_same_v<T, float>) {
+                StoreU(pixel, df, dst + x * 4);
+            } else {
+                HWY_ALIGN float values[4];
+                Store(pixel, df, values);
+                std::copy(values, values + 4, dst + x * 4);
+            }
+        }
+    }
+
+    template<int format, typename T>
+    void storeRecursiveRow(const T *src, uint8_t *dst, const int width) {
+        const FixedTag<float, 4> df;
+        const FixedTag<int32_t, 4> di;
+        const FixedTag<uint32_t, 4> du;
+        const FixedTag<uint8_t, 4> du8;
+        const FixedTag<hwy::float16_t, 4> df16;
+        HWY_ALIGN static constexpr uint32_t kShifts[4] = {0, 10, 20, 30};
+        HWY_ALIGN static constexpr float kMaximums[4] = {1023.f, 1023.f, 1023.f, 3.f};
+        const auto zeros = Zero(df);
+
+        for (int x = 0; x < width; ++x) {
+            Vec<decltype(df)> pixel;
+            if constexpr (std::is_same_v<T, float>) {
+                pixel = LoadU(df, src + x * 4);
+            } else {
+                HWY_ALIGN float values[4];
+                std::copy(src + x * 4, src + x * 4 + 4, values);
+                pixel = Load(df, values);
+            }
+            if constexpr (format == kRecursiveU8) {
+                StoreU(DemoteTo(du8, NearestInt(pixel)), du8, dst + x * 4);
+            } else if constexpr (format == kRecursiveF16) {
+                StoreU(DemoteTo(df16, pixel), df16, reinterpret_cast<hwy::float16_t *>(dst) + x * 4);
+            } else {
+                const auto channels = BitCast(du, NearestInt(Min(Max(pixel, zeros), Load(df, kMaximums))));
+                const auto packed = Shl(channels, Load(du, kShifts));
+                // Channels occupy disjoint bits so their sum is the packed word
+                reinterpret_cast<uint32_t *>(dst)[x] = GetLane(SumOfLanes(du, packed));
+            }
+        }
+    }
+
+    template<int format, typename T>
+    void recursiveGaussian(uint8_t *data, const int stride, const int width, const int height,
+                           const RecursiveGaussianCoefficients &c) {
+        constexpr int stripElements = kRecursiveStripBytes / sizeof(T);
+        const int strips = (width * 4 + stripElements - 1) / stripElements;
+        const size_t pitch = static_cast<size_t>(strips) * stripElements;
+
+        ScratchLease working = acquireScratch(pitch * height * sizeof(T));
+        T *buffer = working.data<T>();
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    width * height / (256 * 256)), 1, 12);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            T *row = buffer + y * pitch;
+            loadRecursiveRow<format>(data + y * stride, row, width);
+            std::fill(row + width * 4, row + pitch, static_cast<T>(0));
+            recursiveSamples<T, 4>(row, width, 4, 4, c);
+        });
+
+        concurrency::parallel_for(threadCount, strips, [&](int strip) {
+            recursiveSamples<T, 0>(buffer + strip * stripElements, height, pitch, stripElements, c);
+        });
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            storeRecursiveRow<format>(buffer + y * pitch, data + y * stride, width);
+        });
+    }
+
+    template<int format>
+    void recursiveGaussianFormat(uint8_t *data, const int stride, const int width, const int height,
+                                 const RecursiveGaussianCoefficients &c, const bool wide) {
+        if (wide) {
+            recursiveGaussian<format, double>(data, stride, width, height, c);
+        } else {
+            recursiveGaussian<format, float>(data, stride, width, height, c);
+        }
+    }
+
+    void recursiveGaussianU8HWY(uint8_t *data, int stride, int width, int height,
+                                const RecursiveGaussianCoefficients &c, bool wide) {
+        recursiveGaussianFormat<kRecursiveU8>(data, stride, width, height, c, wide);
+    }
+
+    void recursiveGaussianF16HWY(uint8_t *data, int stride, int width, int height,
+                                 const RecursiveGaussianCoefficients &c, bool wide) {
+        recursiveGaussianFormat<kRecursiveF16>(data, stride, width, height, c, wide);
+    }
+
+    void recursiveGaussian1010102HWY(uint8_t *data, int stride, int width, int height,
+                                     const RecursiveGaussianCoefficients &c, bool wide) {
+        recursiveGaussianFormat<kRecursive1010102>(data, stride, width, height, c, wide);
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(recursiveGaussianU8HWY);
+    HWY_EXPORT(recursiveGaussianF16HWY);
+    HWY_EXPORT(recursiveGaussian1010102HWY);
+
+    // Gain of the feedback part grows as sigma^3, past this sigma float accumulation rounding becomes visible
+    static constexpr float kRecursiveFloatMaxSigma = 12.f;
+
+    /**
+     * Poles of Young, van Vliet and van Ginkel filter for sigma = 2, other sigmas scale them as p^(1/q)
+     */
+    static const std::complex<double> kRecursivePoles[3] = {{1.41650, 1.00829},
+                                                            {1.41650, -1.00829},
+                                                            {1.86543, 0}};
+
+    static double recursiveVariance(const double q) {
+        std::complex<double> sum = 0;
+        for (const auto &pole: kRecursivePoles) {
+            const std::complex<double> z = std::pow(pole, 1.0 / q);
+            sum += z / ((z - 1.0) * (z - 1.0));
+        }
+        return 2 * sum.real();
+    }
+
+    static double recursiveVarianceDerivative(const double q) {
+        std::complex<double> sum = 0;
+        for (const auto &pole: kRecursivePoles) {
+            const std::complex<double> z = std::pow(pole, 1.0 / q);
+            sum += z * std::log(z) * (z + 1.0) / ((z - 1.0) * (z - 1.0) * (z - 1.0));
+        }
+        return 2 * sum.real() / q;
+    }
+
+    RecursiveGaussianCoefficients recursiveGaussianCoefficients(const float sigma) {
+        if (!(sigma >= 0.5f && sigma <= 512.f)) {
+            std::string err = "Recursive gaussian supports sigma in [0.5, 512] but received " + std::to_string(sigma);
+            throw AireError(err);
+        }
+        const double variance = static_cast<double>(sigma) * sigma;
+        double q = sigma / 2.0;
+        for (int i = 0; i < 32; ++i) {
+            const double step = (recursiveVariance(q) - variance) / recursiveVarianceDerivative(q);
+            q -= step;
+            if (std::abs(step) < 1e-12 * q) {
+                break;
+            }
+        }
+
+        // Denominator (1 - z^-1 / p1)(1 - z^-1 / p2)(1 - z^-1 / p3)
+        const std::complex<double> d1 = 1.0 / std::pow(kRecursivePoles[0], 1.0 / q);
+        const std::complex<double> d2 = 1.0 / std::pow(kRecursivePoles[1], 1.0 / q);
+        const std::complex<double> d3 = 1.0 / std::pow(kRecursivePoles[2], 1.0 / q);
+
+        RecursiveGaussianCoefficients c{};
+        c.a1 = (d1 + d2 + d3).real();
+        c.a2 = -(d1 * d2 + d1 * d3 + d2 * d3).real();
+        c.a3 = (d1 * d2 * d3).real();
+        c.b = 1.0 - c.a1 - c.a2 - c.a3;
+
+        const double a1 = c.a1, a2 = c.a2, a3 = c.a3;
+        const double scale = 1.0 / ((1.0 + a1 - a2 + a3) * (1.0 - a1 - a2 - a3) * (1.0 + a2 + (a1 - a3) * a3));
+        c.m[0] = scale * (-a3 * a1 + 1.0 - a3 * a3 - a2);
+        c.m[1] = scale * (a3 + a1) * (a2 + a3 * a1);
+        c.m[2] = scale * a3 * (a1 + a3 * a2);
+        c.m[3] = scale * (a1 + a3 * a2);
+        c.m[4] = -scale * (a2 - 1.0) * (a2 + a3 * a1);
+        c.m[5] = -scale * a3 * (a3 * a1 + a3 * a3 + a2 - 1.0);
+        c.m[6] = scale * (a3 * a1 + a2 + a1 * a1 - a2 * a2);
+        c.m[7] = scale * (a1 * a2 + a3 * a2 * a2 - a1 * a3 * a3 - a3 * a3 * a3 - a3 * a2 + a3);
+        c.m[8] = scale * a3 * (a1 + a3 * a2);
+        return c;
+    }
+
+    void recursiveGaussianU8(uint8_t *data, int stride, int width, int height, float sigma) {
+        const RecursiveGaussianCoefficients c = recursiveGaussianCoefficients(sigma);
+        HWY_DYNAMIC_DISPATCH(recursiveGaussianU8HWY)(data, stride, width, height, c,
+                                                     sigma > kRecursiveFloatMaxSigma);
+    }
+
+    void recursiveGaussianF16(uint16_t *data, int stride, int width, int height, float sigma) {
+        const RecursiveGaussianCoefficients c = recursiveGaussianCoefficients(sigma);
+        HWY_DYNAMIC_DISPATCH(recursiveGaussianF16HWY)(reinterpret_cast<uint8_t *>(data), stride, width, height, c,
+                                                      sigma > kRecursiveFloatMaxSigma);
+    }
+
+    void recursiveGaussian1010102(uint8_t *data, int stride, int width, int height, float sigma) {
+        const RecursiveGaussianCoefficients c = recursiveGaussianCoefficients(sigma);
+        HWY_DYNAMIC_DISPATCH(recursiveGaussian1010102HWY)(data, stride, width, height, c,
+                                                          sigma > kRecursiveFloatMaxSigma);
+    }
+}
+#endif
@@ -0,0 +1,62 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace aire {
+
+    /**
+     * Third order recursive filter y[n] = b * x[n] + a1 * y[n - 1] + a2 * y[n - 2] + a3 * y[n - 3] with unit gain,
+     * `m` is Triggs - Sdika matrix restoring anticausal state for constant extension past the last sample
+     */
+    struct RecursiveGaussianCoefficients {
+        double b;
+        double a1;
+        double a2;
+        double a3;
+        double m[9];
+    };
+
+    /**
+     * Young - van Vliet coefficients with poles scaled so impulse response variance equals sigma^2 exactly
+     */
+    RecursiveGaussianCoefficients recursiveGaussianCoefficients(float sigma);
+
+    /**
+     * Recursive gaussian blur, cost per pixel does not depend on sigma, supported sigma is [0.5, 512]
+     */
+    void recursiveGaussianU8(uint8_t *data, int stride, int width, int height, float sigma);
+
+    void recursiveGaussianF16(uint16_t *data, int stride, int width, int height, float sigma);
+
+    void recursiveGaussian1010102(uint8_t *data, int stride, int width, int height, float sigma);
+}
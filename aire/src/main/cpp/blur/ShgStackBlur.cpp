@@ -32,6 +32,7 @@
 #include <iostream>
 #include <chrono>
 #include <bitset>
+#include <vector>
 
 using namespace std;
 using namespace std::chrono;
@@ -0,0 +1,116 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "VariableBoxBlur.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "base/SummedAreaTable.h"
+#include "conversion/HalfFloats.h"
+#include "concurrency.hpp"
+
+namespace aire {
+
+    using namespace std;
+
+    /**
+     * Mean of 4 channels over box of integer `radius` centered at (x, y) and clipped by the table bounds
+     */
+    template<typename T>
+    static void boxMean(const SummedAreaTable<T> &table, const int x, const int y, const int radius, float *mean) {
+        const int x0 = max(x - radius, 0);
+        const int y0 = max(y - radius, 0);
+        const int x1 = min(x + radius + 1, table.width);
+        const int y1 = min(y + radius + 1, table.height);
+        const float scale = 1.f / static_cast<float>((x1 - x0) * (y1 - y0));
+        for (int c = 0; c < 4; ++c) {
+            mean[c] = static_cast<float>(table.sum(x0, y0, x1, y1, c)) * scale;
+        }
+    }
+
+    template<typename T, typename V, typename Store>
+    static void variableBoxBlur(V *data, const int stride, const int width, const int height,
+                                const SummedAreaTable<T> &table, const int radiusLimit,
+                                const RadiusRowProvider &radiusRow, Store store) {
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+        const float maxRadius = static_cast<float>(min(max(width, height), radiusLimit));
+
+        concurrency::parallel_for_segment(threadCount, height, [&](int start, int end) {
+            std::vector<float> radii(width);
+            float lower[4], upper[4];
+            for (int y = start; y < end; ++y) {
+                radiusRow(y, radii.data());
+                auto dst = reinterpret_cast<V *>(reinterpret_cast<uint8_t *>(data) + y * stride);
+                for (int x = 0; x < width; ++x) {
+                    const float radius = min(radii[x], maxRadius);
+                    if (!(radius > 0.f)) {
+                        continue;
+                    }
+                    const int r0 = static_cast<int>(radius);
+                    const float t = radius - static_cast<float>(r0);
+                    boxMean(table, x, y, r0, lower);
+                    if (t > 0.f) {
+                        boxMean(table, x, y, r0 + 1, upper);
+                        for (int c = 0; c < 4; ++c) {
+                            lower[c] += (upper[c] - lower[c]) * t;
+                        }
+                    }
+                    store(dst + x * 4, lower);
+                }
+            }
+        });
+    }
+
+    void variableBoxBlurU8(uint8_t *data, const int stride, const int width, const int height,
+                           const RadiusRowProvider &radiusRow) {
+        const SummedAreaTable<uint32_t> table = summedAreaTableU8(data, stride, width, height, 4);
+        // Interpolation reads box of ceil(radius), so limit keeps it within exact range of 32 bit table
+        variableBoxBlur(data, stride, width, height, table, kSummedAreaMaxRadiusU8, radiusRow,
+                        [](uint8_t *px, const float *mean) {
+                            for (int c = 0; c < 4; ++c) {
+                                px[c] = static_cast<uint8_t>(std::clamp(mean[c] + 0.5f, 0.f, 255.f));
+                            }
+                        });
+    }
+
+    void variableBoxBlurF16(uint16_t *data, const int stride, const int width, const int height,
+                            const RadiusRowProvider &radiusRow) {
+        const SummedAreaTable<double> table = summedAreaTableF16(data, stride, width, height);
+        variableBoxBlur(data, stride, width, height, table, std::numeric_limits<int>::max(), radiusRow,
+                        [](uint16_t *px, const float *mean) {
+                            for (int c = 0; c < 4; ++c) {
+                                px[c] = float_to_half(mean[c]);
+                            }
+                        });
+    }
+}
@@ -0,0 +1,290 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 28/02/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "blur/ZoomBlur.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+#include "ZoomBlur.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "MathUtils.hpp"
+#include "concurrency.hpp"
+#include "base/ScratchArena.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    // Every tap is weight followed by 2x2 matrix applied to the offset from the center
+    static constexpr int kRadialTapFloats = 5;
+
+    /**
+     * Blends bilinear samples of all taps for pixels at offsets (dx, dy) from the center and stores them packed
+     */
+    template<class D>
+    HWY_INLINE void radialPixels(D df, const uint32_t *src, const int stride32, const int width, const int height,
+                                 const float cx, const float cy, const Vec<D> dx, const Vec<D> dy,
+                                 const float *taps, const int tapsCount, uint32_t *dst) {
+        const RebindToSigned<D> di;
+        const RebindToUnsigned<D> du;
+        using VF = Vec<D>;
+        using VI = Vec<decltype(di)>;
+        const VF maxX = Set(df, static_cast<float>(width - 1));
+        const VF maxY = Set(df, static_cast<float>(height - 1));
+        const VI lastX = Set(di, width - 1);
+        const VI lastY = Set(di, height - 1);
+        const VI strideV = Set(di, stride32);
+        const VI ones = Set(di, 1);
+        const auto mask = Set(du, 0xff);
+        const VF zeros = Zero(df);
+        const VF one = Set(df, 1.f);
+
+        VF r = zeros, g = zeros, b = zeros, a = zeros;
+
+        auto accumulate = [&](const VI index, const VF weight) {
+            const auto pixel = GatherIndex(du, src, index);
+            r = MulAdd(weight, ConvertTo(df, BitCast(di, And(pixel, mask))), r);
+            g = MulAdd(weight, ConvertTo(df, BitCast(di, And(ShiftRight<8>(pixel), mask))), g);
+            b = MulAdd(weight, ConvertTo(df, BitCast(di, And(ShiftRight<16>(pixel), mask))), b);
+            a = MulAdd(weight, ConvertTo(df, BitCast(di, ShiftRight<24>(pixel))), a);
+        };
+
+        for (int k = 0; k < tapsCount; ++k) {
+            const float *tap = taps + k * kRadialTapFloats;
+            const VF sx = Min(Max(MulAdd(Set(df, tap[1]), dx, MulAdd(Set(df, tap[2]), dy, Set(df, cx))), zeros), maxX);
+            const VF sy = Min(Max(MulAdd(Set(df, tap[3]), dx, MulAdd(Set(df, tap[4]), dy, Set(df, cy))), zeros), maxY);
+            const VF fx = Floor(sx);
+            const VF fy = Floor(sy);
+            const VF wx = Sub(sx, fx);
+            const VF wy = Sub(sy, fy);
+            const VI x0 = ConvertTo(di, fx);
+            const VI y0 = ConvertTo(di, fy);
+            const VI x1 = Min(Add(x0, ones), lastX);
+            const VI row0 = Mul(y0, strideV);
+            const VI row1 = Mul(Min(Add(y0, ones), lastY), strideV);
+            const VF weight = Set(df, tap[0]);
+            const VF top = Mul(weight, Sub(one, wy));
+            const VF bottom = Mul(weight, wy);
+            accumulate(Add(row0, x0), Mul(top, Sub(one, wx)));
+            accumulate(Add(row0, x1), Mul(top, wx));
+            accumulate(Add(row1, x0), Mul(bottom, Sub(one, wx)));
+            accumulate(Add(row1, x1), Mul(bottom, wx));
+        }
+
+        const VI max255 = Set(di, 255);
+        auto channel = [&](const VF v) {
+            return BitCast(du, Min(Max(NearestInt(v), Zero(di)), max255));
+        };
+        const auto packed = Or(Or(channel(r), ShiftLeft<8>(channel(g))),
+                               Or(ShiftLeft<16>(channel(b)), ShiftLeft<24>(channel(a))));
+        StoreU(packed, du, dst);
+    }
+
+    void radialPassHWY(const uint8_t *source, uint8_t *destination, const int stride, const int width,
+                       const int height, const float cx, const float cy, const float *taps, const int tapsLength) {
+        const ScalableTag<float> df;
+        const CappedTag<float, 1> df1;
+        const int lanes = Lanes(df);
+        const auto src = reinterpret_cast<const uint32_t *>(source);
+        const int stride32 = stride / 4;
+        const int tapsCount = tapsLength / kRadialTapFloats;
+
+        const int threadCount = std::clamp(std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                    width * height / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            auto dst = reinterpret_cast<uint32_t *>(destination + y * stride);
+            const auto iota = Iota(df, 0.f);
+            const auto dy = Set(df, static_cast<float>(y) - cy);
+            int x = 0;
+            for (; x + lanes <= width; x += lanes) {
+                const auto dx = Add(Set(df, static_cast<float>(x) - cx), iota);
+                radialPixels(df, src, stride32, width, height, cx, cy, dx, dy, taps, tapsCount, dst + x);
+            }
+            for (; x < width; ++x) {
+                radialPixels(df1, src, stride32, width, height, cx, cy, Set(df1, static_cast<float>(x) - cx),
+                             Set(df1, static_cast<float>(y) - cy), taps, tapsCount, dst + x);
+            }
+        });
+    }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+    HWY_EXPORT(radialPassHWY);
+
+    // Every pass samples at most this many taps, longer kernels are composed from passes with growing step
+    static constexpr int kRadialTaps = 8;
+    // Enough passes for box of 8^5 taps
+    static constexpr int kRadialMaxPasses = 5;
+
+    /**
+     * Transform of the offset from center for parameter t: scale for zoom, rotation for spin.
+     * Both form commutative groups, so pass with taps t1 followed by pass with taps t2 samples at t1 + t2
+     */
+    typedef std::function<void(float t, float *matrix)> RadialTransform;
+
+    typedef std::vector<float> RadialPass;
+
+    static void appendTap(RadialPass &pass, const float weight, const float t, const RadialTransform &transform) {
+        float matrix[4];
+        transform(t, matrix);
+        pass.push_back(weight);
+        pass.insert(pass.end(), matrix, matrix + 4);
+    }
+
+    /**
+     * Uniform box of `boxWidth` in t composed of passes with 8 taps each, every pass is 8 times finer than
+     * previous, until single step moves the farthest pixel by less than a pixel
+     */
+    static void appendBoxPasses(std::vector<RadialPass> &passes, const float boxWidth, const float reach,
+                                const RadialTransform &transform) {
+        float step = boxWidth / static_cast<float>(kRadialTaps);
+        int count = 0;
+        while (count < kRadialMaxPasses) {
+            RadialPass pass;
+            for (int i = 0; i < kRadialTaps; ++i) {
+                appendTap(pass, 1.f / static_cast<float>(kRadialTaps),
+                          (static_cast<float>(i) - static_cast<float>(kRadialTaps - 1) / 2.f) * step, transform);
+            }
+            passes.push_back(std::move(pass));
+            ++count;
+            if (step * reach <= 1.f) {
+                break;
+            }
+            step /= static_cast<float>(kRadialTaps);
+        }
+    }
+
+    static void applyRadialPasses(uint8_t *data, const int stride, const int width, const int height,
+                                  const float cx, const float cy, const std::vector<RadialPass> &passes) {
+        ScratchLease first = acquireScratch(stride * height);
+        ScratchLease second;
+        const uint8_t *source = data;
+        for (size_t i = 0; i < passes.size(); ++i) {
+            uint8_t *destination;
+            if (i + 1 == passes.size() && source != data) {
+                destination = data;
+            } else if (source == first.data()) {
+                if (!second.data()) {
+                    second = acquireScratch(stride * height);
+                }
+                destination = second.data();
+            } else {
+                destination = first.data();
+            }
+            const RadialPass &pass = passes[i];
+            HWY_DYNAMIC_DISPATCH(radialPassHWY)(source, destination, stride, width, height, cx, cy, pass.data(),
+                                                static_cast<int>(pass.size()));
+            source = destination;
+        }
+        if (source != data) {
+            std::copy(source, source + stride * height, data);
+        }
+    }
+
+    static float farthestCorner(const int width, const int height, const float cx, const float cy) {
+        const float fx = std::max(cx, static_cast<float>(width) - cx);
+        const float fy = std::max(cy, static_cast<float>(height) - cy);
+        return std::sqrt(fx * fx + fy * fy);
+    }
+
+    void zoomBlur(uint8_t *data, int stride, int width, int height, int kernelSize, float sigma,
+                  float centerX, float centerY, float strength, float angle) {
+        const int mean = kernelSize / 2;
+        if (kernelSize < 2 || strength == 0.f) {
+            return;
+        }
+        const float cx = std::floor(static_cast<float>(width) * centerX);
+        const float cy = std::floor(static_cast<float>(height) * centerY);
+        const float mx = std::cos(angle);
+        const float my = std::sin(angle);
+
+        // Outermost tap of the kernel reaches `mean * strength` percent of the distance to the center
+        const float extent = std::log1p(static_cast<float>(mean) * std::abs(strength) / 100.f);
+        const float tapStep = extent / static_cast<float>(mean);
+        const RadialTransform transform = [mx, my](const float t, float *matrix) {
+            matrix[0] = std::exp(t * mx);
+            matrix[1] = 0.f;
+            matrix[2] = 0.f;
+            matrix[3] = std::exp(t * my);
+        };
+
+        // Gaussian taps are merged into at most 8 bins, bins are filled by the box passes
+        const std::vector<float> gaussian = compute1DGaussianKernel(kernelSize, sigma);
+        const int bins = std::min(kernelSize, kRadialTaps);
+        const float binWidth = static_cast<float>(kernelSize) / static_cast<float>(bins);
+        std::vector<float> weights(bins, 0.f);
+        for (int j = 0; j < kernelSize; ++j) {
+            for (int bin = 0; bin < bins; ++bin) {
+                const float overlap = std::min(static_cast<float>(j + 1), (bin + 1) * binWidth) -
+                                      std::max(static_cast<float>(j), bin * binWidth);
+                if (overlap > 0.f) {
+                    weights[bin] += gaussian[j] * overlap;
+                }
+            }
+        }
+
+        std::vector<RadialPass> passes(1);
+        for (int bin = 0; bin < bins; ++bin) {
+            const float position = (static_cast<float>(bin) + 0.5f) * binWidth - 0.5f - static_cast<float>(mean);
+            appendTap(passes[0], weights[bin], position * tapStep, transform);
+        }
+        const float reach = farthestCorner(width, height, cx, cy) * std::max(std::abs(mx), std::abs(my)) *
+                            std::exp(extent);
+        appendBoxPasses(passes, binWidth * tapStep, reach, transform);
+        applyRadialPasses(data, stride, width, height, cx, cy, passes);
+    }
+
+    void spinBlur(uint8_t *data, int stride, int width, int height, float centerX, float centerY, float angle) {
+        if (angle == 0.f) {
+            return;
+        }
+        const float cx = std::floor(static_cast<float>(width) * centerX);
+        const float cy = std::floor(static_cast<float>(height) * centerY);
+        const RadialTransform transform = [](const float t, float *matrix) {
+            matrix[0] = std::cos(t);
+            matrix[1] = -std::sin(t);
+            matrix[2] = std::sin(t);
+            matrix[3] = std::cos(t);
+        };
+        std::vector<RadialPass> passes;
+        appendBoxPasses(passes, std::abs(angle), farthestCorner(width, height, cx, cy), transform);
+        applyRadialPasses(data, stride, width, height, cx, cy, passes);
+    }
+}
+#endif
@@ -0,0 +1,51 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 28/02/24, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace aire {
+
+    /**
+     * Radial zoom blur around (centerX, centerY) given as fractions of the frame. Samples of `kernelSize` taps
+     * gaussian are spaced geometrically, so blur grows with distance from the center, `strength` is percent
+     * of the distance to the center covered by one tap. `angle` weights horizontal and vertical zoom as
+     * cos and sin of it. Long kernels are composed from short bilinear passes, so cost grows as log of blur length
+     */
+    void zoomBlur(uint8_t *data, int stride, int width, int height, int kernelSize, float sigma,
+                  float centerX, float centerY, float strength, float angle);
+
+    /**
+     * Rotational blur around (centerX, centerY) given as fractions of the frame, `angle` is arc in radians
+     * every pixel is smeared along
+     */
+    void spinBlur(uint8_t *data, int stride, int width, int height, float centerX, float centerY, float angle);
+}
@@ -34,6 +34,7 @@
 #include "color/Blend.h"
 #include "color/eotf-inl.h"
 #include "concurrency.hpp"
+#include "base/LUT8.h"
 
 namespace aire {
 
@@ -61,27 +62,7 @@ namespace aire {
     }
 
     void adjustment(uint8_t *data, int stride, int width, int height, float gain, float bias) {
-        const Eigen::Vector3f fBias = {bias, bias, bias};
-        const Eigen::Vector3f balance = {0.5f, 0.5f, 0.5f};
-        concurrency::parallel_for(4, height, [&](int y) {
-            auto pixels = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
-            int x = 0;
-
-            for (; x < width; ++x) {
-                Eigen::Vector3f rgb;
-                rgb << pixels[0], pixels[1], pixels[2];
-                rgb /= 255.f;
-
-                rgb = gain * (rgb - balance) + balance + fBias;
-                rgb = (rgb * 255.f).array().max(0.f).min(255.f);
-
-                pixels[0] = rgb.x();
-                pixels[1] = rgb.y();
-                pixels[2] = rgb.z();
-
-                pixels += 4;
-            }
-        });
+        LUT8::adjustment(gain, bias).apply(data, stride, width, height);
     }
 
 }
\ No newline at end of file
@@ -28,8 +28,13 @@
  *
  */
 
-#include "ConvolveToneMapper.h"
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "color/ConvolveToneMapper.cpp"
+
+#include "hwy/foreach_target.h"
 #include "hwy/highway.h"
+
+#include "ConvolveToneMapper.h"
 #include "color/eotf-inl.h"
 #include "tone/LogarithmicToneMapper.hpp"
 #include "tone/AcesFilmicToneMapper.hpp"
@@ -47,11 +52,11 @@
 #include "Eigen/Eigen"
 #include "color/Blend.h"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
-    using namespace aire::HWY_NAMESPACE;
 
     void convolveToneMapper(uint8_t *data, int stride, int width, int height, ToneMapper<FixedTag<float32_t, 4>> *toneMapper) {
         const FixedTag<uint8_t, 4> du;
@@ -116,7 +121,7 @@ namespace aire {
         });
     }
 
-    void logarithmic(uint8_t *data, int stride, int width, int height, float exposure) {
+    void logarithmicHWY(uint8_t *data, int stride, int width, int height, float exposure) {
         const float rPrimary = 0.299f;
         const float gPrimary = 0.587f;
         const float bPrimary = 0.114f;
@@ -126,22 +131,22 @@ namespace aire {
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void acesFilm(uint8_t *data, int stride, int width, int height, float exposure) {
+    void acesFilmHWY(uint8_t *data, int stride, int width, int height, float exposure) {
         AcesFilmicToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void mobius(uint8_t *data, int stride, int width, int height, float exposure, float transition, float peak) {
+    void mobiusHWY(uint8_t *data, int stride, int width, int height, float exposure, float transition, float peak) {
         MobiusToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure, transition, peak);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void aldridge(uint8_t *data, int stride, int width, int height, float exposure, float cutoff) {
+    void aldridgeHWY(uint8_t *data, int stride, int width, int height, float exposure, float cutoff) {
         AldridgeToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure, cutoff);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void drago(uint8_t *data, int stride, int width, int height, float exposure, float sdrWhitePoint) {
+    void dragoHWY(uint8_t *data, int stride, int width, int height, float exposure, float sdrWhitePoint) {
         const float rPrimary = 0.299f;
         const float gPrimary = 0.587f;
         const float bPrimary = 0.114f;
@@ -151,32 +156,32 @@ namespace aire {
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void uchimura(uint8_t *data, int stride, int width, int height, float exposure) {
+    void uchimuraHWY(uint8_t *data, int stride, int width, int height, float exposure) {
         UchimuraToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void exposure(uint8_t *data, int stride, int width, int height, float exposure) {
+    void exposureHWY(uint8_t *data, int stride, int width, int height, float exposure) {
         ExposureToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void hejlBurgess(uint8_t *data, int stride, int width, int height, float exposure) {
+    void hejlBurgessHWY(uint8_t *data, int stride, int width, int height, float exposure) {
         HejlBurgessToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void hableFilmic(uint8_t *data, int stride, int width, int height, float exposure) {
+    void hableFilmicHWY(uint8_t *data, int stride, int width, int height, float exposure) {
         HableFilmicToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void acesHill(uint8_t *data, int stride, int width, int height, float exposure) {
+    void acesHillHWY(uint8_t *data, int stride, int width, int height, float exposure) {
         AcesFilmicToneMapper<FixedTag<float32_t, 4>> toneMapper(exposure);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
 
-    void monochrome(uint8_t *data, int stride, int width, int height, float colors[4], float exposure) {
+    void monochromeHWY(uint8_t *data, int stride, int width, int height, float colors[4], float exposure) {
         const float rPrimary = 0.299f;
         const float gPrimary = 0.587f;
         const float bPrimary = 0.114f;
@@ -185,6 +190,77 @@ namespace aire {
         MonochromeToneMapper<FixedTag<float32_t, 4>> toneMapper(colors, coeffs, exposure);
         convolveToneMapper(data, stride, width, height, &toneMapper);
     }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(logarithmicHWY);
+
+    void logarithmic(uint8_t *data, int stride, int width, int height, float exposure) {
+        HWY_DYNAMIC_DISPATCH(logarithmicHWY)(data, stride, width, height, exposure);
+    }
+
+    HWY_EXPORT(acesFilmHWY);
+
+    void acesFilm(uint8_t *data, int stride, int width, int height, float exposure) {
+        HWY_DYNAMIC_DISPATCH(acesFilmHWY)(data, stride, width, height, exposure);
+    }
+
+    HWY_EXPORT(mobiusHWY);
+
+    void mobius(uint8_t *data, int stride, int width, int height, float exposure, float transition, float peak) {
+        HWY_DYNAMIC_DISPATCH(mobiusHWY)(data, stride, width, height, exposure, transition, peak);
+    }
+
+    HWY_EXPORT(aldridgeHWY);
+
+    void aldridge(uint8_t *data, int stride, int width, int height, float exposure, float cutoff) {
+        HWY_DYNAMIC_DISPATCH(aldridgeHWY)(data, stride, width, height, exposure, cutoff);
+    }
+
+    HWY_EXPORT(dragoHWY);
+
+    void drago(uint8_t *data, int stride, int width, int height, float exposure, float sdrWhitePoint) {
+        HWY_DYNAMIC_DISPATCH(dragoHWY)(data, stride, width, height, exposure, sdrWhitePoint);
+    }
+
+    HWY_EXPORT(uchimuraHWY);
+
+    void uchimura(uint8_t *data, int stride, int width, int height, float exposure) {
+        HWY_DYNAMIC_DISPATCH(uchimuraHWY)(data, stride, width, height, exposure);
+    }
+
+    HWY_EXPORT(exposureHWY);
+
+    void exposure(uint8_t *data, int stride, int width, int height, float exposure) {
+        HWY_DYNAMIC_DISPATCH(exposureHWY)(data, stride, width, height, exposure);
+    }
+
+    HWY_EXPORT(hejlBurgessHWY);
+
+    void hejlBurgess(uint8_t *data, int stride, int width, int height, float exposure) {
+        HWY_DYNAMIC_DISPATCH(hejlBurgessHWY)(data, stride, width, height, exposure);
+    }
+
+    HWY_EXPORT(hableFilmicHWY);
+
+    void hableFilmic(uint8_t *data, int stride, int width, int height, float exposure) {
+        HWY_DYNAMIC_DISPATCH(hableFilmicHWY)(data, stride, width, height, exposure);
+    }
+
+    HWY_EXPORT(acesHillHWY);
+
+    void acesHill(uint8_t *data, int stride, int width, int height, float exposure) {
+        HWY_DYNAMIC_DISPATCH(acesHillHWY)(data, stride, width, height, exposure);
+    }
+
+    HWY_EXPORT(monochromeHWY);
+
+    void monochrome(uint8_t *data, int stride, int width, int height, float colors[4], float exposure) {
+        HWY_DYNAMIC_DISPATCH(monochromeHWY)(data, stride, width, height, colors, exposure);
+    }
 
     void whiteBalance(uint8_t *data, int stride, int width, int height, const float temperature, const float tnt) {
         Eigen::Matrix3f RGBtoYIG;
@@ -223,4 +299,6 @@ namespace aire {
             }
         });
     }
-}
\ No newline at end of file
+
+}
+#endif
@@ -2,13 +2,19 @@
 // Created by Radzivon Bartoshyk on 04/02/2024.
 //
 
-#pragma once
+#if defined(AIRE_ACES_FILMIC_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_ACES_FILMIC_TONE_MAPPER_INL_H_
+#undef AIRE_ACES_FILMIC_TONE_MAPPER_INL_H_
+#else
+#define AIRE_ACES_FILMIC_TONE_MAPPER_INL_H_
+#endif
 
 #include "ToneMapper.h"
 #include <fast_math-inl.h>
 #include "Eigen/Eigen"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     template<typename D>
     class AcesFilmicToneMapper : public ToneMapper<D> {
     private:
@@ -70,4 +76,7 @@ namespace aire {
             return ((x.array() * (a * x.array() + b)) / (x.array() * (c * x.array() + d) + e)).max(0.f).min(1.0f);
         }
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
@@ -2,10 +2,18 @@
 // Created by Radzivon Bartoshyk on 04/02/2024.
 //
 
+#if defined(AIRE_ACES_HILL_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_ACES_HILL_TONE_MAPPER_INL_H_
+#undef AIRE_ACES_HILL_TONE_MAPPER_INL_H_
+#else
+#define AIRE_ACES_HILL_TONE_MAPPER_INL_H_
+#endif
+
 #include "ToneMapper.h"
 #include <fast_math-inl.h>
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     template<typename D>
     class AcesHillToneMapper : public ToneMapper<D> {
     private:
@@ -91,4 +99,7 @@ namespace aire {
             return Cout;
         }
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
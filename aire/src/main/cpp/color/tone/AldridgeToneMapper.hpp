@@ -2,14 +2,20 @@
 // Created by Radzivon Bartoshyk on 16/02/2024.
 //
 
-#pragma once
+#if defined(AIRE_ALDRIDGE_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_ALDRIDGE_TONE_MAPPER_INL_H_
+#undef AIRE_ALDRIDGE_TONE_MAPPER_INL_H_
+#else
+#define AIRE_ALDRIDGE_TONE_MAPPER_INL_H_
+#endif
 
 #include "ToneMapper.h"
 #include <fast_math-inl.h>
 #include <algorithm>
 #include "Eigen/Eigen"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     template<typename D>
     class AldridgeToneMapper : public ToneMapper<D> {
     private:
@@ -73,4 +79,7 @@ namespace aire {
             b = aldridge(b);
         }
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
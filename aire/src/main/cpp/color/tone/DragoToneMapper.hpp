@@ -2,13 +2,19 @@
 // Created by Radzivon Bartoshyk on 17/02/2024.
 //
 
-#pragma once
+#if defined(AIRE_DRAGO_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_DRAGO_TONE_MAPPER_INL_H_
+#undef AIRE_DRAGO_TONE_MAPPER_INL_H_
+#else
+#define AIRE_DRAGO_TONE_MAPPER_INL_H_
+#endif
 
 #include "ToneMapper.h"
 #include <fast_math-inl.h>
 #include "sleef-hwy.h"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     template<typename D>
     class DragoToneMapper : public ToneMapper<D> {
     private:
@@ -116,4 +122,7 @@ namespace aire {
 
         TFromD<D> lumaCoefficients[4];
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
@@ -2,13 +2,19 @@
 // Created by Radzivon Bartoshyk on 04/02/2024.
 //
 
-#pragma once
+#if defined(AIRE_HEJL_BURGESS_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_HEJL_BURGESS_TONE_MAPPER_INL_H_
+#undef AIRE_HEJL_BURGESS_TONE_MAPPER_INL_H_
+#else
+#define AIRE_HEJL_BURGESS_TONE_MAPPER_INL_H_
+#endif
 
 #include "ToneMapper.h"
 #include <fast_math-inl.h>
 #include <algorithm>
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     template<typename D>
     class HejlBurgessToneMapper : public ToneMapper<D> {
     private:
@@ -59,4 +65,7 @@ namespace aire {
         }
 
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
@@ -2,12 +2,18 @@
 // Created by Radzivon Bartoshyk on 04/02/2024.
 //
 
-#pragma once
+#if defined(AIRE_LOGARITHMIC_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_LOGARITHMIC_TONE_MAPPER_INL_H_
+#undef AIRE_LOGARITHMIC_TONE_MAPPER_INL_H_
+#else
+#define AIRE_LOGARITHMIC_TONE_MAPPER_INL_H_
+#endif
 
 #include "ToneMapper.h"
 #include <fast_math-inl.h>
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     template<typename D>
     class LogarithmicToneMapper : public ToneMapper<D> {
     private:
@@ -74,4 +80,7 @@ namespace aire {
     private:
         TFromD<D> lumaCoefficients[4];
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
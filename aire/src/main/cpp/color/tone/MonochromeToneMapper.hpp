@@ -2,12 +2,20 @@
 // Created by Radzivon Bartoshyk on 05/02/2024.
 //
 
+#if defined(AIRE_MONOCHROME_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_MONOCHROME_TONE_MAPPER_INL_H_
+#undef AIRE_MONOCHROME_TONE_MAPPER_INL_H_
+#else
+#define AIRE_MONOCHROME_TONE_MAPPER_INL_H_
+#endif
+
 #include "ToneMapper.h"
 #include "color/Blend.h"
 #include <fast_math-inl.h>
 #include <algorithm>
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     template<typename D>
     class MonochromeToneMapper : public ToneMapper<D> {
     private:
@@ -87,4 +95,7 @@ namespace aire {
         }
 
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
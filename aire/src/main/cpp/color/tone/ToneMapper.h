@@ -2,11 +2,17 @@
 // Created by Radzivon Bartoshyk on 04/02/2024.
 //
 
-#pragma once
+#if defined(AIRE_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_TONE_MAPPER_INL_H_
+#undef AIRE_TONE_MAPPER_INL_H_
+#else
+#define AIRE_TONE_MAPPER_INL_H_
+#endif
 
 #include "hwy/highway.h"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
 
@@ -23,4 +29,7 @@ namespace aire {
 
         }
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
@@ -2,14 +2,20 @@
 // Created by Radzivon Bartoshyk on 16/02/2024.
 //
 
-#pragma once
+#if defined(AIRE_UCHIMURA_TONE_MAPPER_INL_H_) == defined(HWY_TARGET_TOGGLE)
+#ifdef AIRE_UCHIMURA_TONE_MAPPER_INL_H_
+#undef AIRE_UCHIMURA_TONE_MAPPER_INL_H_
+#else
+#define AIRE_UCHIMURA_TONE_MAPPER_INL_H_
+#endif
 
 #include "ToneMapper.h"
 #include <fast_math-inl.h>
 #include <algorithm>
 #include "Eigen/Eigen"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
     template<typename D>
     class UchimuraToneMapper : public ToneMapper<D> {
     private:
@@ -31,7 +37,7 @@ namespace aire {
         }
 
         HWY_FAST_MATH_INLINE TFromD<D> smoothstep(TFromD<D> edge0, TFromD<D> edge1, TFromD<D> x) {
-            TFromD<D> t = clamp((x - edge0) / (edge1 - edge0), TFromD<D>(0), TFromD<D>(1));
+            TFromD<D> t = std::clamp((x - edge0) / (edge1 - edge0), TFromD<D>(0), TFromD<D>(1));
             return t * t * (TFromD<D>(3) - TFromD<D>(2) * t);
         }
 
@@ -124,4 +130,7 @@ namespace aire {
             b = uchimura(b);
         }
     };
-}
\ No newline at end of file
+}
+HWY_AFTER_NAMESPACE();
+
+#endif
@@ -30,6 +30,7 @@
 #define JXL_COPYUNALIGNEDRGBA_H
 
 #include <vector>
+#include <cstdint>
 
 namespace aire {
     void
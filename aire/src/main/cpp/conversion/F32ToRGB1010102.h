@@ -30,6 +30,7 @@
 #define JXLCODER_F32TORGB1010102_H
 
 #include <vector>
+#include <cstdint>
 
 namespace coder {
     void
@@ -30,6 +30,7 @@
 #define AVIF_RGB1010102_H
 
 #include <vector>
+#include <cstdint>
 
 namespace aire {
 
@@ -42,7 +42,6 @@ using namespace std;
 #include <hwy/highway.h>
 #include "hwy/base.h"
 
-#include <android/log.h>
 
 HWY_BEFORE_NAMESPACE();
 namespace aire::HWY_NAMESPACE {
@@ -57,7 +56,7 @@ namespace aire::HWY_NAMESPACE {
         int x = 0;
         auto srcPixels = reinterpret_cast<const TFromD<D> *>(src);
         auto dstPixels = reinterpret_cast<TFromD<D> *>(dst);
-        const int pixels = du.MaxLanes();
+        const int pixels = Lanes(du);
 
         int idx1 = permuteMap[0];
         int idx2 = permuteMap[1];
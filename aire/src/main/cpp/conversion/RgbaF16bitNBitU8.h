@@ -30,6 +30,7 @@
 #define AVIF_RGBAF16BITNBITU8_H
 
 #include <vector>
+#include <cstdint>
 
 namespace aire {
     void RGBAF16BitToNBitU8(const uint16_t *sourceData, int srcStride,
@@ -36,7 +36,7 @@
 using namespace std;
 
 #undef HWY_TARGET_INCLUDE
-#define HWY_TARGET_INCLUDE "YuvConverter.cpp"
+#define HWY_TARGET_INCLUDE "conversion/yuv/YuvConverter.cpp"
 
 #include "hwy/foreach_target.h"
 #include "hwy/highway.h"
@@ -29,181 +29,254 @@
  */
 
 #include "CrystallizeEffect.h"
-#include "algo/jc_voronoi.h"
-#include <memory>
 #include <vector>
-#include <random>
 #include <algorithm>
+#include <limits>
+#include <thread>
+#include <cmath>
 #include "algo/MathUtils.hpp"
-#include "jni/JNIUtils.h"
+#include "algo/concurrency.hpp"
+#include "AireError.h"
 #include "color/Blend.h"
 
 namespace aire {
 
-    static inline jcv_point
-    remap(const jcv_point *pt, const jcv_point *min, const jcv_point *max, const jcv_point *scale) {
-        jcv_point p;
-        p.x = (pt->x - min->x) / (max->x - min->x) * scale->x;
-        p.y = (pt->y - min->y) / (max->y - min->y) * scale->y;
-        return p;
+    static inline uint64_t splitMix64(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
     }
 
-    void
-    drawLine(uint8_t *bitmap, int color, int stride, int width, int height, int x1, int y1, int x2,
-             int y2) {
-        int dx = x2 - x1;
-        int dy = y2 - y1;
-        int steps = (abs(dx) > abs(dy)) ? abs(dx) : abs(dy);
-
-        float xIncrement = static_cast<float>(dx) / static_cast<float>(steps);
-        float yIncrement = static_cast<float>(dy) / static_cast<float>(steps);
-
-        float x = static_cast<float>(x1);
-        float y = static_cast<float>(y1);
-
-        uint8_t a1 = color >> 24 & 0xff;
-        uint8_t r1 = color >> 16 & 0xff;
-        uint8_t g1 = color >> 8 & 0xff;
-        uint8_t b1 = color & 0xff;
-
-        for (int i = 0; i <= steps; ++i) {
-            if (x >= 0 && x < width && y >= 0 && y < height) {
-                uint8_t *src = reinterpret_cast<uint8_t *>((reinterpret_cast<uint8_t *>(bitmap) +
-                                                            static_cast<int>(y) * stride));
-                int pos = static_cast<int>(x);
-                if (pos < 0 || pos >= width) { continue;}
-                pos *= 4;
-                uint8_t a = src[static_cast<int>(x * 4 + 3)];
-                uint8_t b = src[static_cast<int>(x * 4 + 2)];
-                uint8_t g = src[static_cast<int>(x * 4 + 1)];
-                uint8_t r = src[static_cast<int>(x * 4)];
-                uint8_t resultingAlpha = a1 + (a * (255 - a1) + 127) / 255;
-                uint8_t newB = blendColor(b1, b, a1);
-                uint8_t newR = blendColor(r1, r, a1);
-                uint8_t newG = blendColor(g1, g, a1);
-                src[static_cast<int>(x * 4)] = newR;
-                src[static_cast<int>(x * 4 + 1)] = newG;
-                src[static_cast<int>(x * 4 + 2)] = newB;
-                src[static_cast<int>(x * 4 + 3)] = resultingAlpha;
+    /**
+     * Uniform grid of Voronoi seeds, each cell holds approximately one seed and keeps the short list of seeds
+     * that may be the nearest one for any of its pixels, so labelling costs a few distance checks per pixel
+     */
+    class SeedGrid {
+    public:
+        SeedGrid(const std::vector<int> &xs, const std::vector<int> &ys, int width, int height, int threadCount) {
+            const int numSeeds = static_cast<int>(xs.size());
+            cellSize = std::max(static_cast<int>(std::sqrt(static_cast<float>(width) * static_cast<float>(height) /
+                                                           static_cast<float>(numSeeds))), 1);
+            gridWidth = (width + cellSize - 1) / cellSize;
+            gridHeight = (height + cellSize - 1) / cellSize;
+
+            std::vector<int> offsets(gridWidth * gridHeight + 1, 0);
+            for (int i = 0; i < numSeeds; ++i) {
+                offsets[cellOf(xs[i], ys[i]) + 1] += 1;
+            }
+            for (int i = 0; i < gridWidth * gridHeight; ++i) {
+                offsets[i + 1] += offsets[i];
+            }
+            std::vector<int> buckets(numSeeds);
+            std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+            for (int i = 0; i < numSeeds; ++i) {
+                buckets[cursor[cellOf(xs[i], ys[i])]++] = i;
+            }
+
+            std::vector<std::vector<Candidate>> rows(gridHeight);
+            std::vector<std::vector<int>> rowCounts(gridHeight, std::vector<int>(gridWidth, 0));
+            concurrency::parallel_for(threadCount, gridHeight, [&](int gy) {
+                std::vector<Candidate> visited;
+                std::vector<int64_t> minDistances;
+                for (int gx = 0; gx < gridWidth; ++gx) {
+                    const int x0 = gx * cellSize, x1 = std::min(x0 + cellSize, width) - 1;
+                    const int y0 = gy * cellSize, y1 = std::min(y0 + cellSize, height) - 1;
+                    visited.clear();
+                    minDistances.clear();
+                    // Upper bound of the nearest seed distance for every pixel of the cell
+                    int64_t bound = std::numeric_limits<int64_t>::max();
+                    const int maxRing = std::max(gridWidth, gridHeight);
+                    for (int ring = 0; ring <= maxRing; ++ring) {
+                        const int64_t reach = static_cast<int64_t>(ring - 1) * cellSize;
+                        if (reach > 0 && reach * reach > bound) {
+                            break;
+                        }
+                        forEachInRing(gx, gy, ring, [&](int cell) {
+                            for (int j = offsets[cell]; j < offsets[cell + 1]; ++j) {
+                                const int seed = buckets[j];
+                                const int sx = xs[seed], sy = ys[seed];
+                                const int64_t nearX = sx < x0 ? x0 - sx : (sx > x1 ? sx - x1 : 0);
+                                const int64_t nearY = sy < y0 ? y0 - sy : (sy > y1 ? sy - y1 : 0);
+                                const int64_t farX = std::max(std::abs(sx - x0), std::abs(sx - x1));
+                                const int64_t farY = std::max(std::abs(sy - y0), std::abs(sy - y1));
+                                bound = std::min(bound, farX * farX + farY * farY);
+                                visited.push_back({sx, sy, seed});
+                                minDistances.push_back(nearX * nearX + nearY * nearY);
+                            }
+                        });
+                    }
+                    int count = 0;
+                    for (size_t j = 0; j < visited.size(); ++j) {
+                        if (minDistances[j] <= bound) {
+                            rows[gy].push_back(visited[j]);
+                            count += 1;
+                        }
+                    }
+                    rowCounts[gy][gx] = count;
+                }
+            });
+
+            cellOffsets.resize(gridWidth * gridHeight + 1, 0);
+            for (int gy = 0; gy < gridHeight; ++gy) {
+                for (int gx = 0; gx < gridWidth; ++gx) {
+                    const int cell = gy * gridWidth + gx;
+                    cellOffsets[cell + 1] = cellOffsets[cell] + rowCounts[gy][gx];
+                }
+            }
+            candidates.reserve(cellOffsets.back());
+            for (const auto &row: rows) {
+                candidates.insert(candidates.end(), row.begin(), row.end());
             }
+        }
 
-            x += xIncrement;
-            y += yIncrement;
+        int nearest(const int x, const int y) const {
+            const int cell = cellOf(x, y);
+            const Candidate *begin = candidates.data() + cellOffsets[cell];
+            const Candidate *end = candidates.data() + cellOffsets[cell + 1];
+            int best = -1;
+            int64_t bestDistance = std::numeric_limits<int64_t>::max();
+            for (const Candidate *it = begin; it != end; ++it) {
+                const int64_t dx = it->x - x;
+                const int64_t dy = it->y - y;
+                const int64_t distance = dx * dx + dy * dy;
+                if (distance < bestDistance || (distance == bestDistance && it->index < best)) {
+                    bestDistance = distance;
+                    best = it->index;
+                }
+            }
+            return best;
+        }
+
+    private:
+        struct Candidate {
+            int x;
+            int y;
+            int index;
+        };
+
+        int cellOf(const int x, const int y) const {
+            return (y / cellSize) * gridWidth + (x / cellSize);
+        }
+
+        template<typename Function>
+        void forEachInRing(const int cx, const int cy, const int ring, Function &&func) const {
+            const int top = cy - ring;
+            const int bottom = cy + ring;
+            for (int gy = std::max(top, 0); gy <= std::min(bottom, gridHeight - 1); ++gy) {
+                const bool isEdgeRow = gy == top || gy == bottom;
+                const int step = isEdgeRow ? 1 : std::max(ring * 2, 1);
+                for (int gx = cx - ring; gx <= cx + ring; gx += step) {
+                    if (gx >= 0 && gx < gridWidth) {
+                        func(gy * gridWidth + gx);
+                    }
+                }
+            }
         }
-    }
+
+        std::vector<int> cellOffsets;
+        std::vector<Candidate> candidates;
+        int cellSize;
+        int gridWidth;
+        int gridHeight;
+    };
 
     void crystallize(uint8_t *data, int stride, int width, int height, int numClusters,
-                     int strokeColor) {
+                     int strokeColor, uint64_t seed) {
         if (numClusters <= 0) {
             std::string message("Num of clusters must be more than 0, but received " +
                                 std::to_string(numClusters));
             throw AireError(message);
         }
-        std::vector<uint8_t> transient(stride * height);
-        jcv_diagram diagram;
-        memset(&diagram, 0, sizeof(jcv_diagram));
-        std::vector<jcv_point> jcvPoints(numClusters);
-
-        std::default_random_engine generator;
-        generator.seed(std::chrono::system_clock::now().time_since_epoch().count());
-        std::uniform_int_distribution<> widthGenerator(1, width - 1);
-        std::uniform_int_distribution<> heightGenerator(1, height - 1);
 
+        std::vector<int> xs(numClusters);
+        std::vector<int> ys(numClusters);
         for (int i = 0; i < numClusters; ++i) {
-            int x = widthGenerator(generator);
-            int y = heightGenerator(generator);
-            jcvPoints[i] = {
-                    .x = static_cast<float>(x),
-                    .y = static_cast<float>(y),
-            };
+            const uint64_t hash = splitMix64(seed ^ splitMix64(static_cast<uint64_t>(i)));
+            xs[i] = static_cast<int>((hash & 0xffffffffULL) % static_cast<uint64_t>(width));
+            ys[i] = static_cast<int>((hash >> 32) % static_cast<uint64_t>(height));
         }
 
-        jcv_diagram_generate(numClusters, jcvPoints.data(), 0, 0, &diagram);
-
-        jcv_point dimensions;
-        dimensions.x = (jcv_real) width;
-        dimensions.y = (jcv_real) height;
-
-        const jcv_site *sites = jcv_diagram_get_sites(&diagram);
-        for (int i = 0; i < diagram.numsites; ++i) {
-            const jcv_site *site = &sites[i];
-
-            jcv_point v0 = remap(&site->p, &diagram.min, &diagram.max, &dimensions);
-
-            const jcv_graphedge *e = site->edges;
-            while (e) {
-                jcv_point v1 = remap(&e->pos[0], &diagram.min, &diagram.max, &dimensions);
-                jcv_point v2 = remap(&e->pos[1], &diagram.min, &diagram.max, &dimensions);
-
-                int minX = min3((int) v0.x, (int) v1.x, (int) v2.x);
-                int minY = min3((int) v0.y, (int) v1.y, (int) v2.y);
-                int maxX = max3((int) v0.x, (int) v1.x, (int) v2.x);
-                int maxY = max3((int) v0.y, (int) v1.y, (int) v2.y);
-
-                minX = clamp(minX, 0, width - 1);
-                minY = clamp(minY, 0, height - 1);
-                maxX = clamp(maxX, 0, width - 1);
-                maxY = clamp(maxY, 0, height - 1);
-
-                v0 = {
-                        .x = std::clamp(static_cast<float>(ceil(v0.x)), 0.f,
-                                        static_cast<float>(width - 1)),
-                        .y = std::clamp(ceil(v0.y), 0.f, static_cast<float>(height - 1))
-                };
-
-                uint32_t color = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(data) +
-                                                              static_cast<int>(ceil(v0.y)) *
-                                                              stride)[static_cast<int>(ceil(v0.x))];
-
-                jcv_point p;
-                for (p.y = (jcv_real) minY; p.y <= (jcv_real) maxY; p.y++) {
-                    for (p.x = (jcv_real) minX; p.x <= (jcv_real) maxX; p.x++) {
-                        if (p.x >= 0 && p.x < width && p.y >= 0 && p.y < height) {
-                            reinterpret_cast<uint32_t *>(
-                                    reinterpret_cast<uint8_t *>(transient.data()) +
-                                    static_cast<int>(p.y) *
-                                    stride)[static_cast<int>(p.x)] = color;
-                        }
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+
+        const SeedGrid grid(xs, ys, width, height, threadCount);
+
+        std::vector<int> labels(width * height);
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            int *row = labels.data() + y * width;
+            for (int x = 0; x < width; ++x) {
+                row[x] = grid.nearest(x, y);
+            }
+        });
+
+        // Per-thread partial sums for r, g, b, a and pixel count per cell, merged afterwards
+        std::vector<std::vector<uint64_t>> partials(threadCount, std::vector<uint64_t>(numClusters * 5, 0));
+
+        concurrency::parallel_for_with_thread_id(threadCount, height, [&](int threadId, int y) {
+            uint64_t *sums = partials[threadId].data();
+            const uint8_t *src = data + y * stride;
+            const int *row = labels.data() + y * width;
+            for (int x = 0; x < width; ++x) {
+                uint64_t *cell = sums + row[x] * 5;
+                cell[0] += src[0];
+                cell[1] += src[1];
+                cell[2] += src[2];
+                cell[3] += src[3];
+                cell[4] += 1;
+                src += 4;
+            }
+        });
+
+        std::vector<uint32_t> colors(numClusters, 0);
+
+        concurrency::parallel_for_segment(threadCount, numClusters, [&](int start, int end) {
+            for (int i = start; i < end; ++i) {
+                uint64_t accumulator[5] = {0, 0, 0, 0, 0};
+                for (int t = 0; t < threadCount; ++t) {
+                    const uint64_t *cell = partials[t].data() + i * 5;
+                    for (int c = 0; c < 5; ++c) {
+                        accumulator[c] += cell[c];
                     }
                 }
-
-                drawLine(transient.data(),
-                         strokeColor,
-                         stride, width, height,
-                         minX,
-                         minY,
-                         minX,
-                         maxY);
-
-                drawLine(transient.data(),
-                         strokeColor,
-                         stride, width, height,
-                         minX,
-                         maxY,
-                         maxX,
-                         maxY);
-
-                drawLine(transient.data(),
-                         strokeColor,
-                         stride, width, height,
-                         maxX,
-                         maxY,
-                         maxX,
-                         minY);
-
-                drawLine(transient.data(),
-                         strokeColor,
-                         stride, width, height,
-                         maxX,
-                         minY,
-                         minX,
-                         minY);
-
-                e = e->next;
+                const uint64_t count = accumulator[4];
+                if (count == 0) {
+                    continue;
+                }
+                const uint64_t half = count / 2;
+                colors[i] = packRGBA(static_cast<uint8_t>((accumulator[0] + half) / count),
+                                     static_cast<uint8_t>((accumulator[1] + half) / count),
+                                     static_cast<uint8_t>((accumulator[2] + half) / count),
+                                     static_cast<uint8_t>((accumulator[3] + half) / count));
             }
-        }
+        });
+
+        const uint8_t a1 = strokeColor >> 24 & 0xff;
+        const uint8_t r1 = strokeColor >> 16 & 0xff;
+        const uint8_t g1 = strokeColor >> 8 & 0xff;
+        const uint8_t b1 = strokeColor & 0xff;
 
-        jcv_diagram_free(&diagram);
-        std::copy(transient.begin(), transient.end(), data);
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            auto dst = reinterpret_cast<uint32_t *>(data + y * stride);
+            const int *row = labels.data() + y * width;
+            const int *nextRow = y + 1 < height ? row + width : row;
+            for (int x = 0; x < width; ++x) {
+                const int label = row[x];
+                uint32_t color = colors[label];
+                if (a1 != 0) {
+                    const bool isEdge = (x + 1 < width && row[x + 1] != label) || nextRow[x] != label;
+                    if (isEdge) {
+                        const uint8_t r = color & 0xff;
+                        const uint8_t g = color >> 8 & 0xff;
+                        const uint8_t b = color >> 16 & 0xff;
+                        const uint8_t a = color >> 24 & 0xff;
+                        color = packRGBA(blendColor(r1, r, a1), blendColor(g1, g, a1), blendColor(b1, b, a1),
+                                         a1 + (a * (255 - a1) + 127) / 255);
+                    }
+                }
+                dst[x] = color;
+            }
+        });
     }
-}
\ No newline at end of file
+}
@@ -33,5 +33,10 @@
 #include <cstdint>
 
 namespace aire {
-    void crystallize(uint8_t *data, int stride, int width, int height, int numClusters, int strokeColor);
+    /**
+     * Raster Voronoi crystallize, each pixel is labelled with its nearest seed through a uniform grid search,
+     * cell colors are averaged and strokes are drawn on label discontinuities.
+     * Output is deterministic for the same seed
+     */
+    void crystallize(uint8_t *data, int stride, int width, int height, int numClusters, int strokeColor, uint64_t seed);
 }
\ No newline at end of file
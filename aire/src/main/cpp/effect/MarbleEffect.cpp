@@ -31,16 +31,15 @@
 #include "MarbleEffect.h"
 #include "algo/PerlinNoise.hpp"
 #include <algorithm>
-#include <chrono>
+#include "base/ScratchArena.h"
 
 using namespace std;
 
 namespace aire {
 
-    void marbleEffect(uint8_t *data, int stride, int width, int height, float intensity, float turbulence, float amplitude) {
-        const siv::PerlinNoise::seed_type seed = std::chrono::system_clock::now().time_since_epoch().count();
-
-        const siv::PerlinNoise perlin{ seed };
+    void marbleEffect(uint8_t *data, int stride, int width, int height, float intensity, float turbulence, float amplitude,
+                      uint64_t seed) {
+        const siv::PerlinNoise perlin{static_cast<siv::PerlinNoise::seed_type>(seed)};
 
         float sinTable[256];
         float cosTable[256];
@@ -50,7 +49,7 @@ namespace aire {
             cosTable[i] = (float) (cos(angle)) * (intensity * width);
         }
 
-        std::vector<uint8_t > output(stride * height);
+        ScratchLease output = acquireScratch(stride * height);
 
         for (int y = 0; y < height; ++y) {
             auto dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(output.data()) +
@@ -78,6 +77,6 @@ namespace aire {
             }
         }
 
-        std::copy(output.begin(), output.end(), data);
+        std::copy(output.data(), output.data() + stride * height, data);
     }
 }
\ No newline at end of file
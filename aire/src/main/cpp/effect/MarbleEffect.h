@@ -34,5 +34,5 @@
 
 namespace aire {
     void marbleEffect(uint8_t *data, int stride, int width, int height, float intensity,
-                      float turbulence, float amplitude);
+                      float turbulence, float amplitude, uint64_t seed);
 }
\ No newline at end of file
@@ -31,8 +31,11 @@
 #include "OilEffect.h"
 #include "hwy/highway.h"
 #include "MathUtils.hpp"
-#include "jni/JNIUtils.h"
+#include "AireError.h"
+#include "base/ScratchArena.h"
+#include "base/Cancellation.h"
 #include "algo/support-inl.h"
+#include <algorithm>
 
 namespace aire {
 
@@ -53,13 +56,15 @@ namespace aire {
         using VU = Vec<decltype(du)>;
         const FixedTag<float32_t, 4> dfx4;
         using VF = Vec<decltype(dfx4)>;
-        std::vector<uint8_t> transient(stride * height);
+        ScratchLease transient = acquireScratch(stride * height);
         std::vector<uint8_t> intensities(std::powf(2 * radius + 1, 2));
         std::vector<uint8_t> rStore(std::powf(2 * radius + 1, 2));
         std::vector<uint8_t> gStore(std::powf(2 * radius + 1, 2));
         std::vector<uint8_t> bStore(std::powf(2 * radius + 1, 2));
         std::vector<uint8_t> aStore(std::powf(2 * radius + 1, 2));
+        CancellablePass pass(height);
         for (int y = 0; y < height; ++y) {
+            pass.checkpoint();
             for (int x = 0; x < width; ++x) {
                 int intensityIteration = 0;
                 auto dst = reinterpret_cast<uint8_t *>(
@@ -97,7 +102,8 @@ namespace aire {
                 dst[px + 3] = aStore[position];
             }
         }
+        pass.complete();
 
-        std::copy(transient.begin(), transient.end(), data);
+        std::copy(transient.data(), transient.data() + stride * height, data);
     }
 }
\ No newline at end of file
@@ -31,16 +31,14 @@
 #include "PerlinDistortion.h"
 #include "algo/PerlinNoise.hpp"
 #include <algorithm>
-#include <chrono>
 
 namespace aire {
 
     using namespace std;
 
-    void perlinDistortion(uint8_t *data, int stride, int width, int height, float intensity, float turbulence, float amplitude) {
-        const siv::PerlinNoise::seed_type seed = std::chrono::system_clock::now().time_since_epoch().count();
-
-        const siv::PerlinNoise perlin{seed};
+    void perlinDistortion(uint8_t *data, int stride, int width, int height, float intensity, float turbulence, float amplitude,
+                          uint64_t seed) {
+        const siv::PerlinNoise perlin{static_cast<siv::PerlinNoise::seed_type>(seed)};
 
         std::vector<uint8_t> output(stride * height);
 
@@ -33,5 +33,6 @@
 #include <cstdint>
 
 namespace aire {
-    void perlinDistortion(uint8_t *data, int stride, int width, int height, float intensity, float turbulence, float amplitude);
+    void perlinDistortion(uint8_t *data, int stride, int width, int height, float intensity, float turbulence, float amplitude,
+                          uint64_t seed);
 }
\ No newline at end of file
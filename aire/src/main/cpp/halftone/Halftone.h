@@ -31,6 +31,7 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 
 namespace aire {
     template<class V>
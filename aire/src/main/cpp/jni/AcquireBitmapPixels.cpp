@@ -30,6 +30,7 @@
 
 #include "AcquireBitmapPixels.h"
 #include <android/bitmap.h>
+#include <optional>
 #include "JNIUtils.h"
 #include "Rgb1010102toF16.h"
 #include "Rgb1010102.h"
@@ -37,6 +38,8 @@
 #include "Rgb565.h"
 #include "Rgba8ToF16.h"
 #include "CopyUnaligned.h"
+#include "base/Instrumentation.h"
+#include "base/ResultCache.h"
 
 using namespace std;
 
@@ -44,12 +47,62 @@ int androidOSVersion() {
     return android_get_device_api_level();
 }
 
+static jobject createResultBitmap(JNIEnv *env, const uint8_t *data, int stride, int width, int height,
+                                  AcquirePixelFormat pixelFormat) {
+    aire::ScopedStage writeStage("AcquireBitmapPixels.write");
+
+    std::string bitmapPixelConfig = getAndroidFormat(pixelFormat);
+    jclass bitmapConfig = env->FindClass("android/graphics/Bitmap$Config");
+    jfieldID rgba8888FieldID = env->GetStaticFieldID(bitmapConfig,
+                                                     bitmapPixelConfig.c_str(),
+                                                     "Landroid/graphics/Bitmap$Config;");
+    jobject rgba8888Obj = env->GetStaticObjectField(bitmapConfig, rgba8888FieldID);
+
+    jclass bitmapClass = env->FindClass("android/graphics/Bitmap");
+    jmethodID createBitmapMethodID = env->GetStaticMethodID(bitmapClass, "createBitmap",
+                                                            "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;");
+    jobject bitmapObj = env->CallStaticObjectMethod(bitmapClass, createBitmapMethodID,
+                                                    static_cast<jint>(width),
+                                                    static_cast<jint>(height),
+                                                    rgba8888Obj);
+
+
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmapObj, &info) < 0) {
+        std::string exc = "Cannot get destination bitmap info";
+        throw AireError(exc);
+    }
+
+    void *addr = nullptr;
+
+    if (AndroidBitmap_lockPixels(env, bitmapObj, &addr) != 0) {
+        std::string exc = "Cannot acquire destination bitmap pixels";
+        throw AireError(exc);
+    }
+
+    aire::CopyUnaligned(data,
+                        stride,
+                        reinterpret_cast<uint8_t *>(addr), (int) info.stride,
+                        (int) info.width * getComponents(pixelFormat),
+                        (int) info.height, getPixelSize(pixelFormat));
+    aire::Instrumentation::count(aire::COUNTER_BYTES_COPIED, static_cast<uint64_t>(stride) * height);
+
+    if (AndroidBitmap_unlockPixels(env, bitmapObj) != 0) {
+        std::string exc = "Cannot unlock destination bitmap pixels";
+        throw AireError(exc);
+    }
+
+    return bitmapObj;
+}
+
 jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                             std::vector<AcquirePixelFormat> allowedFormats,
                             bool allowsMemoryAlignment,
                             std::function<BuiltImagePresentation(std::vector<uint8_t> &, int, int,
                                                                  int,
-                                                                 AcquirePixelFormat)> worker) {
+                                                                 AcquirePixelFormat)> worker,
+                            bool writesResult,
+                            const aire::ResultKey *cacheKey) {
     try {
         int osVersion = androidOSVersion();
         if (osVersion < 26) {
@@ -95,14 +148,45 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
             throw AireError(msg);
         }
 
+        aire::ScopedStage readStage("AcquireBitmapPixels.read");
+
         void *addr = nullptr;
         if (AndroidBitmap_lockPixels(env, bitmap, &addr) != 0) {
             std::string exc = "Cannot acquire bitmap pixels";
             throw AireError(exc);
         }
 
+        // Result depends on the pixels as stored in the bitmap, rows are hashed without stride padding
+        std::optional<aire::ResultKey> resultKey;
+        if (cacheKey != nullptr && writesResult && aire::ResultCache::shared().enabled()) {
+            const int bytesPerPixel = info.format == ANDROID_BITMAP_FORMAT_RGBA_F16 ? 8
+                                      : (info.format == ANDROID_BITMAP_FORMAT_RGB_565 ? 2 : 4);
+            resultKey = *cacheKey;
+            resultKey->with(info.format).with(info.width).with(info.height);
+            resultKey->pixels(reinterpret_cast<const uint8_t *>(addr), (int) info.stride,
+                              (int) info.width * bytesPerPixel, (int) info.height);
+            auto cached = aire::ResultCache::shared().find(*resultKey);
+            if (cached) {
+                if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+                    string exc = "Unlocking pixels has failed";
+                    throw AireError(exc);
+                }
+                readStage.stop();
+                return createResultBitmap(env, cached->data.data(), cached->stride, cached->width, cached->height,
+                                          static_cast<AcquirePixelFormat>(cached->format));
+            }
+        }
+
         vector<uint8_t> rgbaPixels(info.stride * info.height);
         std::copy(reinterpret_cast<uint8_t *>(addr), reinterpret_cast<uint8_t *>(addr) + info.stride * info.height, rgbaPixels.begin());
+        aire::Instrumentation::count(aire::COUNTER_BYTES_ALLOCATED, rgbaPixels.size());
+        aire::Instrumentation::count(aire::COUNTER_BYTES_COPIED, rgbaPixels.size());
+
+        auto replacePixels = [&rgbaPixels](const vector<uint8_t> &converted) {
+            aire::Instrumentation::count(aire::COUNTER_BYTES_ALLOCATED, converted.size());
+            aire::Instrumentation::count(aire::COUNTER_BYTES_COPIED, converted.size());
+            rgbaPixels = converted;
+        };
 
         if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
             string exc = "Unlocking pixels has failed";
@@ -155,7 +239,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                            (int) info.width,
                                            (int) info.height);
                     usingFormat = APF_RGBA1010102;
-                    rgbaPixels = halfFloatPixels;
+                    replacePixels(halfFloatPixels);
                 } else if (is888Allowed) {
                     imageStride = (int) info.width * 4 * (int) sizeof(uint8_t);
                     vector<uint8_t> halfFloatPixels(imageStride * info.height);
@@ -166,7 +250,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                              (int) info.width,
                                              (int) info.height, 8, true);
                     usingFormat = APF_RGBA8888;
-                    rgbaPixels = halfFloatPixels;
+                    replacePixels(halfFloatPixels);
                 } else if (is565Allowed) {
                     imageStride = (int) info.width * (int) sizeof(uint16_t);
                     vector<uint8_t> r888Pixels(imageStride * info.height);
@@ -177,7 +261,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                        (int) info.width,
                                        (int) info.height);
                     usingFormat = APF_RGBA8888;
-                    rgbaPixels = r888Pixels;
+                    replacePixels(r888Pixels);
                 } else {
                     string ss = getPixelFormatName(APF_F16);
                     string exc = "Unknown " + ss + " conversion path";
@@ -197,7 +281,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                             (int) info.width,
                             (int) info.height);
                     usingFormat = APF_F16;
-                    rgbaPixels = halfFloatPixels;
+                    replacePixels(halfFloatPixels);
                 } else if (is888Allowed) {
                     imageStride = (int) info.width * 4 * (int) sizeof(uint8_t);
                     vector<uint8_t> r888Pixels(imageStride * info.height);
@@ -208,7 +292,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                                 (int) info.width,
                                                 (int) info.height, 8);
                     usingFormat = APF_RGBA8888;
-                    rgbaPixels = r888Pixels;
+                    replacePixels(r888Pixels);
                 } else if (is565Allowed) {
                     imageStride = (int) info.width * (int) sizeof(uint16_t);
                     vector<uint8_t> r888Pixels(imageStride * info.height);
@@ -219,7 +303,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                            (int) info.width,
                                            (int) info.height);
                     usingFormat = APF_565;
-                    rgbaPixels = r888Pixels;
+                    replacePixels(r888Pixels);
                 } else {
                     string ss = getPixelFormatName(APF_RGBA1010102);
                     string exc = "Unknown " + ss + " conversion path";
@@ -242,7 +326,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                      (int) info.width,
                                      (int) info.height, 8, true);
                     usingFormat = APF_F16;
-                    rgbaPixels = halfFloatPixels;
+                    replacePixels(halfFloatPixels);
                 } else if (is1010102Allowed) {
                     imageStride = (int) info.width * 4 * (int) sizeof(uint8_t);
                     vector<uint8_t> halfFloatPixels(imageStride * info.height);
@@ -253,7 +337,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                              (int) info.width,
                                              (int) info.height, true);
                     usingFormat = APF_RGBA1010102;
-                    rgbaPixels = halfFloatPixels;
+                    replacePixels(halfFloatPixels);
                 } else if (is565Allowed) {
                     imageStride = (int) info.width * (int) sizeof(uint16_t);
                     vector<uint8_t> halfFloatPixels(imageStride * info.height);
@@ -264,7 +348,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                      (int) info.width,
                                      (int) info.height, 8, true);
                     usingFormat = APF_RGBA1010102;
-                    rgbaPixels = halfFloatPixels;
+                    replacePixels(halfFloatPixels);
                 } else {
                     string ss = getPixelFormatName(APF_RGBA8888);
                     string exc = "Unknown " + ss + " conversion path";
@@ -285,7 +369,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                       (int) info.width, (int) info.height);
 
                     imageStride = newStride;
-                    rgbaPixels = rgba8888Pixels;
+                    replacePixels(rgba8888Pixels);
                     usingFormat = APF_F16;
                 } else if (is1010102Allowed) {
                     int newStride = (int) info.width * 4 * (int) sizeof(uint8_t);
@@ -296,7 +380,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                               (int) info.width, (int) info.height);
                     usingFormat = APF_RGBA1010102;
                     imageStride = newStride;
-                    rgbaPixels = rgba8888Pixels;
+                    replacePixels(rgba8888Pixels);
                 } else if (is888Allowed) {
                     int newStride = (int) info.width * 4 * (int) sizeof(uint8_t);
                     std::vector<uint8_t> rgba8888Pixels(newStride * info.height);
@@ -306,7 +390,7 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                                             (int) info.width, (int) info.height, 8, 255);
                     usingFormat = APF_RGBA8888;
                     imageStride = newStride;
-                    rgbaPixels = rgba8888Pixels;
+                    replacePixels(rgba8888Pixels);
                 } else {
                     string ss = getPixelFormatName(APF_565);
                     string exc = "Unknown " + ss + " conversion path";
@@ -321,52 +405,32 @@ jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
         if (!allowsMemoryAlignment && imageStride != info.width * components * pixelSize) {
             std::vector<uint8_t> newPixels(
                     info.width * components * pixelSize * (int) info.height);
-            rgbaPixels = newPixels;
+            replacePixels(newPixels);
             imageStride = info.width * components * pixelSize;
         }
 
-        auto result = worker(rgbaPixels, imageStride, info.width, info.height, usingFormat);
-
-        std::string bitmapPixelConfig = getAndroidFormat(result.pixelFormat);
-        jclass bitmapConfig = env->FindClass("android/graphics/Bitmap$Config");
-        jfieldID rgba8888FieldID = env->GetStaticFieldID(bitmapConfig,
-                                                         bitmapPixelConfig.c_str(),
-                                                         "Landroid/graphics/Bitmap$Config;");
-        jobject rgba8888Obj = env->GetStaticObjectField(bitmapConfig, rgba8888FieldID);
-
-        jclass bitmapClass = env->FindClass("android/graphics/Bitmap");
-        jmethodID createBitmapMethodID = env->GetStaticMethodID(bitmapClass, "createBitmap",
-                                                                "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;");
-        jobject bitmapObj = env->CallStaticObjectMethod(bitmapClass, createBitmapMethodID,
-                                                        static_cast<jint>(result.width),
-                                                        static_cast<jint>(result.height),
-                                                        rgba8888Obj);
+        readStage.stop();
 
+        aire::ScopedStage workerStage("AcquireBitmapPixels.worker");
+        auto result = worker(rgbaPixels, imageStride, info.width, info.height, usingFormat);
+        workerStage.stop();
 
-        if (AndroidBitmap_getInfo(env, bitmapObj, &info) < 0) {
-            std::string exc = "Cannot get destination bitmap info";
-            throw AireError(exc);
-        }
-
-        addr = nullptr;
-
-        if (AndroidBitmap_lockPixels(env, bitmapObj, &addr) != 0) {
-            std::string exc = "Cannot acquire destination bitmap pixels";
-            throw AireError(exc);
+        if (!writesResult) {
+            return nullptr;
         }
 
-        aire::CopyUnaligned(reinterpret_cast<const uint8_t *>(result.data.data()),
-                            result.stride,
-                            reinterpret_cast<uint8_t *>(addr), (int) info.stride,
-                            (int) info.width * getComponents(result.pixelFormat),
-                            (int) info.height, getPixelSize(result.pixelFormat));
-
-        if (AndroidBitmap_unlockPixels(env, bitmapObj) != 0) {
-            std::string exc = "Cannot unlock destination bitmap pixels";
-            throw AireError(exc);
+        if (resultKey) {
+            auto cached = std::make_shared<aire::CachedImage>();
+            cached->data = result.data;
+            cached->stride = result.stride;
+            cached->width = result.width;
+            cached->height = result.height;
+            cached->format = result.pixelFormat;
+            aire::ResultCache::shared().insert(*resultKey, std::move(cached));
         }
 
-        return bitmapObj;
+        return createResultBitmap(env, result.data.data(), result.stride, result.width, result.height,
+                                  result.pixelFormat);
     } catch (std::bad_alloc &err) {
         throw AireError(err.what());
     }
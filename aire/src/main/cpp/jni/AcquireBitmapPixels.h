@@ -34,6 +34,7 @@
 #include <vector>
 #include <iostream>
 #include <functional>
+#include "base/ResultCache.h"
 
 enum AcquirePixelFormat {
     APF_RGBA8888,
@@ -106,8 +107,15 @@ struct BuiltImagePresentation {
     AcquirePixelFormat pixelFormat;
 };
 
+/**
+ * @param writesResult - when false the worker only consumes pixels, no bitmap is created and nullptr is returned
+ * @param cacheKey - operation and it's parameters, when given and result cache is enabled the result is looked up
+ * by the key and input pixels before any work is done
+ */
 jobject AcquireBitmapPixels(JNIEnv *env, jobject bitmap,
                          std::vector<AcquirePixelFormat> allowedFormats,
                          bool allowsMemoryAlignment,
                          std::function<BuiltImagePresentation(std::vector<uint8_t> &, int, int, int,
-                                                              AcquirePixelFormat)> worker);
\ No newline at end of file
+                                                              AcquirePixelFormat)> worker,
+                         bool writesResult = true,
+                         const aire::ResultKey *cacheKey = nullptr);
\ No newline at end of file
@@ -35,11 +35,13 @@
 #include "base/Channels.h"
 #include "base/Dilation.h"
 #include "base/Threshold.h"
+#include "base/AdaptiveThreshold.h"
 #include "base/Erosion.h"
 #include "base/Vibrance.h"
 #include "base/Grain.h"
 #include "base/Sharpness.h"
 #include "base/LUT8.h"
+#include "base/ScratchArena.h"
 #include "algo/MedianCut.h"
 #include "blur/GaussBlur.h"
 #include "color/Adjustments.h"
@@ -47,6 +49,7 @@
 #include "Eigen/Eigen"
 #include "algo/WuQuantizer.h"
 #include "base/RemapPalette.h"
+#include "base/ImageCompression.h"
 #include "EigenUtils.h"
 
 extern "C"
@@ -210,6 +213,41 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_thresholdPipeline(JNIEnv *env, j
 }
 extern "C"
 JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_adaptiveThresholdImpl(JNIEnv *env, jobject thiz,
+                                                                      jobject bitmap, jint radius,
+                                                                      jint method, jfloat k) {
+  try {
+    std::vector<AcquirePixelFormat> formats;
+    formats.insert(formats.begin(), APF_RGBA8888);
+    jobject newBitmap = AcquireBitmapPixels(env,
+                                            bitmap,
+                                            formats,
+                                            true,
+                                            [radius, method, k](
+                                                std::vector<uint8_t> &input, int stride,
+                                                int width, int height,
+                                                AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                              if (fmt == APF_RGBA8888) {
+                                                aire::adaptiveThreshold(input.data(), stride, width, height, radius, k,
+                                                                        static_cast<aire::AdaptiveThresholdMethod>(method));
+                                              }
+                                              return {
+                                                  .data = input,
+                                                  .stride = stride,
+                                                  .width = width,
+                                                  .height = height,
+                                                  .pixelFormat = fmt
+                                              };
+                                            });
+    return newBitmap;
+  } catch (AireError &err) {
+    std::string msg = err.what();
+    throwException(env, msg);
+    return nullptr;
+  }
+}
+extern "C"
+JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_BasePipelinesImpl_erodePipeline(JNIEnv *env, jobject thiz,
                                                               jobject bitmap, jint kernelSize) {
   try {
@@ -428,15 +466,22 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_colorMatrixImpl(JNIEnv *env, job
 
 extern "C"
 JNIEXPORT jobject JNICALL
-Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grainImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat intensity) {
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grainImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat intensity,
+                                                          jlong seed, jint mode) {
   try {
+    if (mode != aire::GRAIN_GAUSSIAN && mode != aire::GRAIN_FILM) {
+      std::string msg = "Unknown grain mode " + std::to_string(mode);
+      throw AireError(msg);
+    }
     std::vector<AcquirePixelFormat> formats;
     formats.insert(formats.begin(), APF_RGBA8888);
+    aire::ResultKey cacheKey("grain");
+    cacheKey.with(intensity).with(seed).with(mode);
     jobject newBitmap = AcquireBitmapPixels(env,
                                             bitmap,
                                             formats,
                                             true,
-                                            [intensity](
+                                            [intensity, seed, mode](
                                                 std::vector<uint8_t> &input, int stride,
                                                 int width, int height,
                                                 AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -445,7 +490,9 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grainImpl(JNIEnv *env, jobject t
                                                             stride,
                                                             width,
                                                             height,
-                                                            intensity);
+                                                            intensity,
+                                                            static_cast<uint64_t>(seed),
+                                                            static_cast<aire::GrainMode>(mode));
                                               }
                                               return {
                                                   .data = input,
@@ -454,7 +501,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_grainImpl(JNIEnv *env, jobject t
                                                   .height = height,
                                                   .pixelFormat = fmt
                                               };
-                                            });
+                                            }, true, &cacheKey);
     return newBitmap;
   } catch (AireError &err) {
     std::string msg = err.what();
@@ -549,12 +596,98 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_gammaImpl(JNIEnv *env, jobject t
                                                 int width, int height,
                                                 AcquirePixelFormat fmt) -> BuiltImagePresentation {
                                               if (fmt == APF_RGBA8888) {
-                                                const int TABLE_SIZE = 256;
-                                                uint8_t lookupTable[TABLE_SIZE];
-                                                for (int i = 0; i < 256; ++i) {
-                                                  lookupTable[i] = std::clamp(std::powf(float(i), gamma), 0.f, 255.f);
-                                                }
-                                                const aire::LUT8 lut(lookupTable);
+                                                aire::LUT8::gamma(gamma).apply(input.data(), stride, width, height);
+                                              }
+                                              return {
+                                                  .data = input,
+                                                  .stride = stride,
+                                                  .width = width,
+                                                  .height = height,
+                                                  .pixelFormat = fmt
+                                              };
+                                            });
+    return newBitmap;
+  } catch (AireError &err) {
+    std::string msg = err.what();
+    throwException(env, msg);
+    return nullptr;
+  }
+}
+
+static void curveTable(JNIEnv *env, jintArray curve, uint8_t table[256]) {
+  jint values[256];
+  if (curve == nullptr) {
+    for (int i = 0; i < 256; ++i) {
+      values[i] = i;
+    }
+  } else {
+    env->GetIntArrayRegion(curve, 0, 256, values);
+  }
+  for (int i = 0; i < 256; ++i) {
+    table[i] = static_cast<uint8_t>(std::clamp(values[i], 0, 255));
+  }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_levelsImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                           jint inBlack, jint inWhite, jfloat gamma,
+                                                           jint outBlack, jint outWhite) {
+  try {
+    const aire::LUT8 lut = aire::LUT8::levels(inBlack, inWhite, gamma, outBlack, outWhite);
+    std::vector<AcquirePixelFormat> formats;
+    formats.insert(formats.begin(), APF_RGBA8888);
+    jobject newBitmap = AcquireBitmapPixels(env,
+                                            bitmap,
+                                            formats,
+                                            true,
+                                            [&lut](
+                                                std::vector<uint8_t> &input, int stride,
+                                                int width, int height,
+                                                AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                              if (fmt == APF_RGBA8888) {
+                                                lut.apply(input.data(), stride, width, height);
+                                              }
+                                              return {
+                                                  .data = input,
+                                                  .stride = stride,
+                                                  .width = width,
+                                                  .height = height,
+                                                  .pixelFormat = fmt
+                                              };
+                                            });
+    return newBitmap;
+  } catch (AireError &err) {
+    std::string msg = err.what();
+    throwException(env, msg);
+    return nullptr;
+  }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_curvesImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                           jintArray master, jintArray red, jintArray green,
+                                                           jintArray blue, jintArray alpha) {
+  try {
+    uint8_t redTable[256], greenTable[256], blueTable[256], alphaTable[256], masterTable[256];
+    curveTable(env, red, redTable);
+    curveTable(env, green, greenTable);
+    curveTable(env, blue, blueTable);
+    curveTable(env, alpha, alphaTable);
+    curveTable(env, master, masterTable);
+    const aire::LUT8 lut = aire::LUT8(redTable, greenTable, blueTable, alphaTable).then(aire::LUT8(masterTable));
+    std::vector<AcquirePixelFormat> formats;
+    formats.insert(formats.begin(), APF_RGBA8888);
+    jobject newBitmap = AcquireBitmapPixels(env,
+                                            bitmap,
+                                            formats,
+                                            true,
+                                            [&lut](
+                                                std::vector<uint8_t> &input, int stride,
+                                                int width, int height,
+                                                AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                              if (fmt == APF_RGBA8888) {
                                                 lut.apply(input.data(), stride, width, height);
                                               }
                                               return {
@@ -732,4 +865,10 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_getBokehConvolutionKernelImpl(JN
     throwException(env, exception);
     return nullptr;
   }
-}
\ No newline at end of file
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_trimScratchMemoryImpl(JNIEnv *env, jobject thiz) {
+  aire::ScratchArena::shared().trim();
+}
@@ -0,0 +1,120 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include <jni.h>
+#include <string>
+#include "JNIUtils.h"
+#include "AcquireBitmapPixels.h"
+#include "pipelines/BatchPipeline.h"
+
+namespace {
+    // Exception thrown by the result callback stays pending and is rethrown by JVM on return
+    struct PendingJavaException {
+    };
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_BatchPipelinesImpl_batchCompressImpl(JNIEnv *env, jobject thiz,
+                                                                   jobjectArray bitmaps,
+                                                                   jintArray ops,
+                                                                   jfloatArray params,
+                                                                   jint encoding,
+                                                                   jint quality,
+                                                                   jint maxColors,
+                                                                   jint aireQuantize,
+                                                                   jint ditheringStrategy,
+                                                                   jint mappingStrategy,
+                                                                   jint compressionLevel,
+                                                                   jint maxInFlight,
+                                                                   jobject callback) {
+    try {
+        aire::BatchRecipe recipe;
+        recipe.ops.resize(env->GetArrayLength(ops));
+        env->GetIntArrayRegion(ops, 0, static_cast<jsize>(recipe.ops.size()), recipe.ops.data());
+        recipe.params.resize(env->GetArrayLength(params));
+        env->GetFloatArrayRegion(params, 0, static_cast<jsize>(recipe.params.size()), recipe.params.data());
+        recipe.encoding = static_cast<aire::BatchEncoding>(encoding);
+        recipe.quality = quality;
+        recipe.maxColors = maxColors;
+        recipe.quantize = static_cast<AireQuantize>(aireQuantize);
+        recipe.dithering = static_cast<aire::RemapDithering>(ditheringStrategy);
+        recipe.strategy = static_cast<aire::RemapMappingStrategy>(mappingStrategy);
+        recipe.compressionLevel = compressionLevel;
+
+        jclass callbackClass = env->GetObjectClass(callback);
+        jmethodID onResult = env->GetMethodID(callbackClass, "onResult", "(I[B)V");
+
+        aire::BatchPipeline pipeline(recipe, maxInFlight);
+        pipeline.run(env->GetArrayLength(bitmaps),
+                     [env, bitmaps](int index, aire::BatchImage &image) {
+                         jobject bitmap = env->GetObjectArrayElement(bitmaps, index);
+                         std::vector<AcquirePixelFormat> formats;
+                         formats.insert(formats.begin(), APF_RGBA8888);
+                         AcquireBitmapPixels(env,
+                                             bitmap,
+                                             formats,
+                                             false,
+                                             [&image](std::vector<uint8_t> &input, int stride,
+                                                      int width, int height,
+                                                      AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                 image.data = std::move(input);
+                                                 image.stride = stride;
+                                                 image.width = width;
+                                                 image.height = height;
+                                                 return {
+                                                         .stride = stride,
+                                                         .width = width,
+                                                         .height = height,
+                                                         .pixelFormat = fmt
+                                                 };
+                                             },
+                                             false);
+                         env->DeleteLocalRef(bitmap);
+                     },
+                     [env, callback, onResult](int index, std::vector<uint8_t> &encoded) {
+                         jbyteArray byteArray = env->NewByteArray((jsize) encoded.size());
+                         if (byteArray == nullptr) {
+                             throw PendingJavaException();
+                         }
+                         env->SetByteArrayRegion(byteArray, 0, (jint) encoded.size(),
+                                                 reinterpret_cast<const jbyte *>(encoded.data()));
+                         env->CallVoidMethod(callback, onResult, static_cast<jint>(index), byteArray);
+                         env->DeleteLocalRef(byteArray);
+                         if (env->ExceptionCheck()) {
+                             throw PendingJavaException();
+                         }
+                     });
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+    } catch (PendingJavaException &) {
+    }
+}
@@ -38,8 +38,11 @@
 #include "blur/GaussBlur.h"
 #include "blur/PoissonBlur.h"
 #include <string>
-#include "blur/ZoomBlur.hpp"
+#include "blur/ZoomBlur.h"
 #include "blur/AnisotropicDiffusion.h"
+#include "blur/PyramidBlur.h"
+#include "blur/RecursiveGaussian.h"
+#include "blur/VariableBoxBlur.h"
 #include "color/Gamut.h"
 #include "EigenUtils.h"
 
@@ -125,6 +128,8 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_gaussianBlurPipeline(JNIEnv *env
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
         formats.insert(formats.begin(), APF_F16);
+        aire::ResultKey cacheKey("gaussianBlur");
+        cacheKey.with(radius).with(sigma);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
@@ -150,7 +155,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_gaussianBlurPipeline(JNIEnv *env
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
@@ -246,25 +251,28 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_anisotropicDiffusionPipeline(JNI
 
 extern "C"
 JNIEXPORT jobject JNICALL
-Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_poissonBlurPipeline(JNIEnv *env, jobject thiz, jobject bitmap, jint radius) {
+Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_poissonBlurPipeline(JNIEnv *env, jobject thiz, jobject bitmap, jint radius,
+                                                                    jlong seed) {
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_F16);
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("poissonBlur");
+        cacheKey.with(radius).with(seed);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [radius](std::vector<uint8_t> &input, int stride,
+                                                [radius, seed](std::vector<uint8_t> &input, int stride,
                                                          int width, int height,
                                                          AcquirePixelFormat fmt) -> BuiltImagePresentation {
                                                     if (fmt == APF_RGBA8888) {
                                                         aire::poissonBlur(input.data(), stride, width,
-                                                                          height, radius);
+                                                                          height, radius, static_cast<uint64_t>(seed));
                                                     } else if (fmt == APF_F16) {
                                                         aire::poissonBlurF16(reinterpret_cast<uint16_t *>(input.data()),
                                                                              stride, width,
-                                                                             height, radius);
+                                                                             height, radius, static_cast<uint64_t>(seed));
                                                     }
                                                     return {
                                                             .data = input,
@@ -273,7 +281,7 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_poissonBlurPipeline(JNIEnv *env,
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
@@ -419,8 +427,8 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_zoomBlurImpl(JNIEnv *env, jobjec
                                                 [&](std::vector<uint8_t> &input, int stride,
                                                     int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
                                                     if (fmt == APF_RGBA8888) {
-                                                        aire::ZoomBlur zoom(kernelSize, sigma, centerX, centerY, strength, angle);
-                                                        zoom.apply(input.data(), stride, width, height);
+                                                        aire::zoomBlur(input.data(), stride, width, height, kernelSize, sigma,
+                                                                       centerX, centerY, strength, angle);
                                                         return {
                                                                 .data = input,
                                                                 .stride = stride,
@@ -443,4 +451,179 @@ Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_zoomBlurImpl(JNIEnv *env, jobjec
         throwException(env, msg);
         return nullptr;
     }
-}
\ No newline at end of file
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_variableBlurImpl(JNIEnv *env, jobject thiz,
+                                                                 jobject bitmap,
+                                                                 jfloatArray sigmaMap) {
+    try {
+        jsize length = env->GetArrayLength(sigmaMap);
+        std::vector<float> sigmas(length);
+        env->GetFloatArrayRegion(sigmaMap, 0, length, sigmas.data());
+        float maxSigma = 0.f;
+        for (float sigma: sigmas) {
+            maxSigma = std::max(maxSigma, sigma);
+        }
+
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [&sigmas, maxSigma](std::vector<uint8_t> &input, int stride,
+                                                                    int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (sigmas.size() != static_cast<size_t>(width) * height) {
+                                                        std::string err("Sigma map must have exactly width * height values");
+                                                        throw AireError(err);
+                                                    }
+                                                    if (fmt == APF_RGBA8888) {
+                                                        aire::pyramidBlur(input.data(), stride, width, height, maxSigma,
+                                                                          [&](int y, float *rowSigmas) {
+                                                                              std::copy(sigmas.begin() + y * width,
+                                                                                        sigmas.begin() + (y + 1) * width,
+                                                                                        rowSigmas);
+                                                                          });
+                                                    }
+                                                    return {
+                                                            .data = input,
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_recursiveGaussianBlurImpl(JNIEnv *env, jobject thiz,
+                                                                          jobject bitmap, jfloat sigma) {
+    try {
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        formats.insert(formats.begin(), APF_F16);
+        formats.insert(formats.begin(), APF_RGBA1010102);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [sigma](std::vector<uint8_t> &input, int stride,
+                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (fmt == APF_RGBA8888) {
+                                                        aire::recursiveGaussianU8(input.data(), stride, width,
+                                                                                  height, sigma);
+                                                    } else if (fmt == APF_F16) {
+                                                        aire::recursiveGaussianF16(reinterpret_cast<uint16_t *>(input.data()),
+                                                                                   stride, width, height, sigma);
+                                                    } else if (fmt == APF_RGBA1010102) {
+                                                        aire::recursiveGaussian1010102(input.data(), stride, width,
+                                                                                       height, sigma);
+                                                    }
+                                                    return {
+                                                            .data = input,
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_variableBoxBlurImpl(JNIEnv *env, jobject thiz,
+                                                                    jobject bitmap,
+                                                                    jfloatArray radiusMap) {
+    try {
+        jsize length = env->GetArrayLength(radiusMap);
+        std::vector<float> radii(length);
+        env->GetFloatArrayRegion(radiusMap, 0, length, radii.data());
+
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        formats.insert(formats.begin(), APF_F16);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [&radii](std::vector<uint8_t> &input, int stride,
+                                                         int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (radii.size() != static_cast<size_t>(width) * height) {
+                                                        std::string err("Radius map must have exactly width * height values");
+                                                        throw AireError(err);
+                                                    }
+                                                    auto radiusRow = [&](int y, float *rowRadii) {
+                                                        std::copy(radii.begin() + y * width,
+                                                                  radii.begin() + (y + 1) * width,
+                                                                  rowRadii);
+                                                    };
+                                                    if (fmt == APF_RGBA8888) {
+                                                        aire::variableBoxBlurU8(input.data(), stride, width, height,
+                                                                                radiusRow);
+                                                    } else if (fmt == APF_F16) {
+                                                        aire::variableBoxBlurF16(reinterpret_cast<uint16_t *>(input.data()),
+                                                                                 stride, width, height, radiusRow);
+                                                    }
+                                                    return {
+                                                            .data = input,
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BlurPipelinesImpl_spinBlurImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                             jfloat centerX, jfloat centerY, jfloat angle) {
+    try {
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [&](std::vector<uint8_t> &input, int stride,
+                                                    int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (fmt == APF_RGBA8888) {
+                                                        aire::spinBlur(input.data(), stride, width, height,
+                                                                       centerX, centerY, angle);
+                                                    }
+                                                    return {
+                                                            .data = input,
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
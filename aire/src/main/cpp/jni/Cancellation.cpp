@@ -0,0 +1,105 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include <jni.h>
+#include "base/Cancellation.h"
+
+namespace {
+
+    /**
+     * Token of an asynchronous job, progress is delivered on the thread running the job
+     */
+    struct JniCancellation {
+        explicit JniCancellation(jobject listener) : listener(listener),
+                                                     token([this](int pass, float fraction) {
+                                                         notify(pass, fraction);
+                                                     }) {
+        }
+
+        void notify(int pass, float fraction) {
+            if (env == nullptr || listener == nullptr) {
+                return;
+            }
+            env->CallVoidMethod(listener, onProgress, static_cast<jint>(pass), static_cast<jfloat>(fraction));
+            // Native frames can't unwind through a pending Java exception, failed listener cancels the job instead
+            if (env->ExceptionCheck()) {
+                env->ExceptionClear();
+                token.cancel();
+            }
+        }
+
+        jobject listener;
+        jmethodID onProgress = nullptr;
+        JNIEnv *env = nullptr;
+        aire::CancellationToken token;
+    };
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_awxkee_aire_pipeline_AsyncPipelinesImpl_createTokenImpl(JNIEnv *env, jobject thiz, jobject listener) {
+    auto cancellation = new JniCancellation(listener != nullptr ? env->NewGlobalRef(listener) : nullptr);
+    if (listener != nullptr) {
+        jclass listenerClass = env->GetObjectClass(listener);
+        cancellation->onProgress = env->GetMethodID(listenerClass, "onProgress", "(IF)V");
+        env->DeleteLocalRef(listenerClass);
+    }
+    return reinterpret_cast<jlong>(cancellation);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_AsyncPipelinesImpl_cancelTokenImpl(JNIEnv *env, jobject thiz, jlong handle) {
+    reinterpret_cast<JniCancellation *>(handle)->token.cancel();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_AsyncPipelinesImpl_releaseTokenImpl(JNIEnv *env, jobject thiz, jlong handle) {
+    auto cancellation = reinterpret_cast<JniCancellation *>(handle);
+    if (cancellation->listener != nullptr) {
+        env->DeleteGlobalRef(cancellation->listener);
+    }
+    delete cancellation;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_AsyncPipelinesImpl_runBoundImpl(JNIEnv *env, jobject thiz, jlong handle,
+                                                             jobject block) {
+    auto cancellation = reinterpret_cast<JniCancellation *>(handle);
+    cancellation->env = env;
+    aire::CancellationScope scope(&cancellation->token);
+    jclass runnableClass = env->GetObjectClass(block);
+    jmethodID run = env->GetMethodID(runnableClass, "run", "()V");
+    env->DeleteLocalRef(runnableClass);
+    env->CallVoidMethod(block, run);
+    cancellation->env = nullptr;
+}
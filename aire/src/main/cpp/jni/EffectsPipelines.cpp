@@ -43,20 +43,23 @@
 #include "color/ConvolveToneMapper.h"
 #include "MathUtils.hpp"
 #include "EigenUtils.h"
+#include "base/Instrumentation.h"
 
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_marbleImpl(JNIEnv *env, jobject thiz,
                                                              jobject bitmap, jfloat intensity,
-                                                             jfloat turbulence, jfloat amplitude) {
+                                                             jfloat turbulence, jfloat amplitude, jlong seed) {
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("marble");
+        cacheKey.with(intensity).with(turbulence).with(amplitude).with(seed);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [intensity, turbulence, amplitude](
+                                                [intensity, turbulence, amplitude, seed](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height,
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -65,7 +68,8 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_marbleImpl(JNIEnv *env, jobjec
                                                                            stride, width,
                                                                            height, intensity,
                                                                            turbulence,
-                                                                           amplitude);
+                                                                           amplitude,
+                                                                           static_cast<uint64_t>(seed));
                                                     }
                                                     return {
                                                             .data = input,
@@ -74,7 +78,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_marbleImpl(JNIEnv *env, jobjec
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
@@ -89,6 +93,8 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_oilImpl(JNIEnv *env, jobject t
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("oil");
+        cacheKey.with(radius).with(levels);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
@@ -110,7 +116,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_oilImpl(JNIEnv *env, jobject t
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
@@ -122,15 +128,17 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_crystallizeImpl(JNIEnv *env, jobject thiz,
                                                                   jobject bitmap, jint clustersCount,
-                                                                  jint strokeColor) {
+                                                                  jint strokeColor, jlong seed) {
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("crystallize");
+        cacheKey.with(clustersCount).with(strokeColor).with(seed);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [clustersCount, strokeColor](
+                                                [clustersCount, strokeColor, seed](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height,
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -139,7 +147,8 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_crystallizeImpl(JNIEnv *env, j
                                                                           stride, width,
                                                                           height,
                                                                           clustersCount,
-                                                                          strokeColor);
+                                                                          strokeColor,
+                                                                          static_cast<uint64_t>(seed));
                                                     }
                                                     return {
                                                             .data = input,
@@ -148,7 +157,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_crystallizeImpl(JNIEnv *env, j
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
@@ -237,15 +246,17 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_waterEffectImpl(JNIEnv *env, j
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_perlinDistortionImpl(JNIEnv *env, jobject thiz, jobject bitmap, jfloat intensity, jfloat turbulence,
-                                                                       jfloat amplitude) {
+                                                                       jfloat amplitude, jlong seed) {
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("perlinDistortion");
+        cacheKey.with(intensity).with(turbulence).with(amplitude).with(seed);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [intensity, turbulence, amplitude](
+                                                [intensity, turbulence, amplitude, seed](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height,
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -255,7 +266,8 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_perlinDistortionImpl(JNIEnv *e
                                                                                height,
                                                                                intensity,
                                                                                turbulence,
-                                                                               amplitude);
+                                                                               amplitude,
+                                                                               static_cast<uint64_t>(seed));
                                                     }
                                                     return {
                                                             .data = input,
@@ -264,7 +276,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_perlinDistortionImpl(JNIEnv *e
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
@@ -289,6 +301,8 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_bokehImpl(JNIEnv *env, jobject
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("bokeh");
+        cacheKey.with(kernelSize).with(sides).with(enhance);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
@@ -299,10 +313,12 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_bokehImpl(JNIEnv *env, jobject
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
                                                     if (fmt == APF_RGBA8888) {
                                                         if (enhance) {
+                                                            aire::ScopedStage stage("bokeh.gaussBlur");
                                                             aire::gaussBlurU8(input.data(),
                                                                               stride, width, height,
                                                                               kernelSize, kernelSize);
                                                         }
+                                                        aire::ScopedStage stage("bokeh.dilate");
                                                         auto kernel = getBokehEffect(kernelSize, sides);
                                                         std::vector<uint8_t> output(stride * height);
                                                         aire::dilateRGBA(input.data(),
@@ -320,7 +336,7 @@ Java_com_awxkee_aire_pipeline_EffectsPipelineImpl_bokehImpl(JNIEnv *env, jobject
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
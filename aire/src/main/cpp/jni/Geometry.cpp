@@ -29,12 +29,50 @@
  */
 
 #include <jni.h>
+#include <android/bitmap.h>
 #include "JNIUtils.h"
 #include "AcquireBitmapPixels.h"
 #include "MathUtils.hpp"
 #include "base/AffineTransform.h"
+#include "base/WarpPerspective.h"
+#include "base/ExactTransform.h"
+#include "base/ImagePyramid.h"
 #include "EigenUtils.h"
 
+static aire::WarpSampler warpSampler(const jint sampler) {
+    if (sampler < aire::WARP_BILINEAR || sampler > aire::WARP_LANCZOS) {
+        std::string msg = "Unknown warp sampler " + std::to_string(sampler);
+        throw AireError(msg);
+    }
+    return static_cast<aire::WarpSampler>(sampler);
+}
+
+static std::vector<AcquirePixelFormat> exactGeometryFormats() {
+    std::vector<AcquirePixelFormat> formats;
+    formats.insert(formats.begin(), APF_RGBA8888);
+    formats.insert(formats.begin(), APF_F16);
+    formats.insert(formats.begin(), APF_565);
+    formats.insert(formats.begin(), APF_RGBA1010102);
+    return formats;
+}
+
+static BuiltImagePresentation exactGeometry(std::vector<uint8_t> &input, int stride, int width, int height,
+                                            AcquirePixelFormat fmt, int newWidth, int newHeight,
+                                            const aire::ExactTransform &exact) {
+    const int pixelSize = getPixelSize(fmt) * getComponents(fmt);
+    int newStride = computeStride(newWidth, getPixelSize(fmt), getComponents(fmt));
+    std::vector<uint8_t> output(newStride * newHeight);
+    aire::exactTransform(input.data(), stride, width, height,
+                         output.data(), newStride, newWidth, newHeight, pixelSize, exact);
+    return {
+            .data = output,
+            .stride = newStride,
+            .width = newWidth,
+            .height = newHeight,
+            .pixelFormat = fmt
+    };
+}
+
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_BasePipelinesImpl_cropImpl(JNIEnv *env, jobject thiz, jobject bitmap,
@@ -44,38 +82,72 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_cropImpl(JNIEnv *env, jobject th
             std::string msg = "Width and height must be > 0 but received (" + std::to_string(newWidth) + "," + std::to_string(newHeight) + ")";
             throw AireError(msg);
         }
-        std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
+        const aire::ExactTransform exact = {1, 0, baseX, 0, 1, baseY};
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
-                                                formats,
+                                                exactGeometryFormats(),
                                                 true,
-                                                [baseX, baseY, newWidth, newHeight](
+                                                [newWidth, newHeight, &exact](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    if (fmt == APF_RGBA8888) {
-                                                        int newStride = computeStride(newWidth, sizeof(uint8_t), 4);
-                                                        std::vector<uint8_t> output(newStride * newHeight);
-                                                        Eigen::Affine3f matrix = Eigen::Affine3f::Identity();
-                                                        matrix.translation() << baseX, baseY, 0;
-                                                        aire::AffineTransform transform(input.data(), stride, width, height);
-                                                        transform.setTransform(matrix);
-                                                        transform.apply(output.data(), newStride, newWidth, newHeight);
-                                                        return {
-                                                                .data = output,
-                                                                .stride = newStride,
-                                                                .width = newWidth,
-                                                                .height = newHeight,
-                                                                .pixelFormat = fmt
-                                                        };
+                                                    return exactGeometry(input, stride, width, height, fmt,
+                                                                         newWidth, newHeight, exact);
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_applyOrientationImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                     jint orientation) {
+    try {
+        if (orientation < 1 || orientation > 8) {
+            std::string msg = "Orientation must be in [1, 8] but received " + std::to_string(orientation);
+            throw AireError(msg);
+        }
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                exactGeometryFormats(),
+                                                true,
+                                                [orientation](
+                                                        std::vector<uint8_t> &input, int stride,
+                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    // Destination to source mapping for each EXIF orientation
+                                                    aire::ExactTransform exact = {1, 0, 0, 0, 1, 0};
+                                                    switch (orientation) {
+                                                        case 2:
+                                                            exact = {-1, 0, width - 1, 0, 1, 0};
+                                                            break;
+                                                        case 3:
+                                                            exact = {-1, 0, width - 1, 0, -1, height - 1};
+                                                            break;
+                                                        case 4:
+                                                            exact = {1, 0, 0, 0, -1, height - 1};
+                                                            break;
+                                                        case 5:
+                                                            exact = {0, 1, 0, 1, 0, 0};
+                                                            break;
+                                                        case 6:
+                                                            exact = {0, 1, 0, -1, 0, height - 1};
+                                                            break;
+                                                        case 7:
+                                                            exact = {0, -1, width - 1, -1, 0, height - 1};
+                                                            break;
+                                                        case 8:
+                                                            exact = {0, -1, width - 1, 1, 0, 0};
+                                                            break;
+                                                        default:
+                                                            break;
                                                     }
-                                                    return {
-                                                            .data = input,
-                                                            .stride = stride,
-                                                            .width = width,
-                                                            .height = height,
-                                                            .pixelFormat = fmt
-                                                    };
+                                                    const bool swapsAxes = orientation >= 5;
+                                                    return exactGeometry(input, stride, width, height, fmt,
+                                                                         swapsAxes ? height : width,
+                                                                         swapsAxes ? width : height, exact);
                                                 });
         return newBitmap;
     } catch (AireError &err) {
@@ -89,41 +161,63 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_BasePipelinesImpl_rotateImpl(JNIEnv *env, jobject thiz, jobject bitmap,
                                                            jfloat angle, jint anchorPointX, jint anchorPointY,
-                                                           jint newWidth, jint newHeight) {
+                                                           jint newWidth, jint newHeight, jint sampler) {
     try {
+        const aire::WarpSampler warpMode = warpSampler(sampler);
         if (newWidth < 0 || newHeight < 0) {
             std::string msg = "Width and height must be > 0 but received (" + std::to_string(newWidth) + "," + std::to_string(newHeight) + ")";
             throw AireError(msg);
         }
+        AndroidBitmapInfo info;
+        if (AndroidBitmap_getInfo(env, bitmap, &info) < 0) {
+            std::string msg("Cannot acquire bitmap info");
+            throw AireError(msg);
+        }
+        const int sourceWidth = static_cast<int>(info.width);
+        const int sourceHeight = static_cast<int>(info.height);
+
+        Eigen::Affine3f matrix = Eigen::Affine3f::Identity();
+
+        auto t = Eigen::Translation3f(Eigen::Vector3f{anchorPointX, anchorPointY, 0.f});
+        Eigen::Affine3f tr(t);
+
+        auto comp = Eigen::Translation3f(Eigen::Vector3f{-anchorPointX, -anchorPointY, 0.f});
+        Eigen::Affine3f trc(comp);
+
+        Eigen::Vector3f axis = {0.f, 0.f, 1.f};
+        matrix = matrix * tr;
+        matrix.rotate(Eigen::AngleAxis<float>(angle, axis));
+        matrix = matrix * trc;
+
+        matrix.translate(Eigen::Vector3f{-(newWidth - sourceWidth) / 2.f, -(newHeight - sourceHeight) / 2.f, 0.f});
+
+        // Right angle rotations are moved without resampling, for any pixel format
+        aire::ExactTransform exact;
+        const bool isExact = aire::isExactTransform(aire::AffineTransform::planarTransform(matrix), exact);
+
         std::vector<AcquirePixelFormat> formats;
-        formats.insert(formats.begin(), APF_RGBA8888);
+        if (isExact) {
+            formats = exactGeometryFormats();
+        } else {
+            formats.insert(formats.begin(), APF_RGBA8888);
+        }
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [angle, newWidth, newHeight, anchorPointX, anchorPointY](
+                                                [&matrix, &exact, isExact, newWidth, newHeight, warpMode](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (isExact) {
+                                                        return exactGeometry(input, stride, width, height, fmt,
+                                                                             newWidth, newHeight, exact);
+                                                    }
                                                     if (fmt == APF_RGBA8888) {
                                                         int newStride = computeStride(newWidth, sizeof(uint8_t), 4);
                                                         std::vector<uint8_t> output(newStride * newHeight);
-                                                        Eigen::Affine3f matrix = Eigen::Affine3f::Identity();
-
-                                                        auto t = Eigen::Translation3f(Eigen::Vector3f{anchorPointX, anchorPointY, 0.f});
-                                                        Eigen::Affine3f tr(t);
-
-                                                        auto comp = Eigen::Translation3f(Eigen::Vector3f{-anchorPointX, -anchorPointY, 0.f});
-                                                        Eigen::Affine3f trc(comp);
-
-                                                        Eigen::Vector3f axis = {0.f, 0.f, 1.f};
-                                                        matrix = matrix * tr;
-                                                        matrix.rotate(Eigen::AngleAxis<float>(angle, axis));
-                                                        matrix = matrix * trc;
-
-                                                        matrix.translate(Eigen::Vector3f{-(newWidth - width) / 2.f, -(newHeight - height) / 2.f, 0.f});
-
                                                         aire::AffineTransform transform(input.data(), stride, width, height);
                                                         transform.setTransform(matrix);
+                                                        transform.setSampler(warpMode);
                                                         transform.apply(output.data(), newStride, newWidth, newHeight);
                                                         return {
                                                                 .data = output,
@@ -153,8 +247,9 @@ extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_BasePipelinesImpl_warpAffineImpl(JNIEnv *env, jobject thiz, jobject bitmap,
                                                                jfloatArray transform, jint newWidth,
-                                                               jint newHeight) {
+                                                               jint newHeight, jint sampler) {
     try {
+        const aire::WarpSampler warpMode = warpSampler(sampler);
         if (newWidth < 0 || newHeight < 0) {
             std::string msg = "Width and height must be > 0 but received (" + std::to_string(newWidth) + "," + std::to_string(newHeight) + ")";
             throw AireError(msg);
@@ -184,7 +279,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_warpAffineImpl(JNIEnv *env, jobj
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [newWidth, newHeight, affine](
+                                                [newWidth, newHeight, affine, warpMode](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height,
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -194,6 +289,7 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_warpAffineImpl(JNIEnv *env, jobj
 
                                                         aire::AffineTransform transform(input.data(), stride, width, height);
                                                         transform.setTransform(affine);
+                                                        transform.setSampler(warpMode);
                                                         transform.apply(output.data(), newStride, newWidth, newHeight);
                                                         return {
                                                                 .data = output,
@@ -217,4 +313,121 @@ Java_com_awxkee_aire_pipeline_BasePipelinesImpl_warpAffineImpl(JNIEnv *env, jobj
         throwException(env, msg);
         return nullptr;
     }
-}
\ No newline at end of file
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_warpPerspectiveImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                    jfloatArray transform, jint sampler) {
+    try {
+        const aire::WarpSampler warpMode = warpSampler(sampler);
+        jsize length = env->GetArrayLength(transform);
+        if (length != 9) {
+            std::string msg = "Perspective transform must be exactly 3x3";
+            throwException(env, msg);
+            return nullptr;
+        }
+
+        Eigen::Matrix3f perspective;
+        jfloat *inputElements = env->GetFloatArrayElements(transform, 0);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                perspective(i, j) = inputElements[i * 3 + j];
+            }
+        }
+        env->ReleaseFloatArrayElements(transform, inputElements, 0);
+
+        if (std::abs(perspective.determinant()) < 1e-8f) {
+            std::string msg = "Perspective transform must be invertible";
+            throw AireError(msg);
+        }
+
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [perspective, warpMode](
+                                                        std::vector<uint8_t> &input, int stride,
+                                                        int width, int height,
+                                                        AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (fmt == APF_RGBA8888) {
+                                                        aire::WarpPerspective warpPerspective(input.data(), stride, width, height);
+                                                        warpPerspective.setTransform(perspective);
+                                                        warpPerspective.setSampler(warpMode);
+                                                        aire::WarpResult result = warpPerspective.apply();
+                                                        return {
+                                                                .data = result.result,
+                                                                .stride = result.stride,
+                                                                .width = result.width,
+                                                                .height = result.height,
+                                                                .pixelFormat = fmt
+                                                        };
+                                                    }
+                                                    return {
+                                                            .data = input,
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_BasePipelinesImpl_pyramidDownImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                                jint levels) {
+    try {
+        if (levels < 1) {
+            std::string msg = "Levels count must be positive but received " + std::to_string(levels);
+            throw AireError(msg);
+        }
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [levels](
+                                                        std::vector<uint8_t> &input, int stride,
+                                                        int width, int height, AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    std::vector<uint8_t> level;
+                                                    for (int i = 0; i < levels && (width > 1 || height > 1); ++i) {
+                                                        const int newWidth = (width + 1) / 2;
+                                                        const int newHeight = (height + 1) / 2;
+                                                        const int newStride = computeStride(newWidth, getPixelSize(fmt),
+                                                                                            getComponents(fmt));
+                                                        std::vector<uint8_t> output(newStride * newHeight);
+                                                        aire::pyramidDownsample(i == 0 ? input.data() : level.data(), stride,
+                                                                                width, height, output.data(), newStride);
+                                                        level = std::move(output);
+                                                        stride = newStride;
+                                                        width = newWidth;
+                                                        height = newHeight;
+                                                    }
+                                                    if (level.empty()) {
+                                                        level = input;
+                                                    }
+                                                    return {
+                                                            .data = level,
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                });
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
@@ -34,19 +34,7 @@
 #include <stdexcept>
 #include <string>
 #include <android/log.h>
-
-class AireError : public std::runtime_error {
-    std::string what_message;
-
-public:
-    AireError(const std::string &str) : runtime_error(str), what_message(str) {
-
-    }
-
-    const char *what() const noexcept override {
-        return what_message.c_str();
-    }
-};
+#include "AireError.h"
 
 static jint throwException(JNIEnv *env, std::string &msg) {
     jclass exClass;
@@ -57,9 +45,4 @@ static jint throwException(JNIEnv *env, std::string &msg) {
 #define LOG_TAG "Aire"
 #define LOG(severity, ...) ((void)__android_log_print(ANDROID_LOG_##severity, LOG_TAG, __VA_ARGS__))
 #define LOGE(...) LOG(ERROR, __VA_ARGS__)
-#define LOGV(...) LOG(VERBOSE, __VA_ARGS__)
-
-enum AireQuantize {
-    AIRE_QUANTIZE_MEDIAN_CUT = 1,
-    AIRE_QUANTIZE_XIAOLING_WU = 2
-};
\ No newline at end of file
+#define LOGV(...) LOG(VERBOSE, __VA_ARGS__)
\ No newline at end of file
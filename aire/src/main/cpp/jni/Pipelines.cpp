@@ -33,6 +33,9 @@
 #include "AcquireBitmapPixels.h"
 #include "pipelines/RemoveShadows.h"
 #include "pipelines/DehazeDarkChannel.h"
+#include "base/Convolve2D.h"
+#include "pipelines/FusedPipeline.h"
+#include "pipelines/TiledPipeline.h"
 #include "MathUtils.hpp"
 #include "Eigen/Eigen"
 
@@ -86,6 +89,8 @@ Java_com_awxkee_aire_pipeline_ProcessingPipelinesImpl_dehazeImpl(JNIEnv *env, jo
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("dehaze");
+        cacheKey.with(radius).with(omega);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
@@ -105,6 +110,57 @@ Java_com_awxkee_aire_pipeline_ProcessingPipelinesImpl_dehazeImpl(JNIEnv *env, jo
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
+                                                }, true, &cacheKey);
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_ProcessingPipelinesImpl_fastConvolve2DImpl(JNIEnv *env, jobject thiz,
+                                                                         jobject bitmap, jfloatArray kernel,
+                                                                         jint kernelWidth, jint kernelHeight) {
+    try {
+        jsize length = env->GetArrayLength(kernel);
+        if (kernelWidth < 1 || kernelHeight < 1 || length != kernelWidth * kernelHeight) {
+            std::string msg("Kernel must have exactly kernelWidth * kernelHeight values");
+            throwException(env, msg);
+            return nullptr;
+        }
+        Eigen::MatrixXf matrix(kernelHeight, kernelWidth);
+        jfloat *inputElements = env->GetFloatArrayElements(kernel, 0);
+        for (int j = 0; j < kernelHeight; ++j) {
+            for (int i = 0; i < kernelWidth; ++i) {
+                matrix(j, i) = inputElements[j * kernelWidth + i];
+            }
+        }
+        env->ReleaseFloatArrayElements(kernel, inputElements, 0);
+
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [&matrix](
+                                                        std::vector<uint8_t> &input, int stride,
+                                                        int width, int height,
+                                                        AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (fmt == APF_RGBA8888) {
+                                                        aire::convolve2D(input.data(), stride,
+                                                                         width, height, matrix);
+                                                    }
+                                                    return {
+                                                            .data = input,
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
                                                 });
         return newBitmap;
     } catch (AireError &err) {
@@ -112,4 +168,94 @@ Java_com_awxkee_aire_pipeline_ProcessingPipelinesImpl_dehazeImpl(JNIEnv *env, jo
         throwException(env, msg);
         return nullptr;
     }
-}
\ No newline at end of file
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_awxkee_aire_pipeline_ProcessingPipelinesImpl_fusedPipelineImpl(JNIEnv *env, jobject thiz,
+                                                                        jobject bitmap, jintArray ops,
+                                                                        jfloatArray params) {
+    try {
+        std::vector<int> opsVector(env->GetArrayLength(ops));
+        env->GetIntArrayRegion(ops, 0, static_cast<jsize>(opsVector.size()), opsVector.data());
+        std::vector<float> paramsVector(env->GetArrayLength(params));
+        env->GetFloatArrayRegion(params, 0, static_cast<jsize>(paramsVector.size()), paramsVector.data());
+
+        aire::FusedPipeline pipeline(opsVector, paramsVector);
+
+        std::vector<AcquirePixelFormat> formats;
+        formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("fused");
+        cacheKey.with(opsVector).with(paramsVector);
+        jobject newBitmap = AcquireBitmapPixels(env,
+                                                bitmap,
+                                                formats,
+                                                true,
+                                                [&pipeline](
+                                                        std::vector<uint8_t> &input, int stride,
+                                                        int width, int height,
+                                                        AcquirePixelFormat fmt) -> BuiltImagePresentation {
+                                                    if (fmt == APF_RGBA8888) {
+                                                        pipeline.apply(input.data(), stride, width, height);
+                                                    }
+                                                    return {
+                                                            .data = input,
+                                                            .stride = stride,
+                                                            .width = width,
+                                                            .height = height,
+                                                            .pixelFormat = fmt
+                                                    };
+                                                }, true, &cacheKey);
+        return newBitmap;
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+        return nullptr;
+    }
+}
+
+static std::string tiledPath(JNIEnv *env, jstring path) {
+    const char *chars = env->GetStringUTFChars(path, nullptr);
+    std::string value(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    return value;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_ProcessingPipelinesImpl_fusedTiledImpl(JNIEnv *env, jobject thiz,
+                                                                     jstring inputPath, jint width, jint height,
+                                                                     jstring outputPath, jint output,
+                                                                     jintArray ops, jfloatArray params,
+                                                                     jlong memoryBudget) {
+    try {
+        std::vector<int> opsVector(env->GetArrayLength(ops));
+        env->GetIntArrayRegion(ops, 0, static_cast<jsize>(opsVector.size()), opsVector.data());
+        std::vector<float> paramsVector(env->GetArrayLength(params));
+        env->GetFloatArrayRegion(params, 0, static_cast<jsize>(paramsVector.size()), paramsVector.data());
+
+        if (memoryBudget <= 0) {
+            std::string msg("Memory budget must be positive but received " + std::to_string(memoryBudget));
+            throw AireError(msg);
+        }
+
+        aire::FusedPipeline pipeline(opsVector, paramsVector);
+        aire::TiledPipeline tiled(pipeline, static_cast<size_t>(memoryBudget));
+
+        aire::MappedImage input = aire::MappedImage::open(tiledPath(env, inputPath), width, height,
+                                                          width * 4, 0, false);
+        aire::MappedSource source(input);
+        const std::string destination = tiledPath(env, outputPath);
+        if (output == 1) {
+            aire::PNGStreamSink sink(destination, width, height, 7);
+            tiled.run(source, sink);
+        } else {
+            aire::MappedImage result = aire::MappedImage::create(destination, width, height);
+            aire::MappedSink sink(result);
+            tiled.run(source, sink);
+        }
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include <jni.h>
+#include "base/ResultCache.h"
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_ResultCacheImpl_setResultCacheBudgetImpl(JNIEnv *env, jobject thiz, jlong bytes) {
+    aire::ResultCache::shared().setBudget(bytes > 0 ? static_cast<size_t>(bytes) : 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_ResultCacheImpl_clearResultCacheImpl(JNIEnv *env, jobject thiz) {
+    aire::ResultCache::shared().clear();
+}
+
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_awxkee_aire_pipeline_ResultCacheImpl_resultCacheStatsImpl(JNIEnv *env, jobject thiz) {
+    const aire::ResultCacheStats stats = aire::ResultCache::shared().stats();
+    const jlong values[] = {
+            static_cast<jlong>(stats.hits),
+            static_cast<jlong>(stats.misses),
+            static_cast<jlong>(stats.evictions),
+            static_cast<jlong>(stats.entries),
+            static_cast<jlong>(stats.bytes),
+            static_cast<jlong>(stats.budget),
+    };
+    jlongArray result = env->NewLongArray(6);
+    env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
@@ -31,7 +31,7 @@
 #include "JNIUtils.h"
 #include "AcquireBitmapPixels.h"
 #include "shift/TiltShift.h"
-#include "blur/GaussBlur.h"
+#include "MathUtils.hpp"
 #include "shift/Glitch.h"
 #include "shift/WindStagger.h"
 
@@ -52,24 +52,16 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_tiltShiftImpl(JNIEnv *env, jobje
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height,
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    std::vector<uint8_t> blurred(input.size());
-                                                    std::copy(input.begin(), input.end(), blurred.begin());
-                                                    std::vector<uint8_t> output(input.size());
                                                     if (fmt == APF_RGBA8888) {
-                                                        aire::gaussBlurU8(blurred.data(),
-                                                                          stride, width, height,
-                                                                          radius, sigma);
-                                                        aire::tiltShift(output.data(),
-                                                                        input.data(),
-                                                                        blurred,
+                                                        const float tiltSigma = computeKernelSigma(compute1DGaussianKernel(radius, sigma));
+                                                        aire::tiltShift(input.data(),
                                                                         stride, width,
-                                                                        height,
+                                                                        height, tiltSigma,
                                                                         anchorX, anchorY,
                                                                         tiltRadius);
                                                     }
-                                                    blurred.clear();
                                                     return {
-                                                            .data = output,
+                                                            .data = input,
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
@@ -89,15 +81,17 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_glitchImpl(JNIEnv *env, jobject
                                                            jobject bitmap, jfloat shiftX,
                                                            jfloat shiftY, jfloat corruptionSize,
                                                            jint corruptions, jfloat cShiftX,
-                                                           jfloat cShiftY) {
+                                                           jfloat cShiftY, jlong seed) {
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("glitch");
+        cacheKey.with(shiftX).with(shiftY).with(corruptionSize).with(corruptions).with(cShiftX).with(cShiftY).with(seed);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
                                                 true,
-                                                [shiftX, shiftY, corruptionSize, corruptions, cShiftX, cShiftY](
+                                                [shiftX, shiftY, corruptionSize, corruptions, cShiftX, cShiftY, seed](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height,
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -105,7 +99,8 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_glitchImpl(JNIEnv *env, jobject
                                                         aire::glitchEffect(input.data(),
                                                                            stride, width,
                                                                            height, shiftX, shiftY,
-                                                                           corruptionSize, corruptions, cShiftX, cShiftY);
+                                                                           corruptionSize, corruptions, cShiftX, cShiftY,
+                                                                           static_cast<uint64_t>(seed));
                                                     }
                                                     return {
                                                             .data = input,
@@ -114,7 +109,7 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_glitchImpl(JNIEnv *env, jobject
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
@@ -127,15 +122,17 @@ JNIEXPORT jobject JNICALL
 Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_horizontalWindStaggerImpl(JNIEnv *env, jobject thiz,
                                                                           jobject bitmap,
                                                                           jfloat windStrength, jint streamsCount,
-                                                                          jint clearColor) {
+                                                                          jint clearColor, jlong seed) {
     try {
         std::vector<AcquirePixelFormat> formats;
         formats.insert(formats.begin(), APF_RGBA8888);
+        aire::ResultKey cacheKey("windStagger");
+        cacheKey.with(windStrength).with(streamsCount).with(clearColor).with(seed);
         jobject newBitmap = AcquireBitmapPixels(env,
                                                 bitmap,
                                                 formats,
                                                 false,
-                                                [windStrength, streamsCount, clearColor](
+                                                [windStrength, streamsCount, clearColor, seed](
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height,
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
@@ -145,7 +142,8 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_horizontalWindStaggerImpl(JNIEnv
                                                                                     input.data(),
                                                                                     stride, width, height,
                                                                                     windStrength, streamsCount,
-                                                                                    static_cast<uint32_t>(clearColor));
+                                                                                    static_cast<uint32_t>(clearColor),
+                                                                                    static_cast<uint64_t>(seed));
                                                         input = std::move(output);
                                                     }
                                                     return {
@@ -155,7 +153,7 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_horizontalWindStaggerImpl(JNIEnv
                                                             .height = height,
                                                             .pixelFormat = fmt
                                                     };
-                                                });
+                                                }, true, &cacheKey);
         return newBitmap;
     } catch (AireError &err) {
         std::string msg = err.what();
@@ -181,27 +179,19 @@ Java_com_awxkee_aire_pipeline_ShiftPipelineImpl_horizontalTiltShiftImpl(JNIEnv *
                                                         std::vector<uint8_t> &input, int stride,
                                                         int width, int height,
                                                         AcquirePixelFormat fmt) -> BuiltImagePresentation {
-                                                    std::vector<uint8_t> blurred(input.size());
-                                                    std::copy(input.begin(), input.end(),
-                                                              blurred.begin());
-                                                    std::vector<uint8_t> output(input.size());
                                                     if (fmt == APF_RGBA8888) {
-                                                        aire::gaussBlurU8(blurred.data(),
-                                                                          stride, width, height,
-                                                                          radius, sigma);
-                                                        aire::horizontalTiltShift(output.data(),
-                                                                                  input.data(),
-                                                                                  blurred,
+                                                        const float tiltSigma = computeKernelSigma(compute1DGaussianKernel(radius, sigma));
+                                                        aire::horizontalTiltShift(input.data(),
                                                                                   stride, width,
                                                                                   height,
+                                                                                  tiltSigma,
                                                                                   anchorX,
                                                                                   anchorY,
                                                                                   tiltRadius,
                                                                                   angle);
                                                     }
-                                                    blurred.clear();
                                                     return {
-                                                            .data = output,
+                                                            .data = input,
                                                             .stride = stride,
                                                             .width = width,
                                                             .height = height,
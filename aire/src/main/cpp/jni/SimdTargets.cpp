@@ -0,0 +1,74 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include <jni.h>
+#include <string>
+#include <vector>
+#include "base/SimdTargets.h"
+#include "AireError.h"
+#include "JNIUtils.h"
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_awxkee_aire_pipeline_SimdTargetsImpl_simdTargetsImpl(JNIEnv *env, jobject thiz) {
+    std::vector<std::string> targets = aire::simdTargets();
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(targets.size()), stringClass, nullptr);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        jstring name = env->NewStringUTF(targets[i].c_str());
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), name);
+        env->DeleteLocalRef(name);
+    }
+    return result;
+}
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_awxkee_aire_pipeline_SimdTargetsImpl_activeSimdTargetImpl(JNIEnv *env, jobject thiz) {
+    std::string target = aire::activeSimdTarget();
+    return env->NewStringUTF(target.c_str());
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_aire_pipeline_SimdTargetsImpl_forceSimdTargetImpl(JNIEnv *env, jobject thiz, jstring target) {
+    try {
+        std::string name;
+        if (target != nullptr) {
+            const char *chars = env->GetStringUTFChars(target, nullptr);
+            name = chars;
+            env->ReleaseStringUTFChars(target, chars);
+        }
+        aire::forceSimdTarget(name);
+    } catch (AireError &err) {
+        std::string msg = err.what();
+        throwException(env, msg);
+    }
+}
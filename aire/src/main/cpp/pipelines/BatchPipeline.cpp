@@ -0,0 +1,202 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "BatchPipeline.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "concurrency.hpp"
+#include "pipelines/FusedPipeline.h"
+#include "base/Cancellation.h"
+
+namespace aire {
+
+    BatchPipeline::BatchPipeline(BatchRecipe recipe, const int maxInFlight, const size_t memoryBudget)
+            : recipe(std::move(recipe)), maxInFlight(maxInFlight), memoryBudget(memoryBudget) {
+    }
+
+    size_t BatchPipeline::jobMemory(const BatchImage &image, const FusedPipeline *filter) const {
+        size_t memory = image.data.size();
+        if (filter != nullptr) {
+            memory += filter->workingMemory(image.width, image.height);
+        }
+        if (recipe.encoding == BATCH_ENCODE_PNG) {
+            return memory + compressPNGWorkingMemory(image.width, image.height, recipe.quantize);
+        }
+        return memory + compressJPEGWorkingMemory(image.width, image.height);
+    }
+
+    std::vector<uint8_t> BatchPipeline::process(BatchImage &image) {
+        if (!recipe.ops.empty()) {
+            FusedPipeline pipeline(recipe.ops, recipe.params);
+            pipeline.apply(image.data.data(), image.stride, image.width, image.height);
+        }
+        if (recipe.encoding == BATCH_ENCODE_PNG) {
+            return compressPNG(image.data.data(), image.stride, image.width, image.height, recipe.maxColors,
+                               recipe.quantize, recipe.dithering, recipe.strategy, recipe.compressionLevel);
+        }
+        return compressJPEG(image.data.data(), image.stride, image.width, image.height, recipe.quality);
+    }
+
+    void BatchPipeline::run(const int count,
+                            const std::function<void(int, BatchImage &)> &decode,
+                            const std::function<void(int, std::vector<uint8_t> &)> &deliver) {
+        if (count <= 0) {
+            return;
+        }
+
+        const int threads = concurrency::limitThreads(
+                std::max(static_cast<int>(std::thread::hardware_concurrency()), 1));
+        const int workersCount = std::min(threads, count);
+        const int inFlightLimit = maxInFlight > 0 ? maxInFlight : workersCount * 2;
+
+        std::mutex mutex;
+        std::condition_variable pendingReady;
+        std::condition_variable resultReady;
+        std::deque<std::pair<int, BatchImage>> pending;
+        std::deque<std::pair<int, std::vector<uint8_t>>> results;
+        std::exception_ptr failure;
+        bool finished = false;
+        concurrency::ThreadsShare share(threads);
+        CancellationToken *token = CancellationToken::current();
+
+        auto worker = [&]() {
+            CancellationScope cancellation(token, true);
+            // Loops inside the kernels share the threads with other workers busy at the moment
+            concurrency::localThreadsShare() = &share;
+            while (true) {
+                std::pair<int, BatchImage> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    pendingReady.wait(lock, [&] { return finished || !pending.empty(); });
+                    if (pending.empty()) {
+                        return;
+                    }
+                    job = std::move(pending.front());
+                    pending.pop_front();
+                }
+
+                share.enter();
+                std::vector<uint8_t> encoded;
+                std::exception_ptr error;
+                try {
+                    encoded = process(job.second);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                share.leave();
+                job.second = BatchImage();
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (error && !failure) {
+                        failure = error;
+                    }
+                    results.emplace_back(job.first, std::move(encoded));
+                }
+                resultReady.notify_one();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        auto stop = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished = true;
+                pending.clear();
+            }
+            pendingReady.notify_all();
+            for (auto &thread: workers) {
+                thread.join();
+            }
+        };
+
+        try {
+            for (int i = 0; i < workersCount; ++i) {
+                workers.emplace_back(worker);
+            }
+
+            int next = 0;
+            int delivered = 0;
+            int inFlight = 0;
+            // Images and their scratch are charged from decoding until delivery
+            const std::unique_ptr<FusedPipeline> filter = recipe.ops.empty() ? nullptr
+                    : std::make_unique<FusedPipeline>(recipe.ops, recipe.params);
+            std::vector<size_t> charges(count, 0);
+            size_t charged = 0;
+            auto canDecode = [&]() {
+                return next < count && inFlight < inFlightLimit && (inFlight == 0 || charged < memoryBudget);
+            };
+            while (delivered < count) {
+                cancellationPoint();
+                if (canDecode()) {
+                    BatchImage image;
+                    decode(next, image);
+                    charges[next] = jobMemory(image, filter.get());
+                    charged += charges[next];
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        pending.emplace_back(next, std::move(image));
+                    }
+                    pendingReady.notify_one();
+                    ++next;
+                    ++inFlight;
+                }
+
+                std::deque<std::pair<int, std::vector<uint8_t>>> ready;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (!canDecode()) {
+                        resultReady.wait(lock, [&] { return !results.empty(); });
+                    }
+                    if (failure) {
+                        std::rethrow_exception(failure);
+                    }
+                    ready.swap(results);
+                }
+
+                for (auto &result: ready) {
+                    deliver(result.first, result.second);
+                    charged -= charges[result.first];
+                    --inFlight;
+                    ++delivered;
+                }
+            }
+        } catch (...) {
+            stop();
+            throw;
+        }
+        stop();
+    }
+}
@@ -0,0 +1,107 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <functional>
+#include "base/ImageCompression.h"
+#include "pipelines/FusedPipeline.h"
+
+namespace aire {
+
+    enum BatchEncoding {
+        BATCH_ENCODE_PNG = 0,
+        BATCH_ENCODE_JPEG = 1
+    };
+
+    /**
+     * Filter chain as FusedPipeline ops and params followed by the encoder settings
+     */
+    struct BatchRecipe {
+        std::vector<int> ops;
+        std::vector<float> params;
+        BatchEncoding encoding = BATCH_ENCODE_JPEG;
+        int quality = 90;
+        int maxColors = 256;
+        AireQuantize quantize = AIRE_QUANTIZE_XIAOLING_WU;
+        RemapDithering dithering = Remap_Dither_Jarvis_Judice_Ninke;
+        RemapMappingStrategy strategy = Remap_Search_Cover;
+        int compressionLevel = 7;
+    };
+
+    struct BatchImage {
+        std::vector<uint8_t> data;
+        int stride = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    // Default bound of memory held by images in flight together with their filter and encoder scratch
+    static constexpr size_t kBatchMemoryBudget = 256 * 1024 * 1024;
+
+    /**
+     * Filters and encodes a sequence of premultiplied RGBA8888 images with one recipe.
+     * Images are decoded and results delivered on the calling thread while workers filter and encode,
+     * every worker owns one image at a time, so small images run one per core and a large one
+     * takes the threads of workers that are idle
+     */
+    class BatchPipeline {
+    public:
+        /**
+         * @param maxInFlight - upper bound of images decoded but not delivered yet, 0 picks twice the workers count
+         * @param memoryBudget - next image is not decoded while images in flight with their working memory
+         * take this much, at least one image is always in flight
+         */
+        BatchPipeline(BatchRecipe recipe, int maxInFlight, size_t memoryBudget = kBatchMemoryBudget);
+
+        /**
+         * @param decode - fills the image with the given index, called in index order
+         * @param deliver - receives encoded image with the given index, called in order of completion
+         */
+        void run(int count,
+                 const std::function<void(int, BatchImage &)> &decode,
+                 const std::function<void(int, std::vector<uint8_t> &)> &deliver);
+
+    private:
+        std::vector<uint8_t> process(BatchImage &image);
+
+        /**
+         * Memory the image holds from decoding until delivery, filter and encoder scratch included
+         */
+        size_t jobMemory(const BatchImage &image, const FusedPipeline *filter) const;
+
+        const BatchRecipe recipe;
+        const int maxInFlight;
+        const size_t memoryBudget;
+    };
+}
@@ -28,85 +28,168 @@
  *
  */
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "pipelines/DehazeDarkChannel.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
 #include "DehazeDarkChannel.h"
 #include <vector>
-#include "Eigen/Eigen"
 #include <queue>
-#include "hwy/highway.h"
 #include "MathUtils.hpp"
+#include <thread>
+#include "concurrency.hpp"
+#include "base/PaddedImage.h"
+#include "base/PlanarImage.h"
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace std;
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
 
     void
-    getDarkChannel(const uint8_t *pSrc, std::vector<uint8_t> &tmpVec, const int stride, const int width, const int height, int radius) {
-        const ScalableTag<uint8_t> du;
-        using VU = Vec<decltype(du)>;
-
-        const int lanes = du.MaxLanes();
-
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                uint8_t min_val = 255;
-
-                uint8_t *darkImage = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(tmpVec.data()) + width * i);
-
-                for (int y = -radius; y <= radius; y++) {
-                    const uint8_t *tmp = reinterpret_cast<const uint8_t *>(reinterpret_cast<const uint8_t *>(pSrc) + stride * clamp(y + i, 0, height - 1));
-                    int x = -radius;
-
-                    for (; x + lanes <= radius && x + j + lanes < width; x += lanes) {
-                        int pos = clamp(x + j, 0, width - 1) * 4;
-                        VU r, g, b, a;
-                        LoadInterleaved4(du, &tmp[pos], r, g, b, a);
-                        uint8_t possibleR = ExtractLane(MinOfLanes(du, r), 0);
-                        uint8_t possibleG = ExtractLane(MinOfLanes(du, r), 0);
-                        uint8_t possibleB = ExtractLane(MinOfLanes(du, r), 0);
-                        min_val = std::min(min3(possibleR, possibleG, possibleB), min_val);
-                    }
-
-                    for (; x <= radius; x++) {
-                        int pos = x + j;
-                        if (pos >= width) {
-                            break;
-                        }
-                        pos = clamp(pos, 0, width - 1) * 4;
-                        uint8_t b = tmp[pos + 0];
-                        uint8_t g = tmp[pos + 1];
-                        uint8_t r = tmp[pos + 2];
-                        uint8_t minpixel = min3(r, g, b);
-                        min_val = std::min(minpixel, min_val);
-                    }
+    getDarkChannelHWY(const uint8_t *pSrc, uint8_t *tmpVec, const int stride, const int width, const int height, int radius) {
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+
+        // Replicated edge never changes a window minimum, so borders match the clipped window
+        PaddedImage minimums(width, height, 1, radius, radius);
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const ScalableTag<uint8_t> du;
+            using VU = Vec<decltype(du)>;
+            const int lanes = Lanes(du);
+            const uint8_t *src = pSrc + y * stride;
+            uint8_t *dst = minimums.row(y);
+            int x = 0;
+            for (; x + lanes <= width; x += lanes) {
+                VU r, g, b, a;
+                LoadInterleaved4(du, src + x * 4, r, g, b, a);
+                StoreU(Min(Min(r, g), b), du, dst + x);
+            }
+            for (; x < width; ++x) {
+                dst[x] = min3(src[x * 4], src[x * 4 + 1], src[x * 4 + 2]);
+            }
+        });
+        minimums.materialize(EDGE_CLAMP);
+
+        // Square window minimum is separable, rows of the vertical border are eroded horizontally as well
+        PaddedImage horizontal(width, height, 1, 0, radius);
+        concurrency::parallel_for(threadCount, height + 2 * radius, [&](int i) {
+            const ScalableTag<uint8_t> du;
+            using VU = Vec<decltype(du)>;
+            const int lanes = Lanes(du);
+            const uint8_t *src = minimums.row(i - radius) - radius;
+            uint8_t *dst = horizontal.row(i - radius);
+            int x = 0;
+            for (; x + lanes <= width; x += lanes) {
+                VU m = LoadU(du, src + x);
+                for (int k = 1; k <= 2 * radius; ++k) {
+                    m = Min(m, LoadU(du, src + x + k));
+                }
+                StoreU(m, du, dst + x);
+            }
+            for (; x < width; ++x) {
+                uint8_t m = src[x];
+                for (int k = 1; k <= 2 * radius; ++k) {
+                    m = std::min(m, src[x + k]);
+                }
+                dst[x] = m;
+            }
+        });
+
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            const ScalableTag<uint8_t> du;
+            using VU = Vec<decltype(du)>;
+            const int lanes = Lanes(du);
+            uint8_t *dst = tmpVec + y * width;
+            int x = 0;
+            for (; x + lanes <= width; x += lanes) {
+                VU m = LoadU(du, horizontal.row(y - radius) + x);
+                for (int k = 1; k <= 2 * radius; ++k) {
+                    m = Min(m, LoadU(du, horizontal.row(y - radius + k) + x));
+                }
+                StoreU(m, du, dst + x);
+            }
+            for (; x < width; ++x) {
+                uint8_t m = horizontal.row(y - radius)[x];
+                for (int k = 1; k <= 2 * radius; ++k) {
+                    m = std::min(m, horizontal.row(y - radius + k)[x]);
                 }
-                darkImage[j] = min_val;
+                dst[x] = m;
             }
+        });
+    }
+
+    void transmissionRowHWY(float *r, float *g, float *b, const uint8_t *dark, const int width,
+                            const float atmosphereLight, const float omega) {
+        const ScalableTag<float> df;
+        const Rebind<uint32_t, decltype(df)> du32;
+        const Rebind<uint8_t, decltype(df)> du8;
+        using VF = Vec<decltype(df)>;
+        const VF light = Set(df, atmosphereLight);
+        const VF vOmega = Set(df, omega);
+        const VF ones = Set(df, 1.f);
+        const VF zeros = Zero(df);
+        const VF max255 = Set(df, 255.f);
+        const int lanes = Lanes(df);
+
+        auto recover = [&](VF color, VF t) {
+            return Floor(Min(Max(Add(Div(Sub(color, light), t), light), zeros), max255));
+        };
+
+        int x = 0;
+        for (; x + lanes <= width; x += lanes) {
+            const VF vr = LoadU(df, r + x);
+            const VF vg = LoadU(df, g + x);
+            const VF vb = LoadU(df, b + x);
+            const VF darkValue = ConvertTo(df, PromoteTo(du32, LoadU(du8, dark + x)));
+            const VF t0 = Sub(ones, Mul(vOmega, Div(Min(Min(vr, vg), vb), light)));
+            const VF t = Max(Sub(ones, Mul(vOmega, Div(darkValue, light))), t0);
+            StoreU(recover(vr, t), df, r + x);
+            StoreU(recover(vg, t), df, g + x);
+            StoreU(recover(vb, t), df, b + x);
+        }
+
+        for (; x < width; ++x) {
+            const float t0 = 1.f - omega * (std::min({r[x], g[x], b[x]}) / atmosphereLight);
+            const float t = std::max(1.f - omega * (float(dark[x]) / atmosphereLight), t0);
+            r[x] = std::floor(std::clamp((r[x] - atmosphereLight) / t + atmosphereLight, 0.f, 255.f));
+            g[x] = std::floor(std::clamp((g[x] - atmosphereLight) / t + atmosphereLight, 0.f, 255.f));
+            b[x] = std::floor(std::clamp((b[x] - atmosphereLight) / t + atmosphereLight, 0.f, 255.f));
         }
     }
 
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    using namespace std;
+
+    HWY_EXPORT(getDarkChannelHWY);
+    HWY_EXPORT(transmissionRowHWY);
+
+    void
+    getDarkChannel(const uint8_t *pSrc, std::vector<uint8_t> &tmpVec, const int stride, const int width, const int height, int radius) {
+        HWY_DYNAMIC_DISPATCH(getDarkChannelHWY)(pSrc, tmpVec.data(), stride, width, height, radius);
+    }
+
     void getTransmission(uint8_t *pSrc, std::vector<uint8_t> &tmp_vec, float mAtmosLight,
                          const int stride, const int width, const int height, float omega) {
-        for (int y = 0; y < height; y++) {
-            uint8_t *dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(pSrc) + stride * y);
-            const uint8_t *darkImage = reinterpret_cast<const uint8_t *>(reinterpret_cast<const uint8_t *>(tmp_vec.data()) + width * y);
-            for (int x = 0; x < width; x++) {
-                int pos = x * 4;
-                float r = dst[pos + 0], g = dst[pos + 1], b = dst[pos + 2];
-                float minColor = std::min({r, g, b});
-                float t0 = 1.0 - omega * (float(minColor) / float(mAtmosLight));
-                float t = std::max(1.0f - omega * (float(darkImage[x]) / float(mAtmosLight)), t0);
-
-                Eigen::Vector3f color = {r, g, b};
-                color = ((color.array() - mAtmosLight) / t + mAtmosLight).max(0.f).min(255.f);
-                Eigen::Vector3i dest = color.cast<int>();
-
-                dst[pos + 0] = dest.x();
-                dst[pos + 1] = dest.y();
-                dst[pos + 2] = dest.z();
-            }
-        }
+        // Recovery runs on float planes, values are floored there so interleaving matches truncation
+        PlanarImage<float> planes(width, height, 3);
+        deinterleave(pSrc, stride, planes);
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                          height * width / (256 * 256)), 1, 12);
+        concurrency::parallel_for(threadCount, height, [&](int y) {
+            HWY_DYNAMIC_DISPATCH(transmissionRowHWY)(planes.row(0, y), planes.row(1, y), planes.row(2, y),
+                                                     tmp_vec.data() + y * width, width, mAtmosLight, omega);
+        });
+        interleave(planes, pSrc, stride);
     }
 
     float getAtmosphericLightEstimate(std::vector<uint8_t> &darkImage, int width, int height) {
@@ -144,4 +227,5 @@ namespace aire {
         getTransmission(src, darkImage, atmosphereLight, stride, width, height, omega);
     }
 
-}
\ No newline at end of file
+}
+#endif
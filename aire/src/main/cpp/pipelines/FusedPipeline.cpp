@@ -0,0 +1,543 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "pipelines/FusedPipeline.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
+#include "FusedPipeline.h"
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include "color/eotf-inl.h"
+#include "color/tone/LogarithmicToneMapper.hpp"
+#include "color/tone/AcesFilmicToneMapper.hpp"
+#include "color/tone/ExposureToneMapper.hpp"
+#include "color/tone/HejlBurgessToneMapper.hpp"
+#include "color/tone/HableFilmicToneMapper.hpp"
+#include "color/tone/UchimuraToneMapper.hpp"
+#include "color/tone/AldridgeToneMapper.hpp"
+#include "color/tone/DragoToneMapper.hpp"
+#include "color/tone/MobiusToneMapper.hpp"
+#include "base/Convolve2D.h"
+#include "MathUtils.hpp"
+#include "concurrency.hpp"
+#include "base/ScratchArena.h"
+#include "AireError.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
+    using namespace std;
+    using namespace hwy;
+    using namespace hwy::HWY_NAMESPACE;
+
+    using DF4 = FixedTag<float32_t, 4>;
+    using VF4 = Vec<DF4>;
+
+    static constexpr int kCurveSize = 4096;
+
+    class AdjustmentStage : public FusedStage {
+    public:
+        AdjustmentStage(const float gain, const float bias) : gain(gain), bias(bias) {}
+
+        void execute(float *r, float *g, float *b, int count) override {
+            const DF4 df;
+            const VF4 vGain = Set(df, gain);
+            const VF4 vShift = Set(df, 0.5f - 0.5f * gain + bias);
+            const VF4 zeros = Zero(df);
+            const VF4 ones = Set(df, 1.f);
+            for (int x = 0; x < count; x += 4) {
+                StoreU(Clamp(MulAdd(LoadU(df, r + x), vGain, vShift), zeros, ones), df, r + x);
+                StoreU(Clamp(MulAdd(LoadU(df, g + x), vGain, vShift), zeros, ones), df, g + x);
+                StoreU(Clamp(MulAdd(LoadU(df, b + x), vGain, vShift), zeros, ones), df, b + x);
+            }
+        }
+
+    private:
+        const float gain;
+        const float bias;
+    };
+
+    /**
+     * Arbitrary channel curve sampled into a table and linearly interpolated
+     */
+    class CurveStage : public FusedStage {
+    public:
+        template<typename F>
+        explicit CurveStage(F curve) : table(kCurveSize + 2) {
+            for (int i = 0; i <= kCurveSize; ++i) {
+                table[i] = std::clamp(curve(static_cast<float>(i) / static_cast<float>(kCurveSize)), 0.f, 1.f);
+            }
+            table[kCurveSize + 1] = table[kCurveSize];
+        }
+
+        void execute(float *r, float *g, float *b, int count) override {
+            for (int x = 0; x < count; x += 4) {
+                map(r + x);
+                map(g + x);
+                map(b + x);
+            }
+        }
+
+    private:
+        HWY_INLINE void map(float *v) {
+            const DF4 df;
+            const RebindToSigned<DF4> di;
+            const VF4 position = Mul(Clamp(LoadU(df, v), Zero(df), Set(df, 1.f)), Set(df, static_cast<float>(kCurveSize)));
+            const VF4 floored = Floor(position);
+            const auto index = ConvertTo(di, floored);
+            const VF4 lower = GatherIndex(df, table.data(), index);
+            const VF4 upper = GatherIndex(df, table.data(), Add(index, Set(di, 1)));
+            StoreU(MulAdd(Sub(upper, lower), Sub(position, floored), lower), df, v);
+        }
+
+        std::vector<float> table;
+    };
+
+    class VibranceStage : public FusedStage {
+    public:
+        explicit VibranceStage(const float vibrance) : vibrance(vibrance) {}
+
+        void execute(float *r, float *g, float *b, int count) override {
+            const DF4 df;
+            const VF4 vVibrance = Set(df, vibrance);
+            const VF4 vThird = Set(df, 1.f / 3.f);
+            const VF4 zeros = Zero(df);
+            const VF4 ones = Set(df, 1.f);
+            const VF4 minusOnes = Set(df, -1.f);
+            for (int x = 0; x < count; x += 4) {
+                const VF4 vr = LoadU(df, r + x);
+                const VF4 vg = LoadU(df, g + x);
+                const VF4 vb = LoadU(df, b + x);
+                const VF4 avg = Mul(Add(Add(vr, vg), vb), vThird);
+                const VF4 mx = Max(Max(vr, vg), vb);
+                const VF4 boost = Clamp(Mul(Sub(mx, avg), vVibrance), minusOnes, ones);
+                StoreU(Clamp(Add(vr, boost), zeros, ones), df, r + x);
+                StoreU(Clamp(Add(vg, boost), zeros, ones), df, g + x);
+                StoreU(Clamp(Add(vb, boost), zeros, ones), df, b + x);
+            }
+        }
+
+    private:
+        const float vibrance;
+    };
+
+    class MatrixStage : public FusedStage {
+    public:
+        explicit MatrixStage(const Eigen::Matrix3f &matrix) : matrix(matrix) {}
+
+        void execute(float *r, float *g, float *b, int count) override {
+            const DF4 df;
+            VF4 m[9];
+            for (int i = 0; i < 9; ++i) {
+                m[i] = Set(df, matrix(i / 3, i % 3));
+            }
+            const VF4 zeros = Zero(df);
+            const VF4 ones = Set(df, 1.f);
+            for (int x = 0; x < count; x += 4) {
+                const VF4 vr = LoadU(df, r + x);
+                const VF4 vg = LoadU(df, g + x);
+                const VF4 vb = LoadU(df, b + x);
+                StoreU(Clamp(MulAdd(m[2], vb, MulAdd(m[1], vg, Mul(m[0], vr))), zeros, ones), df, r + x);
+                StoreU(Clamp(MulAdd(m[5], vb, MulAdd(m[4], vg, Mul(m[3], vr))), zeros, ones), df, g + x);
+                StoreU(Clamp(MulAdd(m[8], vb, MulAdd(m[7], vg, Mul(m[6], vr))), zeros, ones), df, b + x);
+            }
+        }
+
+    private:
+        const Eigen::Matrix3f matrix;
+    };
+
+    class GrayscaleStage : public FusedStage {
+    public:
+        GrayscaleStage(const float rPrimary, const float gPrimary, const float bPrimary)
+                : rPrimary(rPrimary), gPrimary(gPrimary), bPrimary(bPrimary) {}
+
+        void execute(float *r, float *g, float *b, int count) override {
+            const DF4 df;
+            const VF4 vR = Set(df, rPrimary);
+            const VF4 vG = Set(df, gPrimary);
+            const VF4 vB = Set(df, bPrimary);
+            const VF4 zeros = Zero(df);
+            const VF4 ones = Set(df, 1.f);
+            for (int x = 0; x < count; x += 4) {
+                const VF4 vr = aire::HWY_NAMESPACE::SRGBToLinear(df, LoadU(df, r + x));
+                const VF4 vg = aire::HWY_NAMESPACE::SRGBToLinear(df, LoadU(df, g + x));
+                const VF4 vb = aire::HWY_NAMESPACE::SRGBToLinear(df, LoadU(df, b + x));
+                const VF4 gray = Clamp(MulAdd(vb, vB, MulAdd(vg, vG, Mul(vr, vR))), zeros, ones);
+                StoreU(gray, df, r + x);
+                StoreU(gray, df, g + x);
+                StoreU(gray, df, b + x);
+            }
+        }
+
+    private:
+        const float rPrimary;
+        const float gPrimary;
+        const float bPrimary;
+    };
+
+    class ToneStage : public FusedStage {
+    public:
+        explicit ToneStage(ToneMapper<DF4> *toneMapper) : toneMapper(toneMapper) {}
+
+        void execute(float *r, float *g, float *b, int count) override {
+            const DF4 df;
+            const VF4 zeros = Zero(df);
+            const VF4 ones = Set(df, 1.f);
+            for (int x = 0; x < count; x += 4) {
+                VF4 vr = aire::HWY_NAMESPACE::SRGBToLinear(df, LoadU(df, r + x));
+                VF4 vg = aire::HWY_NAMESPACE::SRGBToLinear(df, LoadU(df, g + x));
+                VF4 vb = aire::HWY_NAMESPACE::SRGBToLinear(df, LoadU(df, b + x));
+                toneMapper->Execute(vr, vg, vb);
+                StoreU(Clamp(aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, vr), zeros, ones), df, r + x);
+                StoreU(Clamp(aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, vg), zeros, ones), df, g + x);
+                StoreU(Clamp(aire::HWY_NAMESPACE::LinearSRGBTosRGB(df, vb), zeros, ones), df, b + x);
+            }
+        }
+
+    private:
+        std::unique_ptr<ToneMapper<DF4>> toneMapper;
+    };
+
+    FusedStage *createFusedStageHWY(const int op, const float *args) {
+        const float lumaCoeffs[3] = {0.299f, 0.587f, 0.114f};
+        switch (op) {
+            case FUSED_BRIGHTNESS:
+                return new AdjustmentStage(1.f, args[0]);
+            case FUSED_CONTRAST:
+                return new AdjustmentStage(args[0], 0.f);
+            case FUSED_GAMMA: {
+                const float gamma = args[0];
+                return new CurveStage([gamma](float v) {
+                    return std::powf(v * 255.f, gamma) / 255.f;
+                });
+            }
+            case FUSED_VIBRANCE:
+                return new VibranceStage(args[0]);
+            case FUSED_COLOR_MATRIX: {
+                Eigen::Matrix3f matrix;
+                for (int i = 0; i < 9; ++i) {
+                    matrix(i / 3, i % 3) = args[i];
+                }
+                return new MatrixStage(matrix);
+            }
+            case FUSED_GRAYSCALE:
+                return new GrayscaleStage(args[0], args[1], args[2]);
+            case FUSED_EXPOSURE:
+                return new ToneStage(new ExposureToneMapper<DF4>(args[0]));
+            case FUSED_LOGARITHMIC:
+                return new ToneStage(new LogarithmicToneMapper<DF4>(lumaCoeffs, args[0]));
+            case FUSED_ACES_FILMIC:
+                return new ToneStage(new AcesFilmicToneMapper<DF4>(args[0]));
+            case FUSED_HEJL_BURGESS:
+                return new ToneStage(new HejlBurgessToneMapper<DF4>(args[0]));
+            case FUSED_HABLE_FILMIC:
+                return new ToneStage(new HableFilmicToneMapper<DF4>(args[0]));
+            case FUSED_UCHIMURA:
+                return new ToneStage(new UchimuraToneMapper<DF4>(args[0]));
+            case FUSED_ALDRIDGE:
+                return new ToneStage(new AldridgeToneMapper<DF4>(args[0], args[1]));
+            case FUSED_DRAGO:
+                return new ToneStage(new DragoToneMapper<DF4>(lumaCoeffs, args[0], args[1]));
+            case FUSED_MOBIUS:
+                return new ToneStage(new MobiusToneMapper<DF4>(args[0], args[1], args[2]));
+            default: {
+                std::string msg("Unknown fused operation " + std::to_string(op));
+                throw AireError(msg);
+            }
+        }
+    }
+
+    void applyFusedPointsHWY(const std::vector<std::unique_ptr<FusedStage>> &points, uint8_t *row, int count, float *planes) {
+        if (points.empty()) {
+            return;
+        }
+        const FixedTag<uint8_t, 4> du;
+        using VU = Vec<decltype(du)>;
+        const DF4 df;
+        const VF4 vScale = Set(df, 255.f);
+        const VF4 vRevertScale = Set(df, 1.f / 255.f);
+        const VF4 vHalf = Set(df, 0.5f);
+        const VF4 zeros = Zero(df);
+
+        float *r = planes;
+        float *g = planes + kFusedChunk;
+        float *b = planes + kFusedChunk * 2;
+
+        for (int start = 0; start < count; start += kFusedChunk) {
+            const int length = std::min(kFusedChunk, count - start);
+            const int padded = (length + 3) & ~3;
+            uint8_t *pixels = row + start * 4;
+
+            int x = 0;
+            for (; x + 4 <= length; x += 4) {
+                VU ru, gu, bu, au;
+                LoadInterleaved4(du, pixels + x * 4, ru, gu, bu, au);
+                StoreU(Mul(PromoteTo(df, ru), vRevertScale), df, r + x);
+                StoreU(Mul(PromoteTo(df, gu), vRevertScale), df, g + x);
+                StoreU(Mul(PromoteTo(df, bu), vRevertScale), df, b + x);
+            }
+            for (; x < padded; ++x) {
+                const bool inside = x < length;
+                r[x] = inside ? static_cast<float>(pixels[x * 4]) / 255.f : 0.f;
+                g[x] = inside ? static_cast<float>(pixels[x * 4 + 1]) / 255.f : 0.f;
+                b[x] = inside ? static_cast<float>(pixels[x * 4 + 2]) / 255.f : 0.f;
+            }
+
+            for (const auto &stage: points) {
+                stage->execute(r, g, b, padded);
+            }
+
+            x = 0;
+            for (; x + 4 <= length; x += 4) {
+                VU ru, gu, bu, au;
+                LoadInterleaved4(du, pixels + x * 4, ru, gu, bu, au);
+                ru = DemoteTo(du, ConvertTo(RebindToSigned<DF4>(),
+                                            Clamp(MulAdd(LoadU(df, r + x), vScale, vHalf), zeros, vScale)));
+                gu = DemoteTo(du, ConvertTo(RebindToSigned<DF4>(),
+                                            Clamp(MulAdd(LoadU(df, g + x), vScale, vHalf), zeros, vScale)));
+                bu = DemoteTo(du, ConvertTo(RebindToSigned<DF4>(),
+                                            Clamp(MulAdd(LoadU(df, b + x), vScale, vHalf), zeros, vScale)));
+                StoreInterleaved4(ru, gu, bu, au, du, pixels + x * 4);
+            }
+            for (; x < length; ++x) {
+                pixels[x * 4] = static_cast<uint8_t>(std::clamp(r[x] * 255.f + 0.5f, 0.f, 255.f));
+                pixels[x * 4 + 1] = static_cast<uint8_t>(std::clamp(g[x] * 255.f + 0.5f, 0.f, 255.f));
+                pixels[x * 4 + 2] = static_cast<uint8_t>(std::clamp(b[x] * 255.f + 0.5f, 0.f, 255.f));
+            }
+        }
+    }
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    using namespace std;
+
+    HWY_EXPORT(createFusedStageHWY);
+    HWY_EXPORT(applyFusedPointsHWY);
+
+    static FusedStage *createFusedStage(const int op, const std::vector<float> &args) {
+        return HWY_DYNAMIC_DISPATCH(createFusedStageHWY)(op, args.data());
+    }
+
+    FusedPipeline::FusedPipeline(const std::vector<int> &ops, const std::vector<float> &params) {
+        size_t cursor = 0;
+        auto next = [&]() -> float {
+            if (cursor >= params.size()) {
+                std::string msg("Fused pipeline parameters are exhausted at " + std::to_string(cursor));
+                throw AireError(msg);
+            }
+            return params[cursor++];
+        };
+
+        auto consume = [&](const int count) {
+            std::vector<float> args(count);
+            for (float &arg: args) {
+                arg = next();
+            }
+            return args;
+        };
+
+        segments.emplace_back();
+        for (const int op: ops) {
+            auto &points = segments.back().points;
+            switch (op) {
+                case FUSED_BRIGHTNESS:
+                case FUSED_CONTRAST:
+                case FUSED_GAMMA:
+                case FUSED_VIBRANCE:
+                case FUSED_EXPOSURE:
+                case FUSED_LOGARITHMIC:
+                case FUSED_ACES_FILMIC:
+                case FUSED_HEJL_BURGESS:
+                case FUSED_HABLE_FILMIC:
+                case FUSED_UCHIMURA:
+                    points.emplace_back(createFusedStage(op, consume(1)));
+                    break;
+                case FUSED_ALDRIDGE:
+                case FUSED_DRAGO:
+                    points.emplace_back(createFusedStage(op, consume(2)));
+                    break;
+                case FUSED_GRAYSCALE:
+                case FUSED_MOBIUS:
+                    points.emplace_back(createFusedStage(op, consume(3)));
+                    break;
+                case FUSED_COLOR_MATRIX:
+                    points.emplace_back(createFusedStage(op, consume(9)));
+                    break;
+                case FUSED_GAUSSIAN_BLUR: {
+                    const int size = static_cast<int>(next());
+                    float sigma = next();
+                    if (size < 1) {
+                        std::string msg("Gaussian kernel size must be positive but received " + std::to_string(size));
+                        throw AireError(msg);
+                    }
+                    if (sigma <= 0.f) {
+                        sigma = 0.3f * ((static_cast<float>(size) - 1.f) * 0.5f - 1.f) + 0.8f;
+                    }
+                    const auto gaussian = compute1DGaussianKernel(size, sigma);
+                    const Eigen::Map<const Eigen::VectorXf> vector(gaussian.data(), size);
+                    segments.back().kernel = vector * vector.transpose();
+                    segments.back().hasKernel = true;
+                    segments.emplace_back();
+                }
+                    break;
+                case FUSED_CONVOLVE_2D: {
+                    const int kernelWidth = static_cast<int>(next());
+                    const int kernelHeight = static_cast<int>(next());
+                    if (kernelWidth < 1 || kernelHeight < 1) {
+                        std::string msg("Kernel must have positive size but received " + std::to_string(kernelWidth)
+                                        + "x" + std::to_string(kernelHeight));
+                        throw AireError(msg);
+                    }
+                    Eigen::MatrixXf kernel(kernelHeight, kernelWidth);
+                    for (int j = 0; j < kernelHeight; ++j) {
+                        for (int i = 0; i < kernelWidth; ++i) {
+                            kernel(j, i) = next();
+                        }
+                    }
+                    segments.back().kernel = kernel;
+                    segments.back().hasKernel = true;
+                    segments.emplace_back();
+                }
+                    break;
+                default: {
+                    std::string msg("Unknown fused operation " + std::to_string(op));
+                    throw AireError(msg);
+                }
+            }
+        }
+
+        for (auto &segment: segments) {
+            if (segment.hasKernel) {
+                segment.plan = planConvolve2D(segment.kernel);
+                haloX += static_cast<int>(segment.kernel.cols()) / 2;
+                haloY += static_cast<int>(segment.kernel.rows()) / 2;
+            }
+        }
+    }
+
+    void FusedPipeline::applyPoints(const Segment &segment, uint8_t *row, int count, float *planes) {
+        HWY_DYNAMIC_DISPATCH(applyFusedPointsHWY)(segment.points, row, count, planes);
+    }
+
+    size_t FusedPipeline::workingMemory(int width, int height) const {
+        const size_t threadCount = clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 12);
+        const size_t planes = threadCount * kFusedChunk * 3 * sizeof(float);
+        if (segments.size() == 1) {
+            return planes;
+        }
+        const int regionWidth = std::min(kFusedTile + 2 * haloX, width);
+        const int regionHeight = std::min(kFusedTile + 2 * haloY, height);
+        size_t convolution = 0;
+        for (const auto &segment: segments) {
+            if (segment.hasKernel) {
+                convolution = std::max(convolution, convolve2DWorkingMemory(segment.plan, regionWidth, regionHeight, 1));
+            }
+        }
+        const size_t region = static_cast<size_t>(regionWidth) * regionHeight * 4;
+        return planes + threadCount * (region + convolution) + static_cast<size_t>(width) * 4 * height;
+    }
+
+    void FusedPipeline::apply(uint8_t *data, int stride, int width, int height) {
+        if (segments.size() == 1) {
+            const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()),
+                                              height * width / (256 * 256)), 1, 12);
+            concurrency::parallel_for_segment(threadCount, height, [&](int start, int end) {
+                std::vector<float> planes(kFusedChunk * 3);
+                for (int y = start; y < end; ++y) {
+                    applyPoints(segments.front(), data + y * stride, width, planes.data());
+                }
+            });
+            return;
+        }
+
+        const int tilesX = (width + kFusedTile - 1) / kFusedTile;
+        const int tilesY = (height + kFusedTile - 1) / kFusedTile;
+        const int tilesCount = tilesX * tilesY;
+        const int threadCount = clamp(min(static_cast<int>(std::thread::hardware_concurrency()), tilesCount), 1, 12);
+
+        ScratchLease output = acquireScratch(stride * height);
+
+        concurrency::parallel_for_with_thread_id(threadCount, tilesCount, [&](int threadId, int tile) {
+            // Tiles already occupy every worker, nested loops of the convolution would oversubscribe them
+            concurrency::ScopedThreadsLimit serial(1);
+            std::vector<float> planes(kFusedChunk * 3);
+
+            const int tileX = (tile % tilesX) * kFusedTile;
+            const int tileY = (tile / tilesX) * kFusedTile;
+            const int tileWidth = std::min(kFusedTile, width - tileX);
+            const int tileHeight = std::min(kFusedTile, height - tileY);
+
+            const int regionX = std::max(tileX - haloX, 0);
+            const int regionY = std::max(tileY - haloY, 0);
+            const int regionWidth = std::min(tileX + tileWidth + haloX, width) - regionX;
+            const int regionHeight = std::min(tileY + tileHeight + haloY, height) - regionY;
+            const int regionStride = regionWidth * 4;
+
+            std::vector<uint8_t> region(regionStride * regionHeight);
+            for (int y = 0; y < regionHeight; ++y) {
+                std::memcpy(region.data() + y * regionStride,
+                            data + (regionY + y) * stride + regionX * 4, regionStride);
+            }
+
+            const int lastSegment = static_cast<int>(segments.size()) - 1;
+            for (int s = 0; s < lastSegment; ++s) {
+                for (int y = 0; y < regionHeight; ++y) {
+                    applyPoints(segments[s], region.data() + y * regionStride, regionWidth, planes.data());
+                }
+                convolve2D(region.data(), regionStride, regionWidth, regionHeight, segments[s].plan);
+            }
+
+            const int offsetX = tileX - regionX;
+            const int offsetY = tileY - regionY;
+            for (int y = 0; y < tileHeight; ++y) {
+                uint8_t *src = region.data() + (offsetY + y) * regionStride + offsetX * 4;
+                applyPoints(segments[lastSegment], src, tileWidth, planes.data());
+                std::memcpy(output.data() + (tileY + y) * stride + tileX * 4, src, tileWidth * 4);
+            }
+        });
+
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(data + y * stride, output.data() + y * stride, width * 4);
+        }
+    }
+}
+#endif
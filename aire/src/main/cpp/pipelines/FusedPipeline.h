@@ -0,0 +1,118 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include "Eigen/Eigen"
+#include "base/Convolve2D.h"
+
+namespace aire {
+
+    enum FusedOp {
+        FUSED_BRIGHTNESS = 0,
+        FUSED_CONTRAST = 1,
+        FUSED_GAMMA = 2,
+        FUSED_VIBRANCE = 3,
+        FUSED_COLOR_MATRIX = 4,
+        FUSED_GRAYSCALE = 5,
+        FUSED_EXPOSURE = 6,
+        FUSED_LOGARITHMIC = 7,
+        FUSED_ACES_FILMIC = 8,
+        FUSED_HEJL_BURGESS = 9,
+        FUSED_HABLE_FILMIC = 10,
+        FUSED_UCHIMURA = 11,
+        FUSED_ALDRIDGE = 12,
+        FUSED_DRAGO = 13,
+        FUSED_MOBIUS = 14,
+        FUSED_GAUSSIAN_BLUR = 15,
+        FUSED_CONVOLVE_2D = 16,
+    };
+
+    static constexpr int kFusedChunk = 256;
+    static constexpr int kFusedTile = 256;
+
+    /**
+     * Per pixel operation over planar sRGB rows in [0, 1], count is always a multiple of 4
+     */
+    class FusedStage {
+    public:
+        virtual void execute(float *r, float *g, float *b, int count) = 0;
+
+        virtual ~FusedStage() = default;
+    };
+
+    /**
+     * Chain of operations executed over RGBA8888 image in a minimal number of passes.
+     * Consecutive per pixel ops are fused into one pass, neighbourhood ops are barriers
+     * and executed per tile with a halo wide enough for the whole chain. Tiles run in parallel
+     * and the convolution inside each tile is single threaded
+     */
+    class FusedPipeline {
+    public:
+        /**
+         * @param ops - sequence of FusedOp
+         * @param params - parameters of each op, consumed in order
+         */
+        FusedPipeline(const std::vector<int> &ops, const std::vector<float> &params);
+
+        void apply(uint8_t *data, int stride, int width, int height);
+
+        /**
+         * Rows above and below the output that affect it
+         */
+        int verticalHalo() const {
+            return haloY;
+        }
+
+        /**
+         * Upper bound of temporary memory apply takes over RGBA8888 image of the given size,
+         * scratch of the barrier convolutions included
+         */
+        size_t workingMemory(int width, int height) const;
+
+    private:
+        struct Segment {
+            std::vector<std::unique_ptr<FusedStage>> points;
+            Eigen::MatrixXf kernel;
+            // Analysed once when the chain is built, tiles only execute it
+            Convolve2DPlan plan;
+            bool hasKernel = false;
+        };
+
+        void applyPoints(const Segment &segment, uint8_t *row, int count, float *planes);
+
+        std::vector<Segment> segments;
+        int haloX = 0;
+        int haloY = 0;
+    };
+}
@@ -31,12 +31,13 @@
 #include "RemoveShadows.h"
 #include "base/Grayscale.h"
 #include "base/Threshold.h"
-#include "base/Channels.h"
+#include "base/PlanarImage.h"
 #include "base/Dilation.h"
 #include "blur/MedianBlur.h"
 #include <algorithm>
 #include "base/Arithmetics.h"
 #include <thread>
+#include "concurrency.hpp"
 #include "MathUtils.hpp"
 #include "EigenUtils.h"
 
@@ -58,21 +59,14 @@ namespace aire {
     }
 
     void removeShadows(uint8_t *src, int stride, int width, int height, int kernelSize) {
-        std::vector<uint8_t> rChan(width * height);
-        std::vector<uint8_t> gChan(width * height);
-        std::vector<uint8_t> bChan(width * height);
-        std::vector<uint8_t> aChan(width * height);
+        // Converted once at entry and exit, alpha stays in place
+        PlanarImage<uint8_t> planes(width, height, 3);
+        deinterleave(src, stride, planes);
 
-        split(src,
-              rChan.data(), gChan.data(), bChan.data(), aChan.data(),
-              stride, width, height);
+        concurrency::parallel_for(3, 3, [&](int channel) {
+            removeProcessChannel(planes.plane(channel), width, height, kernelSize);
+        });
 
-        removeProcessChannel(rChan.data(), width, height, kernelSize);
-
-        removeProcessChannel(gChan.data(), width, height, kernelSize);
-
-        removeProcessChannel(bChan.data(), width, height, kernelSize);
-
-        merge(src, rChan.data(), gChan.data(), bChan.data(), aChan.data(), stride, width, height);
+        interleave(planes, src, stride);
     }
-}
\ No newline at end of file
+}
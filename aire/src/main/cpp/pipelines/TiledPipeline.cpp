@@ -0,0 +1,188 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#include "TiledPipeline.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include "base/ScratchArena.h"
+#include "AireError.h"
+
+namespace aire {
+
+    using namespace std;
+
+    MappedSource::MappedSource(MappedImage &image) : image(image) {
+        width = image.width;
+        height = image.height;
+    }
+
+    void MappedSource::read(int y, int count, uint8_t *dst, int dstStride) {
+        for (int j = 0; j < count; ++j) {
+            std::memcpy(dst + j * dstStride, image.row(y + j), width * 4);
+        }
+    }
+
+    void MappedSource::consumed(int y) {
+        if (y > released) {
+            image.release(released, y);
+            released = y;
+        }
+    }
+
+    void MappedSink::write(int y, int count, const uint8_t *src, int srcStride) {
+        for (int j = 0; j < count; ++j) {
+            std::memcpy(image.row(y + j), src + j * srcStride, image.width * 4);
+        }
+        image.release(y, y + count);
+    }
+
+    RowProviderSource::RowProviderSource(int width, int height, std::function<void(int, uint8_t *)> provider)
+            : provider(std::move(provider)) {
+        this->width = width;
+        this->height = height;
+    }
+
+    void RowProviderSource::read(int y, int count, uint8_t *dst, int dstStride) {
+        for (int j = 0; j < count; ++j) {
+            provider(y + j, dst + j * dstStride);
+        }
+    }
+
+    void RowConsumerSink::write(int y, int count, const uint8_t *src, int srcStride) {
+        for (int j = 0; j < count; ++j) {
+            consumer(y + j, src + j * srcStride);
+        }
+    }
+
+    PNGStreamSink::PNGStreamSink(const std::string &path, int width, int height, int compressionLevel)
+            : width(width) {
+        file = fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            std::string msg("Cannot create " + path);
+            throw AireError(msg);
+        }
+        ctx = spng_ctx_new(SPNG_CTX_ENCODER);
+        spng_set_png_file(ctx, file);
+        spng_set_option(ctx, SPNG_IMG_COMPRESSION_LEVEL, compressionLevel);
+
+        struct spng_ihdr ihdr = {0};
+        ihdr.width = width;
+        ihdr.height = height;
+        ihdr.color_type = SPNG_COLOR_TYPE_TRUECOLOR_ALPHA;
+        ihdr.bit_depth = 8;
+        spng_set_ihdr(ctx, &ihdr);
+
+        const int ret = spng_encode_image(ctx, nullptr, 0, SPNG_FMT_PNG,
+                                          SPNG_ENCODE_PROGRESSIVE | SPNG_ENCODE_FINALIZE);
+        if (ret) {
+            spng_ctx_free(ctx);
+            fclose(file);
+            std::string msg("Cannot start PNG stream with error: " + std::to_string(ret));
+            throw AireError(msg);
+        }
+    }
+
+    void PNGStreamSink::write(int y, int count, const uint8_t *src, int srcStride) {
+        for (int j = 0; j < count; ++j) {
+            const int ret = spng_encode_row(ctx, src + j * srcStride, width * 4);
+            // Last row finalizes the stream and reports the end of image
+            if (ret != SPNG_OK && ret != SPNG_EOI) {
+                std::string msg("Cannot encode row " + std::to_string(y + j) + " with error: " + std::to_string(ret));
+                throw AireError(msg);
+            }
+        }
+    }
+
+    void PNGStreamSink::finish() {
+        if (fflush(file) != 0) {
+            std::string msg("Cannot flush PNG stream");
+            throw AireError(msg);
+        }
+    }
+
+    PNGStreamSink::~PNGStreamSink() {
+        spng_ctx_free(ctx);
+        fclose(file);
+    }
+
+    int TiledPipeline::bandHeight(int width, int height) const {
+        const size_t stride = static_cast<size_t>(width) * 4;
+        const int halo = pipeline.verticalHalo();
+        auto cost = [&](const int rows) {
+            const int loaded = std::min(rows + 2 * halo, height);
+            return stride * loaded + pipeline.workingMemory(width, loaded);
+        };
+        if (cost(1) > memoryBudget) {
+            std::string msg("Memory budget " + std::to_string(memoryBudget) + " is too small for "
+                            + std::to_string(width) + " pixels wide image, at least "
+                            + std::to_string(cost(1)) + " is required");
+            throw AireError(msg);
+        }
+        int low = 1;
+        int high = height;
+        while (low < high) {
+            const int mid = low + (high - low + 1) / 2;
+            if (cost(mid) <= memoryBudget) {
+                low = mid;
+            } else {
+                high = mid - 1;
+            }
+        }
+        // Even bands, so every band reuses the same scratch buffers
+        const int bands = (height + low - 1) / low;
+        return (height + bands - 1) / bands;
+    }
+
+    void TiledPipeline::run(TiledSource &source, TiledSink &sink) {
+        const int width = source.width;
+        const int height = source.height;
+        if (width <= 0 || height <= 0) {
+            std::string msg("Tiled source must have positive size but received "
+                            + std::to_string(width) + "x" + std::to_string(height));
+            throw AireError(msg);
+        }
+        const int rows = bandHeight(width, height);
+        const int halo = pipeline.verticalHalo();
+        const int stride = width * 4;
+
+        ScratchLease band = acquireScratch(static_cast<size_t>(stride) * std::min(rows + 2 * halo, height));
+        for (int y = 0; y < height; y += rows) {
+            const int count = std::min(rows, height - y);
+            const int top = std::max(y - halo, 0);
+            const int bottom = std::min(y + count + halo, height);
+            source.read(top, bottom - top, band.data(), stride);
+            source.consumed(std::min(y + count - halo, height));
+            pipeline.apply(band.data(), stride, width, bottom - top);
+            sink.write(y, count, band.data() + (y - top) * stride, stride);
+        }
+        sink.finish();
+    }
+}
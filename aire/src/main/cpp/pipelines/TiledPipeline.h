@@ -0,0 +1,166 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 19/10/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include "FusedPipeline.h"
+#include "base/MappedImage.h"
+#include "spng/spng.h"
+
+namespace aire {
+
+    /**
+     * Sequential supplier of RGBA8888 rows, rows are requested in increasing order of band start
+     * but bands overlap by the halo of the pipeline
+     */
+    class TiledSource {
+    public:
+        virtual void read(int y, int count, uint8_t *dst, int dstStride) = 0;
+
+        /**
+         * Rows above `y` will never be requested again
+         */
+        virtual void consumed(int y) {}
+
+        virtual ~TiledSource() = default;
+
+        int width = 0;
+        int height = 0;
+    };
+
+    /**
+     * Receives processed rows exactly once and top to bottom
+     */
+    class TiledSink {
+    public:
+        virtual void write(int y, int count, const uint8_t *src, int srcStride) = 0;
+
+        virtual void finish() {}
+
+        virtual ~TiledSink() = default;
+    };
+
+    class MappedSource : public TiledSource {
+    public:
+        explicit MappedSource(MappedImage &image);
+
+        void read(int y, int count, uint8_t *dst, int dstStride) override;
+
+        void consumed(int y) override;
+
+    private:
+        MappedImage &image;
+        int released = 0;
+    };
+
+    class MappedSink : public TiledSink {
+    public:
+        explicit MappedSink(MappedImage &image) : image(image) {}
+
+        void write(int y, int count, const uint8_t *src, int srcStride) override;
+
+    private:
+        MappedImage &image;
+    };
+
+    /**
+     * Rows pulled from the caller, provider fills `width` pixels of row `y`
+     */
+    class RowProviderSource : public TiledSource {
+    public:
+        RowProviderSource(int width, int height, std::function<void(int, uint8_t *)> provider);
+
+        void read(int y, int count, uint8_t *dst, int dstStride) override;
+
+    private:
+        std::function<void(int, uint8_t *)> provider;
+    };
+
+    class RowConsumerSink : public TiledSink {
+    public:
+        explicit RowConsumerSink(std::function<void(int, const uint8_t *)> consumer) : consumer(std::move(consumer)) {}
+
+        void write(int y, int count, const uint8_t *src, int srcStride) override;
+
+    private:
+        std::function<void(int, const uint8_t *)> consumer;
+    };
+
+    /**
+     * PNG written row by row straight to a file, only the deflate window is held in memory
+     */
+    class PNGStreamSink : public TiledSink {
+    public:
+        PNGStreamSink(const std::string &path, int width, int height, int compressionLevel);
+
+        PNGStreamSink(const PNGStreamSink &) = delete;
+
+        PNGStreamSink &operator=(const PNGStreamSink &) = delete;
+
+        ~PNGStreamSink() override;
+
+        void write(int y, int count, const uint8_t *src, int srcStride) override;
+
+        void finish() override;
+
+    private:
+        spng_ctx *ctx = nullptr;
+        FILE *file = nullptr;
+        const int width;
+    };
+
+    /**
+     * Executes FusedPipeline over images that do not fit in memory. The image is processed in full width bands,
+     * each band is read together with the vertical halo of the chain, and band height is picked to keep working
+     * memory, including convolution scratch, within the budget. Results are identical to FusedPipeline::apply
+     * over the whole frame while barrier kernels are separable or up to 17x17, larger kernels go through FFT
+     * whose transform size follows the band, so they may differ by rounding
+     */
+    class TiledPipeline {
+    public:
+        TiledPipeline(FusedPipeline &pipeline, size_t memoryBudget) : pipeline(pipeline), memoryBudget(memoryBudget) {}
+
+        void run(TiledSource &source, TiledSink &sink);
+
+        /**
+         * Rows processed per band for frames of the given size, throws when the budget cannot fit a single row
+         */
+        int bandHeight(int width, int height) const;
+
+    private:
+        FusedPipeline &pipeline;
+        const size_t memoryBudget;
+    };
+}
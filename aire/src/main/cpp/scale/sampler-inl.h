@@ -39,6 +39,9 @@
 #include "math-inl.h"
 #include "algo/sleef-hwy.h"
 
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
+
 using hwy::HWY_NAMESPACE::Set;
 using hwy::HWY_NAMESPACE::FixedTag;
 using hwy::HWY_NAMESPACE::Vec;
@@ -245,5 +248,7 @@ template<class D, typename T = Vec<D>>
 HWY_MATH_INLINE T Lanczos3Sinc(const D df, T x, T a) {
     return LanczosWindowHWY(df, x, Set(df, a));
 }
+}
+HWY_AFTER_NAMESPACE();
 
-#endif
\ No newline at end of file
+#endif
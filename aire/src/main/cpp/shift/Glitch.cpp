@@ -35,6 +35,7 @@
 #include "halftone/Halftone.h"
 #include "conversion/RGBAlpha.h"
 #include "color/Blend.h"
+#include "base/ScratchArena.h"
 
 using namespace std;
 
@@ -42,13 +43,13 @@ namespace aire {
     template<class V>
     void glitchEffect(V *data, int stride, int width, int height, float channelsShiftX,
                       float channelsShiftY, float corruptionSize, int corruptionCount,
-                      float cShiftX, float cShiftY) {
+                      float cShiftX, float cShiftY, uint64_t seed) {
         std::default_random_engine generator;
-        generator.seed(std::chrono::system_clock::now().time_since_epoch().count());
+        generator.seed(seed);
         std::uniform_int_distribution<int> distribution(0, width);
 
-        std::vector<V> transient(stride * height);
-        std::copy(data, data + (height - 1) * stride, transient.begin());
+        ScratchLease transient = acquireScratch(stride * height * sizeof(V));
+        std::copy(data, data + height * stride, transient.data<V>());
 
         int shiftX = channelsShiftX * width;
         int shiftY = channelsShiftY * height;
@@ -70,8 +71,8 @@ namespace aire {
                 dst[pos + 2] = src[x * 4 + 2];
             }
         }
-        std::vector<V> transient2(stride * height);
-        std::copy(transient.begin(), transient.end(), transient2.begin());
+        ScratchLease transient2 = acquireScratch(stride * height * sizeof(V));
+        std::copy(transient.data<V>(), transient.data<V>() + stride * height, transient2.data<V>());
 
         std::uniform_int_distribution<> start(0, width - 1);
         std::uniform_int_distribution<> startY(0, height - 1);
@@ -139,11 +140,11 @@ namespace aire {
             }
         }
 
-        std::copy(transient.begin(), transient.end(), data);
+        std::copy(transient.data<V>(), transient.data<V>() + stride * height, data);
     }
 
     template void
     glitchEffect(uint8_t *data, int stride, int width, int height, float channelsShiftX,
                  float channelsShiftY, float corruptionSize, int corruptionCount,
-                 float cShiftX, float cShiftY);
+                 float cShiftX, float cShiftY, uint64_t seed);
 }
\ No newline at end of file
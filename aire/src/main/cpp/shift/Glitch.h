@@ -37,5 +37,5 @@ namespace aire {
     template<class V>
     void glitchEffect(V *data, int stride, int width, int height, float channelsShiftX,
                       float channelsShiftY, float corruptionSize, int corruptionCount,
-                      float cShiftX, float cShiftY);
+                      float cShiftX, float cShiftY, uint64_t seed);
 }
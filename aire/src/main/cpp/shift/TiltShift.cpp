@@ -30,17 +30,12 @@
 
 #include "TiltShift.h"
 #include <algorithm>
-#include <vector>
-#include "color/Blend.h"
-#include "jni/JNIUtils.h"
-#include <thread>
-#include "concurrency.hpp"
-#include "Eigen/Eigen"
+#include <cmath>
+#include "blur/PyramidBlur.h"
 
 namespace aire {
 
-void horizontalTiltShift(uint8_t *data, uint8_t *source, std::vector<uint8_t> &blurred, int stride,
-                         int width, int height,
+void horizontalTiltShift(uint8_t *data, int stride, int width, int height, float sigma,
                          float anchorX, float anchorY,
                          float radius, float angle) {
   const int newWidth = std::abs(width * std::cos(angle)) + std::abs(height * std::sin(angle));
@@ -52,7 +47,9 @@ void horizontalTiltShift(uint8_t *data, uint8_t *source, std::vector<uint8_t> &b
   const float horizontalRangeMin = -M_PI / 4.0;  // -45 degrees in radians
   const float horizontalRangeMax = M_PI / 4.0;   // +45 degrees in radians
 
-  if (rotationAngle >= horizontalRangeMin && rotationAngle <= horizontalRangeMax) {
+  const bool isHorizontal = rotationAngle >= horizontalRangeMin && rotationAngle <= horizontalRangeMax;
+
+  if (isHorizontal) {
     availableDistance = std::sqrt(newWidth * newWidth);
   } else {
     availableDistance = std::sqrt(newHeight * newHeight);
@@ -65,86 +62,43 @@ void horizontalTiltShift(uint8_t *data, uint8_t *source, std::vector<uint8_t> &b
   const int centerX = fAnchorX;
   const int centerY = fAnchorY;
 
-  concurrency::parallel_for(4, height, [&](int y) {
-    auto src = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(source) + y * stride);
-    auto dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
-    auto blurredSource = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(blurred.data()) + y * stride);
-    for (int x = 0; x < width; ++x) {
+  const float cosAngle = std::cos(angle);
+  const float sinAngle = std::sin(angle);
 
-      const int newX = (x - fAnchorX) * std::cos(angle) - (y - fAnchorY) * std::sin(angle) + fAnchorX;
-      const int newY = (x - fAnchorX) * std::sin(angle) + (y - fAnchorY) * std::cos(angle) + fAnchorY;
+  pyramidBlur(data, stride, width, height, sigma, [&](int y, float *sigmas) {
+    for (int x = 0; x < width; ++x) {
+      const int newX = (x - fAnchorX) * cosAngle - (y - fAnchorY) * sinAngle + fAnchorX;
+      const int newY = (x - fAnchorX) * sinAngle + (y - fAnchorY) * cosAngle + fAnchorY;
 
       const float dx = newX - centerX;
       const float dy = newY - centerY;
 
-      float currentDistance;
-      if (rotationAngle >= horizontalRangeMin && rotationAngle <= horizontalRangeMax) {
-        currentDistance = std::sqrt(dx * dx);
-      } else {
-        currentDistance = std::sqrt(dy * dy);
-      }
+      const float currentDistance = isHorizontal ? std::abs(dx) : std::abs(dy);
 
       auto fr = currentDistance / minDistance;
       auto fraction = std::clamp(fr * fr * fr, 0.0f, 1.0f);
-      auto blurredA = blurredSource[3];
-      auto sourceA = src[3];
-      auto newA = blurredA * fraction;
-
-      Eigen::Vector3f color = {static_cast<float>(src[0]), static_cast<float>(src[1]), static_cast<float>(src[2])};
-      color /= 255.f;
-      Eigen::Vector3f blurSource = {static_cast<float>(blurredSource[0]), static_cast<float>(blurredSource[1]), static_cast<float>(blurredSource[2])};
-      blurSource /= 255.f;
-      auto blended = mix(color, blurSource, newA / 255.f);
-      auto cmp = (blended * 255.f).array().min(255.f).max(0.f);
-
-      dst[0] = cmp.x();
-      dst[1] = cmp.y();
-      dst[2] = cmp.z();
-      dst[3] = sourceA;
-      src += 4;
-      dst += 4;
-      blurredSource += 4;
+      sigmas[x] = fraction * sigma;
     }
-  });
+  }, true);
 }
 
-void tiltShift(uint8_t *data, uint8_t *source, std::vector<uint8_t> &blurred, int stride, int width, int height,
+void tiltShift(uint8_t *data, int stride, int width, int height, float sigma,
                float anchorX, float anchorY, float radius) {
   const float availableDistance = std::sqrt(height * height + width * width);
   const float minDistance = availableDistance * radius;
   const int centerX = width * anchorX;
   const int centerY = height * anchorY;
 
-  concurrency::parallel_for(4, height, [&](int y) {
-    auto src = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(source) + y * stride);
-    auto dst = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(data) + y * stride);
-    auto blurredSource = reinterpret_cast<uint8_t *>(reinterpret_cast<uint8_t *>(blurred.data()) + y * stride);
+  pyramidBlur(data, stride, width, height, sigma, [&](int y, float *sigmas) {
+    const float dy = y - centerY;
     for (int x = 0; x < width; ++x) {
       const float dx = x - centerX;
-      const float dy = y - centerY;
       float currentDistance = std::sqrt(dx * dx + dy * dy);
 
       auto fr = currentDistance / minDistance;
       auto fraction = std::clamp(fr * fr * fr, 0.0f, 1.0f);
-      auto blurredA = blurredSource[3];
-      auto sourceA = src[3];
-      auto newA = blurredA * fraction;
-
-      Eigen::Vector3f mSource = {static_cast<float>(src[0]), static_cast<float>(src[1]), static_cast<float>(src[2])};
-      mSource /= 255.f;
-      Eigen::Vector3f blurSource = {static_cast<float>(blurredSource[0]), static_cast<float>(blurredSource[1]), static_cast<float>(blurredSource[2])};
-      blurSource /= 255.f;
-      auto blended = mix(mSource, blurSource, newA / 255.f);
-      auto cmp = (blended * 255.f).array().min(255.f).max(0.f);
-
-      dst[0] = cmp.x();
-      dst[1] = cmp.y();
-      dst[2] = cmp.z();
-      dst[3] = sourceA;
-      src += 4;
-      dst += 4;
-      blurredSource += 4;
+      sigmas[x] = fraction * sigma;
     }
-  });
+  }, true);
+}
 }
-}
\ No newline at end of file
@@ -31,12 +31,14 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
 
 namespace aire {
-    void tiltShift(uint8_t *data, uint8_t *source, std::vector<uint8_t> &blurred, int stride, int width,
-                   int height, float anchorX, float anchorY, float radius);
+    /**
+     * Blur grows with distance from the anchor up to `sigma`, uses spatially varying pyramid blur
+     */
+    void tiltShift(uint8_t *data, int stride, int width, int height, float sigma,
+                   float anchorX, float anchorY, float radius);
 
-    void horizontalTiltShift(uint8_t *data, uint8_t *source, std::vector<uint8_t> &blurred, int stride, int width, int height,
+    void horizontalTiltShift(uint8_t *data, int stride, int width, int height, float sigma,
                              float anchorX, float anchorY, float radius, float angle);
 }
@@ -28,12 +28,17 @@
  *
  */
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "shift/WindStagger.cpp"
+
+#include "hwy/foreach_target.h"
+#include "hwy/highway.h"
+
 #include "WindStagger.h"
 #include <algorithm>
 #include <random>
 #include "scale/sampler.h"
 #include "scale/sampler-inl.h"
-#include "hwy/highway.h"
 #include "algo/support-inl.h"
 #include "blur/ShgStackBlur.h"
 #include "base/Arithmetics.h"
@@ -41,13 +46,14 @@
 
 using namespace std;
 
-namespace aire {
+HWY_BEFORE_NAMESPACE();
+namespace aire::HWY_NAMESPACE {
 
     using namespace hwy;
     using namespace hwy::HWY_NAMESPACE;
 
-    void horizontalWindStagger(uint8_t *data, uint8_t *source, int stride, int width, int height,
-                               float windStrength, int streamsCount, uint32_t clearColor) {
+    void horizontalWindStaggerHWY(uint8_t *data, uint8_t *source, int stride, int width, int height,
+                                  float windStrength, int streamsCount, uint32_t clearColor, uint64_t seed) {
         int staggerWidth = width * abs(windStrength);
         const FixedTag<uint8_t, 4> du8;
         const FixedTag<float32_t, 4> dfx4;
@@ -62,7 +68,7 @@ namespace aire {
         int streamSize = float(height) / float(streamsCount);
 
         std::default_random_engine generator;
-        generator.seed(std::chrono::system_clock::now().time_since_epoch().count());
+        generator.seed(seed);
         std::uniform_int_distribution<> wind(width * 0.0001f, clamp(staggerWidth, 0, width - 1));
         int lastY = 0;
         int passedY = 0;
@@ -165,5 +171,19 @@ namespace aire {
             }
         }
     }
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace aire {
+
+    HWY_EXPORT(horizontalWindStaggerHWY);
+
+    void horizontalWindStagger(uint8_t *data, uint8_t *source, int stride, int width, int height,
+                               float windStrength, int streamsCount, uint32_t clearColor, uint64_t seed) {
+        HWY_DYNAMIC_DISPATCH(horizontalWindStaggerHWY)(data, source, stride, width, height, windStrength,
+                                                       streamsCount, clearColor, seed);
+    }
 
-}
\ No newline at end of file
+}
+#endif
@@ -34,5 +34,5 @@
 
 namespace aire {
     void horizontalWindStagger(uint8_t *data, uint8_t *source, int stride, int width, int height,
-                               float windStrength, int streamsCount, uint32_t clearColor);
+                               float windStrength, int streamsCount, uint32_t clearColor, uint64_t seed);
 }
\ No newline at end of file
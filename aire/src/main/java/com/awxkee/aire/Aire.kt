@@ -31,12 +31,17 @@
 package com.awxkee.aire
 
 import androidx.annotation.Keep
+import com.awxkee.aire.pipeline.AsyncPipelinesImpl
 import com.awxkee.aire.pipeline.BasePipelinesImpl
+import com.awxkee.aire.pipeline.BatchPipelinesImpl
 import com.awxkee.aire.pipeline.BlurPipelinesImpl
 import com.awxkee.aire.pipeline.EffectsPipelineImpl
+import com.awxkee.aire.pipeline.InstrumentationImpl
 import com.awxkee.aire.pipeline.ProcessingPipelinesImpl
+import com.awxkee.aire.pipeline.ResultCacheImpl
 import com.awxkee.aire.pipeline.ScalePipelinesImpl
 import com.awxkee.aire.pipeline.ShiftPipelineImpl
+import com.awxkee.aire.pipeline.SimdTargetsImpl
 import com.awxkee.aire.pipeline.TonePipelinesImpl
 import com.awxkee.aire.pipeline.YuvPipelinesImpl
 
@@ -48,7 +53,12 @@ object Aire : BlurPipelines by BlurPipelinesImpl(),
     EffectsPipelines by EffectsPipelineImpl(),
     ScalePipelines by ScalePipelinesImpl(),
     TonePipelines by TonePipelinesImpl(),
-    YuvPipelines by YuvPipelinesImpl() {
+    YuvPipelines by YuvPipelinesImpl(),
+    Instrumentation by InstrumentationImpl(),
+    BatchPipelines by BatchPipelinesImpl(),
+    SimdTargets by SimdTargetsImpl(),
+    ResultCache by ResultCacheImpl(),
+    AsyncPipelines by AsyncPipelinesImpl() {
     init {
         System.loadLibrary("aire")
         System.loadLibrary("aire_filters")
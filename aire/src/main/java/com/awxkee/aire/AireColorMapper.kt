@@ -47,5 +47,10 @@ enum class AireColorMapper(internal val value: Int) {
     /**
      * Optimal for speed and accuracy
      */
-    COVER_TREE(2)
+    COVER_TREE(2),
+
+    /**
+     * Same accuracy as linear, brute force search vectorized and spread over threads
+     */
+    SIMD(3)
 }
\ No newline at end of file
@@ -75,6 +75,20 @@ interface BasePipelines {
 
     fun threshold(bitmap: Bitmap, @IntRange(from = 0, to = 255) level: Int): Bitmap
 
+    /**
+     * Local threshold for document scanning, every pixel is compared with statistics of the window around it.
+     * O(1) complexity, cost does not depend on radius.
+     *
+     * @param radius - window radius, should be about the size of text strokes or larger
+     * @param k - sensitivity, see [AdaptiveThresholdMethod]
+     */
+    fun adaptiveThreshold(
+        bitmap: Bitmap,
+        @IntRange(from = 1) radius: Int,
+        method: AdaptiveThresholdMethod = AdaptiveThresholdMethod.SAUVOLA,
+        k: Float = 0.2f
+    ): Bitmap
+
     fun vibrance(bitmap: Bitmap, vibrance: Float): Bitmap
 
     /**
@@ -97,7 +111,16 @@ interface BasePipelines {
 
     fun emboss(bitmap: Bitmap, intensity: Float): Bitmap
 
-    fun grain(bitmap: Bitmap, intensity: Float = 0.75f): Bitmap
+    /**
+     * @param seed - same seed produces the same grain
+     * @param mode - [GrainMode.FILM] uses tileable blue noise weighted by luminance
+     */
+    fun grain(
+        bitmap: Bitmap,
+        intensity: Float = 0.75f,
+        seed: Long = System.nanoTime(),
+        mode: GrainMode = GrainMode.GAUSSIAN
+    ): Bitmap
 
     fun sharpness(bitmap: Bitmap, kernelSize: Int): Bitmap
 
@@ -105,21 +128,78 @@ interface BasePipelines {
 
     fun gamma(bitmap: Bitmap, gamma: Float = 1f): Bitmap
 
+    /**
+     * Maps input range [inBlack, inWhite] with midtones gamma to output range [outBlack, outWhite]
+     */
+    fun levels(
+        bitmap: Bitmap,
+        inBlack: Int = 0,
+        inWhite: Int = 255,
+        gamma: Float = 1f,
+        outBlack: Int = 0,
+        outWhite: Int = 255
+    ): Bitmap
+
+    /**
+     * Tone curves as 256 entries tables in 0..255, channel curves are applied first and then master curve
+     * @param master - curve for all RGB channels, null keeps values as is
+     */
+    fun curves(
+        bitmap: Bitmap,
+        master: IntArray? = null,
+        red: IntArray? = null,
+        green: IntArray? = null,
+        blue: IntArray? = null,
+        alpha: IntArray? = null
+    ): Bitmap
+
+    /**
+     * Releases native scratch buffers cached between calls, useful on memory pressure
+     */
+    fun trimScratchMemory()
+
     fun crop(bitmap: Bitmap, baseX: Int, baseY: Int, width: Int, height: Int): Bitmap
 
+    /**
+     * Halves image [levels] times with binomial filter, each level is ceil(size / 2)
+     */
+    fun pyramidDown(bitmap: Bitmap, @IntRange(from = 1) levels: Int = 1): Bitmap
+
+    /**
+     * Rotates and flips image to upright orientation without resampling
+     */
+    fun applyOrientation(bitmap: Bitmap, orientation: ExifOrientation): Bitmap
+
     fun rotate(
         bitmap: Bitmap,
         angle: Float,
         anchorPointX: Int,
         anchorPointY: Int,
         newWidth: Int,
-        newHeight: Int
+        newHeight: Int,
+        sampler: WarpSampler = WarpSampler.BILINEAR
     ): Bitmap
 
     /**
      * @param transform - 3D affine transform 3x3 float array
      */
-    fun warpAffine(bitmap: Bitmap, transform: FloatArray, newWidth: Int, newHeight: Int): Bitmap
+    fun warpAffine(
+        bitmap: Bitmap,
+        transform: FloatArray,
+        newWidth: Int,
+        newHeight: Int,
+        sampler: WarpSampler = WarpSampler.BILINEAR
+    ): Bitmap
+
+    /**
+     * @param transform - perspective 3x3 row-major float array mapping source to destination,
+     * result is sized to the transformed bounds
+     */
+    fun warpPerspective(
+        bitmap: Bitmap,
+        transform: FloatArray,
+        sampler: WarpSampler = WarpSampler.BILINEAR
+    ): Bitmap
 
     fun toPNG(
         bitmap: Bitmap,
@@ -0,0 +1,72 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 10/19/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+
+package com.awxkee.aire
+
+import android.graphics.Bitmap
+import androidx.annotation.IntRange
+
+/**
+ * Filters and encodes many bitmaps with the same recipe in one native call.
+ * Bitmaps are read and results are delivered on the calling thread while native workers filter and encode,
+ * small images are processed one per core and large ones spread over cores left idle.
+ * Results arrive as soon as they are ready, not in order of the input
+ */
+interface BatchPipelines {
+
+    /**
+     * @param pipeline - applied to every bitmap before encoding, null encodes as is
+     * @param maxInFlight - upper bound of images held in native memory at once, 0 picks it from cores count
+     */
+    fun batchToJPEG(
+        bitmaps: List<Bitmap>,
+        pipeline: FusedPipeline? = null,
+        @IntRange(from = 0, to = 100) quality: Int = 90,
+        maxInFlight: Int = 0,
+        callback: BatchCallback,
+    )
+
+    /**
+     * @param pipeline - applied to every bitmap before encoding, null encodes as is
+     * @param maxInFlight - upper bound of images held in native memory at once, 0 picks it from cores count
+     */
+    fun batchToPNG(
+        bitmaps: List<Bitmap>,
+        pipeline: FusedPipeline? = null,
+        maxColors: Int,
+        quantize: AireQuantize = AireQuantize.XIAOLING_WU,
+        dithering: AirePaletteDithering = AirePaletteDithering.JARVIS_JUDICE_NINKE,
+        colorMapper: AireColorMapper = AireColorMapper.KD_TREE,
+        @IntRange(from = 0, to = 9) compressionLevel: Int = 7,
+        maxInFlight: Int = 0,
+        callback: BatchCallback,
+    )
+}
@@ -124,7 +124,14 @@ interface BlurPipelines {
     fun boxBlur(bitmap: Bitmap, kernelSize: Int): Bitmap
 
     /**
-     * @param angle - default is PI / 2
+     * Radial zoom blur, blur grows with distance from the center.
+     * Kernel is composed from short bilinear passes, cost grows as log of kernel size.
+     *
+     * @param kernelSize - number of gaussian taps along the ray
+     * @param centerX - zoom center as fraction of the width
+     * @param centerY - zoom center as fraction of the height
+     * @param strength - percent of distance to the center covered by one tap
+     * @param angle - weights horizontal and vertical zoom as cos and sin of it, PI / 4 zooms evenly, default is PI / 2
      */
     fun zoomBlur(
         bitmap: Bitmap,
@@ -136,7 +143,51 @@ interface BlurPipelines {
         angle: Float
     ): Bitmap
 
-    fun poissonBlur(bitmap: Bitmap, kernelSize: Int): Bitmap
+    /**
+     * Rotational blur around the center, every pixel is smeared along an arc.
+     * Cost grows as log of the arc length in pixels.
+     *
+     * @param centerX - rotation center as fraction of the width
+     * @param centerY - rotation center as fraction of the height
+     * @param angle - arc in *radians*
+     */
+    fun spinBlur(
+        bitmap: Bitmap,
+        centerX: Float = 0.5f,
+        centerY: Float = 0.5f,
+        angle: Float
+    ): Bitmap
+
+    /**
+     * @param seed - same seed produces the same kernel
+     */
+    fun poissonBlur(bitmap: Bitmap, kernelSize: Int, seed: Long = System.nanoTime()): Bitmap
+
+    /**
+     * Spatially varying gaussian blur, for depth of field or graduated blur effects.
+     * Cost is independent of the blur strength.
+     *
+     * @param sigmaMap - desired gaussian sigma for every pixel, row-major with size of *width * height*, 0 keeps pixel sharp
+     */
+    fun variableBlur(bitmap: Bitmap, sigmaMap: FloatArray): Bitmap
+
+    /**
+     * Recursive [gaussian blur](https://en.wikipedia.org/wiki/Gaussian_filter) with exact sigma,
+     * edges are extended with border pixels.
+     * O(1) complexity, cost does not depend on sigma.
+     *
+     * @param sigma - gaussian sigma in [0.5, 512]
+     */
+    fun recursiveGaussianBlur(bitmap: Bitmap, sigma: Float): Bitmap
+
+    /**
+     * Box blur with own radius for every pixel, for variable focus effects.
+     * Fractional radii blend two nearest boxes.
+     * O(1) complexity, cost does not depend on radius.
+     *
+     * @param radiusMap - desired box radius for every pixel, row-major with size of *width * height*, 0 keeps pixel sharp
+     */
+    fun variableBoxBlur(bitmap: Bitmap, radiusMap: FloatArray): Bitmap
 
     /**
      * The fastest gaussian blur approximation.
@@ -46,18 +46,26 @@ interface EffectsPipelines {
         enhance: Boolean,
     ): Bitmap
 
+    /**
+     * @param seed - same seed produces the same noise
+     */
     fun marble(
         bitmap: Bitmap,
         intensity: Float = 0.02f,
         turbulence: Float = 1f,
-        amplitude: Float = 1f
+        amplitude: Float = 1f,
+        seed: Long = System.nanoTime()
     ): Bitmap
 
+    /**
+     * @param seed - same seed produces the same noise
+     */
     fun perlinDistortion(
         bitmap: Bitmap,
         intensity: Float = 0.02f,
         turbulence: Float = 1f,
-        amplitude: Float = 1f
+        amplitude: Float = 1f,
+        seed: Long = System.nanoTime()
     ): Bitmap
 
     fun waterEffect(
@@ -73,8 +81,16 @@ interface EffectsPipelines {
 
     fun oil(bitmap: Bitmap, radius: Int, levels: Float = 1f): Bitmap
 
-    /* Prefer relative clustering for ex. width*height * 0.01f = numClusters */
-    fun crystallize(bitmap: Bitmap, numClusters: Int, strokeColor: Int = Color.TRANSPARENT): Bitmap
+    /**
+     * Prefer relative clustering for ex. width*height * 0.01f = numClusters
+     * @param seed - same seed produces the same cells layout
+     */
+    fun crystallize(
+        bitmap: Bitmap,
+        numClusters: Int,
+        strokeColor: Int = Color.TRANSPARENT,
+        seed: Long = System.nanoTime()
+    ): Bitmap
 
     fun equalizeHist(bitmap: Bitmap): Bitmap
 
@@ -0,0 +1,67 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 10/19/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+package com.awxkee.aire
+
+/**
+ * Operations of [FusedPipeline], [value] matches native FusedOp and [arity] is the count of parameters
+ * the operation consumes
+ */
+internal enum class FusedOp(internal val value: Int, internal val arity: Int) {
+    BRIGHTNESS(0, 1),
+    CONTRAST(1, 1),
+    GAMMA(2, 1),
+    VIBRANCE(3, 1),
+    COLOR_MATRIX(4, 9),
+    GRAYSCALE(5, 3),
+    EXPOSURE(6, 1),
+    LOGARITHMIC(7, 1),
+    ACES_FILMIC(8, 1),
+    HEJL_BURGESS(9, 1),
+    HABLE_FILMIC(10, 1),
+    UCHIMURA(11, 1),
+    ALDRIDGE(12, 2),
+    DRAGO(13, 2),
+    MOBIUS(14, 3),
+    GAUSSIAN_BLUR(15, 2),
+
+    /**
+     *  Kernel width and height followed by the kernel itself
+     */
+    CONVOLVE_2D(16, 2) {
+        override fun parameterCount(params: List<Float>, offset: Int): Int =
+            arity + params[offset].toInt() * params[offset + 1].toInt()
+    };
+
+    /**
+     * Parameters taken by the operation whose parameters start at [offset] of [params]
+     */
+    internal open fun parameterCount(params: List<Float>, offset: Int): Int = arity
+}
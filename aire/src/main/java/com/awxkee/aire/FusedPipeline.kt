@@ -0,0 +1,129 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 10/19/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+package com.awxkee.aire
+
+/**
+ * Chain of operations executed in a single native call.
+ * Consecutive per pixel operations are fused into one pass, blurs and convolutions are executed per tile,
+ * so the whole chain touches the image only a couple of times
+ */
+class FusedPipeline {
+    private val ops = ArrayList<FusedOp>()
+    private val params = ArrayList<Float>()
+
+    internal val opsArray: IntArray
+        get() = ops.map { it.value }.toIntArray()
+
+    internal val paramsArray: FloatArray
+        get() = params.toFloatArray()
+
+    /**
+     * Same chain for the image downscaled by [scale], gaussian sizes and sigmas are rescaled,
+     * arbitrary convolution kernels are kept as is
+     */
+    internal fun scaled(scale: Float): FusedPipeline {
+        val result = FusedPipeline()
+        var cursor = 0
+        for (op in ops) {
+            val count = op.parameterCount(params, cursor)
+            val values = params.subList(cursor, cursor + count).toFloatArray()
+            cursor += count
+            if (op == FusedOp.GAUSSIAN_BLUR) {
+                values[0] = scaledKernelSize(values[0].toInt(), scale).toFloat()
+                values[1] = values[1] * scale
+            }
+            result.add(op, *values)
+        }
+        return result
+    }
+
+    private fun add(op: FusedOp, vararg values: Float): FusedPipeline {
+        val expected = op.parameterCount(values.asList(), 0)
+        if (values.size != expected) {
+            throw IllegalStateException("$op takes $expected parameters but received ${values.size}")
+        }
+        ops.add(op)
+        values.forEach { params.add(it) }
+        return this
+    }
+
+    fun brightness(bias: Float) = add(FusedOp.BRIGHTNESS, bias)
+
+    fun contrast(gain: Float) = add(FusedOp.CONTRAST, gain)
+
+    fun gamma(gamma: Float) = add(FusedOp.GAMMA, gamma)
+
+    fun vibrance(vibrance: Float) = add(FusedOp.VIBRANCE, vibrance)
+
+    fun colorMatrix(colorMatrix: FloatArray): FusedPipeline {
+        if (colorMatrix.size != 9) {
+            throw IllegalArgumentException("Color matrix must be 3x3")
+        }
+        return add(FusedOp.COLOR_MATRIX, *colorMatrix)
+    }
+
+    fun grayscale(rPrimary: Float = 0.299f, gPrimary: Float = 0.587f, bPrimary: Float = 0.114f) =
+        add(FusedOp.GRAYSCALE, rPrimary, gPrimary, bPrimary)
+
+    fun exposure(exposure: Float) = add(FusedOp.EXPOSURE, exposure)
+
+    fun logarithmic(exposure: Float = 1f) = add(FusedOp.LOGARITHMIC, exposure)
+
+    fun acesFilmic(exposure: Float = 1f) = add(FusedOp.ACES_FILMIC, exposure)
+
+    fun hejlBurgess(exposure: Float = 1f) = add(FusedOp.HEJL_BURGESS, exposure)
+
+    fun hableFilmic(exposure: Float = 1f) = add(FusedOp.HABLE_FILMIC, exposure)
+
+    fun uchimura(exposure: Float = 1f) = add(FusedOp.UCHIMURA, exposure)
+
+    fun aldridge(exposure: Float = 1f, cutoff: Float = 0.025f) = add(FusedOp.ALDRIDGE, exposure, cutoff)
+
+    fun drago(exposure: Float = 1f, sdrWhitePoint: Float = 250f) = add(FusedOp.DRAGO, exposure, sdrWhitePoint)
+
+    fun mobius(exposure: Float = 1f, transition: Float = 0.9f, peak: Float = 1f) =
+        add(FusedOp.MOBIUS, exposure, transition, peak)
+
+    /**
+     * @param sigma - 0 computes preferred sigma from kernel size
+     */
+    fun gaussianBlur(kernelSize: Int, sigma: Float = 0f) = add(FusedOp.GAUSSIAN_BLUR, kernelSize.toFloat(), sigma)
+
+    /**
+     * Convolution with any kernel, edges are clamped
+     */
+    fun convolve2D(kernel: FloatArray, kernelShape: KernelShape): FusedPipeline {
+        if (kernel.size != kernelShape.width * kernelShape.height) {
+            throw IllegalArgumentException("Kernel must have exactly kernelWidth * kernelHeight values")
+        }
+        return add(FusedOp.CONVOLVE_2D, kernelShape.width.toFloat(), kernelShape.height.toFloat(), *kernel)
+    }
+}
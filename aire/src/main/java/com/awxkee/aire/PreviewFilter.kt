@@ -0,0 +1,131 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 10/19/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+
+package com.awxkee.aire
+
+import android.graphics.Bitmap
+import kotlin.math.max
+import kotlin.math.roundToInt
+
+/**
+ * Odd kernel size covering the same area of an image downscaled by [scale]
+ */
+internal fun scaledKernelSize(kernelSize: Int, scale: Float, minSize: Int = 1): Int {
+    val radius = ((kernelSize - 1) / 2f * scale).roundToInt()
+    return max(radius * 2 + 1, minSize or 1)
+}
+
+internal fun scaledRadius(radius: Int, scale: Float, minRadius: Int = 1): Int {
+    return max((radius * scale).roundToInt(), minRadius)
+}
+
+/**
+ * Filter that can be rendered on a downscaled proxy of the image, see [PreviewSession].
+ * Spatial parameters are given for the full resolution image and rescaled for the proxy,
+ * so the preview matches the look of the final render
+ */
+sealed interface PreviewFilter {
+    /**
+     * Same filter for the image downscaled by [scale]
+     */
+    fun scaled(scale: Float): PreviewFilter
+
+    fun apply(bitmap: Bitmap): Bitmap
+
+    class GaussianBlur(
+        private val kernelSize: Int,
+        private val sigma: Float = 0f,
+        private val edgeMode: EdgeMode = EdgeMode.REFLECT_101,
+        private val preciseLevel: GaussianPreciseLevel = GaussianPreciseLevel.EXACT,
+    ) : PreviewFilter {
+        override fun scaled(scale: Float) =
+            GaussianBlur(scaledKernelSize(kernelSize, scale), sigma * scale, edgeMode, preciseLevel)
+
+        override fun apply(bitmap: Bitmap) =
+            Aire.gaussianBlur(bitmap, kernelSize, kernelSize, sigma, sigma, edgeMode, preciseLevel)
+    }
+
+    class RecursiveGaussianBlur(private val sigma: Float) : PreviewFilter {
+        override fun scaled(scale: Float) = RecursiveGaussianBlur(max(sigma * scale, 0.5f))
+
+        override fun apply(bitmap: Bitmap) = Aire.recursiveGaussianBlur(bitmap, sigma)
+    }
+
+    class BoxBlur(private val kernelSize: Int) : PreviewFilter {
+        override fun scaled(scale: Float) = BoxBlur(scaledKernelSize(kernelSize, scale))
+
+        override fun apply(bitmap: Bitmap) = Aire.boxBlur(bitmap, kernelSize)
+    }
+
+    class StackBlur(private val horizontalRadius: Int, private val verticalRadius: Int) : PreviewFilter {
+        override fun scaled(scale: Float) =
+            StackBlur(scaledRadius(horizontalRadius, scale), scaledRadius(verticalRadius, scale))
+
+        override fun apply(bitmap: Bitmap) = Aire.stackBlur(bitmap, horizontalRadius, verticalRadius)
+    }
+
+    class Bokeh(
+        private val kernelSize: Int,
+        private val sides: Int = 6,
+        private val enhance: Boolean = false,
+    ) : PreviewFilter {
+        override fun scaled(scale: Float) = Bokeh(scaledKernelSize(kernelSize, scale, 3), sides, enhance)
+
+        override fun apply(bitmap: Bitmap) = Aire.bokeh(bitmap, kernelSize, sides, enhance)
+    }
+
+    class Oil(private val radius: Int, private val levels: Float = 1f) : PreviewFilter {
+        override fun scaled(scale: Float) = Oil(scaledRadius(radius, scale), levels)
+
+        override fun apply(bitmap: Bitmap) = Aire.oil(bitmap, radius, levels)
+    }
+
+    class Dehaze(private val radius: Int = 17, private val omega: Float = 0.45f) : PreviewFilter {
+        override fun scaled(scale: Float) = Dehaze(scaledRadius(radius, scale), omega)
+
+        override fun apply(bitmap: Bitmap) = Aire.dehaze(bitmap, radius, omega)
+    }
+
+    class Fused(private val pipeline: FusedPipeline) : PreviewFilter {
+        override fun scaled(scale: Float) = Fused(pipeline.scaled(scale))
+
+        override fun apply(bitmap: Bitmap) = Aire.fused(bitmap, pipeline)
+    }
+
+    /**
+     * Any other filter, [block] receives the image and it's scale relative to the full resolution
+     */
+    class Custom(private val block: (Bitmap, Float) -> Bitmap, private val scale: Float = 1f) : PreviewFilter {
+        override fun scaled(scale: Float) = Custom(block, this.scale * scale)
+
+        override fun apply(bitmap: Bitmap) = block(bitmap, scale)
+    }
+}
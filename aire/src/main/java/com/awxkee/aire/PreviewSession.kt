@@ -0,0 +1,94 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 10/19/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+
+package com.awxkee.aire
+
+import android.graphics.Bitmap
+import kotlin.math.max
+import kotlin.math.min
+import kotlin.math.roundToInt
+
+/**
+ * Interactive editing of one image: keeps a lazily built pyramid of the source and renders filters
+ * on the smallest level that still covers the view, spatial parameters are rescaled to the level,
+ * so slider ticks cost a fraction of the full resolution render, which is done only by [commit]
+ */
+class PreviewSession(private val source: Bitmap) {
+    private val levels = arrayListOf(source)
+
+    /**
+     * Renders [filter] fitted into [viewWidth] x [viewHeight] keeping aspect ratio
+     */
+    fun preview(viewWidth: Int, viewHeight: Int, filter: PreviewFilter): Bitmap {
+        if (viewWidth <= 0 || viewHeight <= 0) {
+            throw IllegalArgumentException("View size must be positive but received $viewWidth x $viewHeight")
+        }
+        val fit = min(viewWidth.toFloat() / source.width, viewHeight.toFloat() / source.height)
+        if (fit >= 1f) {
+            return filter.apply(source)
+        }
+        val targetWidth = max((source.width * fit).roundToInt(), 1)
+        val targetHeight = max((source.height * fit).roundToInt(), 1)
+        val level = levelFor(targetWidth, targetHeight)
+        val scale = level.width.toFloat() / source.width
+        val rendered = if (level === source) filter.apply(level) else filter.scaled(scale).apply(level)
+        if (rendered.width == targetWidth && rendered.height == targetHeight) {
+            return rendered
+        }
+        return Aire.scale(rendered, targetWidth, targetHeight, ResizeFunction.Bilinear, ScaleColorSpace.SRGB)
+    }
+
+    /**
+     * Renders [filter] at full resolution
+     */
+    fun commit(filter: PreviewFilter): Bitmap = filter.apply(source)
+
+    /**
+     * Smallest pyramid level at least as large as the target
+     */
+    @Synchronized
+    private fun levelFor(targetWidth: Int, targetHeight: Int): Bitmap {
+        var index = 0
+        while (true) {
+            val nextWidth = (levels[index].width + 1) / 2
+            val nextHeight = (levels[index].height + 1) / 2
+            if (nextWidth < targetWidth || nextHeight < targetHeight ||
+                (levels[index].width == 1 && levels[index].height == 1)
+            ) {
+                return levels[index]
+            }
+            if (index + 1 == levels.size) {
+                levels.add(Aire.pyramidDown(levels[index]))
+            }
+            index += 1
+        }
+    }
+}
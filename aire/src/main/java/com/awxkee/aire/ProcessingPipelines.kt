@@ -51,6 +51,32 @@ interface ProcessingPipelines {
         mode: MorphOpMode
     ): Bitmap
 
+    /**
+     * 2D Convolution with kernel of any size, edges are clamped.
+     * Separable kernels are applied in two passes, large ones are convolved through FFT
+     **/
+    fun fastConvolve2D(bitmap: Bitmap, kernel: FloatArray, kernelShape: KernelShape): Bitmap
+
+    /**
+     * Executes whole [FusedPipeline] in one native call
+     */
+    fun fused(bitmap: Bitmap, pipeline: FusedPipeline): Bitmap
+
+    /**
+     * Executes [FusedPipeline] over image stored in a file as tightly packed RGBA8888 rows, so images much larger
+     * than available memory can be processed. Files are memory mapped and processed in full width bands
+     * @param memoryBudget - upper bound of working memory in bytes, smaller budget results in more halo rows re-read
+     */
+    fun fusedTiled(
+        inputPath: String,
+        width: Int,
+        height: Int,
+        outputPath: String,
+        output: TiledOutput,
+        pipeline: FusedPipeline,
+        memoryBudget: Long = 256L * 1024L * 1024L
+    )
+
     fun sobel(bitmap: Bitmap, edgeMode: EdgeMode, scalar: Scalar): Bitmap
 
     fun laplacian(bitmap: Bitmap, edgeMode: EdgeMode, scalar: Scalar): Bitmap
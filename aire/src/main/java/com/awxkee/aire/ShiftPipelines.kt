@@ -35,7 +35,16 @@ import android.graphics.Color
 
 interface ShiftPipelines {
 
-    fun horizontalWindStagger(bitmap: Bitmap, windStrength: Float = 0.2f, streamsCount: Int = 90, clearColor: Int = Color.BLACK.toInt()): Bitmap
+    /**
+     * @param seed - same seed produces the same streams
+     */
+    fun horizontalWindStagger(
+        bitmap: Bitmap,
+        windStrength: Float = 0.2f,
+        streamsCount: Int = 90,
+        clearColor: Int = Color.BLACK.toInt(),
+        seed: Long = System.nanoTime()
+    ): Bitmap
 
     fun tiltShift(
         bitmap: Bitmap,
@@ -56,6 +65,9 @@ interface ShiftPipelines {
         angle: Float = Math.PI.toFloat() / 2,
     ): Bitmap
 
+    /**
+     * @param seed - same seed produces the same corruptions
+     */
     fun glitch(
         bitmap: Bitmap,
         channelsShiftX: Float = -0.075f,
@@ -64,5 +76,6 @@ interface ShiftPipelines {
         corruptionCount: Int = 60,
         corruptionShiftX: Float = -0.05f,
         corruptionShiftY: Float = 0.0f,
+        seed: Long = System.nanoTime(),
     ): Bitmap
 }
\ No newline at end of file
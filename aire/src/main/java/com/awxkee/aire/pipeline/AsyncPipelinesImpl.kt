@@ -0,0 +1,108 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 10/19/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+
+package com.awxkee.aire.pipeline
+
+import com.awxkee.aire.AireJob
+import com.awxkee.aire.AsyncPipelines
+import com.awxkee.aire.ProgressListener
+import java.util.concurrent.Callable
+import java.util.concurrent.Executor
+import java.util.concurrent.Executors
+import java.util.concurrent.atomic.AtomicInteger
+
+class AsyncPipelinesImpl : AsyncPipelines {
+
+    private val sharedExecutor: Executor by lazy {
+        val counter = AtomicInteger()
+        Executors.newCachedThreadPool { runnable ->
+            Thread(runnable, "Aire-async-${counter.incrementAndGet()}").apply { isDaemon = true }
+        }
+    }
+
+    override fun <T> async(executor: Executor?, listener: ProgressListener?, block: () -> T): AireJob<T> {
+        val token = JobToken(listener)
+        val job = AireJob(Callable {
+            val handle = token.open()
+            try {
+                var result: T? = null
+                runBoundImpl(handle) { result = block() }
+                @Suppress("UNCHECKED_CAST")
+                result as T
+            } finally {
+                token.close()
+            }
+        }, token::cancel)
+        (executor ?: sharedExecutor).execute(job)
+        return job
+    }
+
+    /**
+     * Native token lives only while the job runs, a job cancelled before start never allocates it
+     */
+    private inner class JobToken(private val listener: ProgressListener?) {
+        private var handle = 0L
+        private var cancelled = false
+
+        @Synchronized
+        fun open(): Long {
+            handle = createTokenImpl(listener)
+            if (cancelled) {
+                cancelTokenImpl(handle)
+            }
+            return handle
+        }
+
+        @Synchronized
+        fun cancel() {
+            cancelled = true
+            if (handle != 0L) {
+                cancelTokenImpl(handle)
+            }
+        }
+
+        @Synchronized
+        fun close() {
+            if (handle != 0L) {
+                releaseTokenImpl(handle)
+                handle = 0L
+            }
+        }
+    }
+
+    private external fun createTokenImpl(listener: ProgressListener?): Long
+
+    private external fun cancelTokenImpl(handle: Long)
+
+    private external fun releaseTokenImpl(handle: Long)
+
+    private external fun runBoundImpl(handle: Long, block: Runnable)
+}
@@ -32,16 +32,20 @@ package com.awxkee.aire.pipeline
 
 import android.graphics.Bitmap
 import androidx.annotation.IntRange
+import com.awxkee.aire.AdaptiveThresholdMethod
 import com.awxkee.aire.Aire
 import com.awxkee.aire.AireColorMapper
 import com.awxkee.aire.AirePaletteDithering
 import com.awxkee.aire.AireQuantize
 import com.awxkee.aire.BasePipelines
 import com.awxkee.aire.EdgeMode
+import com.awxkee.aire.ExifOrientation
+import com.awxkee.aire.GrainMode
 import com.awxkee.aire.KernelShape
 import com.awxkee.aire.MorphOp
 import com.awxkee.aire.MorphOpMode
 import com.awxkee.aire.Scalar
+import com.awxkee.aire.WarpSampler
 
 class BasePipelinesImpl : BasePipelines {
 
@@ -84,6 +88,18 @@ class BasePipelinesImpl : BasePipelines {
         return thresholdPipeline(bitmap, level)
     }
 
+    override fun adaptiveThreshold(
+        bitmap: Bitmap,
+        radius: Int,
+        method: AdaptiveThresholdMethod,
+        k: Float
+    ): Bitmap {
+        if (radius < 1) {
+            throw IllegalStateException("Radius must be more or equal 1")
+        }
+        return adaptiveThresholdImpl(bitmap, radius, method.value, k)
+    }
+
     override fun vibrance(bitmap: Bitmap, vibrance: Float): Bitmap {
         return vibrancePipeline(bitmap, vibrance)
     }
@@ -120,8 +136,8 @@ class BasePipelinesImpl : BasePipelines {
         )
     }
 
-    override fun grain(bitmap: Bitmap, intensity: Float): Bitmap {
-        return grainImpl(bitmap, intensity)
+    override fun grain(bitmap: Bitmap, intensity: Float, seed: Long, mode: GrainMode): Bitmap {
+        return grainImpl(bitmap, intensity, seed, mode.value)
     }
 
     override fun sharpness(bitmap: Bitmap, kernelSize: Int): Bitmap {
@@ -159,10 +175,49 @@ class BasePipelinesImpl : BasePipelines {
         return gammaImpl(bitmap, gamma)
     }
 
+    override fun levels(
+        bitmap: Bitmap,
+        inBlack: Int,
+        inWhite: Int,
+        gamma: Float,
+        outBlack: Int,
+        outWhite: Int
+    ): Bitmap {
+        return levelsImpl(bitmap, inBlack, inWhite, gamma, outBlack, outWhite)
+    }
+
+    override fun curves(
+        bitmap: Bitmap,
+        master: IntArray?,
+        red: IntArray?,
+        green: IntArray?,
+        blue: IntArray?,
+        alpha: IntArray?
+    ): Bitmap {
+        listOf(master, red, green, blue, alpha).forEach {
+            if (it != null && it.size != 256) {
+                throw IllegalArgumentException("Curve must have exactly 256 values")
+            }
+        }
+        return curvesImpl(bitmap, master, red, green, blue, alpha)
+    }
+
+    override fun trimScratchMemory() {
+        trimScratchMemoryImpl()
+    }
+
     override fun crop(bitmap: Bitmap, baseX: Int, baseY: Int, width: Int, height: Int): Bitmap {
         return cropImpl(bitmap, baseX, baseY, width, height)
     }
 
+    override fun pyramidDown(bitmap: Bitmap, levels: Int): Bitmap {
+        return pyramidDownImpl(bitmap, levels)
+    }
+
+    override fun applyOrientation(bitmap: Bitmap, orientation: ExifOrientation): Bitmap {
+        return applyOrientationImpl(bitmap, orientation.value)
+    }
+
     override fun toPNG(
         bitmap: Bitmap,
         maxColors: Int,
@@ -193,18 +248,35 @@ class BasePipelinesImpl : BasePipelines {
 
     override fun rotate(
         bitmap: Bitmap, angle: Float, anchorPointX: Int,
-        anchorPointY: Int, newWidth: Int, newHeight: Int
+        anchorPointY: Int, newWidth: Int, newHeight: Int, sampler: WarpSampler
     ): Bitmap {
-        return rotateImpl(bitmap, angle, anchorPointX, anchorPointY, newWidth, newHeight)
+        return rotateImpl(
+            bitmap,
+            angle,
+            anchorPointX,
+            anchorPointY,
+            newWidth,
+            newHeight,
+            sampler.value
+        )
     }
 
     override fun warpAffine(
         bitmap: Bitmap,
         transform: FloatArray,
         newWidth: Int,
-        newHeight: Int
+        newHeight: Int,
+        sampler: WarpSampler
+    ): Bitmap {
+        return warpAffineImpl(bitmap, transform, newWidth, newHeight, sampler.value)
+    }
+
+    override fun warpPerspective(
+        bitmap: Bitmap,
+        transform: FloatArray,
+        sampler: WarpSampler
     ): Bitmap {
-        return warpAffineImpl(bitmap, transform, newWidth, newHeight)
+        return warpPerspectiveImpl(bitmap, transform, sampler.value)
     }
 
     override fun mozjpeg(bitmap: Bitmap, quality: Int): ByteArray {
@@ -221,14 +293,25 @@ class BasePipelinesImpl : BasePipelines {
         bitmap: Bitmap,
         transform: FloatArray,
         newWidth: Int,
-        newHeight: Int
+        newHeight: Int,
+        sampler: Int
+    ): Bitmap
+
+    private external fun warpPerspectiveImpl(
+        bitmap: Bitmap,
+        transform: FloatArray,
+        sampler: Int
     ): Bitmap
 
     private external fun rotateImpl(
         bitmap: Bitmap, angle: Float, anchorPointX: Int,
-        anchorPointY: Int, newWidth: Int, newHeight: Int
+        anchorPointY: Int, newWidth: Int, newHeight: Int, sampler: Int
     ): Bitmap
 
+    private external fun applyOrientationImpl(bitmap: Bitmap, orientation: Int): Bitmap
+
+    private external fun pyramidDownImpl(bitmap: Bitmap, levels: Int): Bitmap
+
     private external fun cropImpl(
         bitmap: Bitmap,
         baseX: Int,
@@ -260,11 +343,31 @@ class BasePipelinesImpl : BasePipelines {
 
     private external fun gammaImpl(bitmap: Bitmap, gamma: Float): Bitmap
 
+    private external fun trimScratchMemoryImpl()
+
+    private external fun levelsImpl(
+        bitmap: Bitmap,
+        inBlack: Int,
+        inWhite: Int,
+        gamma: Float,
+        outBlack: Int,
+        outWhite: Int
+    ): Bitmap
+
+    private external fun curvesImpl(
+        bitmap: Bitmap,
+        master: IntArray?,
+        red: IntArray?,
+        green: IntArray?,
+        blue: IntArray?,
+        alpha: IntArray?
+    ): Bitmap
+
     private external fun unsharpImpl(bitmap: Bitmap, intensity: Float = 1f): Bitmap
 
     private external fun sharpnessImpl(bitmap: Bitmap, intensity: Float = 1f): Bitmap
 
-    private external fun grainImpl(bitmap: Bitmap, intensity: Float): Bitmap
+    private external fun grainImpl(bitmap: Bitmap, intensity: Float, seed: Long, mode: Int): Bitmap
 
     private external fun colorMatrixImpl(bitmap: Bitmap, colorMatrix: FloatArray): Bitmap
 
@@ -284,6 +387,8 @@ class BasePipelinesImpl : BasePipelines {
 
     private external fun thresholdPipeline(bitmap: Bitmap, level: Int): Bitmap
 
+    private external fun adaptiveThresholdImpl(bitmap: Bitmap, radius: Int, method: Int, k: Float): Bitmap
+
     private external fun morphologyImpl(
         bitmap: Bitmap,
         morphOp: Int,
@@ -0,0 +1,108 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 10/19/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+
+package com.awxkee.aire.pipeline
+
+import android.graphics.Bitmap
+import com.awxkee.aire.AireColorMapper
+import com.awxkee.aire.AirePaletteDithering
+import com.awxkee.aire.AireQuantize
+import com.awxkee.aire.BatchCallback
+import com.awxkee.aire.BatchPipelines
+import com.awxkee.aire.FusedPipeline
+
+class BatchPipelinesImpl : BatchPipelines {
+
+    override fun batchToJPEG(
+        bitmaps: List<Bitmap>,
+        pipeline: FusedPipeline?,
+        quality: Int,
+        maxInFlight: Int,
+        callback: BatchCallback
+    ) {
+        batchCompressImpl(
+            bitmaps.toTypedArray(),
+            pipeline?.opsArray ?: IntArray(0),
+            pipeline?.paramsArray ?: FloatArray(0),
+            1,
+            quality,
+            0,
+            0,
+            0,
+            0,
+            0,
+            maxInFlight,
+            callback
+        )
+    }
+
+    override fun batchToPNG(
+        bitmaps: List<Bitmap>,
+        pipeline: FusedPipeline?,
+        maxColors: Int,
+        quantize: AireQuantize,
+        dithering: AirePaletteDithering,
+        colorMapper: AireColorMapper,
+        compressionLevel: Int,
+        maxInFlight: Int,
+        callback: BatchCallback
+    ) {
+        batchCompressImpl(
+            bitmaps.toTypedArray(),
+            pipeline?.opsArray ?: IntArray(0),
+            pipeline?.paramsArray ?: FloatArray(0),
+            0,
+            0,
+            maxColors,
+            quantize.value,
+            dithering.value,
+            colorMapper.value,
+            compressionLevel,
+            maxInFlight,
+            callback
+        )
+    }
+
+    private external fun batchCompressImpl(
+        bitmaps: Array<Bitmap>,
+        ops: IntArray,
+        params: FloatArray,
+        encoding: Int,
+        quality: Int,
+        maxColors: Int,
+        quantize: Int,
+        dithering: Int,
+        mappingStrategy: Int,
+        compressionLevel: Int,
+        maxInFlight: Int,
+        callback: BatchCallback,
+    )
+}
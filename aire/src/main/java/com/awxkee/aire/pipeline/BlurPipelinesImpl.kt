@@ -220,11 +220,32 @@ class BlurPipelinesImpl : BlurPipelines {
     }
 
 
-    override fun poissonBlur(bitmap: Bitmap, kernelSize: Int): Bitmap {
+    override fun poissonBlur(bitmap: Bitmap, kernelSize: Int, seed: Long): Bitmap {
         if (kernelSize < 1) {
             throw IllegalStateException("Radius must be more or equal 1")
         }
-        return poissonBlurPipeline(bitmap, kernelSize)
+        return poissonBlurPipeline(bitmap, kernelSize, seed)
+    }
+
+    override fun variableBlur(bitmap: Bitmap, sigmaMap: FloatArray): Bitmap {
+        if (sigmaMap.size != bitmap.width * bitmap.height) {
+            throw IllegalStateException("Sigma map must have exactly width * height values")
+        }
+        return variableBlurImpl(bitmap, sigmaMap)
+    }
+
+    override fun recursiveGaussianBlur(bitmap: Bitmap, sigma: Float): Bitmap {
+        if (sigma < 0.5f || sigma > 512f) {
+            throw IllegalStateException("Sigma must be in range [0.5, 512]")
+        }
+        return recursiveGaussianBlurImpl(bitmap, sigma)
+    }
+
+    override fun variableBoxBlur(bitmap: Bitmap, radiusMap: FloatArray): Bitmap {
+        if (radiusMap.size != bitmap.width * bitmap.height) {
+            throw IllegalStateException("Radius map must have exactly width * height values")
+        }
+        return variableBoxBlurImpl(bitmap, radiusMap)
     }
 
     override fun stackBlur(bitmap: Bitmap, horizontalRadius: Int, verticalRadius: Int): Bitmap {
@@ -291,6 +312,15 @@ class BlurPipelinesImpl : BlurPipelines {
         return zoomBlurImpl(bitmap, kernelSize, sigma, centerX, centerY, strength, angle)
     }
 
+    override fun spinBlur(
+        bitmap: Bitmap,
+        centerX: Float,
+        centerY: Float,
+        angle: Float
+    ): Bitmap {
+        return spinBlurImpl(bitmap, centerX, centerY, angle)
+    }
+
     override fun motionBlur(
         bitmap: Bitmap,
         kernelSize: Int,
@@ -327,6 +357,19 @@ class BlurPipelinesImpl : BlurPipelines {
         borderScalar: Scalar
     ): Bitmap
 
+    private external fun variableBlurImpl(bitmap: Bitmap, sigmaMap: FloatArray): Bitmap
+
+    private external fun recursiveGaussianBlurImpl(bitmap: Bitmap, sigma: Float): Bitmap
+
+    private external fun variableBoxBlurImpl(bitmap: Bitmap, radiusMap: FloatArray): Bitmap
+
+    private external fun spinBlurImpl(
+        bitmap: Bitmap,
+        centerX: Float,
+        centerY: Float,
+        angle: Float
+    ): Bitmap
+
     private external fun zoomBlurImpl(
         bitmap: Bitmap,
         kernelSize: Int,
@@ -373,7 +416,7 @@ class BlurPipelinesImpl : BlurPipelines {
         diffusion: Float
     ): Bitmap
 
-    private external fun poissonBlurPipeline(bitmap: Bitmap, radius: Int): Bitmap
+    private external fun poissonBlurPipeline(bitmap: Bitmap, radius: Int, seed: Long): Bitmap
 
     private external fun fastBilateralBlurImpl(
         bitmap: Bitmap,
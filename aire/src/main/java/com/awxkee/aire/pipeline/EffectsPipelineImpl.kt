@@ -51,15 +51,15 @@ class EffectsPipelineImpl : EffectsPipelines {
     }
 
     override fun marble(
-        bitmap: Bitmap, intensity: Float, turbulence: Float, amplitude: Float
+        bitmap: Bitmap, intensity: Float, turbulence: Float, amplitude: Float, seed: Long
     ): Bitmap {
-        return marbleImpl(bitmap, intensity, turbulence, amplitude)
+        return marbleImpl(bitmap, intensity, turbulence, amplitude, seed)
     }
 
     override fun perlinDistortion(
-        bitmap: Bitmap, intensity: Float, turbulence: Float, amplitude: Float
+        bitmap: Bitmap, intensity: Float, turbulence: Float, amplitude: Float, seed: Long
     ): Bitmap {
-        return perlinDistortionImpl(bitmap, intensity, turbulence, amplitude)
+        return perlinDistortionImpl(bitmap, intensity, turbulence, amplitude, seed)
     }
 
     override fun waterEffect(
@@ -81,8 +81,13 @@ class EffectsPipelineImpl : EffectsPipelines {
         return oilImpl(bitmap, radius, levels)
     }
 
-    override fun crystallize(bitmap: Bitmap, numClusters: Int, strokeColor: Int): Bitmap {
-        return crystallizeImpl(bitmap, numClusters, strokeColor)
+    override fun crystallize(
+        bitmap: Bitmap,
+        numClusters: Int,
+        strokeColor: Int,
+        seed: Long
+    ): Bitmap {
+        return crystallizeImpl(bitmap, numClusters, strokeColor, seed)
     }
 
     override fun equalizeHist(bitmap: Bitmap): Bitmap {
@@ -253,7 +258,7 @@ class EffectsPipelineImpl : EffectsPipelines {
     ): Bitmap
 
     private external fun perlinDistortionImpl(
-        bitmap: Bitmap, intensity: Float, turbulence: Float, amplitude: Float
+        bitmap: Bitmap, intensity: Float, turbulence: Float, amplitude: Float, seed: Long
     ): Bitmap
 
     private external fun fractalGlassImpl(
@@ -270,13 +275,13 @@ class EffectsPipelineImpl : EffectsPipelines {
     ): Bitmap
 
     private external fun marbleImpl(
-        bitmap: Bitmap, intensity: Float = 0.5f, turbulence: Float = 1f, amplitude: Float = 1f
+        bitmap: Bitmap, intensity: Float, turbulence: Float, amplitude: Float, seed: Long
     ): Bitmap
 
     private external fun oilImpl(bitmap: Bitmap, radius: Int, levels: Float): Bitmap
 
     private external fun crystallizeImpl(
-        bitmap: Bitmap, clustersCount: Int, strokeColor: Int
+        bitmap: Bitmap, clustersCount: Int, strokeColor: Int, seed: Long
     ): Bitmap
 
     private external fun equalizeHistImpl(bitmap: Bitmap): Bitmap
@@ -33,10 +33,12 @@ package com.awxkee.aire.pipeline
 import android.graphics.Bitmap
 import androidx.annotation.IntRange
 import com.awxkee.aire.EdgeMode
+import com.awxkee.aire.FusedPipeline
 import com.awxkee.aire.KernelShape
 import com.awxkee.aire.MorphOpMode
 import com.awxkee.aire.ProcessingPipelines
 import com.awxkee.aire.Scalar
+import com.awxkee.aire.TiledOutput
 
 class ProcessingPipelinesImpl : ProcessingPipelines {
     override fun removeShadows(
@@ -69,6 +71,35 @@ class ProcessingPipelinesImpl : ProcessingPipelines {
         )
     }
 
+    override fun fastConvolve2D(bitmap: Bitmap, kernel: FloatArray, kernelShape: KernelShape): Bitmap {
+        return fastConvolve2DImpl(bitmap, kernel, kernelShape.width, kernelShape.height)
+    }
+
+    override fun fused(bitmap: Bitmap, pipeline: FusedPipeline): Bitmap {
+        return fusedPipelineImpl(bitmap, pipeline.opsArray, pipeline.paramsArray)
+    }
+
+    override fun fusedTiled(
+        inputPath: String,
+        width: Int,
+        height: Int,
+        outputPath: String,
+        output: TiledOutput,
+        pipeline: FusedPipeline,
+        memoryBudget: Long
+    ) {
+        fusedTiledImpl(
+            inputPath,
+            width,
+            height,
+            outputPath,
+            output.value,
+            pipeline.opsArray,
+            pipeline.paramsArray,
+            memoryBudget
+        )
+    }
+
     override fun sobel(
         bitmap: Bitmap,
         edgeMode: EdgeMode,
@@ -91,6 +122,26 @@ class ProcessingPipelinesImpl : ProcessingPipelines {
         mode: Int,
     ): Bitmap
 
+    private external fun fastConvolve2DImpl(
+        bitmap: Bitmap,
+        kernel: FloatArray,
+        kernelWidth: Int,
+        kernelHeight: Int,
+    ): Bitmap
+
+    private external fun fusedPipelineImpl(bitmap: Bitmap, ops: IntArray, params: FloatArray): Bitmap
+
+    private external fun fusedTiledImpl(
+        inputPath: String,
+        width: Int,
+        height: Int,
+        outputPath: String,
+        output: Int,
+        ops: IntArray,
+        params: FloatArray,
+        memoryBudget: Long,
+    )
+
     private external fun removeShadowsPipelines(bitmap: Bitmap, kernelSize: Int): Bitmap
 
     private external fun dehazeImpl(bitmap: Bitmap, radius: Int, omega: Float): Bitmap
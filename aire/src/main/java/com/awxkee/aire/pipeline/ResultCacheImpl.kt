@@ -0,0 +1,64 @@
+/*
+ *
+ *  * MIT License
+ *  *
+ *  * Copyright (c) 2024 Radzivon Bartoshyk
+ *  * aire [https://github.com/awxkee/aire]
+ *  *
+ *  * Created by Radzivon Bartoshyk on 10/19/26, 6:13 PM
+ *  *
+ *  * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  * of this software and associated documentation files (the "Software"), to deal
+ *  * in the Software without restriction, including without limitation the rights
+ *  * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  * copies of the Software, and to permit persons to whom the Software is
+ *  * furnished to do so, subject to the following conditions:
+ *  *
+ *  * The above copyright notice and this permission notice shall be included in all
+ *  * copies or substantial portions of the Software.
+ *  *
+ *  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  * SOFTWARE.
+ *  *
+ *
+ */
+
+
+package com.awxkee.aire.pipeline
+
+import com.awxkee.aire.ResultCache
+import com.awxkee.aire.ResultCacheStats
+
+class ResultCacheImpl : ResultCache {
+
+    override fun setResultCacheBudget(bytes: Long) {
+        setResultCacheBudgetImpl(bytes)
+    }
+
+    override fun clearResultCache() {
+        clearResultCacheImpl()
+    }
+
+    override fun resultCacheStats(): ResultCacheStats {
+        val values = resultCacheStatsImpl()
+        return ResultCacheStats(
+            hits = values[0],
+            misses = values[1],
+            evictions = values[2],
+            entries = values[3],
+            bytes = values[4],
+            budget = values[5],
+        )
+    }
+
+    private external fun setResultCacheBudgetImpl(bytes: Long)
+
+    private external fun clearResultCacheImpl()
+
+    private external fun resultCacheStatsImpl(): LongArray
+}
@@ -39,9 +39,10 @@ class ShiftPipelineImpl : ShiftPipelines {
         bitmap: Bitmap,
         windStrength: Float,
         streamsCount: Int,
-        clearColor: Int
+        clearColor: Int,
+        seed: Long
     ): Bitmap {
-        return horizontalWindStaggerImpl(bitmap, windStrength, streamsCount, clearColor)
+        return horizontalWindStaggerImpl(bitmap, windStrength, streamsCount, clearColor, seed)
     }
 
     override fun tiltShift(
@@ -77,6 +78,7 @@ class ShiftPipelineImpl : ShiftPipelines {
         corruptionCount: Int,
         corruptionShiftX: Float,
         corruptionShiftY: Float,
+        seed: Long,
     ): Bitmap {
         return glitchImpl(
             bitmap,
@@ -85,7 +87,8 @@ class ShiftPipelineImpl : ShiftPipelines {
             corruptionSize,
             corruptionCount,
             corruptionShiftX,
-            corruptionShiftY
+            corruptionShiftY,
+            seed
         )
     }
 
@@ -93,7 +96,8 @@ class ShiftPipelineImpl : ShiftPipelines {
         bitmap: Bitmap,
         windStrength: Float,
         streamsCount: Int,
-        clearColor: Int
+        clearColor: Int,
+        seed: Long
     ): Bitmap
 
     private external fun horizontalTiltShiftImpl(
@@ -123,5 +127,6 @@ class ShiftPipelineImpl : ShiftPipelines {
         corruptionCount: Int,
         corruptionShiftX: Float,
         corruptionShiftY: Float,
+        seed: Long,
     ): Bitmap
 }
\ No newline at end of file